@@ -9,6 +9,20 @@
 // Includes
 //-------------------------------------------------------------------------------------------------
 #include <asvkApp.h>
+#include <asvkPipelineCache.h>
+#include <asvkResourceState.h>
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// SampleOption enum
+///////////////////////////////////////////////////////////////////////////////////////////////////
+enum SampleOption
+{
+    SampleOption_CommandBenchmark   = 0x1 << 0,     //!< 初期化後にコマンドバッファのベンチマークを実行します(-bench-command).
+    SampleOption_MemoryBenchmark    = 0x1 << 1,     //!< 初期化後にメモリ割り当てのベンチマークを実行します(-bench-memory).
+    SampleOption_MathCheck          = 0x1 << 2,     //!< 初期化後にSIMD版とスカラー版の演算結果を比較します(-check-math).
+    SampleOption_ParallelRecord     = 0x1 << 3,     //!< 描画パスを毎フレーム複数スレッドで記録します(-parallel-record).
+};
 
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -53,8 +67,10 @@ public:
 
     //---------------------------------------------------------------------------------------------
     //! @brief      コンストラクタです.
+    //!
+    //! @param[in]      options     SampleOption の組み合わせです.
     //---------------------------------------------------------------------------------------------
-    SampleApp();
+    explicit SampleApp(uint32_t options = 0);
 
     //---------------------------------------------------------------------------------------------
     //! @brief      デストラクタです.
@@ -67,9 +83,13 @@ private:
     //=============================================================================================
     asvk::Queue*            m_pQueue;           //!< グラフィックスキューです.
     VkPipelineLayout        m_PipelineLayout;   //!< パイプラインレイアウトです.
-    VkPipelineCache         m_PipelineCache;    //!< パイプラインキャッシュです.
+    asvk::PipelineCache     m_PipelineCache;    //!< パイプラインキャッシュです.
     VkPipeline              m_Pipeline;         //!< パイプラインです.
+    asvk::StaticCommandList m_StaticPass;       //!< 記録済みの描画パスです.
+    asvk::ParallelCommandList   m_ParallelPass; //!< 毎フレーム並列に記録する描画パスです.
+    asvk::ResourceStateTracker  m_StateTracker; //!< リソースステートトラッカーです.
     Mesh                    m_Mesh;             //!< メッシュです.
+    uint32_t                m_Options;          //!< SampleOption の組み合わせです.
 
     //=============================================================================================
     // private methods.
@@ -103,25 +123,19 @@ private:
     void OnFrameRender(const asvk::FrameEventArgs& args) override;
 
     //---------------------------------------------------------------------------------------------
-    //! @brief      リソースバリアを設定します.
+    //! @brief      リサイズ時の処理です.
     //!
-    //! @param[in]      commandBuffer       コマンドバッファ.
+    //! @param[in]      args        リサイズイベント引数.
     //---------------------------------------------------------------------------------------------
-    void ResourceBarrier(
-        VkCommandBuffer         commandBuffer,
-        VkPipelineStageFlags    srcStageFlags,
-        VkPipelineStageFlags    dstStageFlags,
-        VkAccessFlags           srcAccessMask,
-        VkAccessFlags           dstAccessMask,
-        VkImageLayout           oldLayout,
-        VkImageLayout           newLayout);
+    void OnResize(const asvk::ResizeEventArgs& args) override;
 
     //---------------------------------------------------------------------------------------------
     //! @brief      レンダーパスを開始します.
     //!
     //! @param[in]      commandBuffer       コマンドバッファ.
+    //! @param[in]      contents            サブパスの記録方法.
     //---------------------------------------------------------------------------------------------
-    void BeginRenderPass(VkCommandBuffer commandBuffer);
+    void BeginRenderPass(VkCommandBuffer commandBuffer, VkSubpassContents contents);
 
     //---------------------------------------------------------------------------------------------
     //! @brief      レンダーパスを終了します.
@@ -129,4 +143,30 @@ private:
     //! @param[in]      commandBuffer       コマンドバッファ.
     //---------------------------------------------------------------------------------------------
     void EndRenderPass(VkCommandBuffer commandBuffer);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      メッシュの描画コマンドを記録します.
+    //!
+    //! @param[in]      commandBuffer       記録先のコマンドバッファ.
+    //! @param[in]      scissor             シザー矩形.
+    //---------------------------------------------------------------------------------------------
+    void DrawMesh(VkCommandBuffer commandBuffer, const VkRect2D& scissor);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コマンドバッファ数を変えてベンチマークを実行し, 比較表をログに出力します.
+    //---------------------------------------------------------------------------------------------
+    void RunCommandBenchmarks();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      バッファ数を変えてメモリ割り当てのベンチマークを実行し, 比較表をログに出力します.
+    //---------------------------------------------------------------------------------------------
+    void RunMemoryBenchmarks();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      SIMD版の演算結果をスカラー版のカーネルと比較し, 結果をログに出力します.
+    //!
+    //! @retval true    全ての結果が一致.
+    //! @retval false   一致しない結果があった.
+    //---------------------------------------------------------------------------------------------
+    bool RunMathCheck();
 };
\ No newline at end of file
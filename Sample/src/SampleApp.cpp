@@ -12,6 +12,10 @@
 #include <asvkLogger.h>
 #include <asvkBlob.h>
 #include <asvkMisc.h>
+#include <asvkAllocator.h>
+#include <chrono>
+#include <cstring>
+#include <cmath>
 
 
 namespace /* anonymous */ {
@@ -26,6 +30,45 @@ struct Vertex
     asvk::Vector4 Color;        //!< 頂点カラーです.
 };
 
+//-------------------------------------------------------------------------------------------------
+//      経過時間をミリ秒で取得します.
+//-------------------------------------------------------------------------------------------------
+inline double ElapsedMs
+(
+    const std::chrono::high_resolution_clock::time_point& begin,
+    const std::chrono::high_resolution_clock::time_point& end
+)
+{ return std::chrono::duration<double, std::milli>(end - begin).count(); }
+
+//-------------------------------------------------------------------------------------------------
+//      ビット単位で一致するかどうかチェックします.
+//-------------------------------------------------------------------------------------------------
+inline bool IsBitEqual(const float* a, const float* b, size_t count)
+{ return memcmp(a, b, sizeof(float) * count) == 0; }
+
+//-------------------------------------------------------------------------------------------------
+//      最大誤差を求めます.
+//-------------------------------------------------------------------------------------------------
+inline float MaxError(const float* a, const float* b, size_t count)
+{
+    auto error = 0.0f;
+    for(size_t i=0; i<count; ++i)
+    { error = asvk::Max(error, fabsf(a[i] - b[i])); }
+    return error;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      乱数で行列を生成します.
+//-------------------------------------------------------------------------------------------------
+inline asvk::Matrix RandomMatrix(asvk::Random& random)
+{
+    asvk::Matrix result;
+    auto p = &result._11;
+    for(auto i=0; i<16; ++i)
+    { p[i] = random.GetAsF32(-1.0f, 1.0f); }
+    return result;
+}
+
 } // namespace /* anonymous */
 
 
@@ -36,12 +79,16 @@ struct Vertex
 //-------------------------------------------------------------------------------------------------
 //      コンストラクタです.
 //-------------------------------------------------------------------------------------------------
-SampleApp::SampleApp()
+SampleApp::SampleApp(uint32_t options)
 : asvk::App(L"SampleApp", 960, 540, nullptr, nullptr, nullptr)
 , m_pQueue          ( nullptr )
 , m_PipelineLayout  ( null_handle )
-, m_PipelineCache   ( null_handle )
+, m_PipelineCache   ()
 , m_Pipeline        ( null_handle )
+, m_StaticPass      ()
+, m_ParallelPass    ()
+, m_StateTracker    ()
+, m_Options         ( options )
 { /* DO_NOTHING */ }
 
 //-------------------------------------------------------------------------------------------------
@@ -55,6 +102,9 @@ SampleApp::~SampleApp()
 //-------------------------------------------------------------------------------------------------
 bool SampleApp::OnInit()
 {
+    auto initBegin = std::chrono::high_resolution_clock::now();
+    auto pipelineMs = 0.0;
+
     // グラフィックスキューを取得します.
     m_pQueue = m_DeviceMgr.GetGraphicsQueue();
     assert(m_pQueue != nullptr);
@@ -90,7 +140,7 @@ bool SampleApp::OnInit()
             return false;
         }
 
-        auto props = m_DeviceMgr.GetPhysicalDevice()[0].MemoryProps;
+        auto props = m_DeviceMgr.GetSelectedPhysicalDevice().MemoryProps;
 
         // メモリ要件を取得.
         VkMemoryRequirements requirements;
@@ -198,17 +248,11 @@ bool SampleApp::OnInit()
 
     // パイプラインキャッシュの生成.
     {
-        VkPipelineCacheCreateInfo info = {};
-        info.sType              = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
-        info.pNext              = nullptr;
-        info.flags              = 0;
-        info.initialDataSize    = 0;
-        info.pInitialData       = nullptr;
-
-        auto result = vkCreatePipelineCache(device, &info, nullptr, &m_PipelineCache);
-        if (result != VK_SUCCESS)
+        // 前回終了時に保存したキャッシュがあれば読み込む.
+        auto path = asvk::GetExePath() + L"PipelineCache.bin";
+        if (!m_PipelineCache.Init(&m_DeviceMgr, path.c_str()))
         {
-            ELOG( "Error : vkCreatePipelineCache() Failed." );
+            ELOG( "Error : PipelineCache::Init() Failed." );
             return false;
         }
     }
@@ -453,7 +497,9 @@ bool SampleApp::OnInit()
         pipelineInfo.basePipelineIndex      = 0;
 
         // グラフィックスパイプラインの生成.
-        auto result = vkCreateGraphicsPipelines(device, m_PipelineCache, 1, &pipelineInfo, nullptr, &m_Pipeline);
+        auto begin  = std::chrono::high_resolution_clock::now();
+        auto result = vkCreateGraphicsPipelines(device, m_PipelineCache.GetHandle(), 1, &pipelineInfo, nullptr, &m_Pipeline);
+        auto end    = std::chrono::high_resolution_clock::now();
         if (result != VK_SUCCESS)
         {
             ELOG( "Error : vkCreateGraphicsPipelines() Failed." );
@@ -462,11 +508,55 @@ bool SampleApp::OnInit()
             return false;
         }
 
+        pipelineMs = ElapsedMs(begin, end);
+
         // 不要なオブジェクトを破棄.
         vkDestroyShaderModule(device, vs, nullptr);
         vkDestroyShaderModule(device, fs, nullptr);
     }
 
+    // 描画パスの記録先をスワップチェインのバッファごとに用意.
+    if (!m_StaticPass.Init(&m_DeviceMgr, asvk::QueueType_Graphics, m_SwapChain.GetDesc().BufferCount))
+    {
+        ELOG( "Error : StaticCommandList::Init() Failed." );
+        return false;
+    }
+
+    // 毎フレーム記録する場合は, 記録先のプールを同時に処理するフレームごとに用意.
+    if (m_Options & SampleOption_ParallelRecord)
+    {
+        if (!m_ParallelPass.Init(&m_DeviceMgr, asvk::QueueType_Graphics, 0, m_CommandList.GetBufferCount()))
+        {
+            ELOG( "Error : ParallelCommandList::Init() Failed." );
+            return false;
+        }
+    }
+
+    // 起動時間のレポート. コールド/ウォームスタートの比較に使用する.
+    {
+        auto& stats = m_PipelineCache.GetStats();
+        auto  initEnd = std::chrono::high_resolution_clock::now();
+
+        ILOG( "Info : Startup Report" );
+        ILOG( "    Pipeline Cache  : %s%s (%zu bytes)",
+            (stats.IsWarm) ? "warm" : "cold",
+            (stats.IsDiscarded) ? ", stale data discarded" : "",
+            stats.LoadedSize );
+        ILOG( "    Cache Load      : %.3lf ms", stats.LoadMs );
+        ILOG( "    Pipeline Create : %.3lf ms", pipelineMs );
+        ILOG( "    OnInit() Total  : %.3lf ms", ElapsedMs(initBegin, initEnd) );
+    }
+
+    // コマンドラインで指定されたベンチマークを実行.
+    if (m_Options & SampleOption_CommandBenchmark)
+    { RunCommandBenchmarks(); }
+
+    if (m_Options & SampleOption_MemoryBenchmark)
+    { RunMemoryBenchmarks(); }
+
+    if (m_Options & SampleOption_MathCheck)
+    { RunMathCheck(); }
+
     // 正常終了.
     return true;
 }
@@ -511,12 +601,12 @@ void SampleApp::OnTerm()
         m_PipelineLayout = null_handle;
     }
 
-    // パイプラインキャッシュ破棄.
-    if (m_PipelineCache != null_handle)
-    {
-        vkDestroyPipelineCache(device, m_PipelineCache, nullptr);
-        m_PipelineCache = null_handle;
-    }
+    // 記録済みの描画パスを破棄.
+    m_StaticPass  .Term(&m_DeviceMgr);
+    m_ParallelPass.Term(&m_DeviceMgr);
+
+    // パイプラインキャッシュを保存して破棄.
+    m_PipelineCache.Term(&m_DeviceMgr);
 
     m_pQueue = nullptr;
 }
@@ -536,112 +626,119 @@ void SampleApp::OnFrameRender(const asvk::FrameEventArgs& args)
 {
     ASVK_UNUSED(args);
 
-    // コマンドの記録を開始.
-    m_CommandList.Reset();
-
-    // 現在のコマンドリストを取得.
+    // 現在のコマンドリストを取得(記録の開始と実行はアプリケーション側で行われる).
     auto cmd = m_CommandList.GetCurrentCommandBuffer();
 
-    VkDeviceSize offset = 0;
+    // GPU時間を計測.
+    m_CommandList.BeginRegion("Frame");
 
     // 描画処理.
     {
-        // Present ---> Attachment へのパイプラインバリアを張る.
-        ResourceBarrier(
-            cmd,
-            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-            VK_ACCESS_MEMORY_READ_BIT,
-            VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+        auto image = m_SwapChain.GetCurrentBuffer()->Image;
+        auto range = m_SwapChain.GetRange();
+
+        // 取得したイメージは Present 状態. イメージ取得のセマフォは COLOR_ATTACHMENT_OUTPUT で
+        // 待機されるので, 同じステージから繋ぐ.
+        m_StateTracker.SetImageState(image, asvk::ResourceState(
             VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
-            VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+            0,
+            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT));
 
-        // レンダーパスを開始.
-        BeginRenderPass(cmd);
+        // Present ---> Attachment へ遷移.
+        m_StateTracker.TransitionImage(image, range, asvk::ResourceUsage_ColorAttachment);
+        m_StateTracker.Flush(cmd);
 
-        // パイプラインをバインドする.
-        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_Pipeline);
+        // 描画はセカンダリコマンドバッファで行うので, クエリを継承できる場合のみパイプライン統計を収集する.
+        auto statsFlags = (m_DeviceMgr.IsInheritedQueries()) ? m_GpuProfiler.GetPipelineStatisticFlags() : 0;
+
+        // レンダーパスを開始.
+        m_CommandList.BeginRegion("MainPass", statsFlags != 0);
+        BeginRenderPass(cmd, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
 
-        // ビューポート・シザー矩形の設定.
-        vkCmdSetViewport(cmd, 0, 1, &m_Viewport);
-        vkCmdSetScissor (cmd, 0, 1, &m_Scissor);
+        auto idx = m_SwapChain.GetBufferIndex();
+        if (m_Options & SampleOption_ParallelRecord)
+        {
+            // 前回このフレームで記録したセカンダリは, App::BeginFrame() でフェンスを待った後なので再利用できる.
+            if (!m_ParallelPass.Reset(m_CommandList.GetBufferIndex()))
+            { ELOG( "Error : ParallelCommandList::Reset() Failed." ); }
+
+            // 画面を横方向の帯に分け, 各スレッドが自分の帯だけを描画する.
+            auto threadCount = m_ParallelPass.GetThreadCount();
+            m_ParallelPass.Record(
+                cmd,
+                m_RenderPass,
+                0,
+                m_FrameBuffer[idx],
+                [&](uint32_t threadIndex, VkCommandBuffer secondary)
+                {
+                    auto top    = m_Scissor.extent.height * threadIndex / threadCount;
+                    auto bottom = m_Scissor.extent.height * (threadIndex + 1) / threadCount;
 
-        // 頂点バッファの設定.
-        vkCmdBindVertexBuffers(cmd, 0, 1, &m_Mesh.Buffer, &offset);
+                    VkRect2D scissor = m_Scissor;
+                    scissor.offset.y      = m_Scissor.offset.y + int32_t(top);
+                    scissor.extent.height = bottom - top;
 
-        // 描画コマンドを積む.
-        vkCmdDraw(cmd, 3, 1, 0, 0);
+                    DrawMesh(secondary, scissor);
+                },
+                statsFlags);
+        }
+        else
+        {
+            // 描画内容はリサイズかパイプライン変更まで変わらないので, 記録済みのものを再生する.
+            m_StaticPass.Execute(
+                cmd,
+                idx,
+                m_RenderPass,
+                0,
+                m_FrameBuffer[idx],
+                reinterpret_cast<uint64_t>(m_Pipeline),
+                [&](uint32_t, VkCommandBuffer secondary)
+                { DrawMesh(secondary, m_Scissor); },
+                statsFlags);
+        }
 
         // レンダーパスを終了.
         EndRenderPass(cmd);
+        m_CommandList.EndRegion();
 
-        // Attachment ---> Present へのパイプラインバリアを張る.
-        ResourceBarrier(
-            cmd,
-            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-            VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
-            VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
-            VK_ACCESS_MEMORY_READ_BIT,
-            VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-            VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+        // Attachment ---> Present へ遷移.
+        m_StateTracker.TransitionImage(image, range, asvk::ResourceUsage_Present);
+        m_StateTracker.Flush(cmd);
     }
 
-    // コマンドの記録を終了.
-    m_CommandList.Close();
-
-    // コマンドを実行.
-    m_pQueue->Execute(1, &cmd);
-
-    // コマンドの完了を待機.
-    m_pQueue->Wait(TimeOut);
-
-    // 画面に表示.
-    m_SwapChain.Present(TimeOut);
+    m_CommandList.EndRegion();
 }
 
 //-------------------------------------------------------------------------------------------------
-//      リソースバリアを設定します.
+//      リサイズ時の処理です.
 //-------------------------------------------------------------------------------------------------
-void SampleApp::ResourceBarrier
-(
-    VkCommandBuffer         commandBuffer,
-    VkPipelineStageFlags    srcStageFlags,
-    VkPipelineStageFlags    dstStageFlags,
-    VkAccessFlags           srcAccessMask,
-    VkAccessFlags           dstAccessMask,
-    VkImageLayout           oldLayout,
-    VkImageLayout           newLayout
-)
+void SampleApp::OnResize(const asvk::ResizeEventArgs& args)
 {
-    VkImageMemoryBarrier barrier;
-    barrier.sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    barrier.pNext               = nullptr;
-    barrier.srcAccessMask       = srcAccessMask;
-    barrier.dstAccessMask       = dstAccessMask;
-    barrier.oldLayout           = oldLayout;
-    barrier.newLayout           = newLayout;
-    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.subresourceRange    = m_SwapChain.GetRange();
-    barrier.image               = m_SwapChain.GetCurrentBuffer()->Image;
-
-    vkCmdPipelineBarrier(
-        commandBuffer,
-        srcStageFlags,
-        dstStageFlags,
-        0,
-        0,
-        nullptr,
-        0,
-        nullptr,
-        1,
-        &barrier);
+    ASVK_UNUSED(args);
+
+    // スワップチェインのイメージ数が変わった場合は記録先を作り直す.
+    // 実行中のフレームは App::ResizeSwapChain() で完了を待っているので破棄してよい.
+    auto bufferCount = m_SwapChain.GetDesc().BufferCount;
+    if (m_StaticPass.GetCount() != bufferCount)
+    {
+        m_StaticPass.Term(&m_DeviceMgr);
+        if (!m_StaticPass.Init(&m_DeviceMgr, asvk::QueueType_Graphics, bufferCount))
+        { ELOG( "Error : StaticCommandList::Init() Failed." ); }
+    }
+    else
+    {
+        // フレームバッファとビューポートが作り直されるので再記録させる.
+        m_StaticPass.Invalidate();
+    }
+
+    // スワップチェインのイメージも作り直されるので追跡中のステートを破棄.
+    m_StateTracker.Reset();
 }
 
 //-------------------------------------------------------------------------------------------------
 //      レンダーパスを開始します.
 //-------------------------------------------------------------------------------------------------
-void SampleApp::BeginRenderPass(VkCommandBuffer commandBuffer)
+void SampleApp::BeginRenderPass(VkCommandBuffer commandBuffer, VkSubpassContents contents)
 {
     // カラーバッファのクリアカラーの設定.
     VkClearColorValue clearColor = {};
@@ -676,7 +773,7 @@ void SampleApp::BeginRenderPass(VkCommandBuffer commandBuffer)
     info.pClearValues               = clearValues;
 
     // レンダーパス開始コマンドを積む.
-    vkCmdBeginRenderPass(commandBuffer, &info, VK_SUBPASS_CONTENTS_INLINE);
+    vkCmdBeginRenderPass(commandBuffer, &info, contents);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -686,4 +783,218 @@ void SampleApp::EndRenderPass(VkCommandBuffer commandBuffer)
 {
     // レンダーパス終了コマンドを積む.
     vkCmdEndRenderPass(commandBuffer);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      メッシュの描画コマンドを記録します.
+//-------------------------------------------------------------------------------------------------
+void SampleApp::DrawMesh(VkCommandBuffer commandBuffer, const VkRect2D& scissor)
+{
+    VkDeviceSize offset = 0;
+
+    // パイプラインをバインドする.
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_Pipeline);
+
+    // ビューポート・シザー矩形の設定.
+    vkCmdSetViewport(commandBuffer, 0, 1, &m_Viewport);
+    vkCmdSetScissor (commandBuffer, 0, 1, &scissor);
+
+    // 頂点バッファの設定.
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, &m_Mesh.Buffer, &offset);
+
+    // 描画コマンドを積む.
+    vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      コマンドバッファ数を変えてベンチマークを実行します.
+//-------------------------------------------------------------------------------------------------
+void SampleApp::RunCommandBenchmarks()
+{
+    static const uint32_t BufferCounts[] = { 1, 10, 100 };
+    static const uint32_t FrameCount     = 100;
+    static const size_t   CaseCount      = sizeof(BufferCounts) / sizeof(BufferCounts[0]);
+
+    asvk::CommandBenchmarkResult results[CaseCount] = {};
+    bool                         succeeded[CaseCount] = {};
+
+    for(size_t i=0; i<CaseCount; ++i)
+    { succeeded[i] = asvk::RunCommandBenchmark(&m_DeviceMgr, BufferCounts[i], FrameCount, &results[i]); }
+
+    // コマンドバッファ数ごとの比較表.
+    ILOG( "Info : Command Benchmark Summary (%u frames, ms/frame)", FrameCount );
+    ILOG( "    Buffers | BufferReset | PoolReset | BufferReset / PoolReset" );
+    for(size_t i=0; i<CaseCount; ++i)
+    {
+        if (!succeeded[i])
+        {
+            ILOG( "    %7u | failed", BufferCounts[i] );
+            continue;
+        }
+
+        auto ratio = (results[i].PoolResetMs > 0.0) ? results[i].BufferResetMs / results[i].PoolResetMs : 0.0;
+        ILOG( "    %7u | %11.4f | %9.4f | %.2lfx",
+            BufferCounts[i],
+            results[i].BufferResetMs,
+            results[i].PoolResetMs,
+            ratio );
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      バッファ数を変えてメモリ割り当てのベンチマークを実行します.
+//-------------------------------------------------------------------------------------------------
+void SampleApp::RunMemoryBenchmarks()
+{
+    static const uint32_t     BufferCounts[] = { 16, 256, 1024 };
+    static const VkDeviceSize BufferSize     = 64 * 1024;
+    static const size_t       CaseCount      = sizeof(BufferCounts) / sizeof(BufferCounts[0]);
+
+    auto device = m_DeviceMgr.GetDevice();
+    auto gpu    = m_DeviceMgr.GetSelectedPhysicalDevice().Gpu;
+
+    asvk::MemoryBenchmarkResult results[CaseCount] = {};
+    bool                        succeeded[CaseCount] = {};
+
+    for(size_t i=0; i<CaseCount; ++i)
+    { succeeded[i] = asvk::RunMemoryBenchmark(device, gpu, BufferCounts[i], BufferSize, &results[i]); }
+
+    // バッファ数ごとの比較表.
+    ILOG( "Info : Memory Benchmark Summary (%llu bytes/buffer, alloc + free ms, vkAllocateMemory count)",
+        static_cast<unsigned long long>(BufferSize) );
+    ILOG( "    Buffers | SubAllocate          | Dedicated" );
+    for(size_t i=0; i<CaseCount; ++i)
+    {
+        if (!succeeded[i])
+        {
+            ILOG( "    %7u | failed", BufferCounts[i] );
+            continue;
+        }
+
+        ILOG( "    %7u | %9.3f ms x %6u | %9.3f ms x %6u",
+            BufferCounts[i],
+            results[i].SubAllocateMs + results[i].SubFreeMs,
+            results[i].SubDeviceAllocations,
+            results[i].DedicatedAllocateMs + results[i].DedicatedFreeMs,
+            results[i].DedicatedDeviceAllocations );
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      SIMD版の演算結果をスカラー版のカーネルと比較します.
+//-------------------------------------------------------------------------------------------------
+bool SampleApp::RunMathCheck()
+{
+    static const uint32_t SampleCount     = 10000;
+    static const float    InvertTolerance = 1e-4f;  // 逆行列は加算順序が異なるため誤差で比較する.
+
+    asvk::Random random(12345);
+
+    auto multiplyFailures   = 0u;
+    auto transformFailures  = 0u;
+    auto quaternionFailures = 0u;
+    auto invertFailures     = 0u;
+    auto maxInvertError     = 0.0f;
+
+    for(auto i=0u; i<SampleCount; ++i)
+    {
+        auto a = RandomMatrix(random);
+        auto b = RandomMatrix(random);
+
+        // 行列乗算. 全ての呼び出し方がスカラー版とビット単位で一致すること.
+        {
+            asvk::Matrix expected;
+            asvk::scalar::MultiplyMatrix(&a._11, &b._11, &expected._11);
+
+            asvk::Matrix r0 = asvk::Matrix::Multiply(a, b);
+            asvk::Matrix r1;
+            asvk::Matrix::Multiply(a, b, r1);
+            asvk::Matrix r2 = a * b;
+            asvk::Matrix r3 = a;
+            r3 *= b;
+
+            if (!IsBitEqual(&r0._11, &expected._11, 16)
+             || !IsBitEqual(&r1._11, &expected._11, 16)
+             || !IsBitEqual(&r2._11, &expected._11, 16)
+             || !IsBitEqual(&r3._11, &expected._11, 16))
+            { multiplyFailures++; }
+        }
+
+        // ベクトル変換.
+        {
+            asvk::Vector4 v(
+                random.GetAsF32(-1.0f, 1.0f),
+                random.GetAsF32(-1.0f, 1.0f),
+                random.GetAsF32(-1.0f, 1.0f),
+                random.GetAsF32(-1.0f, 1.0f));
+
+            asvk::Vector4 expected;
+            asvk::scalar::TransformRow(&v.x, &b._11, &expected.x);
+
+            asvk::Vector4 r0 = asvk::Vector4::Transform(v, b);
+            asvk::Vector4 r1;
+            asvk::Vector4::Transform(v, b, r1);
+
+            if (!IsBitEqual(&r0.x, &expected.x, 4) || !IsBitEqual(&r1.x, &expected.x, 4))
+            { transformFailures++; }
+        }
+
+        // 四元数乗算.
+        {
+            asvk::Quaternion qa(&a._11);
+            asvk::Quaternion qb(&b._11);
+
+            asvk::Quaternion expected;
+            asvk::scalar::MultiplyQuaternion(&qa.x, &qb.x, &expected.x);
+
+            asvk::Quaternion r0 = asvk::Quaternion::Multiply(qa, qb);
+            asvk::Quaternion r1;
+            asvk::Quaternion::Multiply(qa, qb, r1);
+            asvk::Quaternion r2 = qa * qb;
+            asvk::Quaternion r3 = qa;
+            r3 *= qb;
+
+            if (!IsBitEqual(&r0.x, &expected.x, 4)
+             || !IsBitEqual(&r1.x, &expected.x, 4)
+             || !IsBitEqual(&r2.x, &expected.x, 4)
+             || !IsBitEqual(&r3.x, &expected.x, 4))
+            { quaternionFailures++; }
+        }
+
+        // 逆行列. 対角優位にして条件数を抑える.
+        {
+            auto m = a;
+            m._11 += 4.0f;  m._22 += 4.0f;  m._33 += 4.0f;  m._44 += 4.0f;
+
+            asvk::Matrix expected;
+            asvk::scalar::InvertMatrix(&m._11, &expected._11);
+
+            asvk::Matrix r0 = asvk::Matrix::Invert(m);
+            asvk::Matrix r1;
+            asvk::Matrix::Invert(m, r1);
+
+            auto error = asvk::Max(MaxError(&r0._11, &expected._11, 16), MaxError(&r1._11, &expected._11, 16));
+            maxInvertError = asvk::Max(maxInvertError, error);
+            if (error > InvertTolerance)
+            { invertFailures++; }
+        }
+    }
+
+#if ASVK_IS_SIMD && ASVK_IS_AVX
+    ILOG( "Info : Math Check (AVX vs Scalar, %u samples)", SampleCount );
+#elif ASVK_IS_SIMD && ASVK_IS_SSE2
+    ILOG( "Info : Math Check (SSE2 vs Scalar, %u samples)", SampleCount );
+#else
+    ILOG( "Info : Math Check (Scalar only, %u samples)", SampleCount );
+#endif
+    ILOG( "    Multiply   : %u mismatches", multiplyFailures );
+    ILOG( "    Transform  : %u mismatches", transformFailures );
+    ILOG( "    Quaternion : %u mismatches", quaternionFailures );
+    ILOG( "    Invert     : %u over tolerance (max error = %e)", invertFailures, maxInvertError );
+
+    auto failures = multiplyFailures + transformFailures + quaternionFailures + invertFailures;
+    if (failures > 0)
+    { ELOG( "Error : Math Check Failed." ); }
+
+    return failures == 0;
 }
\ No newline at end of file
@@ -8,6 +8,7 @@
 // Includes
 //-------------------------------------------------------------------------------------------------
 #include <SampleApp.h>
+#include <cstring>
 
 
 //-------------------------------------------------------------------------------------------------
@@ -15,8 +16,22 @@
 //-------------------------------------------------------------------------------------------------
 int main(int argc, char** argv)
 {
+    // コマンドライン引数からオプションを設定します.
+    uint32_t options = 0;
+    for(auto i=1; i<argc; ++i)
+    {
+        if (strcmp(argv[i], "-bench-command") == 0)
+        { options |= SampleOption_CommandBenchmark; }
+        else if (strcmp(argv[i], "-bench-memory") == 0)
+        { options |= SampleOption_MemoryBenchmark; }
+        else if (strcmp(argv[i], "-check-math") == 0)
+        { options |= SampleOption_MathCheck; }
+        else if (strcmp(argv[i], "-parallel-record") == 0)
+        { options |= SampleOption_ParallelRecord; }
+    }
+
     // アプリケーションを実行します.
-    SampleApp().Run();
+    SampleApp(options).Run();
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,278 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asvkAllocator.h
+// Desc : Device Memory Allocator Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asvkTypedef.h>
+#include <vulkan/vulkan.h>
+#include <vector>
+#include <mutex>
+
+
+namespace asvk {
+
+//-------------------------------------------------------------------------------------------------
+// Forward Declarations.
+//-------------------------------------------------------------------------------------------------
+class MemoryPage;
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Allocation structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct Allocation
+{
+    VkDeviceMemory  Memory;         //!< デバイスメモリです.
+    VkDeviceSize    Offset;         //!< デバイスメモリ先頭からのオフセットです.
+    VkDeviceSize    Size;           //!< 割り当てサイズです.
+    uint32_t        TypeIndex;      //!< メモリタイプ番号です.
+    MemoryPage*     pPage;          //!< 所属するページです(専用割り当ての場合もページを持ちます).
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    Allocation()
+    : Memory    (null_handle)
+    , Offset    (0)
+    , Size      (0)
+    , TypeIndex (0)
+    , pPage     (nullptr)
+    { /* DO_NOTHING */ }
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// MemoryHeapStats structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct MemoryHeapStats
+{
+    VkDeviceSize    ReservedBytes;  //!< vkAllocateMemory() で確保済みのバイト数です.
+    VkDeviceSize    UsedBytes;      //!< リソースに割り当て済みのバイト数です.
+    uint32_t        PageCount;      //!< ページ数です.
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// MemoryStats structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct MemoryStats
+{
+    uint32_t        PageCount;                          //!< 総ページ数です.
+    uint32_t        DedicatedCount;                     //!< 専用割り当て数です.
+    uint32_t        AllocationCount;                    //!< 割り当て数です.
+    uint32_t        DeviceAllocationCount;              //!< vkAllocateMemory() の累計呼び出し回数です.
+    VkDeviceSize    ReservedBytes;                      //!< 確保済みの総バイト数です.
+    VkDeviceSize    UsedBytes;                          //!< 割り当て済みの総バイト数です.
+    float           Fragmentation;                      //!< 断片化率です (1 - 最大空き領域 / 総空き領域).
+    MemoryHeapStats Heaps[VK_MAX_MEMORY_HEAPS];         //!< ヒープごとの統計です.
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// MemoryAllocatorDesc structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct MemoryAllocatorDesc
+{
+    VkDeviceSize    PageSize;           //!< ページサイズです. 0 の場合はリソースごとに vkAllocateMemory() を呼び出します.
+    VkDeviceSize    DedicatedThreshold; //!< このサイズ以上の要求は専用割り当てにします.
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    MemoryAllocatorDesc()
+    : PageSize          (64 * 1024 * 1024)
+    , DedicatedThreshold(32 * 1024 * 1024)
+    { /* DO_NOTHING */ }
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// MemoryAllocator class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class MemoryAllocator : private NonCopyable
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    //=============================================================================================
+    // public variables.
+    //=============================================================================================
+    /* NOTHING */
+
+    //=============================================================================================
+    // public methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    MemoryAllocator();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ~MemoryAllocator();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      初期化処理を行います.
+    //!
+    //! @param[in]      device          デバイスです.
+    //! @param[in]      gpu             物理デバイスです.
+    //! @param[in]      desc            構成設定です.
+    //! @retval true    初期化に成功.
+    //! @retval false   初期化に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool Init(VkDevice device, VkPhysicalDevice gpu, const MemoryAllocatorDesc& desc);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      終了処理を行います.
+    //---------------------------------------------------------------------------------------------
+    void Term();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      メモリを割り当てます.
+    //!
+    //! @param[in]      requirements    メモリ要件です.
+    //! @param[in]      propFlags       要求するメモリプロパティです.
+    //! @param[in]      isLinear        バッファまたはリニアイメージの場合は true を指定します.
+    //! @param[out]     pResult         割り当て結果の格納先です.
+    //! @retval true    割り当てに成功.
+    //! @retval false   割り当てに失敗.
+    //---------------------------------------------------------------------------------------------
+    bool Allocate(
+        const VkMemoryRequirements& requirements,
+        VkMemoryPropertyFlags       propFlags,
+        bool                        isLinear,
+        Allocation*                 pResult);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      メモリを解放します.
+    //!
+    //! @param[in,out]  pAllocation     解放する割り当てです. 解放後はクリアされます.
+    //---------------------------------------------------------------------------------------------
+    void Free(Allocation* pAllocation);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      メモリをマップします.
+    //!
+    //! @param[in]      allocation      マップする割り当てです.
+    //! @param[out]     ppData          割り当て先頭のポインタの格納先です.
+    //! @retval true    マップに成功.
+    //! @retval false   マップに失敗.
+    //! @note       ページ単位で参照カウントを持つため, 同じページの複数の割り当てを同時にマップできます.
+    //---------------------------------------------------------------------------------------------
+    bool Map(const Allocation& allocation, void** ppData);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      メモリをアンマップします.
+    //!
+    //! @param[in]      allocation      アンマップする割り当てです.
+    //---------------------------------------------------------------------------------------------
+    void Unmap(const Allocation& allocation);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      メモリタイプ番号を検索します.
+    //!
+    //! @param[in]      typeBits        メモリ要件のメモリタイプビットです.
+    //! @param[in]      propFlags       要求するメモリプロパティです.
+    //! @param[out]     pIndex          メモリタイプ番号の格納先です.
+    //! @retval true    見つかった.
+    //! @retval false   見つからなかった.
+    //---------------------------------------------------------------------------------------------
+    bool FindMemoryType(uint32_t typeBits, VkMemoryPropertyFlags propFlags, uint32_t* pIndex) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      統計情報を取得します.
+    //!
+    //! @param[out]     pStats          統計情報の格納先です.
+    //---------------------------------------------------------------------------------------------
+    void GetStats(MemoryStats* pStats) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      統計情報をログに出力します.
+    //---------------------------------------------------------------------------------------------
+    void DumpStats() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デバイスを取得します.
+    //!
+    //! @return     デバイスを返却します.
+    //---------------------------------------------------------------------------------------------
+    VkDevice GetDevice() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      メモリプロパティを取得します.
+    //!
+    //! @return     メモリプロパティを返却します.
+    //---------------------------------------------------------------------------------------------
+    const VkPhysicalDeviceMemoryProperties& GetMemoryProperties() const;
+
+private:
+    //=============================================================================================
+    // private variables.
+    //=============================================================================================
+    VkDevice                            m_Device;                   //!< デバイスです.
+    VkPhysicalDeviceMemoryProperties    m_Props;                    //!< メモリプロパティです.
+    MemoryAllocatorDesc                 m_Desc;                     //!< 構成設定です.
+    std::vector<MemoryPage*>            m_Pages[VK_MAX_MEMORY_TYPES * 2];   //!< ページリストです(メモリタイプ x リニア/非リニア).
+    std::vector<MemoryPage*>            m_Dedicated;                //!< 専用割り当てです.
+    uint32_t                            m_DeviceAllocationCount;    //!< vkAllocateMemory() の累計呼び出し回数です.
+    mutable std::mutex                  m_Mutex;                    //!< ミューテックスです.
+
+    //=============================================================================================
+    // private methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ページを生成します.
+    //!
+    //! @param[in]      typeIndex       メモリタイプ番号です.
+    //! @param[in]      size            ページサイズです.
+    //! @param[in]      isDedicated     専用割り当てかどうか.
+    //! @return     生成したページを返却します. 失敗した場合は nullptr を返却します.
+    //---------------------------------------------------------------------------------------------
+    MemoryPage* CreatePage(uint32_t typeIndex, VkDeviceSize size, bool isDedicated);
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// MemoryBenchmarkResult structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct MemoryBenchmarkResult
+{
+    double      SubAllocateMs;          //!< サブアロケーション方式の割り当て時間(ミリ秒)です.
+    double      SubFreeMs;              //!< サブアロケーション方式の解放時間(ミリ秒)です.
+    uint32_t    SubDeviceAllocations;   //!< サブアロケーション方式の vkAllocateMemory() 呼び出し回数です.
+    double      DedicatedAllocateMs;    //!< リソースごとに割り当てる方式の割り当て時間(ミリ秒)です.
+    double      DedicatedFreeMs;        //!< リソースごとに割り当てる方式の解放時間(ミリ秒)です.
+    uint32_t    DedicatedDeviceAllocations; //!< リソースごとに割り当てる方式の vkAllocateMemory() 呼び出し回数です.
+};
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      サブアロケーションとリソースごとの割り当てを比較するベンチマークを実行します.
+//!
+//! @param[in]      device          デバイスです.
+//! @param[in]      gpu             物理デバイスです.
+//! @param[in]      bufferCount     生成するバッファ数です.
+//! @param[in]      bufferSize      バッファ1つあたりのサイズです.
+//! @param[out]     pResult         計測結果の格納先です.
+//! @retval true    計測に成功.
+//! @retval false   計測に失敗.
+//! @note       サーフェイスを必要としないため, ウィンドウ無しで実行できます.
+//-------------------------------------------------------------------------------------------------
+bool RunMemoryBenchmark(
+    VkDevice                device,
+    VkPhysicalDevice        gpu,
+    uint32_t                bufferCount,
+    VkDeviceSize            bufferSize,
+    MemoryBenchmarkResult*  pResult);
+
+} // namespace asvk
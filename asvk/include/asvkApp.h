@@ -15,7 +15,12 @@
 #include <asvkCommandList.h>
 #include <asvkSwapChain.h>
 #include <asvkRenderBuffer.h>
+#include <asvkFramePacer.h>
+#include <asvkFrameTimeRecorder.h>
+#include <asvkEventQueue.h>
 #include <atomic>
+#include <thread>
+#include <vector>
 
 
 namespace asvk {
@@ -95,19 +100,61 @@ struct ResizeEventArgs
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 struct FrameEventArgs
 {
-    double  UpTimeSec;      //!< アプリの起動時間です.
-    double  ElapsedSec;     //!< 前のフレームからの経過時間です.
-    float   FramePerSec;    //!< FPSです.
-    bool    IsStopDraw;     //!< 描画停止中かどうか.
+    double      UpTimeSec;          //!< アプリの起動時間です.
+    double      ElapsedSec;         //!< 前のフレームからの経過時間です.
+    float       FramePerSec;        //!< FPSです.
+    bool        IsStopDraw;         //!< 描画停止中かどうか.
+    float       Alpha;              //!< 固定ステップ更新の補間係数です[0, 1). 固定ステップ更新が無効な場合は 1 です.
+    uint32_t    FixedStepCount;     //!< このフレームで実行した固定ステップ更新の回数です.
 
     //---------------------------------------------------------------------------------------------
     //! @brief      コンストラクタです.
     //---------------------------------------------------------------------------------------------
     FrameEventArgs()
-    : UpTimeSec  (0)
-    , ElapsedSec (0)
-    , FramePerSec(0.0f)
-    , IsStopDraw (false)
+    : UpTimeSec     (0)
+    , ElapsedSec    (0)
+    , FramePerSec   (0.0f)
+    , IsStopDraw    (false)
+    , Alpha         (1.0f)
+    , FixedStepCount(0)
+    { /* DO_NOTHING */ }
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// FixedUpdateEventArgs
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct FixedUpdateEventArgs
+{
+    double      SimTimeSec;     //!< 固定ステップで進めたシミュレーション時間です.
+    double      StepSec;        //!< 1ステップの時間です.
+    uint64_t    StepIndex;      //!< 起動からの通し番号です.
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    FixedUpdateEventArgs()
+    : SimTimeSec(0)
+    , StepSec   (0)
+    , StepIndex (0)
+    { /* DO_NOTHING */ }
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// FrameStats
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct FrameStats
+{
+    PipelineStats   Pipeline;           //!< パイプライン統計の合計です.
+    uint32_t        PipelinePassCount;  //!< パイプライン統計を収集した区間数です.
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    FrameStats()
+    : Pipeline          ()
+    , PipelinePassCount (0)
     { /* DO_NOTHING */ }
 };
 
@@ -187,7 +234,6 @@ protected:
     //=============================================================================================
     // protected variables.
     //=============================================================================================
-    static constexpr uint32_t   ChainCount = 2;             //!< スワップチェイン数です.
     HINSTANCE                   m_hInst;                    //!< インスタンスハンドルです.
     HWND                        m_hWnd;                     //!< ウィンドウハンドルです.
     LPWSTR                      m_Title;                    //!< タイトル名です.
@@ -204,14 +250,29 @@ protected:
     uint8_t                     m_ClearStencil;             //!< クリアステンシルです.
     DeviceMgr                   m_DeviceMgr;                //!< デバイスマネージャです.
     CommandList                 m_CommandList;              //!< コマンドリストです.
+    GpuProfiler                 m_GpuProfiler;              //!< GPUプロファイラです. m_CommandList.BeginRegion() で計測します.
     SwapChain                   m_SwapChain;                //!< スワップチェインです.
     VkFormat                    m_SwapChainFormat;          //!< スワップチェインフォーマットです.
     RenderBuffer                m_DepthBuffer;              //!< 深度バッファです.
     VkFormat                    m_DepthFormat;              //!< 深度フォーマットです.
-    VkFramebuffer               m_FrameBuffer[ChainCount];  //!< フレームバッファです. 
+    std::vector<VkFramebuffer>  m_FrameBuffer;              //!< フレームバッファです(スワップチェインのイメージごと).
     VkViewport                  m_Viewport;                 //!< ビューポートです.
     VkRect2D                    m_Scissor;                  //!< シザー矩形です.
     VkRenderPass                m_RenderPass;               //!< レンダーパスです.
+    PresentPolicy               m_PresentPolicy;            //!< 表示ポリシーです(Run()の前に設定してください).
+    uint32_t                    m_InFlightFrameCount;       //!< 同時に処理するフレーム数です(Run()の前に設定してください). 0 の場合は表示ポリシーに合わせます.
+    double                      m_TargetFrameRate;          //!< 目標フレームレートです(Run()の前に設定してください). 0 の場合は垂直同期時のみリフレッシュレートに合わせます.
+    FramePacer                  m_FramePacer;               //!< フレームペーサーです. GetStats() でペーシングの誤差を取得できます.
+    FrameTimeRecorder           m_FrameTimes;               //!< フレーム時間の記録です. GetStats() でパーセンタイルやヒッチ数を取得できます.
+    const wchar_t*              m_FrameTimeCsvPath;         //!< 終了時にフレーム時間を保存するCSVファイル名です. nullptr の場合は保存しません.
+    bool                        m_IsRenderThreadMode;       //!< 描画を専用スレッドで行うかどうか(Run()の前に設定してください).
+    bool                        m_IsSubmitThreadMode;       //!< サブミットと表示をキューごとの専用スレッドで行うかどうか(Run()の前に設定してください).
+    double                      m_FixedUpdateRate;          //!< 固定ステップ更新のレート(Hz)です. 0 の場合は無効です.
+    uint32_t                    m_MaxFixedStepCount;        //!< 1フレームで実行する固定ステップ更新の最大回数です. 超えた分は切り捨てます.
+    double                      m_StandByTickRate;          //!< スタンバイ中に状態を確認するレート(Hz)です.
+    bool                        m_IsThrottleInactive;       //!< 非アクティブ時にスタンバイ中のレートまで更新を間引くかどうか(既定値は false です).
+    QueueStats                  m_QueueStats;               //!< 前フレームのグラフィックスキューのサブミット統計です.
+    FrameStats                  m_FrameStats;               //!< 読み戻し済みの最新フレームの統計です(同時処理フレーム数だけ遅れます).
 
     //=============================================================================================
     // protected methods.
@@ -237,10 +298,19 @@ protected:
     //---------------------------------------------------------------------------------------------
     virtual void OnFrameMove( const FrameEventArgs& args );
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      固定ステップ更新時の処理です.
+    //!
+    //! @param[in]      args            固定ステップ更新イベント引数.
+    //! @note       m_FixedUpdateRate が 0 より大きい場合のみ, OnFrameMove() の後に必要な回数だけ呼び出されます.
+    //---------------------------------------------------------------------------------------------
+    virtual void OnFixedUpdate( const FixedUpdateEventArgs& args );
+
     //---------------------------------------------------------------------------------------------
     //! @brief      フレーム描画時の処理です.
     //!
     //! @param[in]      args            フレームイベント引数.
+    //! @note       固定ステップ更新が有効な場合は args.Alpha で前後のステップの状態を補間してください.
     //---------------------------------------------------------------------------------------------
     virtual void OnFrameRender( const FrameEventArgs& args );
 
@@ -279,6 +349,8 @@ protected:
     //! @param[in]      msg             メッセージ.
     //! @param[in]      wp              メッセージの追加情報.
     //! @param[in]      lp              メッセージの追加情報.
+    //! @note       描画スレッドモードでもメッセージスレッドから呼び出されます.
+    //!             OnKey(), OnMouse(), OnResize(), OnDrop() は描画スレッドから呼び出されます.
     //---------------------------------------------------------------------------------------------
     virtual void OnMsgProc( HWND hWnd, UINT msg, WPARAM wp, LPARAM lp );
 
@@ -296,6 +368,14 @@ protected:
     //! @retval false   描画有効です.
     //---------------------------------------------------------------------------------------------
     bool IsStopDraw() const;    
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      スタンバイモードかどうかチェックします.
+    //!
+    //! @retval true    最小化中や非アクティブなどのため更新を休止または間引いています.
+    //! @retval false   通常の更新中です.
+    //---------------------------------------------------------------------------------------------
+    bool IsStandByMode() const;
     
     //---------------------------------------------------------------------------------------------
     //! @brief      フレームカウントを取得します.
@@ -313,14 +393,62 @@ protected:
     float GetFramePerSec() const;
 
 private:
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // EventType enum
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    enum EventType
+    {
+        EventType_Key = 0,      //!< キーイベントです.
+        EventType_Mouse,        //!< マウスイベントです.
+        EventType_Resize,       //!< リサイズイベントです.
+        EventType_Drop,         //!< ドロップイベントです.
+    };
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Event structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct Event
+    {
+        EventType           Type;       //!< イベントの種類です.
+        KeyEventArgs        Key;        //!< キーイベント引数です.
+        MouseEventArgs      Mouse;      //!< マウスイベント引数です.
+        ResizeEventArgs     Resize;     //!< リサイズイベント引数です.
+        DropEventArgs       Drop;       //!< ドロップイベント引数です. ファイル名リストはイベントが所有します.
+
+        //-----------------------------------------------------------------------------------------
+        //! @brief      コンストラクタです.
+        //-----------------------------------------------------------------------------------------
+        Event()
+        : Type  (EventType_Key)
+        , Key   ()
+        , Mouse ()
+        , Resize()
+        , Drop  ()
+        { /* DO_NOTHING */ }
+    };
+
     //=============================================================================================
     // private variables.
     //=============================================================================================
-    std::atomic<uint32_t>   m_FrameCount;      //!< フレームカウント.
-    std::atomic<float>      m_FramePerSec;     //!< 0.5秒ごとのFPS.
-    std::atomic<bool>       m_IsStopDraw;      //!< 描画停止フラグです.
-    std::atomic<bool>       m_IsStandByMode;   //!< スタンバイモードかどうか?
-    double                  m_LastUpdateSec;   //!< 最後の更新時間.
+    static constexpr uint32_t   EventQueueSize = 256;   //!< イベントキューのサイズです.
+    std::atomic<uint32_t>       m_FrameCount;           //!< フレームカウント.
+    std::atomic<float>          m_FramePerSec;          //!< 0.5秒ごとのFPS.
+    std::atomic<bool>           m_IsStopDraw;           //!< 描画停止フラグです.
+    std::atomic<bool>           m_IsStandByMode;        //!< スタンバイモードかどうか?
+    double                      m_LastUpdateSec;        //!< 最後の更新時間.
+    std::vector<VkSemaphore>    m_AcquireSemaphores;    //!< イメージ取得完了を通知するセマフォです(フレームごと).
+    std::vector<VkSemaphore>    m_RenderSemaphores;     //!< 描画完了を通知するセマフォです(スワップチェインのイメージごと).
+    bool                        m_IsResizeRequested;    //!< リサイズ要求があるかどうか?
+    ResizeEventArgs             m_ResizeArgs;           //!< 最後に受け取ったリサイズイベント引数です.
+    EventQueue<Event, EventQueueSize>   m_EventQueue;   //!< メッセージスレッドから描画スレッドへのイベントキューです.
+    std::thread                 m_RenderThread;         //!< 描画スレッドです.
+    std::atomic<bool>           m_IsRenderThreadRunning;//!< 描画スレッドが動作中かどうか?
+    std::atomic<bool>           m_IsQuitRequested;      //!< 描画スレッドに終了を要求したかどうか?
+    double                      m_FixedAccumulatorSec;  //!< 固定ステップ更新で未消化の時間です.
+    FixedUpdateEventArgs        m_FixedArgs;            //!< 固定ステップ更新イベント引数です.
+    HANDLE                      m_hStandByEvent;        //!< スタンバイ中の描画スレッドを起こすイベントです.
+    bool                        m_IsSurfaceSuspended;   //!< サーフェイスの大きさが 0 のためスワップチェインを作れないかどうか?
+    double                      m_NextTickSec;          //!< スタンバイ中に次にフレームを進める時刻(秒)です.
 
     //=============================================================================================
     // private methods.
@@ -370,6 +498,106 @@ private:
     //---------------------------------------------------------------------------------------------
     void MainLoop();
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      フレームを更新して描画します.
+    //!
+    //! @param[in,out]  args            フレームイベント引数です.
+    //! @param[in,out]  frameCount      FPS計測用のフレームカウントです.
+    //---------------------------------------------------------------------------------------------
+    void UpdateFrame( FrameEventArgs& args, uint32_t& frameCount );
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      描画スレッドを開始します.
+    //---------------------------------------------------------------------------------------------
+    void StartRenderThread();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      描画スレッドを停止します.
+    //!
+    //! @note       メッセージスレッドから呼び出してください. 残ったイベントはこのスレッドで処理します.
+    //---------------------------------------------------------------------------------------------
+    void StopRenderThread();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      描画スレッドに停止を要求します.
+    //!
+    //! @note       スレッドの終了は待ちません. ウィンドウプロシージャから呼び出せます.
+    //---------------------------------------------------------------------------------------------
+    void RequestStopRenderThread();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      描画スレッドのメイン処理です.
+    //---------------------------------------------------------------------------------------------
+    void RenderThreadMain();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      イベントを送信します.
+    //!
+    //! @param[in]      event       イベントです.
+    //! @note       描画スレッドが動作中ならキューに積み，そうでなければ即座に処理します.
+    //---------------------------------------------------------------------------------------------
+    void PostEvent( const Event& event );
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      イベントを処理します.
+    //!
+    //! @param[in]      event       イベントです.
+    //---------------------------------------------------------------------------------------------
+    void DispatchEvent( const Event& event );
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      スタンバイ状態を更新し，必要なら待機します.
+    //!
+    //! @retval true    このフレームは休止します. 待機から戻ったらメッセージやイベントを処理してください.
+    //! @retval false   フレームを更新します.
+    //! @note       最小化中や表示されていない間はフレームを進めず，非アクティブ中やスワップチェインを
+    //!             作れない間は m_StandByTickRate までフレームを間引きます. 待機中にメッセージや
+    //!             イベントが届いた場合は即座に戻ります.
+    //---------------------------------------------------------------------------------------------
+    bool StandBy();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      スタンバイ中の描画スレッドを起こします.
+    //---------------------------------------------------------------------------------------------
+    void WakeStandBy();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      フレームの描画を開始します.
+    //!
+    //! @retval true    描画の開始に成功.
+    //! @retval false   描画の開始に失敗.
+    //! @note       再利用するフレームのフェンスのみを待機し，コマンドの記録を開始します.
+    //---------------------------------------------------------------------------------------------
+    bool BeginFrame();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      フレームの描画を終了します.
+    //!
+    //! @note       コマンドをサブミットして表示します. GPUの完了は待機しません.
+    //---------------------------------------------------------------------------------------------
+    void EndFrame();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      スワップチェインのサイズを変更します.
+    //!
+    //! @retval true    再生成に成功.
+    //! @retval false   再生成に失敗，または最小化中のため見送り.
+    //! @note       サーフェイスは再利用し，サイズに依存するリソースだけを作り直します.
+    //!             連続したリサイズイベントはフレームごとに1回にまとめて処理されます.
+    //---------------------------------------------------------------------------------------------
+    bool ResizeSwapChain();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      セマフォを作り直します.
+    //!
+    //! @param[in,out]  pSemaphores     作り直すセマフォの配列です. 既存のセマフォは破棄されます.
+    //! @param[in]      count           生成するセマフォ数です.
+    //! @retval true    生成に成功.
+    //! @retval false   生成に失敗.
+    //! @note       破棄するセマフォを参照するサブミットが全て完了してから呼び出してください.
+    //---------------------------------------------------------------------------------------------
+    bool CreateSemaphores(std::vector<VkSemaphore>* pSemaphores, uint32_t count);
+
     //---------------------------------------------------------------------------------------------
     //! @brief      キーイベントを処理します.
     //!
@@ -384,7 +612,7 @@ private:
     //! @brief      リサイズイベントを処理します.
     //!
     //! @param[in]      param       リサイズイベント引数です.
-    //! @note       このメソッドは内部処理で, OnResize() を呼び出します.
+    //! @note       このメソッドはリサイズ要求を記録するだけで，再生成と OnResize() の呼び出しは次のフレームの開始時に行います.
     //!             また，このメソッドはウィンドウプロシージャからのアクセス専用メソッドですので，
     //!             アプリケーション側で呼び出しを行わないでください.
     //---------------------------------------------------------------------------------------------
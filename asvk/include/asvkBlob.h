@@ -39,6 +39,16 @@ struct IBlob : public IReference
     virtual size_t GetBufferSize() const = 0;
 };
 
+//-------------------------------------------------------------------------------------------------
+//! @brief      バイト長オブジェクトを生成します.
+//!
+//! @param[in]      size            バッファサイズ.
+//! @param[out]     ppOut           生成したオブジェクトの格納先.
+//! @retval true    生成に成功.
+//! @retval false   生成に失敗.
+//-------------------------------------------------------------------------------------------------
+bool CreateBlob(size_t size, IBlob** ppOut);
+
 //-------------------------------------------------------------------------------------------------
 //! @brief      ファイルから読み込みします.
 //!
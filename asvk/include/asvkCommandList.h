@@ -9,6 +9,11 @@
 // Includes
 //-------------------------------------------------------------------------------------------------
 #include <asvkDevice.h>
+#include <asvkGpuProfiler.h>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
 
 
 namespace asvk {
@@ -70,6 +75,8 @@ public:
 
     //---------------------------------------------------------------------------------------------
     //! @brief      コマンドバッファを先頭に戻し，記録を開始します.
+    //!
+    //! @note       再利用するコマンドバッファのフェンスがシグナル状態になるまで待機します.
     //---------------------------------------------------------------------------------------------
     bool Reset();
 
@@ -107,13 +114,69 @@ public:
     //---------------------------------------------------------------------------------------------
     uint32_t GetBufferIndex() const;
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コマンドバッファの数を取得します.
+    //!
+    //! @return     コマンドバッファの数を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t GetBufferCount() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コマンドバッファに対応するフェンスを取得します.
+    //!
+    //! @param[in]      index       コマンドバッファインデックス.
+    //! @return     コマンドバッファの実行完了を通知するフェンスを返却します.
+    //! @note       サブミット時にこのフェンスを指定すると，次の Reset() で完了を待機します.
+    //---------------------------------------------------------------------------------------------
+    VkFence GetFence(uint32_t index) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      全てのコマンドバッファの実行完了を待機します.
+    //!
+    //! @param[in]      timeout     タイムアウト時間です(ナノ秒単位).
+    //---------------------------------------------------------------------------------------------
+    void WaitAll(uint64_t timeout);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      GPUプロファイラを設定します.
+    //!
+    //! @param[in]      pProfiler   GPUプロファイラです(nullptr で解除).
+    //! @note       プロファイラのフレーム数はコマンドバッファの数以上にしてください.
+    //!             Reset() でフェンスを待機した後に前回の結果を読み戻すため, 計測によるストールは発生しません.
+    //---------------------------------------------------------------------------------------------
+    void SetProfiler(GpuProfiler* pProfiler);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      GPUプロファイラを取得します.
+    //!
+    //! @return     設定されたGPUプロファイラを返却します.
+    //---------------------------------------------------------------------------------------------
+    GpuProfiler* GetProfiler() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      現在のコマンドバッファで区間の計測を開始します.
+    //!
+    //! @param[in]      name            区間名です.
+    //! @param[in]      pipelineStats   パイプライン統計も収集する場合は true を指定します.
+    //! @note       プロファイラが設定されていない場合は何もしません.
+    //---------------------------------------------------------------------------------------------
+    void BeginRegion(const char* name, bool pipelineStats = false);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      現在のコマンドバッファで区間の計測を終了します.
+    //---------------------------------------------------------------------------------------------
+    void EndRegion();
+
 private:
     //=============================================================================================
     // private variables.
     //=============================================================================================
+    VkDevice                        m_Device;           //!< デバイスです.
     VkCommandPool                   m_CommandPool;      //!< コマンドプールです.
     std::vector<VkCommandBuffer>    m_CommandBuffers;   //!< コマンドバッファです.
+    std::vector<VkFence>            m_Fences;           //!< コマンドバッファごとのフェンスです.
     uint32_t                        m_BufferIndex;      //!< コマンドバッファインデックスです.
+    GpuProfiler*                    m_pProfiler;        //!< GPUプロファイラです.
 
     //=============================================================================================
     // private methods.
@@ -121,4 +184,466 @@ private:
     /* NOTHING */
 };
 
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// ParallelCommandList class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class ParallelCommandList : NonCopyable
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    //=============================================================================================
+    // public variables.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      記録関数です.
+    //!
+    //! @param[in]      threadIndex     スレッド番号です(0 は呼び出し元スレッド).
+    //! @param[in]      commandBuffer   記録先のセカンダリコマンドバッファです.
+    //---------------------------------------------------------------------------------------------
+    typedef std::function<void(uint32_t threadIndex, VkCommandBuffer commandBuffer)> RecordFunc;
+
+    //=============================================================================================
+    // public methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ParallelCommandList();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ~ParallelCommandList();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      初期化処理です.
+    //!
+    //! @param[in]      pDeviceMgr      デバイスマネージャです.
+    //! @param[in]      queueType       キュータイプです.
+    //! @param[in]      threadCount     記録スレッド数です. 0 の場合は論理コア数を使用します.
+    //! @param[in]      frameCount      同時に処理するフレーム数です.
+    //! @retval true    初期化に成功.
+    //! @retval false   初期化に失敗.
+    //! @note       コマンドプールはスレッドごと・フレームごとに生成します.
+    //---------------------------------------------------------------------------------------------
+    bool Init(
+        DeviceMgr*  pDeviceMgr,
+        QueueType   queueType,
+        uint32_t    threadCount,
+        uint32_t    frameCount);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      終了処理です.
+    //!
+    //! @param[in]      pDeviceMgr  デバイスマネージャです.
+    //---------------------------------------------------------------------------------------------
+    void Term(DeviceMgr* pDeviceMgr);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      指定フレームのコマンドプールをリセットします.
+    //!
+    //! @param[in]      frameIndex      フレーム番号です.
+    //! @retval true    リセットに成功.
+    //! @retval false   リセットに失敗.
+    //! @note       指定フレームのコマンドの実行完了を待機してから呼び出してください.
+    //!             CommandList と併用する場合は CommandList::Reset() の後に
+    //!             CommandList::GetBufferIndex() を渡します.
+    //---------------------------------------------------------------------------------------------
+    bool Reset(uint32_t frameIndex);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      セカンダリコマンドバッファを並列に記録し, プライマリコマンドバッファから実行します.
+    //!
+    //! @param[in]      primary         プライマリコマンドバッファです.
+    //! @param[in]      renderPass      継承するレンダーパスです.
+    //! @param[in]      subpass         継承するサブパス番号です.
+    //! @param[in]      frameBuffer     継承するフレームバッファです. null_handle も指定できます.
+    //! @param[in]      func            各スレッドで呼び出す記録関数です.
+    //! @param[in]      pipelineStatistics  プライマリ側でアクティブなパイプライン統計クエリのフラグです.
+    //! @retval true    記録に成功.
+    //! @retval false   記録に失敗.
+    //! @note       プライマリ側は VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS で
+    //!             レンダーパスを開始しておく必要があります.
+    //!             記録関数は全スレッドから同時に呼び出されます.
+    //!             パイプライン統計を指定する場合は DeviceMgr::IsInheritedQueries() が true である必要があります.
+    //---------------------------------------------------------------------------------------------
+    bool Record(
+        VkCommandBuffer                 primary,
+        VkRenderPass                    renderPass,
+        uint32_t                        subpass,
+        VkFramebuffer                   frameBuffer,
+        const RecordFunc&               func,
+        VkQueryPipelineStatisticFlags   pipelineStatistics = 0);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      記録スレッド数を取得します.
+    //!
+    //! @return     記録スレッド数を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t GetThreadCount() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      同時に処理するフレーム数を取得します.
+    //!
+    //! @return     同時に処理するフレーム数を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t GetFrameCount() const;
+
+private:
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // ThreadContext structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct ThreadContext
+    {
+        VkCommandPool                   CommandPool;        //!< コマンドプールです.
+        std::vector<VkCommandBuffer>    CommandBuffers;     //!< 確保済みのセカンダリコマンドバッファです.
+        uint32_t                        UsedCount;          //!< 現在のフレームで使用した数です.
+    };
+
+    //=============================================================================================
+    // private variables.
+    //=============================================================================================
+    VkDevice                        m_Device;           //!< デバイスです.
+    uint32_t                        m_ThreadCount;      //!< 記録スレッド数です.
+    uint32_t                        m_FrameCount;       //!< 同時に処理するフレーム数です.
+    uint32_t                        m_FrameIndex;       //!< 現在のフレーム番号です.
+    std::vector<ThreadContext>      m_Contexts;         //!< フレーム・スレッドごとのコンテキストです.
+    std::vector<VkCommandBuffer>    m_Secondaries;      //!< 記録したセカンダリコマンドバッファです.
+    std::vector<std::thread>        m_Workers;          //!< ワーカースレッドです.
+    std::mutex                      m_Mutex;            //!< ミューテックスです.
+    std::condition_variable         m_StartCond;        //!< 記録開始の通知です.
+    std::condition_variable         m_DoneCond;         //!< 記録完了の通知です.
+    uint64_t                        m_Generation;       //!< 記録要求の世代番号です.
+    uint32_t                        m_PendingCount;     //!< 記録中のワーカー数です.
+    bool                            m_IsExit;           //!< ワーカーを終了させる場合は true.
+    bool                            m_IsFailed;         //!< 記録に失敗したワーカーがある場合は true.
+    const RecordFunc*               m_pFunc;            //!< 現在の記録関数です.
+    VkCommandBufferInheritanceInfo  m_Inheritance;      //!< 現在の継承情報です.
+
+    //=============================================================================================
+    // private methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ワーカースレッドのメイン処理です.
+    //---------------------------------------------------------------------------------------------
+    void WorkerMain(uint32_t threadIndex);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      指定スレッドのセカンダリコマンドバッファを記録します.
+    //---------------------------------------------------------------------------------------------
+    bool RecordSecondary(uint32_t threadIndex);
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// FrameCommandAllocator class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class FrameCommandAllocator : NonCopyable
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    //=============================================================================================
+    // public variables.
+    //=============================================================================================
+    /* NOTHING */
+
+    //=============================================================================================
+    // public methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    FrameCommandAllocator();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ~FrameCommandAllocator();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      初期化処理です.
+    //!
+    //! @param[in]      pDeviceMgr      デバイスマネージャです.
+    //! @param[in]      queueType       キュータイプです.
+    //! @param[in]      frameCount      同時に処理するフレーム数です.
+    //! @retval true    初期化に成功.
+    //! @retval false   初期化に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool Init(
+        DeviceMgr*  pDeviceMgr,
+        QueueType   queueType,
+        uint32_t    frameCount);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      終了処理です.
+    //!
+    //! @param[in]      pDeviceMgr  デバイスマネージャです.
+    //---------------------------------------------------------------------------------------------
+    void Term(DeviceMgr* pDeviceMgr);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      フレームを開始します.
+    //!
+    //! @retval true    開始に成功.
+    //! @retval false   開始に失敗.
+    //! @note       現在のフレームのフェンスを待機してから, コマンドプールをまとめてリセットします.
+    //---------------------------------------------------------------------------------------------
+    bool BeginFrame();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      フレームを終了し, フレーム番号を更新します.
+    //---------------------------------------------------------------------------------------------
+    void EndFrame();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      記録を開始したプライマリコマンドバッファを取得します.
+    //!
+    //! @return     記録を開始したコマンドバッファを返却します. 失敗した場合は null_handle を返却します.
+    //! @note       VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT で記録を開始します.
+    //!             記録の終了(vkEndCommandBuffer)は呼び出し側で行ってください.
+    //---------------------------------------------------------------------------------------------
+    VkCommandBuffer Allocate();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      現在のフレームのフェンスを取得します.
+    //!
+    //! @return     現在のフレームのフェンスを返却します.
+    //! @note       フレームの最後のサブミットにこのフェンスを指定してください.
+    //---------------------------------------------------------------------------------------------
+    VkFence GetFence() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      現在のフレーム番号を取得します.
+    //!
+    //! @return     現在のフレーム番号を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t GetFrameIndex() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      同時に処理するフレーム数を取得します.
+    //!
+    //! @return     同時に処理するフレーム数を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t GetFrameCount() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      現在のフレームで割り当てたコマンドバッファ数を取得します.
+    //!
+    //! @return     現在のフレームで割り当てたコマンドバッファ数を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t GetAllocatedCount() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      全てのフレームの実行完了を待機します.
+    //!
+    //! @param[in]      timeout     タイムアウト時間です(ナノ秒単位).
+    //---------------------------------------------------------------------------------------------
+    void WaitAll(uint64_t timeout);
+
+private:
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Frame structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct Frame
+    {
+        VkCommandPool                   CommandPool;        //!< コマンドプールです.
+        std::vector<VkCommandBuffer>    CommandBuffers;     //!< 確保済みのコマンドバッファです.
+        uint32_t                        UsedCount;          //!< 使用したコマンドバッファ数です.
+        VkFence                         Fence;              //!< フレームの完了を通知するフェンスです.
+    };
+
+    //=============================================================================================
+    // private variables.
+    //=============================================================================================
+    VkDevice                        m_Device;           //!< デバイスです.
+    std::vector<Frame>              m_Frames;           //!< フレームです.
+    uint32_t                        m_FrameIndex;       //!< 現在のフレーム番号です.
+
+    //=============================================================================================
+    // private methods.
+    //=============================================================================================
+    /* NOTHING */
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// StaticCommandList class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class StaticCommandList : NonCopyable
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    //=============================================================================================
+    // public variables.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      記録関数です.
+    //!
+    //! @param[in]      index           記録するバッファ番号です.
+    //! @param[in]      commandBuffer   記録先のセカンダリコマンドバッファです.
+    //---------------------------------------------------------------------------------------------
+    typedef std::function<void(uint32_t index, VkCommandBuffer commandBuffer)> RecordFunc;
+
+    //=============================================================================================
+    // public methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    StaticCommandList();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ~StaticCommandList();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      初期化処理です.
+    //!
+    //! @param[in]      pDeviceMgr      デバイスマネージャです.
+    //! @param[in]      queueType       実行するキューのタイプです.
+    //! @param[in]      count           バッファ数です. 通常はスワップチェインのバッファ数を指定します.
+    //! @retval true    初期化に成功.
+    //! @retval false   初期化に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool Init(
+        DeviceMgr*  pDeviceMgr,
+        QueueType   queueType,
+        uint32_t    count);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      終了処理です.
+    //!
+    //! @param[in]      pDeviceMgr  デバイスマネージャです.
+    //---------------------------------------------------------------------------------------------
+    void Term(DeviceMgr* pDeviceMgr);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      記録済みのコマンドを全て無効にします.
+    //!
+    //! @note       リサイズ時など, 記録内容が参照するリソースを作り直したときに呼び出します.
+    //!             次の Execute() で再記録されます.
+    //---------------------------------------------------------------------------------------------
+    void Invalidate();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      記録済みのセカンダリコマンドバッファをプライマリコマンドバッファから実行します.
+    //!
+    //! @param[in]      primary         プライマリコマンドバッファです.
+    //! @param[in]      index           バッファ番号です.
+    //! @param[in]      renderPass      継承するレンダーパスです.
+    //! @param[in]      subpass         継承するサブパス番号です.
+    //! @param[in]      frameBuffer     継承するフレームバッファです.
+    //! @param[in]      stateKey        記録内容を識別する値です. パイプラインの変更回数などを指定します.
+    //! @param[in]      func            記録関数です.
+    //! @param[in]      pipelineStatistics  プライマリ側でアクティブなパイプライン統計クエリのフラグです.
+    //! @retval true    実行に成功.
+    //! @retval false   実行に失敗.
+    //! @note       未記録・無効化済み, またはレンダーパス・フレームバッファ・stateKey・パイプライン統計の
+    //!             いずれかが前回と異なる場合のみ記録関数を呼び出します.
+    //!             プライマリ側は VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS で
+    //!             レンダーパスを開始しておく必要があります.
+    //!             パイプライン統計を指定する場合は DeviceMgr::IsInheritedQueries() が true である必要があります.
+    //---------------------------------------------------------------------------------------------
+    bool Execute(
+        VkCommandBuffer                 primary,
+        uint32_t                        index,
+        VkRenderPass                    renderPass,
+        uint32_t                        subpass,
+        VkFramebuffer                   frameBuffer,
+        uint64_t                        stateKey,
+        const RecordFunc&               func,
+        VkQueryPipelineStatisticFlags   pipelineStatistics = 0);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      バッファ数を取得します.
+    //!
+    //! @return     バッファ数を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t GetCount() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      記録した回数を取得します.
+    //!
+    //! @return     初期化してから記録関数を呼び出した回数を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t GetRecordCount() const;
+
+private:
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Entry structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct Entry
+    {
+        VkCommandBuffer     CommandBuffer;      //!< セカンダリコマンドバッファです.
+        VkRenderPass        RenderPass;         //!< 記録時のレンダーパスです.
+        uint32_t            Subpass;            //!< 記録時のサブパス番号です.
+        VkFramebuffer       FrameBuffer;        //!< 記録時のフレームバッファです.
+        uint64_t            StateKey;           //!< 記録時の識別値です.
+        VkQueryPipelineStatisticFlags   PipelineStatistics; //!< 記録時に継承したパイプライン統計です.
+        uint64_t            UseTicket;          //!< 最後に実行したプライマリが取りうる最小のチケットです.
+        bool                IsValid;            //!< 記録内容が有効かどうか.
+    };
+
+    //=============================================================================================
+    // private variables.
+    //=============================================================================================
+    VkDevice                        m_Device;           //!< デバイスです.
+    Queue*                          m_pQueue;           //!< 実行するキューです.
+    VkCommandPool                   m_CommandPool;      //!< コマンドプールです.
+    std::vector<Entry>              m_Entries;          //!< バッファごとの記録情報です.
+    uint32_t                        m_RecordCount;      //!< 記録した回数です.
+
+    //=============================================================================================
+    // private methods.
+    //=============================================================================================
+    /* NOTHING */
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// CommandBenchmarkResult structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct CommandBenchmarkResult
+{
+    double      BufferResetMs;      //!< コマンドバッファごとに暗黙リセットする方式の1フレームあたりの記録時間(ミリ秒)です.
+    double      PoolResetMs;        //!< コマンドプールをまとめてリセットする方式の1フレームあたりの記録時間(ミリ秒)です.
+};
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      コマンドバッファごとのリセットとコマンドプールのリセットを比較するベンチマークを実行します.
+//!
+//! @param[in]      pDeviceMgr      デバイスマネージャです.
+//! @param[in]      bufferCount     1フレームあたりのコマンドバッファ数です(1/10/100 など).
+//! @param[in]      frameCount      計測するフレーム数です.
+//! @param[out]     pResult         計測結果の格納先です.
+//! @retval true    計測に成功.
+//! @retval false   計測に失敗.
+//! @note       記録時間にはリセット, 記録開始, 記録終了を含み, GPUの完了待ちは含みません.
+//-------------------------------------------------------------------------------------------------
+bool RunCommandBenchmark(
+    DeviceMgr*              pDeviceMgr,
+    uint32_t                bufferCount,
+    uint32_t                frameCount,
+    CommandBenchmarkResult* pResult);
+
 } // namespace asvk
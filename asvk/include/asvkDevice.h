@@ -9,6 +9,7 @@
 // Includes 
 //-------------------------------------------------------------------------------------------------
 #include <asvkQueue.h>
+#include <asvkAllocator.h>
 #include <vector>
 
 
@@ -29,6 +30,25 @@ struct PhysicalDevice
 {
     VkPhysicalDevice                    Gpu;                //!< 物理デバイスです.
     VkPhysicalDeviceMemoryProperties    MemoryProps;        //!< 物理デバイスメモリプロパティです.
+    VkPhysicalDeviceProperties          Props;              //!< 物理デバイスプロパティです.
+    VkDeviceSize                        LocalHeapSize;      //!< デバイスローカルなヒープの最大サイズです.
+    int32_t                             Score;              //!< 選択時の評価値です. 使用できない場合は負値です.
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// DeviceMgrDesc structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct DeviceMgrDesc
+{
+    bool    Headless;       //!< サーフェイス・スワップチェイン拡張機能を使用しない場合は true を指定します.
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    DeviceMgrDesc()
+    : Headless  (false)
+    { /* DO_NOTHING */ }
 };
 
 
@@ -65,10 +85,12 @@ public:
     //---------------------------------------------------------------------------------------------
     //! @brief      初期化処理を行います.
     //!
+    //! @param[in]      desc            構成設定です.
     //! @retval true    初期化に成功.
     //! @retval false   初期化に失敗.
+    //! @note       ヘッドレスモードではウィンドウシステムの無い環境(ソフトウェアICD等)でも初期化できます.
     //---------------------------------------------------------------------------------------------
-    bool Init();
+    bool Init(const DeviceMgrDesc& desc = DeviceMgrDesc());
 
     //---------------------------------------------------------------------------------------------
     //! @brief      終了処理を行います.
@@ -92,10 +114,19 @@ public:
     //---------------------------------------------------------------------------------------------
     //! @brief      物理デバイスを取得します.
     //!
-    //! @return     物理デバイスを返却します.
+    //! @return     列挙した全ての物理デバイスを返却します.
     //---------------------------------------------------------------------------------------------
     const std::vector<PhysicalDevice>& GetPhysicalDevice() const;
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      選択した物理デバイスを取得します.
+    //!
+    //! @return     論理デバイスの生成に使用した物理デバイスを返却します.
+    //! @note       デバイスタイプ, デバイスローカルメモリ量, 機能, キュー構成から評価して選択します.
+    //!             環境変数 ASVK_PHYSICAL_DEVICE に番号またはデバイス名の一部を指定すると優先されます.
+    //---------------------------------------------------------------------------------------------
+    const PhysicalDevice& GetSelectedPhysicalDevice() const;
+
     //---------------------------------------------------------------------------------------------
     //! @brief      グラフィックスキューを取得します.
     //!
@@ -107,9 +138,59 @@ public:
     //! @brief      コンピュートキューを取得します.
     //!
     //! @return     コンピュートキューを返却します.
+    //! @note       グラフィックス非対応のファミリーがあれば非同期コンピュート用のキューを返却します.
+    //!             空きキューが無い場合はグラフィックスキューと同じインスタンスを返却します.
     //---------------------------------------------------------------------------------------------
     Queue* GetComputeQueue();
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      転送キューを取得します.
+    //!
+    //! @return     転送キューを返却します.
+    //! @note       転送専用のファミリーがあればそのキューを返却します.
+    //!             空きキューが無い場合は同じ VkQueue を持つ他のキューのインスタンスを返却します.
+    //---------------------------------------------------------------------------------------------
+    Queue* GetTransferQueue();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      メモリアロケータを取得します.
+    //!
+    //! @return     メモリアロケータを返却します.
+    //---------------------------------------------------------------------------------------------
+    MemoryAllocator* GetMemoryAllocator();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ヘッドレスモードかどうかチェックします.
+    //!
+    //! @retval true    ヘッドレスモードです.
+    //! @retval false   スワップチェインを使用するモードです.
+    //---------------------------------------------------------------------------------------------
+    bool IsHeadless() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      タイムラインセマフォが有効かどうかチェックします.
+    //!
+    //! @retval true    各キューのチケットはタイムラインセマフォで管理されます.
+    //! @retval false   各キューのチケットはフェンスプールで管理されます.
+    //---------------------------------------------------------------------------------------------
+    bool IsTimelineSemaphore() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      パイプライン統計クエリが有効かどうかチェックします.
+    //!
+    //! @retval true    VK_QUERY_TYPE_PIPELINE_STATISTICS のクエリを使用できます.
+    //! @retval false   使用できません.
+    //---------------------------------------------------------------------------------------------
+    bool IsPipelineStatistics() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      クエリの継承が有効かどうかチェックします.
+    //!
+    //! @retval true    クエリがアクティブな状態でセカンダリコマンドバッファを実行できます.
+    //! @retval false   実行できません.
+    //---------------------------------------------------------------------------------------------
+    bool IsInheritedQueries() const;
+
 private:
     //=============================================================================================
     // private variables.
@@ -117,9 +198,18 @@ private:
     VkInstance                      m_Instance;         //!< インスタンスです.
     VkDevice                        m_Device;           //!< デバイスです.
     std::vector<PhysicalDevice>     m_PhysicalDevice;   //!< 物理デバイスです.
+    uint32_t                        m_SelectedIndex;    //!< 選択した物理デバイスの番号です.
     Queue                           m_GraphicsQueue;    //!< グラフィックスキューです.
     Queue                           m_ComputeQueue;     //!< コンピュートキューです.
+    Queue                           m_TransferQueue;    //!< 転送キューです.
+    Queue*                          m_pComputeQueue;    //!< コンピュートキューとして返却するキューです.
+    Queue*                          m_pTransferQueue;   //!< 転送キューとして返却するキューです.
     VkAllocationCallbacks           m_Allocator;        //!< アロケータです.
+    MemoryAllocator                 m_MemoryAllocator;  //!< デバイスメモリアロケータです.
+    bool                            m_IsHeadless;       //!< ヘッドレスモードかどうか.
+    bool                            m_IsTimelineSemaphore;  //!< タイムラインセマフォが有効かどうか.
+    bool                            m_IsPipelineStatistics; //!< パイプライン統計クエリが有効かどうか.
+    bool                            m_IsInheritedQueries;   //!< クエリの継承が有効かどうか.
 
 #if ASVK_IS_DEBUG
     VkDebugReportCallbackEXT            m_DebugReporter;
@@ -0,0 +1,122 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asvkEventQueue.h
+// Desc : Lock-Free Event Queue Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asvkTypedef.h>
+#include <atomic>
+
+
+namespace asvk {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// EventQueue class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//! @brief      単一プロデューサ・単一コンシューマのロックフリーなリングバッファです.
+//!
+//! @note       Push() は1つのスレッドから，Pop() は別の1つのスレッドからのみ呼び出してください.
+//!             Capacity は2のべき乗である必要があります.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename T, uint32_t Capacity>
+class EventQueue : NonCopyable
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be power of two.");
+
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    //=============================================================================================
+    // public variables.
+    //=============================================================================================
+    /* NOTHING */
+
+    //=============================================================================================
+    // public methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    EventQueue()
+    : m_Head(0)
+    , m_Tail(0)
+    { /* DO_NOTHING */ }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ~EventQueue()
+    { /* DO_NOTHING */ }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      要素を追加します.
+    //!
+    //! @param[in]      value       追加する要素です.
+    //! @retval true    追加に成功.
+    //! @retval false   キューが一杯のため追加に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool Push(const T& value)
+    {
+        auto tail = m_Tail.load(std::memory_order_relaxed);
+        if (tail - m_Head.load(std::memory_order_acquire) >= Capacity)
+        { return false; }
+
+        m_Items[tail & (Capacity - 1)] = value;
+
+        // 要素の書き込みをコンシューマから見えるようにしてから末尾を進める.
+        m_Tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      要素を取り出します.
+    //!
+    //! @param[out]     pValue      取り出した要素の格納先です.
+    //! @retval true    取り出しに成功.
+    //! @retval false   キューが空です.
+    //---------------------------------------------------------------------------------------------
+    bool Pop(T* pValue)
+    {
+        auto head = m_Head.load(std::memory_order_relaxed);
+        if (head == m_Tail.load(std::memory_order_acquire))
+        { return false; }
+
+        *pValue = m_Items[head & (Capacity - 1)];
+
+        // 読み出しが終わってからスロットをプロデューサに返す.
+        m_Head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      空かどうかチェックします.
+    //!
+    //! @retval true    空です.
+    //! @retval false   要素があります.
+    //---------------------------------------------------------------------------------------------
+    bool IsEmpty() const
+    { return m_Head.load(std::memory_order_acquire) == m_Tail.load(std::memory_order_acquire); }
+
+private:
+    //=============================================================================================
+    // private variables.
+    //=============================================================================================
+    alignas(64) std::atomic<uint32_t>   m_Head;             //!< 先頭位置です(コンシューマが更新).
+    alignas(64) std::atomic<uint32_t>   m_Tail;             //!< 末尾位置です(プロデューサが更新).
+    T                                   m_Items[Capacity];  //!< 要素です.
+
+    //=============================================================================================
+    // private methods.
+    //=============================================================================================
+    /* NOTHING */
+};
+
+} // namespace asvk
@@ -0,0 +1,381 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asvkFrameGraph.h
+// Desc : Frame Graph Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asvkTypedef.h>
+#include <asvkDevice.h>
+#include <asvkAllocator.h>
+#include <asvkCommandList.h>
+#include <asvkResourceState.h>
+#include <vulkan/vulkan.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+
+namespace asvk {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// FrameGraphTextureDesc structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct FrameGraphTextureDesc
+{
+    uint32_t                Width;      //!< 横幅です.
+    uint32_t                Height;     //!< 縦幅です.
+    VkFormat                Format;     //!< フォーマットです.
+    VkSampleCountFlagBits   Samples;    //!< サンプルカウントです.
+    VkImageUsageFlags       Usage;      //!< 追加の使用用途です(宣言した読み書きから導出されるフラグは不要です).
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    FrameGraphTextureDesc()
+    : Width     (0)
+    , Height    (0)
+    , Format    (VK_FORMAT_UNDEFINED)
+    , Samples   (VK_SAMPLE_COUNT_1_BIT)
+    , Usage     (0)
+    { /* DO_NOTHING */ }
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// FrameGraphStats structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct FrameGraphStats
+{
+    uint32_t        PassCount;          //!< 宣言されたパス数です.
+    uint32_t        CulledPassCount;    //!< カリングされたパス数です.
+    uint32_t        AsyncPassCount;     //!< 非同期コンピュートキューで実行するパス数です.
+    uint32_t        TextureCount;       //!< 生成したテクスチャ数です(インポートは含みません).
+    uint32_t        MemoryBlockCount;   //!< テクスチャ用に割り当てたメモリブロック数です.
+    VkDeviceSize    RequiredBytes;      //!< エイリアスしない場合に必要なバイト数です.
+    VkDeviceSize    AllocatedBytes;     //!< 実際に割り当てたバイト数です.
+    uint32_t        RebuildCount;       //!< 物理リソースを作り直した回数です.
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// FrameGraph class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class FrameGraph : NonCopyable
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    //=============================================================================================
+    // public variables.
+    //=============================================================================================
+    static const uint32_t InvalidIndex = UINT32_MAX;     //!< 無効な番号です.
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      パスの実行関数です.
+    //!
+    //! @param[in]      commandBuffer   記録先のコマンドバッファです.
+    //! @param[in]      graph           フレームグラフです. 物理イメージの参照に使用します.
+    //---------------------------------------------------------------------------------------------
+    typedef std::function<void(VkCommandBuffer commandBuffer, const FrameGraph& graph)> ExecuteFunc;
+
+    //=============================================================================================
+    // public methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    FrameGraph();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ~FrameGraph();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      初期化処理です.
+    //!
+    //! @param[in]      pDeviceMgr      デバイスマネージャです.
+    //! @param[in]      frameCount      同時に処理するフレーム数です.
+    //! @retval true    初期化に成功.
+    //! @retval false   初期化に失敗.
+    //! @note       グラフィックスキューと異なるコンピュートキューがある場合は非同期コンピュートを有効にします.
+    //---------------------------------------------------------------------------------------------
+    bool Init(DeviceMgr* pDeviceMgr, uint32_t frameCount);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      終了処理です.
+    //!
+    //! @param[in]      pDeviceMgr      デバイスマネージャです.
+    //---------------------------------------------------------------------------------------------
+    void Term(DeviceMgr* pDeviceMgr);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      宣言したパスとテクスチャを破棄します.
+    //!
+    //! @note       物理リソースは保持され, 次の Compile() で同じ構成であれば再利用されます.
+    //---------------------------------------------------------------------------------------------
+    void Reset();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      フレームグラフが管理する一時テクスチャを宣言します.
+    //!
+    //! @param[in]      name        テクスチャ名です.
+    //! @param[in]      desc        構成設定です.
+    //! @return     テクスチャ番号を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t CreateTexture(const char* name, const FrameGraphTextureDesc& desc);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      外部で生成したイメージをインポートします.
+    //!
+    //! @param[in]      name        テクスチャ名です.
+    //! @param[in]      image       イメージです.
+    //! @param[in]      view        イメージビューです.
+    //! @param[in]      range       サブリソース範囲です.
+    //! @param[in]      state       現在のステートです.
+    //! @param[in]      finalUsage  グラフ実行後に遷移させる使用用途です.
+    //! @return     テクスチャ番号を返却します.
+    //! @note       インポートしたテクスチャは常に出力として扱われ, エイリアスされません.
+    //---------------------------------------------------------------------------------------------
+    uint32_t ImportTexture(
+        const char*                     name,
+        VkImage                         image,
+        VkImageView                     view,
+        const VkImageSubresourceRange&  range,
+        const ResourceState&            state,
+        ResourceUsage                   finalUsage);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      パスを追加します.
+    //!
+    //! @param[in]      name        パス名です.
+    //! @param[in]      queueType   パスの種類です(QueueType_Graphics または QueueType_Compute).
+    //! @param[in]      func        実行関数です.
+    //! @return     パス番号を返却します.
+    //! @note       レンダーパスの開始・終了は実行関数内で行ってください.
+    //---------------------------------------------------------------------------------------------
+    uint32_t AddPass(const char* name, QueueType queueType, ExecuteFunc func);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      パスがテクスチャを読み取ることを宣言します.
+    //!
+    //! @param[in]      pass        パス番号です.
+    //! @param[in]      texture     テクスチャ番号です.
+    //! @param[in]      usage       使用用途です.
+    //---------------------------------------------------------------------------------------------
+    void Read(uint32_t pass, uint32_t texture, ResourceUsage usage);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      パスがテクスチャに書き込むことを宣言します.
+    //!
+    //! @param[in]      pass        パス番号です.
+    //! @param[in]      texture     テクスチャ番号です.
+    //! @param[in]      usage       使用用途です.
+    //---------------------------------------------------------------------------------------------
+    void Write(uint32_t pass, uint32_t texture, ResourceUsage usage);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      パスに副作用があることを設定します.
+    //!
+    //! @param[in]      pass        パス番号です.
+    //! @note       副作用のあるパスはカリングされません.
+    //---------------------------------------------------------------------------------------------
+    void SetSideEffect(uint32_t pass);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      テクスチャをグラフの出力に設定します.
+    //!
+    //! @param[in]      texture     テクスチャ番号です.
+    //---------------------------------------------------------------------------------------------
+    void MarkOutput(uint32_t texture);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      グラフをコンパイルします.
+    //!
+    //! @param[in]      pDeviceMgr      デバイスマネージャです.
+    //! @retval true    コンパイルに成功.
+    //! @retval false   コンパイルに失敗.
+    //! @note       不要なパスのカリング, 寿命が重ならないテクスチャのメモリエイリアス,
+    //!             非同期コンピュートに回すパスの選択を行います.
+    //!             テクスチャの構成や寿命が前回から変わった場合のみ物理リソースを作り直します.
+    //---------------------------------------------------------------------------------------------
+    bool Compile(DeviceMgr* pDeviceMgr);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      グラフを実行します.
+    //!
+    //! @param[in]      commandBuffer   記録中のグラフィックス用コマンドバッファです.
+    //! @retval true    実行に成功.
+    //! @retval false   実行に失敗.
+    //! @note       非同期コンピュートのパスはこの関数内でコンピュートキューにサブミットされます.
+    //!             記録したコマンドバッファをサブミットする際は AddAsyncWait() で完了を待機させてください.
+    //---------------------------------------------------------------------------------------------
+    bool Execute(VkCommandBuffer commandBuffer);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      非同期コンピュートの完了待ちをバッチに追加します.
+    //!
+    //! @param[in,out]  pBatch      Execute() で記録したコマンドバッファをサブミットするバッチです.
+    //! @note       コマンドバッファを追加する前に呼び出してください.
+    //!             直前の Execute() で非同期コンピュートをサブミットしていない場合は何もしません.
+    //---------------------------------------------------------------------------------------------
+    void AddAsyncWait(SubmitBatch* pBatch) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      テクスチャのイメージを取得します.
+    //!
+    //! @param[in]      texture     テクスチャ番号です.
+    //! @return     イメージを返却します.
+    //---------------------------------------------------------------------------------------------
+    VkImage GetImage(uint32_t texture) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      テクスチャのイメージビューを取得します.
+    //!
+    //! @param[in]      texture     テクスチャ番号です.
+    //! @return     イメージビューを返却します.
+    //---------------------------------------------------------------------------------------------
+    VkImageView GetView(uint32_t texture) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      テクスチャのサブリソース範囲を取得します.
+    //!
+    //! @param[in]      texture     テクスチャ番号です.
+    //! @return     サブリソース範囲を返却します.
+    //---------------------------------------------------------------------------------------------
+    VkImageSubresourceRange GetRange(uint32_t texture) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      パスがカリングされたかどうかチェックします.
+    //!
+    //! @param[in]      pass        パス番号です.
+    //! @retval true    カリングされました.
+    //! @retval false   実行されます.
+    //---------------------------------------------------------------------------------------------
+    bool IsCulled(uint32_t pass) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      統計情報を取得します.
+    //!
+    //! @return     統計情報を返却します.
+    //! @note       RebuildCount はフレームバッファなど物理イメージを参照するオブジェクトの再生成判定に使用できます.
+    //---------------------------------------------------------------------------------------------
+    const FrameGraphStats& GetStats() const;
+
+private:
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Access structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct Access
+    {
+        uint32_t        Texture;    //!< テクスチャ番号です.
+        ResourceUsage   Usage;      //!< 使用用途です.
+        bool            IsWrite;    //!< 書き込みの場合は true です.
+    };
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Pass structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct Pass
+    {
+        std::string             Name;           //!< パス名です.
+        QueueType               Type;           //!< パスの種類です.
+        ExecuteFunc             Func;           //!< 実行関数です.
+        std::vector<Access>     Accesses;       //!< 読み書きするテクスチャです.
+        bool                    HasSideEffect;  //!< 副作用がある場合は true です.
+        bool                    IsCulled;       //!< カリングされた場合は true です.
+        bool                    IsAsync;        //!< 非同期コンピュートキューで実行する場合は true です.
+    };
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Texture structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct Texture
+    {
+        std::string             Name;           //!< テクスチャ名です.
+        FrameGraphTextureDesc   Desc;           //!< 構成設定です.
+        VkImageUsageFlags       Usage;          //!< 宣言から導出した使用用途です.
+        bool                    IsImported;     //!< インポートしたテクスチャの場合は true です.
+        bool                    IsOutput;       //!< グラフの出力の場合は true です.
+        bool                    IsAsync;        //!< 非同期コンピュートのパスから参照される場合は true です.
+        VkImage                 Image;          //!< イメージです.
+        VkImageView             View;           //!< イメージビューです.
+        VkImageSubresourceRange Range;          //!< サブリソース範囲です.
+        ResourceState           InitialState;   //!< インポート時のステートです.
+        ResourceUsage           FinalUsage;     //!< 実行後に遷移させる使用用途です.
+        uint32_t                FirstPass;      //!< 最初に使用するパス番号です.
+        uint32_t                LastPass;       //!< 最後に使用するパス番号です.
+        uint32_t                Block;          //!< 割り当てたメモリブロック番号です.
+    };
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // MemoryBlock structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct MemoryBlock
+    {
+        Allocation              Memory;         //!< メモリ割り当てです.
+        VkMemoryRequirements    Requirements;   //!< 共有するテクスチャを合わせたメモリ要件です.
+        std::vector<uint32_t>   Textures;       //!< 共有するテクスチャ番号です.
+        ResourceState           LastState;      //!< 直前に使用したテクスチャの最終ステートです.
+    };
+
+    //=============================================================================================
+    // private variables.
+    //=============================================================================================
+    MemoryAllocator*            m_pAllocator;       //!< メモリアロケータです.
+    VkDevice                    m_Device;           //!< デバイスです.
+    Queue*                      m_pGraphicsQueue;   //!< グラフィックスキューです.
+    Queue*                      m_pComputeQueue;    //!< 非同期コンピュートキューです(無効な場合は nullptr).
+    FrameCommandAllocator       m_ComputeCommands;  //!< 非同期コンピュート用のコマンドバッファです.
+    SubmitBatch                 m_ComputeBatch;     //!< 非同期コンピュートのサブミット用のバッチです.
+    uint64_t                    m_AsyncTicket;      //!< 直前にサブミットした非同期コンピュートのチケットです.
+    ResourceStateTracker        m_Tracker;          //!< ステートトラッカーです.
+    std::vector<Pass>           m_Passes;           //!< パスです.
+    std::vector<Texture>        m_Textures;         //!< テクスチャです.
+    std::vector<MemoryBlock>    m_Blocks;           //!< メモリブロックです.
+    std::vector<VkImage>        m_Images;           //!< 生成済みのイメージです.
+    std::vector<VkImageView>    m_Views;            //!< 生成済みのイメージビューです.
+    std::vector<uint64_t>       m_Signature;        //!< 物理リソースを生成した時の構成です.
+    VkPipelineStageFlags        m_AsyncWaitStage;   //!< 非同期コンピュートの完了を待機するステージです.
+    bool                        m_IsCompiled;       //!< コンパイル済みの場合は true です.
+    FrameGraphStats             m_Stats;            //!< 統計情報です.
+
+    //=============================================================================================
+    // private methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      カリングを行います.
+    //---------------------------------------------------------------------------------------------
+    void CullPasses();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      非同期コンピュートで実行するパスを選択します.
+    //---------------------------------------------------------------------------------------------
+    void ScheduleAsync();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      物理リソースを生成します.
+    //---------------------------------------------------------------------------------------------
+    bool CreateResources();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      物理リソースを破棄します.
+    //---------------------------------------------------------------------------------------------
+    void DestroyResources();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      パスを記録します.
+    //---------------------------------------------------------------------------------------------
+    void RecordPass(uint32_t index, VkCommandBuffer commandBuffer);
+};
+
+} // namespace asvk
@@ -0,0 +1,160 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asvkFramePacer.h
+// Desc : Frame Pacer Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asvkTypedef.h>
+#include <asvkStepTimer.h>
+#include <Windows.h>
+
+
+namespace asvk {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// FramePacerStats structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct FramePacerStats
+{
+    uint32_t    FrameCount;         //!< 集計したフレーム数です.
+    uint32_t    MissedCount;        //!< 目標時刻に間に合わなかったフレーム数です.
+    double      TargetMs;           //!< 目標フレーム時間(ミリ秒)です. 0 の場合は無制限です.
+    double      AvgErrorMs;         //!< 目標時刻と実際の表示時刻の誤差の平均(ミリ秒)です.
+    double      MaxErrorMs;         //!< 目標時刻と実際の表示時刻の誤差の最大(ミリ秒)です.
+    double      AvgSleepMs;         //!< スリープで待機した時間の平均(ミリ秒)です.
+    double      AvgSpinMs;          //!< スピンで待機した時間の平均(ミリ秒)です.
+    double      PredictedWorkMs;    //!< 予測した入力取得から表示までの時間(ミリ秒)です.
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// FramePacer class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class FramePacer : NonCopyable
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    //=============================================================================================
+    // public variables.
+    //=============================================================================================
+    /* NOTHING */
+
+    //=============================================================================================
+    // public methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    FramePacer();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ~FramePacer();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      初期化処理を行います.
+    //!
+    //! @param[in]      targetFrameRate     目標フレームレートです. 0 の場合は制限しません.
+    //! @retval true    初期化に成功.
+    //! @retval false   初期化に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool Init(double targetFrameRate);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      終了処理を行います.
+    //---------------------------------------------------------------------------------------------
+    void Term();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      目標フレームレートを設定します.
+    //!
+    //! @param[in]      targetFrameRate     目標フレームレートです. 0 の場合は制限しません.
+    //---------------------------------------------------------------------------------------------
+    void SetTargetFrameRate(double targetFrameRate);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      目標フレーム時間を取得します.
+    //!
+    //! @return     目標フレーム時間(秒)を返却します. 制限しない場合は 0 を返却します.
+    //---------------------------------------------------------------------------------------------
+    double GetTargetFrameSec() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      次のフレームの入力取得時刻まで待機します.
+    //!
+    //! @retval true    入力取得時刻になりました. BeginFrame() を呼び出してフレームを開始してください.
+    //! @retval false   待機中にウィンドウメッセージが届きました. メッセージを処理してから再度呼び出してください.
+    //! @note       表示の目標時刻から予測した処理時間を逆算した時刻まで，スリープとスピンを併用して待機します.
+    //---------------------------------------------------------------------------------------------
+    bool Wait();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      フレームの開始(入力の取得)を通知します.
+    //---------------------------------------------------------------------------------------------
+    void BeginFrame();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      フレームの終了(表示)を通知します.
+    //---------------------------------------------------------------------------------------------
+    void EndFrame();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      統計情報を取得します.
+    //!
+    //! @return     前回 ResetStats() を呼び出してからの統計情報を返却します.
+    //---------------------------------------------------------------------------------------------
+    const FramePacerStats& GetStats() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      統計情報をリセットします.
+    //---------------------------------------------------------------------------------------------
+    void ResetStats();
+
+private:
+    //=============================================================================================
+    // private variables.
+    //=============================================================================================
+    static const double MinSpinSec;         //!< スピンで待機する最小時間(秒)です.
+    static const double MaxSpinSec;         //!< スピンで待機する最大時間(秒)です.
+    static const double SafetyMarginSec;    //!< 処理時間の予測に加える余裕(秒)です.
+    static const double SmoothFactor;       //!< 予測値の指数移動平均の係数です.
+
+    StepTimer           m_Timer;            //!< タイマーです.
+    HANDLE              m_hTimer;           //!< スリープに使用する待機可能タイマーです.
+    double              m_TargetSec;        //!< 目標フレーム時間(秒)です.
+    double              m_DeadlineSec;      //!< 次のフレームの表示目標時刻(秒)です.
+    double              m_FrameBeginSec;    //!< フレームを開始した時刻(秒)です.
+    double              m_PredictedSec;     //!< 予測した入力取得から表示までの時間(秒)です.
+    double              m_SpinSec;          //!< スピンで待機する時間(秒)です. スリープの寝過ごしから補正します.
+    double              m_SleepSec;         //!< 今回のフレームでスリープした時間(秒)です.
+    double              m_SpinWaitSec;      //!< 今回のフレームでスピンした時間(秒)です.
+    double              m_SumErrorSec;      //!< 誤差の合計です.
+    double              m_SumSleepSec;      //!< スリープ時間の合計です.
+    double              m_SumSpinSec;       //!< スピン時間の合計です.
+    FramePacerStats     m_Stats;            //!< 統計情報です.
+
+    //=============================================================================================
+    // private methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      スリープします.
+    //!
+    //! @param[in]      sec         スリープする時間(秒)です.
+    //! @retval true    指定時間スリープしました.
+    //! @retval false   ウィンドウメッセージが届いたため中断しました.
+    //---------------------------------------------------------------------------------------------
+    bool SleepFor(double sec);
+};
+
+} // namespace asvk
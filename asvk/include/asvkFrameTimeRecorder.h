@@ -0,0 +1,166 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asvkFrameTimeRecorder.h
+// Desc : Frame Time Recorder Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asvkTypedef.h>
+#include <atomic>
+#include <vector>
+
+
+namespace asvk {
+
+//-------------------------------------------------------------------------------------------------
+// Constant Values
+//-------------------------------------------------------------------------------------------------
+const uint32_t  FrameTimeBucketCount = 16;      //!< フレーム時間ヒストグラムのビン数です.
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// FrameTimeSummary structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct FrameTimeSummary
+{
+    uint32_t    SampleCount;                        //!< 集計したサンプル数です.
+    double      AvgMs;                              //!< 平均(ミリ秒)です.
+    double      P50Ms;                              //!< 50パーセンタイル(ミリ秒)です.
+    double      P95Ms;                              //!< 95パーセンタイル(ミリ秒)です.
+    double      P99Ms;                              //!< 99パーセンタイル(ミリ秒)です.
+    double      MaxMs;                              //!< 最大(ミリ秒)です.
+    uint32_t    Histogram[FrameTimeBucketCount];    //!< 対数ビンのヒストグラムです. 上限は FrameTimeRecorder::GetBucketUpperMs() で取得します.
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// FrameTimeStats structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct FrameTimeStats
+{
+    FrameTimeSummary    Cpu;            //!< CPUのフレーム時間の集計です.
+    FrameTimeSummary    Gpu;            //!< GPUのフレーム時間の集計です(計測できない場合はサンプル数 0).
+    uint64_t            FrameCount;     //!< 記録開始からのフレーム数です.
+    uint64_t            HitchCount;     //!< 記録開始からのヒッチ数です.
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// FrameTimeRecorder class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class FrameTimeRecorder : NonCopyable
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    //=============================================================================================
+    // public variables.
+    //=============================================================================================
+    static const uint32_t Capacity = 4096;      //!< 保持するフレーム数です(2のべき乗).
+
+    //=============================================================================================
+    // public methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    FrameTimeRecorder();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ~FrameTimeRecorder();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      フレーム時間を記録します.
+    //!
+    //! @param[in]      cpuMs       CPUのフレーム時間(ミリ秒)です.
+    //! @param[in]      gpuMs       GPUのフレーム時間(ミリ秒)です. 計測できない場合は負値を指定します.
+    //! @note       記録は1つのスレッドからのみ行ってください. 集計はどのスレッドからでも行えます.
+    //---------------------------------------------------------------------------------------------
+    void Record(double cpuMs, double gpuMs);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      記録を破棄します.
+    //!
+    //! @note       記録を行うスレッドから呼び出してください.
+    //---------------------------------------------------------------------------------------------
+    void Reset();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      直近のフレームを集計します.
+    //!
+    //! @param[out]     pStats      集計結果の格納先です.
+    //! @retval true    集計に成功.
+    //! @retval false   記録がありません.
+    //---------------------------------------------------------------------------------------------
+    bool GetStats(FrameTimeStats* pStats) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      集計結果と直近のフレーム時間をCSVファイルに保存します.
+    //!
+    //! @param[in]      filename    ファイル名です.
+    //! @retval true    保存に成功.
+    //! @retval false   保存に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool SaveCsv(const wchar_t* filename) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ヒストグラムのビンの上限を取得します.
+    //!
+    //! @param[in]      index       ビン番号です.
+    //! @return     ビンの上限(ミリ秒)を返却します. 最後のビンは上限がないため負値を返却します.
+    //---------------------------------------------------------------------------------------------
+    static double GetBucketUpperMs(uint32_t index);
+
+private:
+    //=============================================================================================
+    // private variables.
+    //=============================================================================================
+    static const double HitchRatio;     //!< 平均に対してこの倍率を超えたフレームをヒッチとみなします.
+    static const double SmoothFactor;   //!< 平均フレーム時間の指数移動平均の係数です.
+    static const double MinBucketMs;    //!< 最初のビンの上限(ミリ秒)です.
+
+    std::atomic<uint64_t>   m_Samples[Capacity];    //!< CPU時間とGPU時間を32bit浮動小数でまとめたサンプルです.
+    std::atomic<uint64_t>   m_WriteIndex;           //!< 次に書き込むサンプル番号です.
+    std::atomic<uint64_t>   m_HitchCount;           //!< ヒッチ数です.
+    double                  m_AvgCpuMs;             //!< ヒッチ判定用の平均CPU時間(ミリ秒)です.
+
+    //=============================================================================================
+    // private methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      直近のサンプルを取得します.
+    //!
+    //! @param[out]     cpuMs       CPU時間の格納先です.
+    //! @param[out]     gpuMs       GPU時間の格納先です(計測できなかったフレームは含みません).
+    //! @return     記録開始からのフレーム数を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint64_t Snapshot(std::vector<float>& cpuMs, std::vector<float>& gpuMs) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      サンプルを集計します.
+    //!
+    //! @param[in,out]  samples     サンプルです. ソートされます.
+    //! @param[out]     pSummary    集計結果の格納先です.
+    //---------------------------------------------------------------------------------------------
+    static void Summarize(std::vector<float>& samples, FrameTimeSummary* pSummary);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ビン番号を取得します.
+    //!
+    //! @param[in]      ms          フレーム時間(ミリ秒)です.
+    //! @return     ビン番号を返却します.
+    //---------------------------------------------------------------------------------------------
+    static uint32_t GetBucketIndex(double ms);
+};
+
+} // namespace asvk
@@ -0,0 +1,308 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asvkGpuProfiler.h
+// Desc : GPU Profiler Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asvkTypedef.h>
+#include <asvkDevice.h>
+#include <vulkan/vulkan.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+namespace asvk {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// GpuRegionStats structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct GpuRegionStats
+{
+    const char*     Name;           //!< 区間名です.
+    uint32_t        Depth;          //!< 入れ子の深さです.
+    uint32_t        SampleCount;    //!< 集計に使用したサンプル数です.
+    double          LastMs;         //!< 最新のGPU時間(ミリ秒)です.
+    double          MinMs;          //!< 直近のサンプルの最小GPU時間(ミリ秒)です.
+    double          AvgMs;          //!< 直近のサンプルの平均GPU時間(ミリ秒)です.
+    double          MaxMs;          //!< 直近のサンプルの最大GPU時間(ミリ秒)です.
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// PipelineStats structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct PipelineStats
+{
+    uint64_t    InputVertices;              //!< 入力アセンブラが処理した頂点数です.
+    uint64_t    InputPrimitives;            //!< 入力アセンブラが処理したプリミティブ数です.
+    uint64_t    VertexShaderInvocations;    //!< 頂点シェーダの起動回数です.
+    uint64_t    ClippingInvocations;        //!< クリッピングに入力されたプリミティブ数です.
+    uint64_t    ClippingPrimitives;         //!< クリッピング後に出力されたプリミティブ数です.
+    uint64_t    FragmentShaderInvocations;  //!< フラグメントシェーダの起動回数です.
+    uint64_t    ComputeShaderInvocations;   //!< コンピュートシェーダの起動回数です.
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// GpuProfiler class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class GpuProfiler : NonCopyable
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    //=============================================================================================
+    // public variables.
+    //=============================================================================================
+    static const uint32_t HistoryCount = 64;     //!< 最小・平均・最大の集計に使用するサンプル数です.
+
+    //=============================================================================================
+    // public methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    GpuProfiler();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ~GpuProfiler();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      初期化処理です.
+    //!
+    //! @param[in]      pDeviceMgr      デバイスマネージャです.
+    //! @param[in]      queueType       計測するコマンドバッファのキュータイプです.
+    //! @param[in]      frameCount      結果を読み戻すまでに経過するフレーム数です.
+    //! @param[in]      maxRegionCount  1フレームで計測できる最大区間数です.
+    //! @param[in]      maxStatsCount   1フレームでパイプライン統計を収集できる最大区間数です(0 で無効).
+    //! @retval true    初期化に成功.
+    //! @retval false   初期化に失敗.
+    //! @note       タイムスタンプやパイプライン統計に対応していないデバイスでも true を返却し,
+    //!             対応していない計測を行わずに動作します.
+    //---------------------------------------------------------------------------------------------
+    bool Init(
+        DeviceMgr*  pDeviceMgr,
+        QueueType   queueType,
+        uint32_t    frameCount,
+        uint32_t    maxRegionCount,
+        uint32_t    maxStatsCount = 0);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      終了処理です.
+    //!
+    //! @param[in]      pDeviceMgr      デバイスマネージャです.
+    //---------------------------------------------------------------------------------------------
+    void Term(DeviceMgr* pDeviceMgr);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      フレームの計測を開始します.
+    //!
+    //! @param[in]      commandBuffer   記録を開始したコマンドバッファです.
+    //! @param[in]      frameIndex      フレーム番号です.
+    //! @note       同じフレーム番号で前回記録した結果を読み戻してから, クエリをリセットします.
+    //!             フレーム番号に対応するフェンスの完了を待ってから呼び出してください.
+    //---------------------------------------------------------------------------------------------
+    void BeginFrame(VkCommandBuffer commandBuffer, uint32_t frameIndex);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      区間の計測を開始します.
+    //!
+    //! @param[in]      commandBuffer   コマンドバッファです.
+    //! @param[in]      name            区間名です.
+    //! @param[in]      pipelineStats   パイプライン統計も収集する場合は true を指定します.
+    //! @note       EndRegion() と対にして呼び出してください. 入れ子にできます.
+    //!             パイプライン統計は入れ子にできないため, 収集中の区間の内側では無視されます.
+    //!             レンダーパスの内側で開始した区間は同じサブパス内で終了してください.
+    //---------------------------------------------------------------------------------------------
+    void BeginRegion(VkCommandBuffer commandBuffer, const char* name, bool pipelineStats = false);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      区間の計測を終了します.
+    //!
+    //! @param[in]      commandBuffer   コマンドバッファです.
+    //---------------------------------------------------------------------------------------------
+    void EndRegion(VkCommandBuffer commandBuffer);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      タイムスタンプによる計測が可能かどうかチェックします.
+    //!
+    //! @retval true    計測可能です.
+    //! @retval false   計測できません.
+    //---------------------------------------------------------------------------------------------
+    bool IsSupported() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      パイプライン統計の収集が可能かどうかチェックします.
+    //!
+    //! @retval true    収集可能です.
+    //! @retval false   収集できません.
+    //---------------------------------------------------------------------------------------------
+    bool IsPipelineStatsSupported() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      収集するパイプライン統計のフラグを取得します.
+    //!
+    //! @return     パイプライン統計のフラグを返却します. 収集できない場合は 0 を返却します.
+    //! @note       統計を収集する区間内で実行するセカンダリコマンドバッファの継承情報に指定します.
+    //---------------------------------------------------------------------------------------------
+    VkQueryPipelineStatisticFlags GetPipelineStatisticFlags() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      計測済みの区間数を取得します.
+    //!
+    //! @return     計測済みの区間数を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t GetRegionCount() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      区間の統計情報を取得します.
+    //!
+    //! @param[in]      index       区間番号です.
+    //! @param[out]     pStats      統計情報の格納先です.
+    //! @retval true    取得に成功.
+    //! @retval false   取得に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool GetRegionStats(uint32_t index, GpuRegionStats* pStats) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      区間名を指定して統計情報を取得します.
+    //!
+    //! @param[in]      name        区間名です.
+    //! @param[out]     pStats      統計情報の格納先です.
+    //! @retval true    取得に成功.
+    //! @retval false   区間が見つかりません.
+    //---------------------------------------------------------------------------------------------
+    bool FindRegionStats(const char* name, GpuRegionStats* pStats) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      区間名を指定して最新のパイプライン統計を取得します.
+    //!
+    //! @param[in]      name        区間名です.
+    //! @param[out]     pStats      パイプライン統計の格納先です.
+    //! @retval true    取得に成功.
+    //! @retval false   区間が見つからないか, パイプライン統計を収集していません.
+    //---------------------------------------------------------------------------------------------
+    bool FindPipelineStats(const char* name, PipelineStats* pStats) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      最後に読み戻したフレームのパイプライン統計の合計を取得します.
+    //!
+    //! @param[out]     pStats      パイプライン統計の格納先です.
+    //! @return     合計した区間数を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t GetFramePipelineStats(PipelineStats* pStats) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      最後に読み戻したフレームのGPU時間を取得します.
+    //!
+    //! @return     最上位の区間の合計時間(ミリ秒)を返却します. 読み戻せなかった場合は負値を返却します.
+    //! @note       読み戻しは BeginFrame() で行うため, 同時に処理するフレーム数だけ前のフレームの値です.
+    //---------------------------------------------------------------------------------------------
+    double GetFrameGpuMs() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      集計済みのサンプルを破棄します.
+    //---------------------------------------------------------------------------------------------
+    void ResetStats();
+
+private:
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Region structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct Region
+    {
+        std::string             Name;           //!< 区間名です.
+        uint32_t                Depth;          //!< 入れ子の深さです.
+        std::vector<double>     History;        //!< 直近のGPU時間(ミリ秒)です.
+        uint32_t                HistoryIndex;   //!< 次に書き込むサンプル番号です.
+        uint32_t                SampleCount;    //!< 有効なサンプル数です.
+        double                  FrameMs;        //!< 読み戻し中のフレームの合計時間(ミリ秒)です.
+        bool                    IsHit;          //!< 読み戻し中のフレームで計測された場合は true です.
+        PipelineStats           Stats;          //!< 最新のパイプライン統計です.
+        bool                    HasStats;       //!< パイプライン統計を収集済みの場合は true です.
+    };
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Query structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct Query
+    {
+        uint32_t    Region;     //!< 区間番号です.
+        uint32_t    Begin;      //!< 開始タイムスタンプのクエリ番号です.
+        uint32_t    End;        //!< 終了タイムスタンプのクエリ番号です.
+    };
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Frame structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct Frame
+    {
+        std::vector<Query>      Queries;        //!< 記録した区間です.
+        uint32_t                QueryCount;     //!< 使用したクエリ数です.
+        std::vector<uint32_t>   StatsRegions;   //!< パイプライン統計を収集した区間番号です.
+    };
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Scope structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct Scope
+    {
+        uint32_t    Query;      //!< タイムスタンプの区間番号です(無効な場合は UINT32_MAX).
+        uint32_t    Stats;      //!< パイプライン統計のクエリ番号です(無効な場合は UINT32_MAX).
+    };
+
+    //=============================================================================================
+    // private variables.
+    //=============================================================================================
+    VkDevice                                    m_Device;           //!< デバイスです.
+    VkQueryPool                                 m_QueryPool;        //!< タイムスタンプクエリプールです.
+    VkQueryPool                                 m_StatsPool;        //!< パイプライン統計クエリプールです.
+    VkQueryPipelineStatisticFlags               m_StatsFlags;       //!< 収集するパイプライン統計です.
+    uint32_t                                    m_StatsValueCount;  //!< 1クエリあたりの統計値の数です.
+    uint32_t                                    m_MaxStatsCount;    //!< 1フレームあたりのパイプライン統計クエリ数です.
+    bool                                        m_IsStatsActive;    //!< パイプライン統計を収集中の場合は true です.
+    PipelineStats                               m_FrameStats;       //!< 最後に読み戻したフレームのパイプライン統計の合計です.
+    uint32_t                                    m_FrameStatsCount;  //!< m_FrameStats に合計した区間数です.
+    double                                      m_FrameGpuMs;       //!< 最後に読み戻したフレームのGPU時間(ミリ秒)です.
+    double                                      m_TimestampPeriod;  //!< 1カウントあたりのナノ秒です.
+    uint64_t                                    m_TimestampMask;    //!< タイムスタンプの有効ビットのマスクです.
+    uint32_t                                    m_MaxQueryCount;    //!< 1フレームあたりのクエリ数です.
+    uint32_t                                    m_FrameIndex;       //!< 記録中のフレーム番号です.
+    std::vector<Frame>                          m_Frames;           //!< フレームごとの記録です.
+    std::vector<Region>                         m_Regions;          //!< 区間です.
+    std::unordered_map<std::string, uint32_t>   m_RegionMap;        //!< 区間名から区間番号への対応表です.
+    std::vector<Scope>                          m_Stack;            //!< 計測中の区間です.
+    std::vector<uint64_t>                       m_Results;          //!< 読み戻し用のバッファです.
+
+    //=============================================================================================
+    // private methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      区間名に対応する区間番号を取得します. 無ければ追加します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t FindOrAddRegion(const char* name);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      前回記録したタイムスタンプを読み戻して集計します.
+    //---------------------------------------------------------------------------------------------
+    void Resolve(Frame& frame, uint32_t firstQuery);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      前回記録したパイプライン統計を読み戻します.
+    //---------------------------------------------------------------------------------------------
+    void ResolveStats(Frame& frame, uint32_t firstQuery);
+};
+
+} // namespace asvk
@@ -15,6 +15,14 @@
 #include <cstring>
 #include <climits>
 
+#if ASVK_IS_SIMD
+  #if ASVK_IS_AVX
+    #include <immintrin.h>
+  #elif ASVK_IS_SSE2
+    #include <emmintrin.h>
+  #endif
+#endif//ASVK_IS_SIMD
+
 
 namespace asvk {
 
@@ -1600,6 +1608,96 @@ public:
     //----------------------------------------------------------------------------------------------
     static void    TransformCoord( const Vector3& coord, const Matrix& matrix, Vector3& result );
 
+    //----------------------------------------------------------------------------------------------
+    //! @brief      指定された行列を用いて，ベクトル配列を一括変換します.
+    //!
+    //! @param [in]     pInput      入力ベクトル配列.
+    //! @param [in]     count       要素数.
+    //! @param [in]     matrix      変換行列.
+    //! @param [out]    pOutput     変換されたベクトルの格納先. pInput と同じ配列を指定できます.
+    //! @note       範囲が重ならなければ, 配列を分割して複数スレッドから呼び出せます.
+    //----------------------------------------------------------------------------------------------
+    static void    TransformArray( const Vector3* pInput, size_t count, const Matrix& matrix, Vector3* pOutput );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      指定された行列を用いて，ベクトル配列を一括変換します.
+    //!
+    //! @param [in]     pInput          入力ベクトルの先頭アドレス.
+    //! @param [in]     inputStride     入力要素間のバイト数.
+    //! @param [in]     count           要素数.
+    //! @param [in]     matrix          変換行列.
+    //! @param [out]    pOutput         変換されたベクトルの格納先の先頭アドレス.
+    //! @param [in]     outputStride    出力要素間のバイト数.
+    //! @note       頂点バッファのようなインターリーブされたデータを直接変換できます.
+    //----------------------------------------------------------------------------------------------
+    static void    TransformArray(
+        const void*     pInput,
+        size_t          inputStride,
+        size_t          count,
+        const Matrix&   matrix,
+        void*           pOutput,
+        size_t          outputStride );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      指定された行列を用いて，法線ベクトル配列を一括変換します.
+    //!
+    //! @param [in]     pInput      入力法線ベクトル配列.
+    //! @param [in]     count       要素数.
+    //! @param [in]     matrix      変換行列.
+    //! @param [out]    pOutput     変換された法線ベクトルの格納先. pInput と同じ配列を指定できます.
+    //! @note       範囲が重ならなければ, 配列を分割して複数スレッドから呼び出せます.
+    //----------------------------------------------------------------------------------------------
+    static void    TransformNormalArray( const Vector3* pInput, size_t count, const Matrix& matrix, Vector3* pOutput );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      指定された行列を用いて，法線ベクトル配列を一括変換します.
+    //!
+    //! @param [in]     pInput          入力法線ベクトルの先頭アドレス.
+    //! @param [in]     inputStride     入力要素間のバイト数.
+    //! @param [in]     count           要素数.
+    //! @param [in]     matrix          変換行列.
+    //! @param [out]    pOutput         変換された法線ベクトルの格納先の先頭アドレス.
+    //! @param [in]     outputStride    出力要素間のバイト数.
+    //! @note       頂点バッファのようなインターリーブされたデータを直接変換できます.
+    //----------------------------------------------------------------------------------------------
+    static void    TransformNormalArray(
+        const void*     pInput,
+        size_t          inputStride,
+        size_t          count,
+        const Matrix&   matrix,
+        void*           pOutput,
+        size_t          outputStride );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      指定された行列を用いてベクトル配列を一括変換し，変換結果をw=1に射影します.
+    //!
+    //! @param [in]     pInput      入力ベクトル配列.
+    //! @param [in]     count       要素数.
+    //! @param [in]     matrix      変換行列.
+    //! @param [out]    pOutput     w=1に射影されたベクトルの格納先. pInput と同じ配列を指定できます.
+    //! @note       範囲が重ならなければ, 配列を分割して複数スレッドから呼び出せます.
+    //----------------------------------------------------------------------------------------------
+    static void    TransformCoordArray( const Vector3* pInput, size_t count, const Matrix& matrix, Vector3* pOutput );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      指定された行列を用いてベクトル配列を一括変換し，変換結果をw=1に射影します.
+    //!
+    //! @param [in]     pInput          入力ベクトルの先頭アドレス.
+    //! @param [in]     inputStride     入力要素間のバイト数.
+    //! @param [in]     count           要素数.
+    //! @param [in]     matrix          変換行列.
+    //! @param [out]    pOutput         w=1に射影されたベクトルの格納先の先頭アドレス.
+    //! @param [in]     outputStride    出力要素間のバイト数.
+    //! @note       頂点バッファのようなインターリーブされたデータを直接変換できます.
+    //----------------------------------------------------------------------------------------------
+    static void    TransformCoordArray(
+        const void*     pInput,
+        size_t          inputStride,
+        size_t          count,
+        const Matrix&   matrix,
+        void*           pOutput,
+        size_t          outputStride );
+
     //----------------------------------------------------------------------------------------------
     //! @brief      スカラー3重積を計算します.
     //!
@@ -2220,6 +2318,36 @@ public:
     //----------------------------------------------------------------------------------------------
     static void    Transform( const Vector4& position, const Matrix& matrix, Vector4 &result );
 
+    //----------------------------------------------------------------------------------------------
+    //! @brief      指定された行列を用いて，ベクトル配列を一括変換します.
+    //!
+    //! @param [in]     pInput      入力ベクトル配列.
+    //! @param [in]     count       要素数.
+    //! @param [in]     matrix      変換行列.
+    //! @param [out]    pOutput     変換されたベクトルの格納先. pInput と同じ配列を指定できます.
+    //! @note       範囲が重ならなければ, 配列を分割して複数スレッドから呼び出せます.
+    //----------------------------------------------------------------------------------------------
+    static void    TransformArray( const Vector4* pInput, size_t count, const Matrix& matrix, Vector4* pOutput );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      指定された行列を用いて，ベクトル配列を一括変換します.
+    //!
+    //! @param [in]     pInput          入力ベクトルの先頭アドレス.
+    //! @param [in]     inputStride     入力要素間のバイト数.
+    //! @param [in]     count           要素数.
+    //! @param [in]     matrix          変換行列.
+    //! @param [out]    pOutput         変換されたベクトルの格納先の先頭アドレス.
+    //! @param [in]     outputStride    出力要素間のバイト数.
+    //! @note       頂点バッファのようなインターリーブされたデータを直接変換できます.
+    //----------------------------------------------------------------------------------------------
+    static void    TransformArray(
+        const void*     pInput,
+        size_t          inputStride,
+        size_t          count,
+        const Matrix&   matrix,
+        void*           pOutput,
+        size_t          outputStride );
+
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -2559,6 +2687,27 @@ public:
     //----------------------------------------------------------------------------------------------
     static void    MultiplyTranspose( const Matrix& a, const Matrix& b, Matrix &result );
 
+    //----------------------------------------------------------------------------------------------
+    //! @brief      行列配列の各要素に行列を乗算します ( pOutput[i] = pInput[i] * matrix ).
+    //!
+    //! @param [in]     pInput      入力行列配列.
+    //! @param [in]     count       要素数.
+    //! @param [in]     matrix      乗算する行列.
+    //! @param [out]    pOutput     乗算結果の格納先. pInput と同じ配列を指定できます.
+    //! @note       ボーン行列パレットの更新などに用います.
+    //----------------------------------------------------------------------------------------------
+    static void    MultiplyArray( const Matrix* pInput, size_t count, const Matrix& matrix, Matrix* pOutput );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      行列配列の各要素に行列を乗算します ( pOutput[i] = matrix * pInput[i] ).
+    //!
+    //! @param [in]     matrix      乗算する行列.
+    //! @param [in]     pInput      入力行列配列.
+    //! @param [in]     count       要素数.
+    //! @param [out]    pOutput     乗算結果の格納先. pInput と同じ配列を指定できます.
+    //----------------------------------------------------------------------------------------------
+    static void    MultiplyArray( const Matrix& matrix, const Matrix* pInput, size_t count, Matrix* pOutput );
+
     //----------------------------------------------------------------------------------------------
     //! @brief      逆行列を求めます.
     //!
@@ -0,0 +1,120 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asvkPipelineCache.h
+// Desc : Pipeline Cache Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asvkTypedef.h>
+#include <asvkDevice.h>
+#include <vulkan/vulkan.h>
+#include <string>
+
+
+namespace asvk {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// PipelineCacheStats structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct PipelineCacheStats
+{
+    bool        IsWarm;         //!< 有効なキャッシュデータを読み込んだ場合は true になります.
+    bool        IsDiscarded;    //!< ヘッダーが一致せずキャッシュデータを破棄した場合は true になります.
+    size_t      LoadedSize;     //!< 読み込んだキャッシュデータのサイズです.
+    size_t      SavedSize;      //!< 保存したキャッシュデータのサイズです.
+    double      LoadMs;         //!< 読み込みとキャッシュ生成にかかった時間(ミリ秒)です.
+    double      SaveMs;         //!< 保存にかかった時間(ミリ秒)です.
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// PipelineCache class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class PipelineCache : NonCopyable
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    //=============================================================================================
+    // public variables.
+    //=============================================================================================
+    /* NOTHING */
+
+    //=============================================================================================
+    // public methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    PipelineCache();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ~PipelineCache();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      初期化処理を行います.
+    //!
+    //! @param[in]      pDeviceMgr      デバイスマネージャです.
+    //! @param[in]      filePath        キャッシュファイルのパスです.
+    //! @retval true    初期化に成功.
+    //! @retval false   初期化に失敗.
+    //! @note       ファイルが存在しない場合や, ベンダーID・デバイスID・UUIDが一致しない場合は
+    //!             空のキャッシュを生成します.
+    //---------------------------------------------------------------------------------------------
+    bool Init(DeviceMgr* pDeviceMgr, const wchar_t* filePath);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      終了処理を行います.
+    //!
+    //! @param[in]      pDeviceMgr      デバイスマネージャです.
+    //! @note       破棄する前にキャッシュデータをファイルに保存します.
+    //---------------------------------------------------------------------------------------------
+    void Term(DeviceMgr* pDeviceMgr);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      キャッシュデータをファイルに保存します.
+    //!
+    //! @param[in]      pDeviceMgr      デバイスマネージャです.
+    //! @retval true    保存に成功.
+    //! @retval false   保存に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool Save(DeviceMgr* pDeviceMgr);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      パイプラインキャッシュを取得します.
+    //!
+    //! @return     パイプラインキャッシュを返却します.
+    //---------------------------------------------------------------------------------------------
+    VkPipelineCache GetHandle() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      統計情報を取得します.
+    //!
+    //! @return     統計情報を返却します.
+    //---------------------------------------------------------------------------------------------
+    const PipelineCacheStats& GetStats() const;
+
+private:
+    //=============================================================================================
+    // private variables.
+    //=============================================================================================
+    std::wstring            m_FilePath;     //!< キャッシュファイルのパスです.
+    VkPipelineCache         m_Cache;        //!< パイプラインキャッシュです.
+    PipelineCacheStats      m_Stats;        //!< 統計情報です.
+
+    //=============================================================================================
+    // private methods.
+    //=============================================================================================
+    /* NOTHING */
+};
+
+} // namespace asvk
@@ -8,11 +8,33 @@
 //-------------------------------------------------------------------------------------------------
 // Includes
 //-------------------------------------------------------------------------------------------------
+#include <asvkTypedef.h>
 #include <vulkan/vulkan.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+//-------------------------------------------------------------------------------------------------
+// Constant Values
+//-------------------------------------------------------------------------------------------------
+#if defined(VK_KHR_timeline_semaphore)
+#define ASVK_IS_TIMELINE_SEMAPHORE  (1)
+#else
+#define ASVK_IS_TIMELINE_SEMAPHORE  (0)
+#endif
 
 
 namespace asvk {
 
+//-------------------------------------------------------------------------------------------------
+// Forward Declarations.
+//-------------------------------------------------------------------------------------------------
+class Queue;
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // QueueType enum
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -20,6 +42,144 @@ enum QueueType
 {
     QueueType_Graphics = 0,     //!< グラフィックス用途です.
     QueueType_Compute,          //!< コンピュート用途です.
+    QueueType_Transfer,         //!< 転送用途です.
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// QueueStats structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct QueueStats
+{
+    uint32_t    SubmitCallCount;        //!< vkQueueSubmit() の呼び出し回数です.
+    uint32_t    SubmitInfoCount;        //!< サブミットした VkSubmitInfo の数です.
+    uint32_t    CommandBufferCount;     //!< サブミットしたコマンドバッファの数です.
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// SubmitBatch class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class SubmitBatch
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    friend class Queue;
+
+public:
+    //=============================================================================================
+    // public variables.
+    //=============================================================================================
+    /* NOTHING */
+
+    //=============================================================================================
+    // public methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    SubmitBatch();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ~SubmitBatch();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      登録内容を全て破棄します.
+    //---------------------------------------------------------------------------------------------
+    void Reset();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      現在のバッチの実行前に待機するセマフォを追加します.
+    //!
+    //! @param[in]      semaphore       待機するセマフォです.
+    //! @param[in]      waitStageMask   セマフォを待機するパイプラインステージです.
+    //---------------------------------------------------------------------------------------------
+    void AddWait(VkSemaphore semaphore, VkPipelineStageFlags waitStageMask);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      現在のバッチの実行前に, 他のキューのチケット完了を待機させます.
+    //!
+    //! @param[in]      pQueue          待機対象のキューです.
+    //! @param[in]      ticket          待機するチケットです.
+    //! @param[in]      waitStageMask   待機するパイプラインステージです.
+    //! @note       待機はこのバッチをサブミットした時にだけ適用されます.
+    //!             待機対象のキューがタイムラインセマフォを使えない場合は, この関数内でCPU側で完了を待機します.
+    //---------------------------------------------------------------------------------------------
+    void AddWaitQueue(Queue* pQueue, uint64_t ticket, VkPipelineStageFlags waitStageMask);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      現在のバッチにコマンドバッファを追加します.
+    //!
+    //! @param[in]      commandBuffer   実行するコマンドバッファです.
+    //---------------------------------------------------------------------------------------------
+    void AddCommandBuffer(VkCommandBuffer commandBuffer);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      現在のバッチの実行完了時にシグナルするセマフォを追加します.
+    //!
+    //! @param[in]      semaphore       シグナルするセマフォです.
+    //---------------------------------------------------------------------------------------------
+    void AddSignal(VkSemaphore semaphore);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      現在のバッチを閉じて, 次のバッチ(VkSubmitInfo)を開始します.
+    //!
+    //! @note       セマフォの待機やシグナルを挟む位置で呼び出します.
+    //---------------------------------------------------------------------------------------------
+    void NextBatch();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      バッチ数を取得します.
+    //!
+    //! @return     空でないバッチの数を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t GetBatchCount() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      空かどうかチェックします.
+    //!
+    //! @retval true    何も登録されていません.
+    //! @retval false   登録済みのバッチがあります.
+    //---------------------------------------------------------------------------------------------
+    bool IsEmpty() const;
+
+private:
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Entry structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct Entry
+    {
+        uint32_t    WaitOffset;             //!< 待機セマフォの開始位置です.
+        uint32_t    WaitCount;              //!< 待機セマフォ数です.
+        uint32_t    CommandBufferOffset;    //!< コマンドバッファの開始位置です.
+        uint32_t    CommandBufferCount;     //!< コマンドバッファ数です.
+        uint32_t    SignalOffset;           //!< シグナルセマフォの開始位置です.
+        uint32_t    SignalCount;            //!< シグナルセマフォ数です.
+    };
+
+    //=============================================================================================
+    // private variables.
+    //=============================================================================================
+    std::vector<Entry>                  m_Entries;          //!< バッチです.
+    std::vector<VkSemaphore>            m_WaitSemaphores;   //!< 待機セマフォです.
+    std::vector<VkPipelineStageFlags>   m_WaitStages;       //!< 待機ステージです.
+    std::vector<uint64_t>               m_WaitValues;       //!< 待機するタイムラインセマフォの値です(バイナリセマフォは 0).
+    std::vector<VkCommandBuffer>        m_CommandBuffers;   //!< コマンドバッファです.
+    std::vector<VkSemaphore>            m_SignalSemaphores; //!< シグナルセマフォです.
+    bool                                m_IsOpen;           //!< 末尾のバッチが追加可能かどうか.
+
+    //=============================================================================================
+    // private methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      追加先のバッチを取得します.
+    //---------------------------------------------------------------------------------------------
+    Entry& GetCurrent();
 };
 
 
@@ -59,39 +219,181 @@ public:
     //! @param[in]      device          デバイスです.
     //! @param[in]      familyIndex     ファミリーインデックスです.
     //! @param[in]      queueIndex      キューインデックスです.
+    //! @param[in]      type            キュータイプです.
+    //! @param[in]      useTimeline     タイムラインセマフォを使用する場合は true を指定します.
+    //!                                 VK_KHR_timeline_semaphore が有効なデバイスでのみ指定できます.
     //---------------------------------------------------------------------------------------------
-    bool Init(VkDevice device, uint32_t familyIndex, uint32_t queueIndex, QueueType type);
+    bool Init(
+        VkDevice    device,
+        uint32_t    familyIndex,
+        uint32_t    queueIndex,
+        QueueType   type,
+        bool        useTimeline = false);
 
     //---------------------------------------------------------------------------------------------
     //! @brief      終了処理です.
     //---------------------------------------------------------------------------------------------
     void Term(VkDevice device);
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      サブミットスレッドを開始します.
+    //!
+    //! @retval true    開始に成功.
+    //! @retval false   開始に失敗.
+    //! @note       開始後は vkQueueSubmit() と vkQueuePresentKHR() をこのスレッドだけが呼び出します.
+    //!             サブミットと表示の関数は要求をロックフリーなキューに積んで即座に戻り,
+    //!             完了は返却したチケットで追跡できます. 他のスレッドからのサブミットと同時に呼び出さないでください.
+    //---------------------------------------------------------------------------------------------
+    bool StartSubmitThread();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      サブミットスレッドを停止します.
+    //!
+    //! @note       積まれている要求を全て処理してから停止します.
+    //---------------------------------------------------------------------------------------------
+    void StopSubmitThread();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      サブミットスレッドが動作中かどうかチェックします.
+    //!
+    //! @retval true    動作中です.
+    //! @retval false   停止中です.
+    //---------------------------------------------------------------------------------------------
+    bool IsSubmitThreadRunning() const;
+
     //---------------------------------------------------------------------------------------------
     //! @brief      コマンドを実行します.
+    //!
+    //! @param[in]      count           コマンドバッファ数です.
+    //! @param[in]      pBuffers        実行するコマンドバッファです.
+    //! @return     チケットを返却します. 失敗した場合は 0 を返却します.
     //---------------------------------------------------------------------------------------------
-    void Execute(uint32_t count, VkCommandBuffer* pBuffers);
+    uint64_t Execute(uint32_t count, VkCommandBuffer* pBuffers);
 
     //---------------------------------------------------------------------------------------------
-    //! @brief      コマンドの完了を待機します.
+    //! @brief      セマフォとフェンスを指定してコマンドを実行します.
+    //!
+    //! @param[in]      commandBuffer       実行するコマンドバッファです.
+    //! @param[in]      waitSemaphore       実行前に待機するセマフォです(null_handle可).
+    //! @param[in]      waitStageMask       セマフォを待機するパイプラインステージです.
+    //! @param[in]      signalSemaphore     実行完了時にシグナルするセマフォです(null_handle可).
+    //! @param[in]      fence               実行完了時にシグナルするフェンスです(null_handle可).
+    //! @return     チケットを返却します. 失敗した場合は 0 を返却します.
+    //! @note       フェンスはサブミット直前にリセットされます.
+    //---------------------------------------------------------------------------------------------
+    uint64_t Submit(
+        VkCommandBuffer         commandBuffer,
+        VkSemaphore             waitSemaphore,
+        VkPipelineStageFlags    waitStageMask,
+        VkSemaphore             signalSemaphore,
+        VkFence                 fence);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      バッチをまとめて1回の vkQueueSubmit() で実行します.
+    //!
+    //! @param[in]      pBatch          実行するバッチです.
+    //! @param[in]      fence           全バッチの完了時にシグナルするフェンスです(null_handle可).
+    //! @return     チケットを返却します. 失敗した場合は 0 を返却します.
+    //! @note       フェンスはサブミット直前にリセットされます. バッチの内容はクリアされません.
+    //---------------------------------------------------------------------------------------------
+    uint64_t Submit(const SubmitBatch* pBatch, VkFence fence = null_handle);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      スワップチェインのイメージを表示します.
+    //!
+    //! @param[in]      swapChain       スワップチェインです.
+    //! @param[in]      imageIndex      表示するイメージ番号です.
+    //! @param[in]      waitSemaphore   表示前に待機するセマフォです(null_handle可).
+    //! @param[out]     pResult         vkQueuePresentKHR() の結果の格納先です(nullptr可).
+    //! @note       サブミットスレッドの動作中は結果が後から書き込まれます.
+    //---------------------------------------------------------------------------------------------
+    void Present(
+        VkSwapchainKHR          swapChain,
+        uint32_t                imageIndex,
+        VkSemaphore             waitSemaphore,
+        std::atomic<int32_t>*   pResult);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      積まれている要求が全てドライバに渡るまで待機します.
+    //!
+    //! @note       サブミットスレッドが停止中の場合は何もしません.
+    //---------------------------------------------------------------------------------------------
+    void Flush();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      統計情報を取得します.
+    //!
+    //! @param[out]     pStats          前回の ResetStats() からの統計情報の格納先です.
+    //---------------------------------------------------------------------------------------------
+    void GetStats(QueueStats* pStats) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      統計情報をリセットします.
+    //---------------------------------------------------------------------------------------------
+    void ResetStats();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      チケットが完了したかどうかチェックします.
+    //!
+    //! @param[in]      ticket          チェックするチケットです.
+    //! @retval true    完了しています.
+    //! @retval false   実行中です.
+    //---------------------------------------------------------------------------------------------
+    bool IsComplete(uint64_t ticket);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      チケットの完了を待機します.
+    //!
+    //! @param[in]      ticket          待機するチケットです.
+    //! @param[in]      timeout         タイムアウト時間です(ナノ秒単位).
+    //! @retval true    完了しました.
+    //! @retval false   タイムアウトまたはエラーです.
+    //---------------------------------------------------------------------------------------------
+    bool WaitFor(uint64_t ticket, uint64_t timeout = UINT64_MAX);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      最後にサブミットしたコマンドの完了を待機します.
     //!
     //! @param[in]      timeout     タイムアウト時間です(ナノ秒単位).
     //---------------------------------------------------------------------------------------------
     void Wait(uint64_t timeout);
 
     //---------------------------------------------------------------------------------------------
-    //! @brief      キューを取得します.
+    //! @brief      最後にサブミットしたチケットを取得します.
     //!
-    //! @return     キューを返却します.
+    //! @return     最後にサブミットしたチケットを返却します.
+    //! @note       サブミットスレッドの動作中は, まだドライバに渡していないチケットも含みます.
     //---------------------------------------------------------------------------------------------
-    VkQueue GetQueue() const;
+    uint64_t GetSubmittedTicket() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      完了済みのチケットを取得します.
+    //!
+    //! @return     完了が確認されている最大のチケットを返却します.
+    //---------------------------------------------------------------------------------------------
+    uint64_t GetCompletedTicket();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      タイムラインセマフォを使用しているかどうかチェックします.
+    //!
+    //! @retval true    タイムラインセマフォを使用しています.
+    //! @retval false   フェンスプールを使用しています.
+    //---------------------------------------------------------------------------------------------
+    bool IsTimeline() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      タイムラインセマフォを取得します.
+    //!
+    //! @return     タイムラインセマフォを返却します. 使用していない場合は null_handle を返却します.
+    //---------------------------------------------------------------------------------------------
+    VkSemaphore GetTimelineSemaphore() const;
 
     //---------------------------------------------------------------------------------------------
-    //! @brief      フェンスを取得します.
+    //! @brief      キューを取得します.
     //!
-    //! @return     フェンスを返却します.
+    //! @return     キューを返却します.
     //---------------------------------------------------------------------------------------------
-    VkFence GetFence() const;
+    VkQueue GetQueue() const;
 
     //---------------------------------------------------------------------------------------------
     //! @brief      ファミリーインデックスを取得します.
@@ -108,19 +410,174 @@ public:
     QueueType GetType() const;
 
 private:
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // FenceEntry structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct FenceEntry
+    {
+        uint64_t    Ticket;     //!< チケットです.
+        VkFence     Fence;      //!< 完了時にシグナルされるフェンスです.
+        bool        IsOwned;    //!< フェンスプールのフェンスかどうか(false なら呼び出し側のフェンス).
+    };
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // RequestType enum
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    enum RequestType
+    {
+        RequestType_Submit = 0,     //!< サブミットです.
+        RequestType_Present,        //!< 表示です.
+    };
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Request structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct Request
+    {
+        std::atomic<uint64_t>   Sequence;       //!< 書き込み済みなら位置 + 1, 空きなら位置です.
+        RequestType             Type;           //!< 要求の種類です.
+        SubmitBatch             Batch;          //!< サブミットするバッチです.
+        VkFence                 Fence;          //!< サブミット完了時にシグナルするフェンスです.
+        VkSwapchainKHR          SwapChain;      //!< 表示するスワップチェインです.
+        uint32_t                ImageIndex;     //!< 表示するイメージ番号です.
+        VkSemaphore             WaitSemaphore;  //!< 表示前に待機するセマフォです.
+        std::atomic<int32_t>*   pResult;        //!< 表示結果の格納先です.
+    };
+
     //=============================================================================================
     // private variables.
     //=============================================================================================
-    VkDevice    m_Device;           //!< デバイスです.
-    VkQueue     m_Queue;            //!< キューです.
-    VkFence     m_Fence;            //!< フェンスです.
-    uint32_t    m_FamiliyIndex;     //!< ファミリーインデックスです.
-    QueueType   m_Type;             //!< キュータイプです.
+    VkDevice                    m_Device;           //!< デバイスです.
+    VkQueue                     m_Queue;            //!< キューです.
+    uint32_t                    m_FamiliyIndex;     //!< ファミリーインデックスです.
+    QueueType                   m_Type;             //!< キュータイプです.
+    std::mutex                  m_Mutex;            //!< サブミットとチケット管理用のミューテックスです.
+    uint64_t                    m_NextTicket;       //!< 次に発行するチケットです.
+    std::atomic<uint64_t>       m_SubmittedTicket;  //!< 最後にサブミットしたチケットです.
+    std::atomic<uint64_t>       m_CompletedTicket;  //!< 完了が確認されたチケットです.
+    VkSemaphore                 m_Timeline;         //!< タイムラインセマフォです.
+    std::deque<FenceEntry>      m_InFlightFences;   //!< 実行中のフェンスです.
+    std::vector<VkFence>        m_FreeFences;       //!< 再利用可能なフェンスです.
+    std::vector<VkFence>        m_RetiredFences;    //!< 待機中のスレッドがあるため再利用を保留しているフェンスです.
+    std::atomic<uint32_t>       m_FenceWaiterCount; //!< ロック外でフェンスを待機しているスレッド数です.
+    SubmitBatch                 m_SingleBatch;      //!< 単発サブミット用のバッチです.
+    std::vector<VkSubmitInfo>   m_SubmitInfos;      //!< サブミット用の作業領域です.
+    std::vector<VkSemaphore>    m_SignalSemaphores; //!< サブミット用の作業領域です.
+    std::vector<uint64_t>       m_SignalValues;     //!< サブミット用の作業領域です.
+    std::atomic<uint32_t>       m_SubmitCallCount;  //!< vkQueueSubmit() の呼び出し回数です.
+    std::atomic<uint32_t>       m_SubmitInfoCount;  //!< VkSubmitInfo の数です.
+    std::atomic<uint32_t>       m_CommandBufferCount;   //!< コマンドバッファの数です.
+    std::atomic<uint64_t>       m_IssuedTicket;     //!< 最後に発行したチケットです.
+
+    static const uint32_t       RequestQueueSize = 64;                  //!< 要求キューのサイズです(2のべき乗).
+    Request                     m_Requests[RequestQueueSize];           //!< 要求キューです.
+    alignas(64) std::atomic<uint64_t>   m_RequestHead;                  //!< 次に処理する位置です(サブミットスレッドが更新).
+    alignas(64) std::atomic<uint64_t>   m_RequestTail;                  //!< 次に積む位置です(要求側が更新).
+    uint64_t                    m_TicketBase;       //!< 位置 0 の要求に対応するチケットです.
+    std::thread                 m_SubmitThread;     //!< サブミットスレッドです.
+    std::atomic<bool>           m_IsSubmitThreadRunning;    //!< サブミットスレッドが動作中かどうか.
+    std::atomic<bool>           m_IsSubmitQuitRequested;    //!< サブミットスレッドに終了を要求したかどうか.
+    std::atomic<bool>           m_IsSubmitThreadSleeping;   //!< サブミットスレッドが要求待ちで眠っているかどうか.
+    std::mutex                  m_SleepMutex;       //!< サブミットスレッドの起床用のミューテックスです.
+    std::condition_variable     m_SleepCondition;   //!< サブミットスレッドの起床用の条件変数です.
+    std::atomic<uint32_t>       m_DrainWaiterCount; //!< 要求の処理を待機しているスレッド数です.
+    std::mutex                  m_DrainMutex;       //!< 要求の処理待ち用のミューテックスです.
+    std::condition_variable     m_DrainCondition;   //!< 要求の処理待ち用の条件変数です.
+
+#if ASVK_IS_TIMELINE_SEMAPHORE
+    PFN_vkGetSemaphoreCounterValueKHR   m_GetSemaphoreCounterValue;     //!< vkGetSemaphoreCounterValueKHR() の関数ポインタです.
+    PFN_vkWaitSemaphoresKHR             m_WaitSemaphoresFunc;           //!< vkWaitSemaphoresKHR() の関数ポインタです.
+    PFN_vkSignalSemaphoreKHR            m_SignalSemaphoreFunc;          //!< vkSignalSemaphoreKHR() の関数ポインタです.
+    std::vector<VkTimelineSemaphoreSubmitInfoKHR>   m_TimelineInfos;    //!< サブミット用の作業領域です(バッチごとのタイムライン値).
+#endif
 
     //=============================================================================================
     // private methods.
     //=============================================================================================
-    /* NOTHING */
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      チケットを付与してサブミットします(ロック済みであること).
+    //!
+    //! @param[in]      batch           サブミットするバッチです.
+    //! @param[in]      fence           サブミット完了時にシグナルするフェンスです.
+    //! @return     発行したチケットを返却します. 失敗した場合は 0 を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint64_t SubmitWithTicket(const SubmitBatch& batch, VkFence fence);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      サブミットに失敗したフェンスをシグナルさせます(ロック済みであること).
+    //---------------------------------------------------------------------------------------------
+    void SignalFence(VkFence fence);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      サブミットできなかったチケットを完了扱いにして進めます(ロック済みであること).
+    //!
+    //! @param[in]      ticket          進めるチケットです.
+    //! @note       タイムラインセマフォを使用している場合は, 待機側が止まらないようチケットの値までシグナルします.
+    //---------------------------------------------------------------------------------------------
+    void SkipTicket(uint64_t ticket);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      完了したフェンスを回収します(ロック済みであること).
+    //---------------------------------------------------------------------------------------------
+    void RetireFences();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      呼び出し側のフェンスとチケットの対応を外します(ロック済みであること).
+    //---------------------------------------------------------------------------------------------
+    void ReleaseFence(VkFence fence);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      完了済みチケットを更新します.
+    //---------------------------------------------------------------------------------------------
+    void UpdateCompletedTicket(uint64_t ticket);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      発行済みチケットを更新します.
+    //---------------------------------------------------------------------------------------------
+    void UpdateIssuedTicket(uint64_t ticket);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      表示します(サブミットスレッドまたはロック済みであること).
+    //---------------------------------------------------------------------------------------------
+    VkResult PresentCore(VkSwapchainKHR swapChain, uint32_t imageIndex, VkSemaphore waitSemaphore);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      要求キューの空きを確保します.
+    //!
+    //! @param[out]     pPosition       確保した位置の格納先です.
+    //! @return     書き込み先の要求を返却します. キューが一杯の場合は空くまで待機します.
+    //---------------------------------------------------------------------------------------------
+    Request* BeginRequest(uint64_t* pPosition);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      書き込んだ要求をサブミットスレッドに渡します.
+    //!
+    //! @param[in]      pRequest        BeginRequest() で確保した要求です.
+    //! @param[in]      position        BeginRequest() で確保した位置です.
+    //---------------------------------------------------------------------------------------------
+    void EndRequest(Request* pRequest, uint64_t position);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      サブミットスレッドが要求を処理し終えるまで待機します.
+    //!
+    //! @param[in]      position        待機する要求の位置です.
+    //! @note       スピンせずに眠り, サブミットスレッドが要求を処理するたびに起こされます.
+    //---------------------------------------------------------------------------------------------
+    void WaitRequest(uint64_t position);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      サブミットスレッドのメイン処理です.
+    //---------------------------------------------------------------------------------------------
+    void SubmitThreadMain();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      要求を処理します.
+    //!
+    //! @param[in]      request         処理する要求です.
+    //! @param[in]      ticket          要求の位置に対応するチケットです.
+    //---------------------------------------------------------------------------------------------
+    void ProcessRequest(Request& request, uint64_t ticket);
 };
 
 } // namespace asvk
@@ -9,6 +9,7 @@
 // Includes
 //-------------------------------------------------------------------------------------------------
 #include <asvkTypedef.h>
+#include <asvkAllocator.h>
 #include <vulkan/vulkan.h>
 
 
@@ -47,48 +48,36 @@ public:
     //---------------------------------------------------------------------------------------------
     //! @brief      初期化処理を行います.
     //!
-    //! @param[in]      device      デバイスです.
-    //! @param[in]      props       物理デバイスメモリプロパティです.
+    //! @param[in]      pAllocator  メモリアロケータです.
     //! @param[in]      pInfo       イメージ生成情報です.
+    //! @param[in]      propFlags   要求するメモリプロパティです.
     //! @retval true    初期化に成功.
     //! @retval false   初期化に失敗.
     //---------------------------------------------------------------------------------------------
     bool Init(
-        VkDevice                            device,
-        VkPhysicalDeviceMemoryProperties    props,
-        const VkImageCreateInfo*            pInfo);
+        MemoryAllocator*            pAllocator,
+        const VkImageCreateInfo*    pInfo,
+        VkMemoryPropertyFlags       propFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 
     //---------------------------------------------------------------------------------------------
     //! @brief      終了処理を行います.
-    //!
-    //! @param[in]      device      デバイスです.
     //---------------------------------------------------------------------------------------------
-    void Term(VkDevice device);
+    void Term();
 
     //---------------------------------------------------------------------------------------------
     //! @brief      マップします.
     //!
-    //! @param[in]      device      デバイスです.
-    //! @param[in]      offset      オフセットです.
-    //! @param[in]      size        サイズです.
-    //! @param[in]      flags       メモリマップフラグです.
+    //! @param[in]      offset      リソース先頭からのオフセットです.
     //! @param[out]     ppData      バッファポインタの格納先.
     //! @retval true    マップに成功.
     //! @retval false   マップに失敗.
     //---------------------------------------------------------------------------------------------
-    bool Map(
-        VkDevice            device,
-        VkDeviceSize        offset,
-        VkDeviceSize        size,
-        VkMemoryMapFlags    flags,
-        void**              ppData) const;
+    bool Map(VkDeviceSize offset, void** ppData) const;
 
     //---------------------------------------------------------------------------------------------
     //! @brief      アンマップします.
-    //!
-    //! @param[in]      device      デバイスです.
     //---------------------------------------------------------------------------------------------
-    void Unmap(VkDevice device) const;
+    void Unmap() const;
 
     //---------------------------------------------------------------------------------------------
     //! @brief      デバイスメモリを取得します.
@@ -97,6 +86,13 @@ public:
     //---------------------------------------------------------------------------------------------
     VkDeviceMemory GetMemory() const;
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デバイスメモリ先頭からのオフセットを取得します.
+    //!
+    //! @return     オフセットを返却します.
+    //---------------------------------------------------------------------------------------------
+    VkDeviceSize GetOffset() const;
+
     //---------------------------------------------------------------------------------------------
     //! @brief      イメージを取得します.
     //!
@@ -108,8 +104,9 @@ private:
     //=============================================================================================
     // private variables.
     //=============================================================================================
-    VkImage         m_Resource;     //!< イメージです.
-    VkDeviceMemory  m_Memory;       //!< デバイスメモリです.
+    VkImage             m_Resource;     //!< イメージです.
+    MemoryAllocator*    m_pAllocator;   //!< メモリアロケータです.
+    Allocation          m_Allocation;   //!< メモリ割り当てです.
 
     //=============================================================================================
     // private methods.
@@ -150,44 +147,36 @@ public:
     //---------------------------------------------------------------------------------------------
     //! @brief      初期化処理を行います.
     //!
-    //! @param[in]      device          デバイスです.
+    //! @param[in]      pAllocator      メモリアロケータです.
     //! @param[in]      pInfo           バッファ生成情報です.
+    //! @param[in]      propFlags       要求するメモリプロパティです.
     //! @retval true    初期化に成功.
     //! @retval false   初期化に失敗.
     //---------------------------------------------------------------------------------------------
-    bool Init(VkDevice device, const VkBufferCreateInfo* pInfo);
+    bool Init(
+        MemoryAllocator*            pAllocator,
+        const VkBufferCreateInfo*   pInfo,
+        VkMemoryPropertyFlags       propFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 
     //---------------------------------------------------------------------------------------------
     //! @brief      終了処理を行います.
-    //!
-    //! @param[in]      device          デバイスです.
     //---------------------------------------------------------------------------------------------
-    void Term(VkDevice device);
+    void Term();
 
     //---------------------------------------------------------------------------------------------
     //! @brief      マップします.
     //!
-    //! @param[in]      device          デバイスです.
-    //! @param[in]      offset          オフセットです.
-    //! @param[in]      size            サイズです.
-    //! @param[in]      flags           メモリマップフラグです.
+    //! @param[in]      offset          リソース先頭からのオフセットです.
     //! @param[out]     ppData          バッファポインタの格納先です.
     //! @retval true    マップに成功.
     //! @retval false   マップに失敗.
     //---------------------------------------------------------------------------------------------
-    bool Map(
-        VkDevice            device,
-        VkDeviceSize        offset,
-        VkDeviceSize        size,
-        VkMemoryMapFlags    flags,
-        void**              ppData) const;
+    bool Map(VkDeviceSize offset, void** ppData) const;
 
     //---------------------------------------------------------------------------------------------
     //! @brief      アンマップします.
-    //!
-    //! @param[in]      device          デバイスです.
     //---------------------------------------------------------------------------------------------
-    void Unmap(VkDevice device) const;
+    void Unmap() const;
 
     //---------------------------------------------------------------------------------------------
     //! @brief      デバイスメモリを取得します.
@@ -196,6 +185,13 @@ public:
     //---------------------------------------------------------------------------------------------
     VkDeviceMemory GetMemory() const;
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デバイスメモリ先頭からのオフセットを取得します.
+    //!
+    //! @return     オフセットを返却します.
+    //---------------------------------------------------------------------------------------------
+    VkDeviceSize GetOffset() const;
+
     //---------------------------------------------------------------------------------------------
     //! @brief      バッファを取得します.
     //!
@@ -207,8 +203,9 @@ private:
     //=============================================================================================
     // private variables.
     //=============================================================================================
-    VkBuffer        m_Resource;     //!< バッファです.
-    VkDeviceMemory  m_Memory;       //!< デバイスメモリです.
+    VkBuffer            m_Resource;     //!< バッファです.
+    MemoryAllocator*    m_pAllocator;   //!< メモリアロケータです.
+    Allocation          m_Allocation;   //!< メモリ割り当てです.
 
     //=============================================================================================
     // private methods.
@@ -0,0 +1,236 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asvkResourceState.h
+// Desc : Resource State Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asvkTypedef.h>
+#include <asvkResource.h>
+#include <vulkan/vulkan.h>
+#include <unordered_map>
+#include <vector>
+
+
+namespace asvk {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// ResourceUsage enum
+///////////////////////////////////////////////////////////////////////////////////////////////////
+enum ResourceUsage
+{
+    ResourceUsage_Undefined = 0,            //!< 未定義です(内容を破棄します).
+    ResourceUsage_ColorAttachment,          //!< カラーアタッチメントとして読み書きします.
+    ResourceUsage_DepthStencilAttachment,   //!< 深度ステンシルアタッチメントとして読み書きします.
+    ResourceUsage_DepthStencilRead,         //!< 読み取り専用の深度ステンシルとして使用します.
+    ResourceUsage_ShaderRead,               //!< フラグメントシェーダから読み取ります.
+    ResourceUsage_ComputeRead,              //!< コンピュートシェーダから読み取ります.
+    ResourceUsage_ComputeWrite,             //!< コンピュートシェーダから読み書きします.
+    ResourceUsage_TransferSrc,              //!< 転送元として使用します.
+    ResourceUsage_TransferDst,              //!< 転送先として使用します.
+    ResourceUsage_Present,                  //!< 表示に使用します.
+    ResourceUsage_VertexBuffer,             //!< 頂点バッファとして使用します.
+    ResourceUsage_IndexBuffer,              //!< インデックスバッファとして使用します.
+    ResourceUsage_UniformBuffer,            //!< 定数バッファとして使用します.
+    ResourceUsage_IndirectBuffer,           //!< 間接描画の引数バッファとして使用します.
+    ResourceUsage_HostRead,                 //!< CPUから読み取ります.
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// ResourceState structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct ResourceState
+{
+    VkImageLayout           Layout;     //!< イメージレイアウトです(バッファでは無視されます).
+    VkAccessFlags           Access;     //!< アクセスフラグです.
+    VkPipelineStageFlags    Stage;      //!< パイプラインステージです.
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ResourceState()
+    : Layout    (VK_IMAGE_LAYOUT_UNDEFINED)
+    , Access    (0)
+    , Stage     (VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT)
+    { /* DO_NOTHING */ }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      引数付きコンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ResourceState(VkImageLayout layout, VkAccessFlags access, VkPipelineStageFlags stage)
+    : Layout    (layout)
+    , Access    (access)
+    , Stage     (stage)
+    { /* DO_NOTHING */ }
+};
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      使用用途に対応するリソースステートを取得します.
+//!
+//! @param[in]      usage       使用用途です.
+//! @return     使用用途に対応するレイアウト・アクセスフラグ・パイプラインステージを返却します.
+//-------------------------------------------------------------------------------------------------
+ResourceState GetResourceState(ResourceUsage usage);
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// ResourceStateTracker class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class ResourceStateTracker : NonCopyable
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    //=============================================================================================
+    // public variables.
+    //=============================================================================================
+    /* NOTHING */
+
+    //=============================================================================================
+    // public methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ResourceStateTracker();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ~ResourceStateTracker();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      追跡中のステートと未発行のバリアを全て破棄します.
+    //---------------------------------------------------------------------------------------------
+    void Reset();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      イメージの現在のステートを設定します.
+    //!
+    //! @param[in]      image       イメージです.
+    //! @param[in]      state       現在のステートです.
+    //! @note       バリアは発行しません. 外部で遷移したイメージ(スワップチェインなど)の登録に使用します.
+    //!             登録されていないイメージは未定義レイアウトとして扱います.
+    //---------------------------------------------------------------------------------------------
+    void SetImageState(VkImage image, const ResourceState& state);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      バッファの現在のステートを設定します.
+    //!
+    //! @param[in]      buffer      バッファです.
+    //! @param[in]      state       現在のステートです.
+    //---------------------------------------------------------------------------------------------
+    void SetBufferState(VkBuffer buffer, const ResourceState& state);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      イメージの現在のステートを取得します.
+    //!
+    //! @param[in]      image       イメージです.
+    //! @param[out]     pState      ステートの格納先です.
+    //! @retval true    追跡中のイメージです.
+    //! @retval false   追跡していないイメージです.
+    //---------------------------------------------------------------------------------------------
+    bool GetImageState(VkImage image, ResourceState* pState) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      イメージの遷移を要求します.
+    //!
+    //! @param[in]      image       イメージです.
+    //! @param[in]      range       サブリソース範囲です.
+    //! @param[in]      usage       次の使用用途です.
+    //! @note       バリアは Flush() でまとめて発行されます.
+    //---------------------------------------------------------------------------------------------
+    void TransitionImage(VkImage image, const VkImageSubresourceRange& range, ResourceUsage usage);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      イメージの遷移を要求します.
+    //!
+    //! @param[in]      image       イメージです.
+    //! @param[in]      range       サブリソース範囲です.
+    //! @param[in]      state       次のステートです.
+    //---------------------------------------------------------------------------------------------
+    void TransitionImage(VkImage image, const VkImageSubresourceRange& range, const ResourceState& state);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      イメージリソースの遷移を要求します.
+    //!
+    //! @param[in]      resource    イメージリソースです.
+    //! @param[in]      range       サブリソース範囲です.
+    //! @param[in]      usage       次の使用用途です.
+    //---------------------------------------------------------------------------------------------
+    void TransitionImage(const ImageResource& resource, const VkImageSubresourceRange& range, ResourceUsage usage);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      バッファの遷移を要求します.
+    //!
+    //! @param[in]      buffer      バッファです.
+    //! @param[in]      usage       次の使用用途です.
+    //---------------------------------------------------------------------------------------------
+    void TransitionBuffer(VkBuffer buffer, ResourceUsage usage);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      バッファの遷移を要求します.
+    //!
+    //! @param[in]      buffer      バッファです.
+    //! @param[in]      state       次のステートです.
+    //---------------------------------------------------------------------------------------------
+    void TransitionBuffer(VkBuffer buffer, const ResourceState& state);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      バッファリソースの遷移を要求します.
+    //!
+    //! @param[in]      resource    バッファリソースです.
+    //! @param[in]      usage       次の使用用途です.
+    //---------------------------------------------------------------------------------------------
+    void TransitionBuffer(const BufferResource& resource, ResourceUsage usage);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      未発行のバリアを1回の vkCmdPipelineBarrier() にまとめて発行します.
+    //!
+    //! @param[in]      commandBuffer   コマンドバッファです.
+    //---------------------------------------------------------------------------------------------
+    void Flush(VkCommandBuffer commandBuffer);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      未発行のバリアがあるかどうかチェックします.
+    //!
+    //! @retval true    未発行のバリアがあります.
+    //! @retval false   未発行のバリアはありません.
+    //---------------------------------------------------------------------------------------------
+    bool HasPending() const;
+
+private:
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Entry structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct Entry
+    {
+        ResourceState   State;          //!< 現在のステートです.
+        int             PendingIndex;   //!< 未発行バリアの番号です(無ければ -1).
+    };
+
+    //=============================================================================================
+    // private variables.
+    //=============================================================================================
+    std::unordered_map<VkImage,  Entry>     m_Images;           //!< イメージのステートです.
+    std::unordered_map<VkBuffer, Entry>     m_Buffers;          //!< バッファのステートです.
+    std::vector<VkImageMemoryBarrier>       m_ImageBarriers;    //!< 未発行のイメージバリアです.
+    std::vector<VkBufferMemoryBarrier>      m_BufferBarriers;   //!< 未発行のバッファバリアです.
+    VkPipelineStageFlags                    m_SrcStageMask;     //!< 未発行バリアの転送元ステージです.
+    VkPipelineStageFlags                    m_DstStageMask;     //!< 未発行バリアの転送先ステージです.
+
+    //=============================================================================================
+    // private methods.
+    //=============================================================================================
+    /* NOTHING */
+};
+
+} // namespace asvk
@@ -11,11 +11,22 @@
 #include <asvkTypedef.h>
 #include <asvkDevice.h>
 #include <asvkCommandList.h>
+#include <atomic>
 #include <vector>
 
 
 namespace asvk {
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// PresentPolicy enum
+///////////////////////////////////////////////////////////////////////////////////////////////////
+enum PresentPolicy
+{
+    PresentPolicy_LowLatency = 0,   //!< ティアリングなしで遅延を最小にします(MAILBOX優先, 同時処理1フレーム).
+    PresentPolicy_Throughput,       //!< フレームレートを最大にします(IMMEDIATE優先, 同時処理2フレーム以上).
+    PresentPolicy_PowerSaving,      //!< 垂直同期で消費電力を抑えます(FIFO, 最小イメージ数).
+};
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // SwapChainDesc structure
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -25,7 +36,8 @@ struct SwapChainDesc
     uint32_t        Height;         //!< 縦幅です.
     VkFormat        Format;         //!< フォーマットです.
     VkColorSpaceKHR ColorSpace;     //!< カラースペースです.
-    uint32_t        BufferCount;    //!< スワップチェイン数です.
+    uint32_t        BufferCount;    //!< スワップチェイン数です. 0 の場合はポリシーから決定します.
+    PresentPolicy   Policy;         //!< 表示ポリシーです.
     HINSTANCE       hInstance;      //!< インスタンスハンドルです
     HWND            hWnd;           //!< ウィンドウハンドルです.
 };
@@ -77,6 +89,8 @@ public:
     //! @param[in]      pDesc           スワップチェインの設定です.
     //! @retval true    初期化に成功.
     //! @retval false   初期化に失敗.
+    //! @note       表示モードとイメージ数はサーフェイスの能力とポリシーから決定します.
+    //!             決定した値は GetDesc(), GetPresentMode(), GetFrameLatency() で取得できます.
     //---------------------------------------------------------------------------------------------
     bool Init(DeviceMgr* pDeviceMgr, VkCommandBuffer commandBuffer, const SwapChainDesc* pDesc);
 
@@ -85,12 +99,35 @@ public:
     //---------------------------------------------------------------------------------------------
     void Term(DeviceMgr* pDevice);
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      サイズを変更します.
+    //!
+    //! @param[in]      commandBuffer   レイアウト遷移を積むコマンドバッファです.
+    //! @param[in]      width           横幅です.
+    //! @param[in]      height          縦幅です.
+    //! @retval true    再生成に成功.
+    //! @retval false   再生成に失敗，または最小化中のため見送り.
+    //! @note       サーフェイスは再利用し，旧スワップチェインを引き継いで再生成します.
+    //!             呼び出し前にイメージを参照するGPU処理が完了している必要があります.
+    //---------------------------------------------------------------------------------------------
+    bool Resize(VkCommandBuffer commandBuffer, uint32_t width, uint32_t height);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      次に描画するイメージを取得します.
+    //!
+    //! @param[in]      semaphore       イメージが利用可能になった時にシグナルするセマフォです.
+    //! @param[in]      timeout         タイムアウト時間です(ナノ秒単位).
+    //! @retval true    取得に成功.
+    //! @retval false   取得に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool AcquireNextImage(VkSemaphore semaphore, uint64_t timeout);
+
     //---------------------------------------------------------------------------------------------
     //! @brief      表示します.
     //!
-    //! @param[in]      timeout         タイムアウト時間()
+    //! @param[in]      waitSemaphore   表示前に待機するセマフォです(描画完了のセマフォ).
     //---------------------------------------------------------------------------------------------
-    void Present(uint64_t timeout);
+    void Present(VkSemaphore waitSemaphore);
 
     //---------------------------------------------------------------------------------------------
     //! @brief      バッファ番号を取得します.
@@ -113,13 +150,6 @@ public:
     //---------------------------------------------------------------------------------------------
     VkSurfaceKHR GetSurface() const;
 
-    //---------------------------------------------------------------------------------------------
-    //! @brief      セマフォを取得します.
-    //!
-    //! @return     セマフォを返却します.
-    //---------------------------------------------------------------------------------------------
-    VkSemaphore GetSemaphore() const;
-
     //---------------------------------------------------------------------------------------------
     //! @brief      バッファを取得します.
     //!
@@ -149,6 +179,28 @@ public:
     //---------------------------------------------------------------------------------------------
     const SwapChainDesc& GetDesc() const;
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      再生成が必要かどうかチェックします.
+    //!
+    //! @retval true    VK_ERROR_OUT_OF_DATE_KHR または VK_SUBOPTIMAL_KHR を受け取ったため再生成が必要です.
+    //! @retval false   再生成は不要です.
+    //---------------------------------------------------------------------------------------------
+    bool IsOutOfDate() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      選択された表示モードを取得します.
+    //!
+    //! @return     選択された表示モードを返却します.
+    //---------------------------------------------------------------------------------------------
+    VkPresentModeKHR GetPresentMode() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ポリシーに見合った同時処理フレーム数を取得します.
+    //!
+    //! @return     ポリシーに見合った同時処理フレーム数を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t GetFrameLatency() const;
+
 private:
     //=============================================================================================
     // private variables.
@@ -158,15 +210,28 @@ private:
     VkSurfaceKHR            m_Surface;          //!< サーフェイスです.
     VkSwapchainKHR          m_SwapChain;        //!< スワップチェインです.
     VkDevice                m_Device;           //!< デバイスです.
-    VkSemaphore             m_Semaphore;        //!< セマフォです.
     Queue*                  m_pQueue;           //!< キューへのポインタです.
     VkImageSubresourceRange m_Range;            //!< イメージサブリソースレンジです.
     SwapChainDesc           m_Desc;             //!< 構成設定です.
+    VkPhysicalDevice        m_Gpu;              //!< 物理デバイスです.
+    VkSurfaceTransformFlagBitsKHR m_PreTransform;   //!< プレトランスフォームです.
+    VkPresentModeKHR        m_PresentMode;      //!< 表示モードです.
+    bool                    m_IsOutOfDate;      //!< 再生成が必要かどうか.
+    std::atomic<int32_t>    m_PresentResult;    //!< 表示結果です. サブミットスレッド使用時は後から書き込まれます.
+    uint32_t                m_FrameLatency;     //!< ポリシーに見合った同時処理フレーム数です.
 
     //=============================================================================================
     // private methods.
     //=============================================================================================
-    /* NOTHING */
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      スワップチェインを生成します.
+    //!
+    //! @param[in]      commandBuffer   レイアウト遷移を積むコマンドバッファです.
+    //! @retval true    生成に成功.
+    //! @retval false   生成に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool CreateSwapChain(VkCommandBuffer commandBuffer);
 };
 
 } // namespace asvk
@@ -0,0 +1,211 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asvkTarget.h
+// Desc : Render Target Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asvkRenderBuffer.h>
+
+
+namespace asvk {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// OffscreenTargetDesc structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct OffscreenTargetDesc
+{
+    uint32_t    Width;          //!< 横幅です.
+    uint32_t    Height;         //!< 縦幅です.
+    VkFormat    ColorFormat;    //!< カラーフォーマットです.
+    VkFormat    DepthFormat;    //!< 深度フォーマットです. VK_FORMAT_UNDEFINED の場合は深度バッファを生成しません.
+    bool        Readback;       //!< CPUへの読み戻し用バッファを生成する場合は true を指定します.
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    OffscreenTargetDesc()
+    : Width         (0)
+    , Height        (0)
+    , ColorFormat   (VK_FORMAT_R8G8B8A8_UNORM)
+    , DepthFormat   (VK_FORMAT_UNDEFINED)
+    , Readback      (true)
+    { /* DO_NOTHING */ }
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// OffscreenTarget class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class OffscreenTarget : NonCopyable
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    //=============================================================================================
+    // public variables.
+    //=============================================================================================
+    /* NOTHING */
+
+    //=============================================================================================
+    // public methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    OffscreenTarget();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ~OffscreenTarget();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      初期化処理を行います.
+    //!
+    //! @param[in]      pDeviceMgr      デバイスマネージャです.
+    //! @param[in]      commandBuffer   イメージレイアウト設定を記録するコマンドバッファです.
+    //! @param[in]      pDesc           構成設定です.
+    //! @retval true    初期化に成功.
+    //! @retval false   初期化に失敗.
+    //! @note       スワップチェインを必要としないため, ヘッドレスモードのデバイスでも使用できます.
+    //---------------------------------------------------------------------------------------------
+    bool Init(
+        DeviceMgr*                  pDeviceMgr,
+        VkCommandBuffer             commandBuffer,
+        const OffscreenTargetDesc*  pDesc);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      終了処理を行います.
+    //!
+    //! @param[in]      pDeviceMgr      デバイスマネージャです.
+    //---------------------------------------------------------------------------------------------
+    void Term(DeviceMgr* pDeviceMgr);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      レンダーパスを開始します.
+    //!
+    //! @param[in]      commandBuffer   コマンドバッファです.
+    //! @param[in]      clearColor      クリアカラーです.
+    //! @param[in]      clearDepth      クリア深度です.
+    //! @param[in]      clearStencil    クリアステンシルです.
+    //---------------------------------------------------------------------------------------------
+    void Begin(
+        VkCommandBuffer             commandBuffer,
+        const VkClearColorValue&    clearColor,
+        float                       clearDepth   = 1.0f,
+        uint32_t                    clearStencil = 0);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      レンダーパスを終了します.
+    //!
+    //! @param[in]      commandBuffer   コマンドバッファです.
+    //---------------------------------------------------------------------------------------------
+    void End(VkCommandBuffer commandBuffer);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      カラーバッファを読み戻し用バッファにコピーするコマンドを記録します.
+    //!
+    //! @param[in]      commandBuffer   コマンドバッファです.
+    //! @note       レンダーパスの外で呼び出してください. 実行完了後に MapReadback() で参照できます.
+    //---------------------------------------------------------------------------------------------
+    void Readback(VkCommandBuffer commandBuffer);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      読み戻し用バッファをマップします.
+    //!
+    //! @param[out]     ppData          ピクセルデータの格納先です.
+    //! @retval true    マップに成功.
+    //! @retval false   マップに失敗.
+    //---------------------------------------------------------------------------------------------
+    bool MapReadback(void** ppData) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      読み戻し用バッファをアンマップします.
+    //---------------------------------------------------------------------------------------------
+    void UnmapReadback() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      読み戻し用バッファの行ピッチを取得します.
+    //!
+    //! @return     行ピッチ(バイト数)を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t GetReadbackRowPitch() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      構成設定を取得します.
+    //!
+    //! @return     構成設定を返却します.
+    //---------------------------------------------------------------------------------------------
+    const OffscreenTargetDesc& GetDesc() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      カラーバッファを取得します.
+    //!
+    //! @return     カラーバッファを返却します.
+    //---------------------------------------------------------------------------------------------
+    RenderBuffer* GetColorBuffer();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      深度バッファを取得します.
+    //!
+    //! @return     深度バッファを返却します. 深度バッファが無い場合は nullptr を返却します.
+    //---------------------------------------------------------------------------------------------
+    RenderBuffer* GetDepthBuffer();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      レンダーパスを取得します.
+    //!
+    //! @return     レンダーパスを返却します.
+    //---------------------------------------------------------------------------------------------
+    VkRenderPass GetRenderPass() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      フレームバッファを取得します.
+    //!
+    //! @return     フレームバッファを返却します.
+    //---------------------------------------------------------------------------------------------
+    VkFramebuffer GetFrameBuffer() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ビューポートを取得します.
+    //!
+    //! @return     ビューポートを返却します.
+    //---------------------------------------------------------------------------------------------
+    const VkViewport& GetViewport() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      シザー矩形を取得します.
+    //!
+    //! @return     シザー矩形を返却します.
+    //---------------------------------------------------------------------------------------------
+    const VkRect2D& GetScissor() const;
+
+private:
+    //=============================================================================================
+    // private variables.
+    //=============================================================================================
+    OffscreenTargetDesc     m_Desc;             //!< 構成設定です.
+    RenderBuffer            m_ColorBuffer;      //!< カラーバッファです.
+    RenderBuffer            m_DepthBuffer;      //!< 深度バッファです.
+    BufferResource          m_ReadbackBuffer;   //!< 読み戻し用バッファです.
+    VkRenderPass            m_RenderPass;       //!< レンダーパスです.
+    VkFramebuffer           m_FrameBuffer;      //!< フレームバッファです.
+    VkViewport              m_Viewport;         //!< ビューポートです.
+    VkRect2D                m_Scissor;          //!< シザー矩形です.
+    uint32_t                m_RowPitch;         //!< 読み戻し用バッファの行ピッチです.
+
+    //=============================================================================================
+    // private methods.
+    //=============================================================================================
+    /* NOTHING */
+};
+
+} // namespace asvk
@@ -143,7 +143,7 @@
 
 
 #if defined(_M_IX86) || defined(_M_AMD64)
-  #if defined(_M_IX86_FP)
+  #if defined(_M_AMD64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
     #define ASVK_IS_SSE2   (1)     // SSE2有効.
     #define ASVK_IS_NEON   (0)     // NEON無効.
   #else
@@ -153,6 +153,9 @@
 #elif defined(_M_ARM)
     #define ASVK_IS_SSE2   (0)     // SSE2無効.
     #define ASVK_IS_NEON   (1)     // NEON有効.
+#elif defined(__SSE2__)
+    #define ASVK_IS_SSE2   (1)     // SSE2有効.
+    #define ASVK_IS_NEON   (0)     // NEON無効.
 #else
     #define ASVK_IS_SSE2   (0)     // SSE2無効.
     #define ASVK_IS_NEON   (0)     // NEON無効.
@@ -7,6 +7,283 @@
 
 namespace asvk {
 
+#if ASVK_IS_SIMD && ASVK_IS_SSE2
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// SIMD Functions
+///////////////////////////////////////////////////////////////////////////////////////////////////
+namespace detail {
+
+//-------------------------------------------------------------------------------------------------
+//      符号ビットマスクを生成します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+__m128 SignMask( bool x, bool y, bool z, bool w )
+{
+    return _mm_castsi128_ps( _mm_set_epi32(
+        w ? INT_MIN : 0,
+        z ? INT_MIN : 0,
+        y ? INT_MIN : 0,
+        x ? INT_MIN : 0 ) );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      行ベクトルと行列を乗算します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+__m128 TransformRow( __m128 v, __m128 r0, __m128 r1, __m128 r2, __m128 r3 )
+{
+    // スカラー版と同じ加算順序 ((x*r0 + y*r1) + z*r2) + w*r3 を保つため結果はビット単位で一致する.
+    auto result = _mm_mul_ps( _mm_shuffle_ps( v, v, _MM_SHUFFLE(0, 0, 0, 0) ), r0 );
+    result = _mm_add_ps( result, _mm_mul_ps( _mm_shuffle_ps( v, v, _MM_SHUFFLE(1, 1, 1, 1) ), r1 ) );
+    result = _mm_add_ps( result, _mm_mul_ps( _mm_shuffle_ps( v, v, _MM_SHUFFLE(2, 2, 2, 2) ), r2 ) );
+    result = _mm_add_ps( result, _mm_mul_ps( _mm_shuffle_ps( v, v, _MM_SHUFFLE(3, 3, 3, 3) ), r3 ) );
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      行列同士を乗算します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void MultiplyMatrix( const float* a, const float* b, float* result )
+{
+    // result が a または b と同じ場合に備えて, 書き込み前に全て読み込む.
+#if ASVK_IS_AVX
+    auto b0  = _mm256_broadcast_ps( reinterpret_cast<const __m128*>( b + 0  ) );
+    auto b1  = _mm256_broadcast_ps( reinterpret_cast<const __m128*>( b + 4  ) );
+    auto b2  = _mm256_broadcast_ps( reinterpret_cast<const __m128*>( b + 8  ) );
+    auto b3  = _mm256_broadcast_ps( reinterpret_cast<const __m128*>( b + 12 ) );
+    auto a01 = _mm256_loadu_ps( a + 0 );
+    auto a23 = _mm256_loadu_ps( a + 8 );
+
+    auto r01 = _mm256_mul_ps( _mm256_shuffle_ps( a01, a01, _MM_SHUFFLE(0, 0, 0, 0) ), b0 );
+    r01 = _mm256_add_ps( r01, _mm256_mul_ps( _mm256_shuffle_ps( a01, a01, _MM_SHUFFLE(1, 1, 1, 1) ), b1 ) );
+    r01 = _mm256_add_ps( r01, _mm256_mul_ps( _mm256_shuffle_ps( a01, a01, _MM_SHUFFLE(2, 2, 2, 2) ), b2 ) );
+    r01 = _mm256_add_ps( r01, _mm256_mul_ps( _mm256_shuffle_ps( a01, a01, _MM_SHUFFLE(3, 3, 3, 3) ), b3 ) );
+
+    auto r23 = _mm256_mul_ps( _mm256_shuffle_ps( a23, a23, _MM_SHUFFLE(0, 0, 0, 0) ), b0 );
+    r23 = _mm256_add_ps( r23, _mm256_mul_ps( _mm256_shuffle_ps( a23, a23, _MM_SHUFFLE(1, 1, 1, 1) ), b1 ) );
+    r23 = _mm256_add_ps( r23, _mm256_mul_ps( _mm256_shuffle_ps( a23, a23, _MM_SHUFFLE(2, 2, 2, 2) ), b2 ) );
+    r23 = _mm256_add_ps( r23, _mm256_mul_ps( _mm256_shuffle_ps( a23, a23, _MM_SHUFFLE(3, 3, 3, 3) ), b3 ) );
+
+    _mm256_storeu_ps( result + 0, r01 );
+    _mm256_storeu_ps( result + 8, r23 );
+#else
+    auto b0 = _mm_loadu_ps( b + 0  );
+    auto b1 = _mm_loadu_ps( b + 4  );
+    auto b2 = _mm_loadu_ps( b + 8  );
+    auto b3 = _mm_loadu_ps( b + 12 );
+    auto a0 = _mm_loadu_ps( a + 0  );
+    auto a1 = _mm_loadu_ps( a + 4  );
+    auto a2 = _mm_loadu_ps( a + 8  );
+    auto a3 = _mm_loadu_ps( a + 12 );
+
+    _mm_storeu_ps( result + 0,  TransformRow( a0, b0, b1, b2, b3 ) );
+    _mm_storeu_ps( result + 4,  TransformRow( a1, b0, b1, b2, b3 ) );
+    _mm_storeu_ps( result + 8,  TransformRow( a2, b0, b1, b2, b3 ) );
+    _mm_storeu_ps( result + 12, TransformRow( a3, b0, b1, b2, b3 ) );
+#endif
+}
+
+//-------------------------------------------------------------------------------------------------
+//      2x2行列同士を乗算します ( A * B ).
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+__m128 Mat2Mul( __m128 a, __m128 b )
+{
+    return _mm_add_ps(
+        _mm_mul_ps( a, _mm_shuffle_ps( b, b, _MM_SHUFFLE(3, 0, 3, 0) ) ),
+        _mm_mul_ps( _mm_shuffle_ps( a, a, _MM_SHUFFLE(2, 3, 0, 1) ), _mm_shuffle_ps( b, b, _MM_SHUFFLE(1, 2, 1, 2) ) ) );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      2x2行列の余因子行列と乗算します ( adj(A) * B ).
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+__m128 Mat2AdjMul( __m128 a, __m128 b )
+{
+    return _mm_sub_ps(
+        _mm_mul_ps( _mm_shuffle_ps( a, a, _MM_SHUFFLE(0, 0, 3, 3) ), b ),
+        _mm_mul_ps( _mm_shuffle_ps( a, a, _MM_SHUFFLE(2, 2, 1, 1) ), _mm_shuffle_ps( b, b, _MM_SHUFFLE(1, 0, 3, 2) ) ) );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      2x2行列を余因子行列と乗算します ( A * adj(B) ).
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+__m128 Mat2MulAdj( __m128 a, __m128 b )
+{
+    return _mm_sub_ps(
+        _mm_mul_ps( a, _mm_shuffle_ps( b, b, _MM_SHUFFLE(0, 3, 0, 3) ) ),
+        _mm_mul_ps( _mm_shuffle_ps( a, a, _MM_SHUFFLE(2, 3, 0, 1) ), _mm_shuffle_ps( b, b, _MM_SHUFFLE(1, 2, 1, 2) ) ) );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      逆行列を求めます.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void InvertMatrix( const float* value, float* result )
+{
+    // 2x2 ブロック行列に分割して余因子展開を行う.
+    // 加算順序がスカラー版と異なるため, 結果は許容誤差の範囲で一致する.
+    auto r0 = _mm_loadu_ps( value + 0  );
+    auto r1 = _mm_loadu_ps( value + 4  );
+    auto r2 = _mm_loadu_ps( value + 8  );
+    auto r3 = _mm_loadu_ps( value + 12 );
+
+    auto A = _mm_movelh_ps( r0, r1 );
+    auto B = _mm_movehl_ps( r1, r0 );
+    auto C = _mm_movelh_ps( r2, r3 );
+    auto D = _mm_movehl_ps( r3, r2 );
+
+    // ( |A|, |B|, |C|, |D| )
+    auto detSub = _mm_sub_ps(
+        _mm_mul_ps( _mm_shuffle_ps( r0, r2, _MM_SHUFFLE(2, 0, 2, 0) ), _mm_shuffle_ps( r1, r3, _MM_SHUFFLE(3, 1, 3, 1) ) ),
+        _mm_mul_ps( _mm_shuffle_ps( r0, r2, _MM_SHUFFLE(3, 1, 3, 1) ), _mm_shuffle_ps( r1, r3, _MM_SHUFFLE(2, 0, 2, 0) ) ) );
+    auto detA = _mm_shuffle_ps( detSub, detSub, _MM_SHUFFLE(0, 0, 0, 0) );
+    auto detB = _mm_shuffle_ps( detSub, detSub, _MM_SHUFFLE(1, 1, 1, 1) );
+    auto detC = _mm_shuffle_ps( detSub, detSub, _MM_SHUFFLE(2, 2, 2, 2) );
+    auto detD = _mm_shuffle_ps( detSub, detSub, _MM_SHUFFLE(3, 3, 3, 3) );
+
+    auto DC = Mat2AdjMul( D, C );
+    auto AB = Mat2AdjMul( A, B );
+    auto X  = _mm_sub_ps( _mm_mul_ps( detD, A ), Mat2Mul( B, DC ) );
+    auto W  = _mm_sub_ps( _mm_mul_ps( detA, D ), Mat2Mul( C, AB ) );
+    auto Y  = _mm_sub_ps( _mm_mul_ps( detB, C ), Mat2MulAdj( D, AB ) );
+    auto Z  = _mm_sub_ps( _mm_mul_ps( detC, B ), Mat2MulAdj( A, DC ) );
+
+    // |M| = |A||D| + |B||C| - tr( adj(A)B adj(D)C )
+    auto det = _mm_add_ps( _mm_mul_ps( detA, detD ), _mm_mul_ps( detB, detC ) );
+    auto tr  = _mm_mul_ps( AB, _mm_shuffle_ps( DC, DC, _MM_SHUFFLE(3, 1, 2, 0) ) );
+    tr  = _mm_add_ps( tr, _mm_shuffle_ps( tr, tr, _MM_SHUFFLE(2, 3, 0, 1) ) );
+    tr  = _mm_add_ps( tr, _mm_shuffle_ps( tr, tr, _MM_SHUFFLE(1, 0, 3, 2) ) );
+    det = _mm_sub_ps( det, tr );
+
+    auto rcpDet = _mm_div_ps( _mm_setr_ps( 1.0f, -1.0f, -1.0f, 1.0f ), det );
+    X = _mm_mul_ps( X, rcpDet );
+    Y = _mm_mul_ps( Y, rcpDet );
+    Z = _mm_mul_ps( Z, rcpDet );
+    W = _mm_mul_ps( W, rcpDet );
+
+    _mm_storeu_ps( result + 0,  _mm_shuffle_ps( X, Y, _MM_SHUFFLE(1, 3, 1, 3) ) );
+    _mm_storeu_ps( result + 4,  _mm_shuffle_ps( X, Y, _MM_SHUFFLE(0, 2, 0, 2) ) );
+    _mm_storeu_ps( result + 8,  _mm_shuffle_ps( Z, W, _MM_SHUFFLE(1, 3, 1, 3) ) );
+    _mm_storeu_ps( result + 12, _mm_shuffle_ps( Z, W, _MM_SHUFFLE(0, 2, 0, 2) ) );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      四元数同士を乗算します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+__m128 MultiplyQuaternion( __m128 a, __m128 b )
+{
+    // 各項をスカラー版と同じ順序で加算するため結果はビット単位で一致する.
+    auto t0 = _mm_mul_ps( b, _mm_shuffle_ps( a, a, _MM_SHUFFLE(3, 3, 3, 3) ) );
+    auto t1 = _mm_mul_ps( _mm_shuffle_ps( a, a, _MM_SHUFFLE(0, 2, 1, 0) ), _mm_shuffle_ps( b, b, _MM_SHUFFLE(0, 3, 3, 3) ) );
+    auto t2 = _mm_mul_ps( _mm_shuffle_ps( b, b, _MM_SHUFFLE(1, 0, 2, 1) ), _mm_shuffle_ps( a, a, _MM_SHUFFLE(1, 1, 0, 2) ) );
+    auto t3 = _mm_mul_ps( _mm_shuffle_ps( b, b, _MM_SHUFFLE(2, 1, 0, 2) ), _mm_shuffle_ps( a, a, _MM_SHUFFLE(2, 0, 2, 1) ) );
+
+    auto result = _mm_add_ps( t0, _mm_xor_ps( t1, SignMask( false, false, false, true ) ) );
+    result = _mm_add_ps( result, _mm_xor_ps( t2, SignMask( false, false, false, true ) ) );
+    result = _mm_sub_ps( result, t3 );
+    return result;
+}
+
+} // namespace detail
+#endif//ASVK_IS_SIMD && ASVK_IS_SSE2
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Scalar Functions
+///////////////////////////////////////////////////////////////////////////////////////////////////
+namespace scalar {
+
+//-------------------------------------------------------------------------------------------------
+//      行ベクトルと行列を乗算します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void TransformRow( const float* v, const float* m, float* result )
+{
+    // SIMD版と同じ加算順序 ((x*r0 + y*r1) + z*r2) + w*r3 で計算するため結果はビット単位で一致する.
+    auto x = v[0];
+    auto y = v[1];
+    auto z = v[2];
+    auto w = v[3];
+    result[0] = ( ( ((x * m[0]) + (y * m[4])) + (z * m[ 8]) ) + (w * m[12]));
+    result[1] = ( ( ((x * m[1]) + (y * m[5])) + (z * m[ 9]) ) + (w * m[13]));
+    result[2] = ( ( ((x * m[2]) + (y * m[6])) + (z * m[10]) ) + (w * m[14]));
+    result[3] = ( ( ((x * m[3]) + (y * m[7])) + (z * m[11]) ) + (w * m[15]));
+}
+
+//-------------------------------------------------------------------------------------------------
+//      行列同士を乗算します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void MultiplyMatrix( const float* a, const float* b, float* result )
+{
+    // result が a または b と同じ場合に備えて, 一時領域で計算してから書き込む.
+    float temp[16];
+    TransformRow( a + 0,  b, temp + 0  );
+    TransformRow( a + 4,  b, temp + 4  );
+    TransformRow( a + 8,  b, temp + 8  );
+    TransformRow( a + 12, b, temp + 12 );
+    memcpy( result, temp, sizeof(temp) );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      逆行列を求めます.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void InvertMatrix( const float* value, float* result )
+{
+    // 余因子展開で求める. SIMD版とは加算順序が異なるため, 結果は誤差の範囲で一致する.
+    auto _11 = value[ 0]; auto _12 = value[ 1]; auto _13 = value[ 2]; auto _14 = value[ 3];
+    auto _21 = value[ 4]; auto _22 = value[ 5]; auto _23 = value[ 6]; auto _24 = value[ 7];
+    auto _31 = value[ 8]; auto _32 = value[ 9]; auto _33 = value[10]; auto _34 = value[11];
+    auto _41 = value[12]; auto _42 = value[13]; auto _43 = value[14]; auto _44 = value[15];
+
+    float m[16];
+    m[ 0] = _22*_33*_44 + _23*_34*_42 + _24*_32*_43 - _22*_34*_43 - _23*_32*_44 - _24*_33*_42;
+    m[ 1] = _12*_34*_43 + _13*_32*_44 + _14*_33*_42 - _12*_33*_44 - _13*_34*_42 - _14*_32*_43;
+    m[ 2] = _12*_23*_44 + _13*_24*_42 + _14*_22*_43 - _12*_24*_43 - _13*_22*_44 - _14*_23*_42;
+    m[ 3] = _12*_24*_33 + _13*_22*_34 + _14*_23*_32 - _12*_23*_34 - _13*_24*_32 - _14*_22*_33;
+
+    m[ 4] = _21*_34*_43 + _23*_31*_44 + _24*_33*_41 - _21*_33*_44 - _23*_34*_41 - _24*_31*_43;
+    m[ 5] = _11*_33*_44 + _13*_34*_41 + _14*_31*_43 - _11*_34*_43 - _13*_31*_44 - _14*_33*_41;
+    m[ 6] = _11*_24*_43 + _13*_21*_44 + _14*_23*_41 - _11*_23*_44 - _13*_24*_41 - _14*_21*_43;
+    m[ 7] = _11*_23*_34 + _13*_24*_31 + _14*_21*_33 - _11*_24*_33 - _13*_21*_34 - _14*_23*_31;
+
+    m[ 8] = _21*_32*_44 + _22*_34*_41 + _24*_31*_42 - _21*_34*_42 - _22*_31*_44 - _24*_32*_41;
+    m[ 9] = _11*_34*_42 + _12*_31*_44 + _14*_32*_41 - _11*_32*_44 - _12*_34*_41 - _14*_31*_42;
+    m[10] = _11*_22*_44 + _12*_24*_41 + _14*_21*_42 - _11*_24*_42 - _12*_21*_44 - _14*_22*_41;
+    m[11] = _11*_24*_32 + _12*_21*_34 + _14*_22*_31 - _11*_22*_34 - _12*_24*_31 - _14*_21*_32;
+
+    m[12] = _21*_33*_42 + _22*_31*_43 + _23*_32*_41 - _21*_32*_43 - _22*_33*_41 - _23*_31*_42;
+    m[13] = _11*_32*_43 + _12*_33*_41 + _13*_31*_42 - _11*_33*_42 - _12*_31*_43 - _13*_32*_41;
+    m[14] = _11*_23*_42 + _12*_21*_43 + _13*_22*_41 - _11*_22*_43 - _12*_23*_41 - _13*_21*_42;
+    m[15] = _11*_22*_33 + _12*_23*_31 + _13*_21*_32 - _11*_23*_32 - _12*_21*_33 - _13*_22*_31;
+
+    // 1行目と余因子の1列目から行列式を求める.
+    auto det = _11 * m[0] + _12 * m[4] + _13 * m[8] + _14 * m[12];
+    for( auto i=0; i<16; ++i )
+    { result[i] = m[i] / det; }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      四元数同士を乗算します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void MultiplyQuaternion( const float* a, const float* b, float* result )
+{
+    // SIMD版と同じ順序で加算するため結果はビット単位で一致する.
+    auto ax = a[0]; auto ay = a[1]; auto az = a[2]; auto aw = a[3];
+    auto bx = b[0]; auto by = b[1]; auto bz = b[2]; auto bw = b[3];
+    result[0] = ( bx * aw ) + ( ax * bw ) + ( by * az ) - ( bz * ay );
+    result[1] = ( by * aw ) + ( ay * bw ) + ( bz * ax ) - ( bx * az );
+    result[2] = ( bz * aw ) + ( az * bw ) + ( bx * ay ) - ( by * ax );
+    result[3] = ( bw * aw ) - ( bx * ax ) - ( by * ay ) - ( bz * az );
+}
+
+} // namespace scalar
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // Functions
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -3032,11 +3309,15 @@ void Vector4::SmoothStep( const Vector4 &a, const Vector4 &b, float amount, Vect
 ASVK_INLINE
 Vector4 Vector4::Transform( const Vector4& position, const Matrix& matrix )
 {
-    return Vector4(
-        ( ( ((position.x * matrix._11) + (position.y * matrix._21)) + (position.z * matrix._31) ) + (position.w * matrix._41)),
-        ( ( ((position.x * matrix._12) + (position.y * matrix._22)) + (position.z * matrix._32) ) + (position.w * matrix._42)),
-        ( ( ((position.x * matrix._13) + (position.y * matrix._23)) + (position.z * matrix._33) ) + (position.w * matrix._43)),
-        ( ( ((position.x * matrix._14) + (position.y * matrix._24)) + (position.z * matrix._34) ) + (position.w * matrix._44)) );
+#if ASVK_IS_SIMD && ASVK_IS_SSE2
+    Vector4 result;
+    Transform( position, matrix, result );
+    return result;
+#else
+    Vector4 result;
+    scalar::TransformRow( &position.x, &matrix._11, &result.x );
+    return result;
+#endif
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -3045,10 +3326,17 @@ Vector4 Vector4::Transform( const Vector4& position, const Matrix& matrix )
 ASVK_INLINE
 void Vector4::Transform( const Vector4 &position, const Matrix &matrix, Vector4 &result )
 {
-    result.x = ( ( ((position.x * matrix._11) + (position.y * matrix._21)) + (position.z * matrix._31) ) + (position.w * matrix._41));
-    result.y = ( ( ((position.x * matrix._12) + (position.y * matrix._22)) + (position.z * matrix._32) ) + (position.w * matrix._42));
-    result.z = ( ( ((position.x * matrix._13) + (position.y * matrix._23)) + (position.z * matrix._33) ) + (position.w * matrix._43));
-    result.w = ( ( ((position.x * matrix._14) + (position.y * matrix._24)) + (position.z * matrix._34) ) + (position.w * matrix._44));
+#if ASVK_IS_SIMD && ASVK_IS_SSE2
+    auto v = detail::TransformRow(
+        _mm_loadu_ps( &position.x ),
+        _mm_loadu_ps( &matrix._11 ),
+        _mm_loadu_ps( &matrix._21 ),
+        _mm_loadu_ps( &matrix._31 ),
+        _mm_loadu_ps( &matrix._41 ) );
+    _mm_storeu_ps( &result.x, v );
+#else
+    scalar::TransformRow( &position.x, &matrix._11, &result.x );
+#endif
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -3136,32 +3424,13 @@ Matrix::operator const float* () const
 ASVK_INLINE 
 Matrix& Matrix::operator *= ( const Matrix &value )
 {
-    auto m11 = ( _11 * value._11 ) + ( _12 * value._21 ) + ( _13 * value._31 ) + ( _14 * value._41 );
-    auto m12 = ( _11 * value._12 ) + ( _12 * value._22 ) + ( _13 * value._32 ) + ( _14 * value._42 );
-    auto m13 = ( _11 * value._13 ) + ( _12 * value._23 ) + ( _13 * value._33 ) + ( _14 * value._43 );
-    auto m14 = ( _11 * value._14 ) + ( _12 * value._24 ) + ( _13 * value._34 ) + ( _14 * value._44 );
-
-    auto m21 = ( _21 * value._11 ) + ( _22 * value._21 ) + ( _23 * value._31 ) + ( _24 * value._41 );
-    auto m22 = ( _21 * value._12 ) + ( _22 * value._22 ) + ( _23 * value._32 ) + ( _24 * value._42 );
-    auto m23 = ( _21 * value._13 ) + ( _22 * value._23 ) + ( _23 * value._33 ) + ( _24 * value._43 );
-    auto m24 = ( _21 * value._14 ) + ( _22 * value._24 ) + ( _23 * value._34 ) + ( _24 * value._44 );
-
-    auto m31 = ( _31 * value._11 ) + ( _32 * value._21 ) + ( _33 * value._31 ) + ( _34 * value._41 );
-    auto m32 = ( _31 * value._12 ) + ( _32 * value._22 ) + ( _33 * value._32 ) + ( _34 * value._42 );
-    auto m33 = ( _31 * value._13 ) + ( _32 * value._23 ) + ( _33 * value._33 ) + ( _34 * value._43 );
-    auto m34 = ( _31 * value._14 ) + ( _32 * value._24 ) + ( _33 * value._34 ) + ( _34 * value._44 );
-
-    auto m41 = ( _41 * value._11 ) + ( _42 * value._21 ) + ( _43 * value._31 ) + ( _44 * value._41 );
-    auto m42 = ( _41 * value._12 ) + ( _42 * value._22 ) + ( _43 * value._32 ) + ( _44 * value._42 );
-    auto m43 = ( _41 * value._13 ) + ( _42 * value._23 ) + ( _43 * value._33 ) + ( _44 * value._43 );
-    auto m44 = ( _41 * value._14 ) + ( _42 * value._24 ) + ( _43 * value._34 ) + ( _44 * value._44 );
-
-    _11 = m11;  _12 = m12;  _13 = m13;  _14 = m14;
-    _21 = m21;  _22 = m22;  _23 = m23;  _24 = m24;
-    _31 = m31;  _32 = m32;  _33 = m33;  _34 = m34;
-    _41 = m41;  _42 = m42;  _43 = m43;  _44 = m44;
-
+#if ASVK_IS_SIMD && ASVK_IS_SSE2
+    detail::MultiplyMatrix( &_11, &value._11, &_11 );
+    return (*this);
+#else
+    scalar::MultiplyMatrix( &_11, &value._11, &_11 );
     return (*this);
+#endif
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -3253,27 +3522,15 @@ Matrix Matrix::operator - () const
 ASVK_INLINE 
 Matrix Matrix::operator * ( const Matrix& value ) const
 {
-    return Matrix(
-        ( _11 * value._11 ) + ( _12 * value._21 ) + ( _13 * value._31 ) + ( _14 * value._41 ),
-        ( _11 * value._12 ) + ( _12 * value._22 ) + ( _13 * value._32 ) + ( _14 * value._42 ),
-        ( _11 * value._13 ) + ( _12 * value._23 ) + ( _13 * value._33 ) + ( _14 * value._43 ),
-        ( _11 * value._14 ) + ( _12 * value._24 ) + ( _13 * value._34 ) + ( _14 * value._44 ),
-
-        ( _21 * value._11 ) + ( _22 * value._21 ) + ( _23 * value._31 ) + ( _24 * value._41 ),
-        ( _21 * value._12 ) + ( _22 * value._22 ) + ( _23 * value._32 ) + ( _24 * value._42 ),
-        ( _21 * value._13 ) + ( _22 * value._23 ) + ( _23 * value._33 ) + ( _24 * value._43 ),
-        ( _21 * value._14 ) + ( _22 * value._24 ) + ( _23 * value._34 ) + ( _24 * value._44 ),
-
-        ( _31 * value._11 ) + ( _32 * value._21 ) + ( _33 * value._31 ) + ( _34 * value._41 ),
-        ( _31 * value._12 ) + ( _32 * value._22 ) + ( _33 * value._32 ) + ( _34 * value._42 ),
-        ( _31 * value._13 ) + ( _32 * value._23 ) + ( _33 * value._33 ) + ( _34 * value._43 ),
-        ( _31 * value._14 ) + ( _32 * value._24 ) + ( _33 * value._34 ) + ( _34 * value._44 ),
-
-        ( _41 * value._11 ) + ( _42 * value._21 ) + ( _43 * value._31 ) + ( _44 * value._41 ),
-        ( _41 * value._12 ) + ( _42 * value._22 ) + ( _43 * value._32 ) + ( _44 * value._42 ),
-        ( _41 * value._13 ) + ( _42 * value._23 ) + ( _43 * value._33 ) + ( _44 * value._43 ),
-        ( _41 * value._14 ) + ( _42 * value._24 ) + ( _43 * value._34 ) + ( _44 * value._44 )
-    );
+#if ASVK_IS_SIMD && ASVK_IS_SSE2
+    Matrix result;
+    detail::MultiplyMatrix( &_11, &value._11, &result._11 );
+    return result;
+#else
+    Matrix result;
+    scalar::MultiplyMatrix( &_11, &value._11, &result._11 );
+    return result;
+#endif
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -3468,27 +3725,15 @@ void Matrix::Transpose( const Matrix &value, Matrix &result )
 ASVK_INLINE
 Matrix Matrix::Multiply( const Matrix& a, const Matrix& b )
 {
-    return Matrix(
-        ( a._11 * b._11 ) + ( a._12 * b._21 ) + ( a._13 * b._31 ) + ( a._14 * b._41 ),
-        ( a._11 * b._12 ) + ( a._12 * b._22 ) + ( a._13 * b._32 ) + ( a._14 * b._42 ),
-        ( a._11 * b._13 ) + ( a._12 * b._23 ) + ( a._13 * b._33 ) + ( a._14 * b._43 ),
-        ( a._11 * b._14 ) + ( a._12 * b._24 ) + ( a._13 * b._34 ) + ( a._14 * b._44 ),
-
-        ( a._21 * b._11 ) + ( a._22 * b._21 ) + ( a._23 * b._31 ) + ( a._24 * b._41 ),
-        ( a._21 * b._12 ) + ( a._22 * b._22 ) + ( a._23 * b._32 ) + ( a._24 * b._42 ),
-        ( a._21 * b._13 ) + ( a._22 * b._23 ) + ( a._23 * b._33 ) + ( a._24 * b._43 ),
-        ( a._21 * b._14 ) + ( a._22 * b._24 ) + ( a._23 * b._34 ) + ( a._24 * b._44 ),
-
-        ( a._31 * b._11 ) + ( a._32 * b._21 ) + ( a._33 * b._31 ) + ( a._34 * b._41 ),
-        ( a._31 * b._12 ) + ( a._32 * b._22 ) + ( a._33 * b._32 ) + ( a._34 * b._42 ),
-        ( a._31 * b._13 ) + ( a._32 * b._23 ) + ( a._33 * b._33 ) + ( a._34 * b._43 ),
-        ( a._31 * b._14 ) + ( a._32 * b._24 ) + ( a._33 * b._34 ) + ( a._34 * b._44 ),
-
-        ( a._41 * b._11 ) + ( a._42 * b._21 ) + ( a._43 * b._31 ) + ( a._44 * b._41 ),
-        ( a._41 * b._12 ) + ( a._42 * b._22 ) + ( a._43 * b._32 ) + ( a._44 * b._42 ),
-        ( a._41 * b._13 ) + ( a._42 * b._23 ) + ( a._43 * b._33 ) + ( a._44 * b._43 ),
-        ( a._41 * b._14 ) + ( a._42 * b._24 ) + ( a._43 * b._34 ) + ( a._44 * b._44 )
-    );
+#if ASVK_IS_SIMD && ASVK_IS_SSE2
+    Matrix result;
+    detail::MultiplyMatrix( &a._11, &b._11, &result._11 );
+    return result;
+#else
+    Matrix result;
+    scalar::MultiplyMatrix( &a._11, &b._11, &result._11 );
+    return result;
+#endif
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -3497,25 +3742,11 @@ Matrix Matrix::Multiply( const Matrix& a, const Matrix& b )
 ASVK_INLINE
 void Matrix::Multiply( const Matrix &a, const Matrix &b, Matrix &result )
 {
-    result._11 = ( a._11 * b._11 ) + ( a._12 * b._21 ) + ( a._13 * b._31 ) + ( a._14 * b._41 );
-    result._12 = ( a._11 * b._12 ) + ( a._12 * b._22 ) + ( a._13 * b._32 ) + ( a._14 * b._42 );
-    result._13 = ( a._11 * b._13 ) + ( a._12 * b._23 ) + ( a._13 * b._33 ) + ( a._14 * b._43 );
-    result._14 = ( a._11 * b._14 ) + ( a._12 * b._24 ) + ( a._13 * b._34 ) + ( a._14 * b._44 );
-
-    result._21 = ( a._21 * b._11 ) + ( a._22 * b._21 ) + ( a._23 * b._31 ) + ( a._24 * b._41 );
-    result._22 = ( a._21 * b._12 ) + ( a._22 * b._22 ) + ( a._23 * b._32 ) + ( a._24 * b._42 );
-    result._23 = ( a._21 * b._13 ) + ( a._22 * b._23 ) + ( a._23 * b._33 ) + ( a._24 * b._43 );
-    result._24 = ( a._21 * b._14 ) + ( a._22 * b._24 ) + ( a._23 * b._34 ) + ( a._24 * b._44 );
-
-    result._31 = ( a._31 * b._11 ) + ( a._32 * b._21 ) + ( a._33 * b._31 ) + ( a._34 * b._41 );
-    result._32 = ( a._31 * b._12 ) + ( a._32 * b._22 ) + ( a._33 * b._32 ) + ( a._34 * b._42 );
-    result._33 = ( a._31 * b._13 ) + ( a._32 * b._23 ) + ( a._33 * b._33 ) + ( a._34 * b._43 );
-    result._34 = ( a._31 * b._14 ) + ( a._32 * b._24 ) + ( a._33 * b._34 ) + ( a._34 * b._44 );
-
-    result._41 = ( a._41 * b._11 ) + ( a._42 * b._21 ) + ( a._43 * b._31 ) + ( a._44 * b._41 );
-    result._42 = ( a._41 * b._12 ) + ( a._42 * b._22 ) + ( a._43 * b._32 ) + ( a._44 * b._42 );
-    result._43 = ( a._41 * b._13 ) + ( a._42 * b._23 ) + ( a._43 * b._33 ) + ( a._44 * b._43 );
-    result._44 = ( a._41 * b._14 ) + ( a._42 * b._24 ) + ( a._43 * b._34 ) + ( a._44 * b._44 );
+#if ASVK_IS_SIMD && ASVK_IS_SSE2
+    detail::MultiplyMatrix( &a._11, &b._11, &result._11 );
+#else
+    scalar::MultiplyMatrix( &a._11, &b._11, &result._11 );
+#endif
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -3620,34 +3851,19 @@ void Matrix::MultiplyTranspose( const Matrix &a, const Matrix &b, Matrix &result
 ASVK_INLINE 
 Matrix Matrix::Invert( const Matrix& value )
 {
-    auto det = value.Determinant();
-    assert( !IsZero( det ) );
-
-    auto m11 = value._22*value._33*value._44 + value._23*value._34*value._42 + value._24*value._32*value._43 - value._22*value._34*value._43 - value._23*value._32*value._44 - value._24*value._33*value._42;
-    auto m12 = value._12*value._34*value._43 + value._13*value._32*value._44 + value._14*value._33*value._42 - value._12*value._33*value._44 - value._13*value._34*value._42 - value._14*value._32*value._43;
-    auto m13 = value._12*value._23*value._44 + value._13*value._24*value._42 + value._14*value._22*value._43 - value._12*value._24*value._43 - value._13*value._22*value._44 - value._14*value._23*value._42;
-    auto m14 = value._12*value._24*value._33 + value._13*value._22*value._34 + value._14*value._23*value._32 - value._12*value._23*value._34 - value._13*value._24*value._32 - value._14*value._22*value._33;
-
-    auto m21 = value._21*value._34*value._43 + value._23*value._31*value._44 + value._24*value._33*value._41 - value._21*value._33*value._44 - value._23*value._34*value._41 - value._24*value._31*value._43;
-    auto m22 = value._11*value._33*value._44 + value._13*value._34*value._41 + value._14*value._31*value._43 - value._11*value._34*value._43 - value._13*value._31*value._44 - value._14*value._33*value._41;
-    auto m23 = value._11*value._24*value._43 + value._13*value._21*value._44 + value._14*value._23*value._41 - value._11*value._23*value._44 - value._13*value._24*value._41 - value._14*value._21*value._43;
-    auto m24 = value._11*value._23*value._34 + value._13*value._24*value._31 + value._14*value._21*value._33 - value._11*value._24*value._33 - value._13*value._21*value._34 - value._14*value._23*value._31;
-
-    auto m31 = value._21*value._32*value._44 + value._22*value._34*value._41 + value._24*value._31*value._42 - value._21*value._34*value._42 - value._22*value._31*value._44 - value._24*value._32*value._41;
-    auto m32 = value._11*value._34*value._42 + value._12*value._31*value._44 + value._14*value._32*value._41 - value._11*value._32*value._44 - value._12*value._34*value._41 - value._14*value._31*value._42;
-    auto m33 = value._11*value._22*value._44 + value._12*value._24*value._41 + value._14*value._21*value._42 - value._11*value._24*value._42 - value._12*value._21*value._44 - value._14*value._22*value._41;
-    auto m34 = value._11*value._24*value._32 + value._12*value._21*value._34 + value._14*value._22*value._31 - value._11*value._22*value._34 - value._12*value._24*value._31 - value._14*value._21*value._32;
+#if ASVK_IS_SIMD && ASVK_IS_SSE2
+    assert( !IsZero( value.Determinant() ) );
 
-    auto m41 = value._21*value._33*value._42 + value._22*value._31*value._43 + value._23*value._32*value._41 - value._21*value._32*value._43 - value._22*value._33*value._41 - value._23*value._31*value._42;
-    auto m42 = value._11*value._32*value._43 + value._12*value._33*value._41 + value._13*value._31*value._42 - value._11*value._33*value._42 - value._12*value._31*value._43 - value._13*value._32*value._41;
-    auto m43 = value._11*value._23*value._42 + value._12*value._21*value._43 + value._13*value._22*value._41 - value._11*value._22*value._43 - value._12*value._23*value._41 - value._13*value._21*value._42;
-    auto m44 = value._11*value._22*value._33 + value._12*value._23*value._31 + value._13*value._21*value._32 - value._11*value._23*value._32 - value._12*value._21*value._33 - value._13*value._22*value._31;
+    Matrix result;
+    detail::InvertMatrix( &value._11, &result._11 );
+    return result;
+#else
+    assert( !IsZero( value.Determinant() ) );
 
-    return Matrix(
-        m11 / det, m12 / det, m13 / det, m14 / det,
-        m21 / det, m22 / det, m23 / det, m24 / det,
-        m31 / det, m32 / det, m33 / det, m34 / det,
-        m41 / det, m42 / det, m43 / det, m44 / det );
+    Matrix result;
+    scalar::InvertMatrix( &value._11, &result._11 );
+    return result;
+#endif
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -3656,48 +3872,13 @@ Matrix Matrix::Invert( const Matrix& value )
 ASVK_INLINE
 void Matrix::Invert( const Matrix &value, Matrix &result )
 { 
-    auto det = value.Determinant();
-    assert( det != 0.0f );
-
-    result._11 = value._22*value._33*value._44 + value._23*value._34*value._42 + value._24*value._32*value._43 - value._22*value._34*value._43 - value._23*value._32*value._44 - value._24*value._33*value._42;
-    result._12 = value._12*value._34*value._43 + value._13*value._32*value._44 + value._14*value._33*value._42 - value._12*value._33*value._44 - value._13*value._34*value._42 - value._14*value._32*value._43;
-    result._13 = value._12*value._23*value._44 + value._13*value._24*value._42 + value._14*value._22*value._43 - value._12*value._24*value._43 - value._13*value._22*value._44 - value._14*value._23*value._42;
-    result._14 = value._12*value._24*value._33 + value._13*value._22*value._34 + value._14*value._23*value._32 - value._12*value._23*value._34 - value._13*value._24*value._32 - value._14*value._22*value._33;
-
-    result._21 = value._21*value._34*value._43 + value._23*value._31*value._44 + value._24*value._33*value._41 - value._21*value._33*value._44 - value._23*value._34*value._41 - value._24*value._31*value._43;
-    result._22 = value._11*value._33*value._44 + value._13*value._34*value._41 + value._14*value._31*value._43 - value._11*value._34*value._43 - value._13*value._31*value._44 - value._14*value._33*value._41;
-    result._23 = value._11*value._24*value._43 + value._13*value._21*value._44 + value._14*value._23*value._41 - value._11*value._23*value._44 - value._13*value._24*value._41 - value._14*value._21*value._43;
-    result._24 = value._11*value._23*value._34 + value._13*value._24*value._31 + value._14*value._21*value._33 - value._11*value._24*value._33 - value._13*value._21*value._34 - value._14*value._23*value._31;
-
-    result._31 = value._21*value._32*value._44 + value._22*value._34*value._41 + value._24*value._31*value._42 - value._21*value._34*value._42 - value._22*value._31*value._44 - value._24*value._32*value._41;
-    result._32 = value._11*value._34*value._42 + value._12*value._31*value._44 + value._14*value._32*value._41 - value._11*value._32*value._44 - value._12*value._34*value._41 - value._14*value._31*value._42;
-    result._33 = value._11*value._22*value._44 + value._12*value._24*value._41 + value._14*value._21*value._42 - value._11*value._24*value._42 - value._12*value._21*value._44 - value._14*value._22*value._41;
-    result._34 = value._11*value._24*value._32 + value._12*value._21*value._34 + value._14*value._22*value._31 - value._11*value._22*value._34 - value._12*value._24*value._31 - value._14*value._21*value._32;
-
-    result._41 = value._21*value._33*value._42 + value._22*value._31*value._43 + value._23*value._32*value._41 - value._21*value._32*value._43 - value._22*value._33*value._41 - value._23*value._31*value._42;
-    result._42 = value._11*value._32*value._43 + value._12*value._33*value._41 + value._13*value._31*value._42 - value._11*value._33*value._42 - value._12*value._31*value._43 - value._13*value._32*value._41;
-    result._43 = value._11*value._23*value._42 + value._12*value._21*value._43 + value._13*value._22*value._41 - value._11*value._22*value._43 - value._12*value._23*value._41 - value._13*value._21*value._42;
-    result._44 = value._11*value._22*value._33 + value._12*value._23*value._31 + value._13*value._21*value._32 - value._11*value._23*value._32 - value._12*value._21*value._33 - value._13*value._22*value._31;
-
-    result._11 /= det;
-    result._12 /= det;
-    result._13 /= det;
-    result._14 /= det;
-
-    result._21 /= det;
-    result._22 /= det;
-    result._23 /= det;
-    result._24 /= det;
-
-    result._31 /= det;
-    result._32 /= det;
-    result._33 /= det;
-    result._34 /= det;
-
-    result._41 /= det;
-    result._42 /= det;
-    result._43 /= det;
-    result._44 /= det;
+#if ASVK_IS_SIMD && ASVK_IS_SSE2
+    assert( value.Determinant() != 0.0f );
+    detail::InvertMatrix( &value._11, &result._11 );
+#else
+    assert( value.Determinant() != 0.0f );
+    scalar::InvertMatrix( &value._11, &result._11 );
+#endif
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -4834,15 +5015,13 @@ Quaternion& Quaternion::operator -= ( const Quaternion& q )
 ASVK_INLINE
 Quaternion& Quaternion::operator *= ( const Quaternion& q )
 {
-    auto X = ( q.x * w ) + ( x * q.w ) + ( q.y * z ) - ( q.z * y );
-    auto Y = ( q.y * w ) + ( y * q.w ) + ( q.z * x ) - ( q.x * z );
-    auto Z = ( q.z * w ) + ( z * q.w ) + ( q.x * y ) - ( q.y * x );
-    auto W = ( q.w * w ) - ( q.x * x ) - ( q.y * y ) + ( q.z * z );
-    x = X;
-    y = Y;
-    z = Z;
-    w = W;
+#if ASVK_IS_SIMD && ASVK_IS_SSE2
+    _mm_storeu_ps( &x, detail::MultiplyQuaternion( _mm_loadu_ps( &x ), _mm_loadu_ps( &q.x ) ) );
     return (*this);
+#else
+    scalar::MultiplyQuaternion( &x, &q.x, &x );
+    return (*this);
+#endif
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -4906,12 +5085,15 @@ Quaternion Quaternion::operator - ( const Quaternion& q ) const
 ASVK_INLINE 
 Quaternion Quaternion::operator * ( const Quaternion& q ) const
 { 
-    return Quaternion(
-        ( q.x * w ) + ( x * q.w ) + ( q.y * z ) - ( q.z * y ),
-        ( q.y * w ) + ( y * q.w ) + ( q.z * x ) - ( q.x * z ),
-        ( q.z * w ) + ( z * q.w ) + ( q.x * y ) - ( q.y * x ),
-        ( q.w * w ) - ( q.x * x ) - ( q.y * y ) + ( q.z * z )
-   );
+#if ASVK_IS_SIMD && ASVK_IS_SSE2
+    Quaternion result;
+    _mm_storeu_ps( &result.x, detail::MultiplyQuaternion( _mm_loadu_ps( &x ), _mm_loadu_ps( &q.x ) ) );
+    return result;
+#else
+    Quaternion result;
+    scalar::MultiplyQuaternion( &x, &q.x, &result.x );
+    return result;
+#endif
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -5066,12 +5248,15 @@ bool Quaternion::IsNormalized( const Quaternion& value )
 ASVK_INLINE
 Quaternion Quaternion::Multiply( const Quaternion& a, const Quaternion& b )
 {
-    return Quaternion(
-        ( b.x * a.w ) + ( a.x * b.w ) + ( b.y * a.z ) - ( b.z * a.y ),
-        ( b.y * a.w ) + ( a.y * b.w ) + ( b.z * a.x ) - ( b.x * a.z ),
-        ( b.z * a.w ) + ( a.z * b.w ) + ( b.x * a.y ) - ( b.y * a.x ),
-        ( b.w * a.w ) - ( b.x * a.x ) - ( b.y * a.y ) + ( b.z * a.z )
-   );
+#if ASVK_IS_SIMD && ASVK_IS_SSE2
+    Quaternion result;
+    _mm_storeu_ps( &result.x, detail::MultiplyQuaternion( _mm_loadu_ps( &a.x ), _mm_loadu_ps( &b.x ) ) );
+    return result;
+#else
+    Quaternion result;
+    scalar::MultiplyQuaternion( &a.x, &b.x, &result.x );
+    return result;
+#endif
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -5080,10 +5265,11 @@ Quaternion Quaternion::Multiply( const Quaternion& a, const Quaternion& b )
 ASVK_INLINE
 void Quaternion::Multiply( const Quaternion& a, const Quaternion& b, Quaternion& result )
 {
-    result.x = ( b.x * a.w ) + ( a.x * b.w ) + ( b.y * a.z ) - ( b.z * a.y );
-    result.y = ( b.y * a.w ) + ( a.y * b.w ) + ( b.z * a.x ) - ( b.x * a.z );
-    result.z = ( b.z * a.w ) + ( a.z * b.w ) + ( b.x * a.y ) - ( b.y * a.x );
-    result.w = ( b.w * a.w ) - ( b.x * a.x ) - ( b.y * a.y ) + ( b.z * a.z );
+#if ASVK_IS_SIMD && ASVK_IS_SSE2
+    _mm_storeu_ps( &result.x, detail::MultiplyQuaternion( _mm_loadu_ps( &a.x ), _mm_loadu_ps( &b.x ) ) );
+#else
+    scalar::MultiplyQuaternion( &a.x, &b.x, &result.x );
+#endif
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -5487,11 +5673,19 @@ Quaternion Quaternion::Slerp
         scale1 = amount;
     }
 
+#if ASVK_IS_SIMD && ASVK_IS_SSE2
+    Quaternion result;
+    _mm_storeu_ps( &result.x, _mm_add_ps(
+        _mm_mul_ps( _mm_set1_ps( scale0 ), _mm_loadu_ps( &a.x ) ),
+        _mm_mul_ps( _mm_set1_ps( scale1 ), _mm_loadu_ps( &temp.x ) ) ) );
+    return result;
+#else
     return Quaternion(
         scale0 * a.x + scale1 * temp.x,
         scale0 * a.y + scale1 * temp.y,
         scale0 * a.z + scale1 * temp.z,
         scale0 * a.w + scale1 * temp.w);
+#endif
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -5550,10 +5744,16 @@ void Quaternion::Slerp
         scale1 = amount;
     }
 
+#if ASVK_IS_SIMD && ASVK_IS_SSE2
+    _mm_storeu_ps( &result.x, _mm_add_ps(
+        _mm_mul_ps( _mm_set1_ps( scale0 ), _mm_loadu_ps( &a.x ) ),
+        _mm_mul_ps( _mm_set1_ps( scale1 ), _mm_loadu_ps( &temp.x ) ) ) );
+#else
     result.x = scale0 * a.x + scale1 * temp.x;
     result.y = scale0 * a.y + scale1 * temp.y;
     result.z = scale0 * a.z + scale1 * temp.z;
     result.w = scale0 * a.w + scale1 * temp.w;
+#endif
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -0,0 +1,714 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asvkAllocator.cpp
+// Desc : Device Memory Allocator Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asvkAllocator.h>
+#include <asvkLogger.h>
+#include <algorithm>
+#include <chrono>
+
+
+namespace /* anonymous */ {
+
+//-------------------------------------------------------------------------------------------------
+//      アライメントに切り上げます.
+//-------------------------------------------------------------------------------------------------
+inline VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment)
+{
+    if (alignment <= 1)
+    { return value; }
+
+    return ((value + alignment - 1) / alignment) * alignment;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      経過時間をミリ秒で取得します.
+//-------------------------------------------------------------------------------------------------
+inline double ElapsedMs
+(
+    const std::chrono::high_resolution_clock::time_point& begin,
+    const std::chrono::high_resolution_clock::time_point& end
+)
+{ return std::chrono::duration<double, std::milli>(end - begin).count(); }
+
+} // namespace /* anonymous */
+
+
+namespace asvk {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// MemoryPage class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class MemoryPage
+{
+public:
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Block structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct Block
+    {
+        VkDeviceSize    Offset;     //!< オフセットです.
+        VkDeviceSize    Size;       //!< サイズです.
+    };
+
+    VkDeviceMemory      Memory;             //!< デバイスメモリです.
+    VkDeviceSize        Size;               //!< ページサイズです.
+    uint32_t            TypeIndex;          //!< メモリタイプ番号です.
+    uint32_t            PoolIndex;          //!< 所属するページリストの番号です.
+    bool                IsDedicated;        //!< 専用割り当てかどうか.
+    VkDeviceSize        UsedBytes;          //!< 割り当て済みのバイト数です.
+    uint32_t            AllocationCount;    //!< 割り当て数です.
+    uint32_t            MapCount;           //!< マップの参照カウントです.
+    void*               pMapped;            //!< マップ先のポインタです.
+    std::vector<Block>  FreeList;           //!< オフセット順に並んだ空き領域です.
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    MemoryPage(VkDeviceMemory memory, VkDeviceSize size, uint32_t typeIndex, bool isDedicated)
+    : Memory         (memory)
+    , Size           (size)
+    , TypeIndex      (typeIndex)
+    , PoolIndex      (0)
+    , IsDedicated    (isDedicated)
+    , UsedBytes      (0)
+    , AllocationCount(0)
+    , MapCount       (0)
+    , pMapped        (nullptr)
+    {
+        Block block = { 0, size };
+        FreeList.push_back(block);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ファーストフィットで領域を割り当てます.
+    //---------------------------------------------------------------------------------------------
+    bool Allocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize* pOffset)
+    {
+        for(size_t i=0; i<FreeList.size(); ++i)
+        {
+            auto block   = FreeList[i];
+            auto aligned = AlignUp(block.Offset, alignment);
+            auto padding = aligned - block.Offset;
+            if (padding + size > block.Size)
+            { continue; }
+
+            // 前方のパディングは空き領域として残す.
+            auto tailOffset = aligned + size;
+            auto tailSize   = block.Size - padding - size;
+
+            if (padding > 0)
+            {
+                FreeList[i].Size = padding;
+                if (tailSize > 0)
+                {
+                    Block tail = { tailOffset, tailSize };
+                    FreeList.insert(FreeList.begin() + i + 1, tail);
+                }
+            }
+            else if (tailSize > 0)
+            {
+                FreeList[i].Offset = tailOffset;
+                FreeList[i].Size   = tailSize;
+            }
+            else
+            {
+                FreeList.erase(FreeList.begin() + i);
+            }
+
+            UsedBytes += size;
+            AllocationCount++;
+            *pOffset = aligned;
+            return true;
+        }
+
+        return false;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      領域を解放し, 隣接する空き領域と結合します.
+    //---------------------------------------------------------------------------------------------
+    void Free(VkDeviceSize offset, VkDeviceSize size)
+    {
+        Block block = { offset, size };
+        auto itr = std::lower_bound(FreeList.begin(), FreeList.end(), block,
+            [](const Block& lhs, const Block& rhs) { return lhs.Offset < rhs.Offset; });
+        itr = FreeList.insert(itr, block);
+
+        // 後方と結合.
+        auto next = itr + 1;
+        if (next != FreeList.end() && itr->Offset + itr->Size == next->Offset)
+        {
+            itr->Size += next->Size;
+            itr = FreeList.erase(next) - 1;
+        }
+
+        // 前方と結合.
+        if (itr != FreeList.begin())
+        {
+            auto prev = itr - 1;
+            if (prev->Offset + prev->Size == itr->Offset)
+            {
+                prev->Size += itr->Size;
+                FreeList.erase(itr);
+            }
+        }
+
+        UsedBytes -= size;
+        AllocationCount--;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      最大の空き領域サイズを取得します.
+    //---------------------------------------------------------------------------------------------
+    VkDeviceSize GetLargestFree() const
+    {
+        VkDeviceSize result = 0;
+        for(size_t i=0; i<FreeList.size(); ++i)
+        { result = std::max(result, FreeList[i].Size); }
+        return result;
+    }
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// MemoryAllocator class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+MemoryAllocator::MemoryAllocator()
+: m_Device                  (null_handle)
+, m_Props                   ()
+, m_Desc                    ()
+, m_DeviceAllocationCount   (0)
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      デストラクタです.
+//-------------------------------------------------------------------------------------------------
+MemoryAllocator::~MemoryAllocator()
+{ Term(); }
+
+//-------------------------------------------------------------------------------------------------
+//      初期化処理を行います.
+//-------------------------------------------------------------------------------------------------
+bool MemoryAllocator::Init(VkDevice device, VkPhysicalDevice gpu, const MemoryAllocatorDesc& desc)
+{
+    if (device == null_handle || gpu == null_handle)
+    {
+        ELOG( "Error : Invalid Argument." );
+        return false;
+    }
+
+    vkGetPhysicalDeviceMemoryProperties(gpu, &m_Props);
+
+    m_Device                = device;
+    m_Desc                  = desc;
+    m_DeviceAllocationCount = 0;
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      終了処理を行います.
+//-------------------------------------------------------------------------------------------------
+void MemoryAllocator::Term()
+{
+    std::lock_guard<std::mutex> locker(m_Mutex);
+
+    for(auto i=0u; i<VK_MAX_MEMORY_TYPES * 2; ++i)
+    {
+        for(size_t j=0; j<m_Pages[i].size(); ++j)
+        {
+            auto pPage = m_Pages[i][j];
+            if (pPage->AllocationCount > 0)
+            { ELOG( "Error : Memory Leak Detected. type = %u, count = %u", pPage->TypeIndex, pPage->AllocationCount ); }
+
+            if (pPage->pMapped != nullptr)
+            { vkUnmapMemory(m_Device, pPage->Memory); }
+
+            vkFreeMemory(m_Device, pPage->Memory, nullptr);
+            SafeDelete(pPage);
+        }
+        m_Pages[i].clear();
+    }
+
+    for(size_t i=0; i<m_Dedicated.size(); ++i)
+    {
+        auto pPage = m_Dedicated[i];
+        ELOG( "Error : Memory Leak Detected. type = %u, dedicated", pPage->TypeIndex );
+
+        if (pPage->pMapped != nullptr)
+        { vkUnmapMemory(m_Device, pPage->Memory); }
+
+        vkFreeMemory(m_Device, pPage->Memory, nullptr);
+        SafeDelete(pPage);
+    }
+    m_Dedicated.clear();
+
+    m_Device = null_handle;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      メモリを割り当てます.
+//-------------------------------------------------------------------------------------------------
+bool MemoryAllocator::Allocate
+(
+    const VkMemoryRequirements& requirements,
+    VkMemoryPropertyFlags       propFlags,
+    bool                        isLinear,
+    Allocation*                 pResult
+)
+{
+    if (pResult == nullptr || requirements.size == 0)
+    {
+        ELOG( "Error : Invalid Argument." );
+        return false;
+    }
+
+    uint32_t typeIndex = 0;
+    if (!FindMemoryType(requirements.memoryTypeBits, propFlags, &typeIndex))
+    {
+        ELOG( "Error : FindMemoryType() Failed." );
+        return false;
+    }
+
+    std::lock_guard<std::mutex> locker(m_Mutex);
+
+    // ページに収まらない要求は専用割り当て.
+    if (m_Desc.PageSize == 0
+     || requirements.size >= m_Desc.DedicatedThreshold
+     || requirements.size >  m_Desc.PageSize)
+    {
+        auto pPage = CreatePage(typeIndex, requirements.size, true);
+        if (pPage == nullptr)
+        { return false; }
+
+        VkDeviceSize offset = 0;
+        pPage->Allocate(requirements.size, 1, &offset);
+        m_Dedicated.push_back(pPage);
+
+        pResult->Memory    = pPage->Memory;
+        pResult->Offset    = 0;
+        pResult->Size      = requirements.size;
+        pResult->TypeIndex = typeIndex;
+        pResult->pPage     = pPage;
+        return true;
+    }
+
+    // リニアと非リニアでページを分けるため, 同じページ内で bufferImageGranularity を考慮する必要はない.
+    auto  poolIndex = typeIndex * 2 + (isLinear ? 0 : 1);
+    auto& pages     = m_Pages[poolIndex];
+
+    VkDeviceSize offset = 0;
+    MemoryPage*  pPage  = nullptr;
+    for(size_t i=0; i<pages.size(); ++i)
+    {
+        if (pages[i]->Allocate(requirements.size, requirements.alignment, &offset))
+        {
+            pPage = pages[i];
+            break;
+        }
+    }
+
+    if (pPage == nullptr)
+    {
+        pPage = CreatePage(typeIndex, m_Desc.PageSize, false);
+        if (pPage == nullptr)
+        { return false; }
+
+        pPage->PoolIndex = poolIndex;
+        pages.push_back(pPage);
+        if (!pPage->Allocate(requirements.size, requirements.alignment, &offset))
+        {
+            ELOG( "Error : MemoryPage::Allocate() Failed." );
+            return false;
+        }
+    }
+
+    pResult->Memory    = pPage->Memory;
+    pResult->Offset    = offset;
+    pResult->Size      = requirements.size;
+    pResult->TypeIndex = typeIndex;
+    pResult->pPage     = pPage;
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      メモリを解放します.
+//-------------------------------------------------------------------------------------------------
+void MemoryAllocator::Free(Allocation* pAllocation)
+{
+    if (pAllocation == nullptr || pAllocation->pPage == nullptr)
+    { return; }
+
+    std::lock_guard<std::mutex> locker(m_Mutex);
+
+    auto pPage = pAllocation->pPage;
+    if (pPage->IsDedicated)
+    {
+        auto itr = std::find(m_Dedicated.begin(), m_Dedicated.end(), pPage);
+        if (itr != m_Dedicated.end())
+        { m_Dedicated.erase(itr); }
+
+        if (pPage->pMapped != nullptr)
+        { vkUnmapMemory(m_Device, pPage->Memory); }
+
+        vkFreeMemory(m_Device, pPage->Memory, nullptr);
+        SafeDelete(pPage);
+    }
+    else
+    {
+        pPage->Free(pAllocation->Offset, pAllocation->Size);
+
+        // 空になったページは 1 枚だけ残して返却する.
+        if (pPage->AllocationCount == 0 && pPage->MapCount == 0)
+        {
+            auto& pages = m_Pages[pPage->PoolIndex];
+            if (pages.size() > 1)
+            {
+                pages.erase(std::find(pages.begin(), pages.end(), pPage));
+                vkFreeMemory(m_Device, pPage->Memory, nullptr);
+                SafeDelete(pPage);
+            }
+        }
+    }
+
+    *pAllocation = Allocation();
+}
+
+//-------------------------------------------------------------------------------------------------
+//      メモリをマップします.
+//-------------------------------------------------------------------------------------------------
+bool MemoryAllocator::Map(const Allocation& allocation, void** ppData)
+{
+    if (allocation.pPage == nullptr || ppData == nullptr)
+    {
+        ELOG( "Error : Invalid Argument." );
+        return false;
+    }
+
+    if ((m_Props.memoryTypes[allocation.TypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) == 0)
+    {
+        ELOG( "Error : Memory is not host visible." );
+        return false;
+    }
+
+    std::lock_guard<std::mutex> locker(m_Mutex);
+
+    auto pPage = allocation.pPage;
+    if (pPage->MapCount == 0)
+    {
+        auto result = vkMapMemory(m_Device, pPage->Memory, 0, VK_WHOLE_SIZE, 0, &pPage->pMapped);
+        if ( result != VK_SUCCESS )
+        {
+            ELOG( "Error : vkMapMemory() Failed." );
+            return false;
+        }
+    }
+
+    pPage->MapCount++;
+    *ppData = static_cast<uint8_t*>(pPage->pMapped) + allocation.Offset;
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      メモリをアンマップします.
+//-------------------------------------------------------------------------------------------------
+void MemoryAllocator::Unmap(const Allocation& allocation)
+{
+    if (allocation.pPage == nullptr)
+    { return; }
+
+    std::lock_guard<std::mutex> locker(m_Mutex);
+
+    auto pPage = allocation.pPage;
+    if (pPage->MapCount == 0)
+    { return; }
+
+    pPage->MapCount--;
+    if (pPage->MapCount == 0)
+    {
+        vkUnmapMemory(m_Device, pPage->Memory);
+        pPage->pMapped = nullptr;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      メモリタイプ番号を検索します.
+//-------------------------------------------------------------------------------------------------
+bool MemoryAllocator::FindMemoryType
+(
+    uint32_t                typeBits,
+    VkMemoryPropertyFlags   propFlags,
+    uint32_t*               pIndex
+) const
+{
+    for(auto i=0u; i<m_Props.memoryTypeCount; ++i)
+    {
+        if ((typeBits & (1u << i)) == 0)
+        { continue; }
+
+        if ((m_Props.memoryTypes[i].propertyFlags & propFlags) == propFlags)
+        {
+            *pIndex = i;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      統計情報を取得します.
+//-------------------------------------------------------------------------------------------------
+void MemoryAllocator::GetStats(MemoryStats* pStats) const
+{
+    if (pStats == nullptr)
+    { return; }
+
+    std::lock_guard<std::mutex> locker(m_Mutex);
+
+    *pStats = MemoryStats();
+
+    VkDeviceSize totalFree   = 0;
+    VkDeviceSize largestFree = 0;
+
+    for(auto i=0u; i<VK_MAX_MEMORY_TYPES * 2; ++i)
+    {
+        for(size_t j=0; j<m_Pages[i].size(); ++j)
+        {
+            auto pPage = m_Pages[i][j];
+            auto& heap = pStats->Heaps[m_Props.memoryTypes[pPage->TypeIndex].heapIndex];
+
+            heap.ReservedBytes += pPage->Size;
+            heap.UsedBytes     += pPage->UsedBytes;
+            heap.PageCount++;
+
+            pStats->PageCount++;
+            pStats->AllocationCount += pPage->AllocationCount;
+            pStats->ReservedBytes   += pPage->Size;
+            pStats->UsedBytes       += pPage->UsedBytes;
+
+            totalFree  += pPage->Size - pPage->UsedBytes;
+            largestFree = std::max(largestFree, pPage->GetLargestFree());
+        }
+    }
+
+    for(size_t i=0; i<m_Dedicated.size(); ++i)
+    {
+        auto pPage = m_Dedicated[i];
+        auto& heap = pStats->Heaps[m_Props.memoryTypes[pPage->TypeIndex].heapIndex];
+
+        heap.ReservedBytes += pPage->Size;
+        heap.UsedBytes     += pPage->UsedBytes;
+
+        pStats->DedicatedCount++;
+        pStats->AllocationCount++;
+        pStats->ReservedBytes += pPage->Size;
+        pStats->UsedBytes     += pPage->UsedBytes;
+    }
+
+    pStats->DeviceAllocationCount = m_DeviceAllocationCount;
+    pStats->Fragmentation = (totalFree > 0)
+        ? 1.0f - static_cast<float>(double(largestFree) / double(totalFree))
+        : 0.0f;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      統計情報をログに出力します.
+//-------------------------------------------------------------------------------------------------
+void MemoryAllocator::DumpStats() const
+{
+    MemoryStats stats;
+    GetStats(&stats);
+
+    ILOG( "Info : MemoryAllocator Stats" );
+    ILOG( "    Pages       : %u", stats.PageCount );
+    ILOG( "    Dedicated   : %u", stats.DedicatedCount );
+    ILOG( "    Allocations : %u (vkAllocateMemory x %u)", stats.AllocationCount, stats.DeviceAllocationCount );
+    ILOG( "    Reserved    : %llu bytes", static_cast<unsigned long long>(stats.ReservedBytes) );
+    ILOG( "    Used        : %llu bytes", static_cast<unsigned long long>(stats.UsedBytes) );
+    ILOG( "    Fragment    : %.2f %%", stats.Fragmentation * 100.0f );
+
+    for(auto i=0u; i<m_Props.memoryHeapCount; ++i)
+    {
+        ILOG( "    Heap[%u]     : used %llu / reserved %llu bytes, pages %u",
+            i,
+            static_cast<unsigned long long>(stats.Heaps[i].UsedBytes),
+            static_cast<unsigned long long>(stats.Heaps[i].ReservedBytes),
+            stats.Heaps[i].PageCount );
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      デバイスを取得します.
+//-------------------------------------------------------------------------------------------------
+VkDevice MemoryAllocator::GetDevice() const
+{ return m_Device; }
+
+//-------------------------------------------------------------------------------------------------
+//      メモリプロパティを取得します.
+//-------------------------------------------------------------------------------------------------
+const VkPhysicalDeviceMemoryProperties& MemoryAllocator::GetMemoryProperties() const
+{ return m_Props; }
+
+//-------------------------------------------------------------------------------------------------
+//      ページを生成します.
+//-------------------------------------------------------------------------------------------------
+MemoryPage* MemoryAllocator::CreatePage(uint32_t typeIndex, VkDeviceSize size, bool isDedicated)
+{
+    VkMemoryAllocateInfo info = {};
+    info.sType              = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    info.pNext              = nullptr;
+    info.memoryTypeIndex    = typeIndex;
+    info.allocationSize     = size;
+
+    VkDeviceMemory memory = null_handle;
+    auto result = vkAllocateMemory(m_Device, &info, nullptr, &memory);
+    if ( result != VK_SUCCESS )
+    {
+        ELOG( "Error : vkAllocateMemory() Failed." );
+        return nullptr;
+    }
+
+    m_DeviceAllocationCount++;
+    return new MemoryPage(memory, size, typeIndex, isDedicated);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+//      サブアロケーションとリソースごとの割り当てを比較するベンチマークを実行します.
+//-------------------------------------------------------------------------------------------------
+bool RunMemoryBenchmark
+(
+    VkDevice                device,
+    VkPhysicalDevice        gpu,
+    uint32_t                bufferCount,
+    VkDeviceSize            bufferSize,
+    MemoryBenchmarkResult*  pResult
+)
+{
+    if (device == null_handle || gpu == null_handle || bufferCount == 0 || pResult == nullptr)
+    {
+        ELOG( "Error : Invalid Argument." );
+        return false;
+    }
+
+    VkBufferCreateInfo bufferInfo = {};
+    bufferInfo.sType        = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.pNext        = nullptr;
+    bufferInfo.size         = bufferSize;
+    bufferInfo.usage        = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    bufferInfo.sharingMode  = VK_SHARING_MODE_EXCLUSIVE;
+
+    std::vector<VkBuffer>   buffers(bufferCount, null_handle);
+    std::vector<Allocation> allocations(bufferCount);
+
+    for(auto i=0u; i<bufferCount; ++i)
+    {
+        auto result = vkCreateBuffer(device, &bufferInfo, nullptr, &buffers[i]);
+        if ( result != VK_SUCCESS )
+        {
+            ELOG( "Error : vkCreateBuffer() Failed." );
+            for(auto j=0u; j<i; ++j)
+            { vkDestroyBuffer(device, buffers[j], nullptr); }
+            return false;
+        }
+    }
+
+    VkMemoryRequirements requirements;
+    vkGetBufferMemoryRequirements(device, buffers[0], &requirements);
+
+    // 0 : サブアロケーション, 1 : リソースごとの割り当て.
+    bool succeeded = true;
+    for(auto pass=0; pass<2 && succeeded; ++pass)
+    {
+        MemoryAllocatorDesc desc;
+        if (pass == 1)
+        { desc.PageSize = 0; }
+
+        MemoryAllocator allocator;
+        if (!allocator.Init(device, gpu, desc))
+        {
+            ELOG( "Error : MemoryAllocator::Init() Failed." );
+            succeeded = false;
+            break;
+        }
+
+        auto begin = std::chrono::high_resolution_clock::now();
+        auto count = 0u;
+        for(; count<bufferCount; ++count)
+        {
+            if (!allocator.Allocate(requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, true, &allocations[count]))
+            {
+                ELOG( "Error : MemoryAllocator::Allocate() Failed." );
+                succeeded = false;
+                break;
+            }
+
+            vkBindBufferMemory(device, buffers[count], allocations[count].Memory, allocations[count].Offset);
+        }
+        auto middle = std::chrono::high_resolution_clock::now();
+
+        MemoryStats stats;
+        allocator.GetStats(&stats);
+
+        for(auto i=0u; i<count; ++i)
+        { allocator.Free(&allocations[i]); }
+        auto end = std::chrono::high_resolution_clock::now();
+
+        // バインド済みメモリは再バインドできないため, バッファを作り直す.
+        for(auto i=0u; i<bufferCount; ++i)
+        {
+            vkDestroyBuffer(device, buffers[i], nullptr);
+            buffers[i] = null_handle;
+            if (pass == 0 && vkCreateBuffer(device, &bufferInfo, nullptr, &buffers[i]) != VK_SUCCESS)
+            {
+                ELOG( "Error : vkCreateBuffer() Failed." );
+                succeeded = false;
+            }
+        }
+
+        if (pass == 0)
+        {
+            pResult->SubAllocateMs          = ElapsedMs(begin, middle);
+            pResult->SubFreeMs              = ElapsedMs(middle, end);
+            pResult->SubDeviceAllocations   = stats.DeviceAllocationCount;
+        }
+        else
+        {
+            pResult->DedicatedAllocateMs        = ElapsedMs(begin, middle);
+            pResult->DedicatedFreeMs            = ElapsedMs(middle, end);
+            pResult->DedicatedDeviceAllocations = stats.DeviceAllocationCount;
+        }
+
+        allocator.Term();
+    }
+
+    for(auto i=0u; i<bufferCount; ++i)
+    {
+        if (buffers[i] != null_handle)
+        { vkDestroyBuffer(device, buffers[i], nullptr); }
+    }
+
+    if (!succeeded)
+    { return false; }
+
+    ILOG( "Info : Memory Benchmark (%u buffers x %llu bytes)", bufferCount, static_cast<unsigned long long>(bufferSize) );
+    ILOG( "    SubAllocate : alloc %.3f ms, free %.3f ms, vkAllocateMemory x %u",
+        pResult->SubAllocateMs, pResult->SubFreeMs, pResult->SubDeviceAllocations );
+    ILOG( "    Dedicated   : alloc %.3f ms, free %.3f ms, vkAllocateMemory x %u",
+        pResult->DedicatedAllocateMs, pResult->DedicatedFreeMs, pResult->DedicatedDeviceAllocations );
+
+    return true;
+}
+
+} // namespace asvk
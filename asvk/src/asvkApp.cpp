@@ -9,8 +9,16 @@
 //-------------------------------------------------------------------------------------------------
 #include <list>
 #include <cassert>
+#include <cmath>
 #include <asvkApp.h>
 #include <asvkLogger.h>
+#include <dwmapi.h>
+
+
+//-------------------------------------------------------------------------------------------------
+// Linker
+//-------------------------------------------------------------------------------------------------
+#pragma comment( lib, "dwmapi.lib" )
 
 
 namespace /* anonymous */ {
@@ -87,22 +95,46 @@ App::App
 , m_FramePerSec         ( 0.0f )
 , m_LastUpdateSec       ( 0 )
 , m_IsStopDraw          ( false )
+, m_IsStandByMode       ( false )
 , m_ChainIndex          ( 0 )
 , m_ClearColor          ( 0.392156899f, 0.584313750f, 0.929411829f, 1.0f )
 , m_ClearDepth          ( 1.0f )
 , m_ClearStencil        ( 0 )
 , m_DeviceMgr           ()
 , m_CommandList         ()
+, m_GpuProfiler         ()
 , m_SwapChain           ()
 , m_SwapChainFormat     ( VK_FORMAT_B8G8R8A8_UNORM )
 , m_DepthBuffer         ()
 , m_DepthFormat         ( VK_FORMAT_D24_UNORM_S8_UINT )
+, m_FrameBuffer         ()
 , m_RenderPass          ( null_handle )
+, m_PresentPolicy       ( PresentPolicy_Throughput )
+, m_InFlightFrameCount  ( 0 )
+, m_TargetFrameRate     ( 0.0 )
+, m_FramePacer          ()
+, m_FrameTimes          ()
+, m_FrameTimeCsvPath    ( nullptr )
+, m_IsRenderThreadMode  ( false )
+, m_IsSubmitThreadMode  ( false )
+, m_IsRenderThreadRunning( false )
+, m_IsQuitRequested     ( false )
+, m_FixedUpdateRate     ( 0.0 )
+, m_MaxFixedStepCount   ( 5 )
+, m_StandByTickRate     ( 10.0 )
+, m_IsThrottleInactive  ( false )
+, m_FixedAccumulatorSec ( 0.0 )
+, m_FixedArgs           ()
+, m_hStandByEvent       ( nullptr )
+, m_IsSurfaceSuspended  ( false )
+, m_NextTickSec         ( 0.0 )
+, m_QueueStats          ()
+, m_FrameStats          ()
+, m_IsResizeRequested   ( false )
+, m_ResizeArgs          ()
 {
     m_Viewport = { 0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height) };
     m_Scissor  = { 0, 0, width, height };
-    for(auto i=0u; i<ChainCount; ++i)
-    { m_FrameBuffer[i] = null_handle; }
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -123,6 +155,12 @@ void App::StopDraw( bool isStopDraw )
 bool App::IsStopDraw() const
 { return m_IsStopDraw; }
 
+//-------------------------------------------------------------------------------------------------
+//      スタンバイモードかどうかチェックします.
+//-------------------------------------------------------------------------------------------------
+bool App::IsStandByMode() const
+{ return m_IsStandByMode; }
+
 //-------------------------------------------------------------------------------------------------
 //      フレームカウントを取得します.
 //-------------------------------------------------------------------------------------------------
@@ -180,6 +218,25 @@ bool App::InitApp()
         return false;
     }
 
+    // フレームペーサーの初期化.
+    {
+        // 未指定の場合，垂直同期で表示が制限されるならディスプレイのリフレッシュレートに合わせる.
+        auto targetFrameRate = m_TargetFrameRate;
+        if (targetFrameRate <= 0.0 && m_SwapChain.GetPresentMode() != VK_PRESENT_MODE_IMMEDIATE_KHR)
+        {
+            DEVMODEW mode = {};
+            mode.dmSize = sizeof(mode);
+            if (EnumDisplaySettingsW(nullptr, ENUM_CURRENT_SETTINGS, &mode) && mode.dmDisplayFrequency > 1)
+            { targetFrameRate = static_cast<double>(mode.dmDisplayFrequency); }
+        }
+
+        if ( !m_FramePacer.Init( targetFrameRate ) )
+        {
+            ELOG( "Error : FramePacer::Init() Failed." );
+            return false;
+        }
+    }
+
     // アプリケーション固有の初期化.
     if ( !OnInit() )
     {
@@ -187,6 +244,9 @@ bool App::InitApp()
         return false;
     }
 
+    // 初期化にかかった時間を最初のフレーム時間に含めない.
+    m_StepTimer.GetElapsedSec();
+
     // 正常終了.
     return true;
 }
@@ -196,12 +256,42 @@ bool App::InitApp()
 //-------------------------------------------------------------------------------------------------
 void App::TermApp()
 {
+    // 実行中のフレームの完了を待ってから破棄する.
+    m_CommandList.WaitAll(UINT64_MAX);
+
     // アプリケーション固有の終了処理.
     OnTerm();
 
     // Vulkanの終了処理.
     TermVulkan();
 
+    // フレームペーサーの終了処理.
+    m_FramePacer.Term();
+
+    // フレーム時間の集計結果を出力.
+    {
+        FrameTimeStats stats;
+        if ( m_FrameTimes.GetStats( &stats ) )
+        {
+            ILOG( "Frame Time : frames = %llu, hitches = %llu",
+                static_cast<unsigned long long>(stats.FrameCount),
+                static_cast<unsigned long long>(stats.HitchCount) );
+            ILOG( "    CPU : avg = %.3f ms, p50 = %.3f ms, p95 = %.3f ms, p99 = %.3f ms, max = %.3f ms",
+                stats.Cpu.AvgMs, stats.Cpu.P50Ms, stats.Cpu.P95Ms, stats.Cpu.P99Ms, stats.Cpu.MaxMs );
+            if ( stats.Gpu.SampleCount > 0 )
+            {
+                ILOG( "    GPU : avg = %.3f ms, p50 = %.3f ms, p95 = %.3f ms, p99 = %.3f ms, max = %.3f ms",
+                    stats.Gpu.AvgMs, stats.Gpu.P50Ms, stats.Gpu.P95Ms, stats.Gpu.P99Ms, stats.Gpu.MaxMs );
+            }
+
+            if ( m_FrameTimeCsvPath != nullptr && !m_FrameTimes.SaveCsv( m_FrameTimeCsvPath ) )
+            { ELOG( "Error : FrameTimeRecorder::SaveCsv() Failed." ); }
+        }
+
+        // TermApp() は Run() の終了時とデストラクタの両方から呼ばれるので，出力は1回だけにする.
+        m_FrameTimes.Reset();
+    }
+
     // ウィンドウの終了処理.
     TermWnd();
 
@@ -340,40 +430,108 @@ bool App::InitVulkan()
         return false;
     }
 
-    // コマンドリスト生成.
-    if (!m_CommandList.Init(
-        &m_DeviceMgr, 
-        QueueType_Graphics,
-        VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
-        VK_COMMAND_BUFFER_LEVEL_PRIMARY,
-        ChainCount))
+    // スワップチェインの生成.
+    // 同時処理フレーム数は表示ポリシーで決まるので，初期レイアウトの設定には一時的なコマンドリストを使う.
     {
-        ELOG( "Error : CommandList::Init() Failed." );
-        return false;
-    }
+        CommandList initCommand;
+        if (!initCommand.Init(
+            &m_DeviceMgr,
+            QueueType_Graphics,
+            VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+            VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+            1))
+        {
+            ELOG( "Error : CommandList::Init() Failed." );
+            return false;
+        }
 
-    // コマンドリストをリセットしておく.
-    m_CommandList.Reset();
-    auto cmd = m_CommandList.GetCurrentCommandBuffer();
+        initCommand.Reset();
+        auto cmd = initCommand.GetCurrentCommandBuffer();
 
-    // スワップチェインの生成.
-    {
         SwapChainDesc desc;
         desc.Width       = m_Width;
         desc.Height      = m_Height;
         desc.Format      = m_SwapChainFormat;
         desc.ColorSpace  = VK_COLORSPACE_SRGB_NONLINEAR_KHR;
-        desc.BufferCount = ChainCount;
+        desc.BufferCount = 0;
+        desc.Policy      = m_PresentPolicy;
         desc.hInstance   = m_hInst;
         desc.hWnd        = m_hWnd;
 
         if (!m_SwapChain.Init(&m_DeviceMgr, cmd, &desc))
         {
             ELOG( "Error : SwapChain::Init() Falied." );
+            initCommand.Close();
+            initCommand.Term(&m_DeviceMgr);
             return false;
         }
+
+        initCommand.Close();
+        m_DeviceMgr.GetGraphicsQueue()->Submit(
+            cmd,
+            null_handle,
+            VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+            null_handle,
+            initCommand.GetFence(0));
+        initCommand.WaitAll(UINT64_MAX);
+        initCommand.Term(&m_DeviceMgr);
+
+        ILOG( "Info : SwapChain BufferCount = %u, PresentMode = %d, FrameLatency = %u",
+            m_SwapChain.GetDesc().BufferCount,
+            static_cast<int>(m_SwapChain.GetPresentMode()),
+            m_SwapChain.GetFrameLatency() );
     }
 
+    // 同時処理フレーム数を決定. 未指定の場合は表示ポリシーに合わせる.
+    if (m_InFlightFrameCount == 0)
+    { m_InFlightFrameCount = m_SwapChain.GetFrameLatency(); }
+    if (m_InFlightFrameCount > m_SwapChain.GetDesc().BufferCount)
+    { m_InFlightFrameCount = m_SwapChain.GetDesc().BufferCount; }
+    if (m_InFlightFrameCount == 0)
+    { m_InFlightFrameCount = 1; }
+
+    // コマンドリスト生成(フレームごとに1つ).
+    if (!m_CommandList.Init(
+        &m_DeviceMgr, 
+        QueueType_Graphics,
+        VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+        VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+        m_InFlightFrameCount))
+    {
+        ELOG( "Error : CommandList::Init() Failed." );
+        return false;
+    }
+
+    // GPUプロファイラ生成(タイムスタンプ非対応の場合は計測せずに動作する).
+    if (!m_GpuProfiler.Init(
+        &m_DeviceMgr,
+        QueueType_Graphics,
+        m_InFlightFrameCount,
+        64,
+        16))
+    {
+        ELOG( "Error : GpuProfiler::Init() Failed." );
+        return false;
+    }
+    m_CommandList.SetProfiler(&m_GpuProfiler);
+
+    // イメージ取得はフレームごと, 描画完了は表示が終わるまで使われるのでイメージごとにセマフォを生成.
+    if (!CreateSemaphores(&m_AcquireSemaphores, m_InFlightFrameCount))
+    {
+        ELOG( "Error : App::CreateSemaphores() Failed." );
+        return false;
+    }
+
+    if (!CreateSemaphores(&m_RenderSemaphores, m_SwapChain.GetDesc().BufferCount))
+    {
+        ELOG( "Error : App::CreateSemaphores() Failed." );
+        return false;
+    }
+
+    // コマンドリストをリセットしておく.
+    m_CommandList.Reset();
+    auto cmd = m_CommandList.GetCurrentCommandBuffer();
+
     // 深度バッファの生成.
     {
         RenderBufferDesc desc;
@@ -437,6 +595,20 @@ bool App::InitVulkan()
         subpass.preserveAttachmentCount = 0;
         subpass.pPreserveAttachments    = nullptr;
 
+        // 複数フレームが同時に処理されるため, 深度バッファへの書き込みを前フレームと順序付ける.
+        VkSubpassDependency dependency = {};
+        dependency.srcSubpass       = VK_SUBPASS_EXTERNAL;
+        dependency.dstSubpass       = 0;
+        dependency.srcStageMask     = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT
+                                    | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        dependency.dstStageMask     = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT
+                                    | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+        dependency.srcAccessMask    = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        dependency.dstAccessMask    = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT
+                                    | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT
+                                    | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        dependency.dependencyFlags  = 0;
+
         VkRenderPassCreateInfo info = {};
         info.sType              = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
         info.pNext              = nullptr;
@@ -445,8 +617,8 @@ bool App::InitVulkan()
         info.pAttachments       = attachments;
         info.subpassCount       = 1;
         info.pSubpasses         = &subpass;
-        info.dependencyCount    = 0;
-        info.pDependencies      = nullptr;
+        info.dependencyCount    = 1;
+        info.pDependencies      = &dependency;
 
         auto result = vkCreateRenderPass(m_DeviceMgr.GetDevice(), &info, nullptr, &m_RenderPass);
         if (result != VK_SUCCESS)
@@ -471,9 +643,10 @@ bool App::InitVulkan()
         info.height             = m_Height;
         info.layers             = 1;
 
-        for(auto i=0u; i<ChainCount; ++i)
+        m_FrameBuffer.resize(m_SwapChain.GetDesc().BufferCount, null_handle);
+        for(size_t i=0; i<m_FrameBuffer.size(); ++i)
         {
-            attachments[0] = m_SwapChain.GetBuffer(i)->View;
+            attachments[0] = m_SwapChain.GetBuffer(uint32_t(i))->View;
             attachments[1] = m_DepthBuffer.GetView();
 
             auto result = vkCreateFramebuffer(m_DeviceMgr.GetDevice(), &info, nullptr, &m_FrameBuffer[i]);
@@ -539,6 +712,27 @@ bool App::InitVulkan()
         }
     }
 
+    // サブミットスレッドの開始. 以降キューへのアクセスは全てキュー経由で行うこと.
+    if ( m_IsSubmitThreadMode )
+    {
+        Queue* queues[] = {
+            m_DeviceMgr.GetGraphicsQueue(),
+            m_DeviceMgr.GetComputeQueue(),
+            m_DeviceMgr.GetTransferQueue(),
+        };
+
+        // 同じ VkQueue を指すキューは DeviceMgr が1つのインスタンスにまとめているので,
+        // どのキューから積んでも同じスレッドがサブミットする(開始済みなら何もしない).
+        for( auto i=0; i<3; ++i )
+        {
+            if ( !queues[i]->StartSubmitThread() )
+            {
+                ELOG( "Error : Queue::StartSubmitThread() Failed." );
+                return false;
+            }
+        }
+    }
+
     // 正常終了.
     return true;
 }
@@ -548,7 +742,26 @@ bool App::InitVulkan()
 //-------------------------------------------------------------------------------------------------
 void App::TermVulkan()
 {
-    for(auto i=0u; i<ChainCount; ++i)
+    // 積まれている表示要求が参照するセマフォを破棄する前に, 全ての要求をドライバに渡す.
+    m_DeviceMgr.GetGraphicsQueue()->StopSubmitThread();
+    m_DeviceMgr.GetComputeQueue ()->StopSubmitThread();
+    m_DeviceMgr.GetTransferQueue()->StopSubmitThread();
+
+    for(size_t i=0; i<m_AcquireSemaphores.size(); ++i)
+    {
+        if (m_AcquireSemaphores[i] != null_handle)
+        { vkDestroySemaphore(m_DeviceMgr.GetDevice(), m_AcquireSemaphores[i], nullptr); }
+    }
+    m_AcquireSemaphores.clear();
+
+    for(size_t i=0; i<m_RenderSemaphores.size(); ++i)
+    {
+        if (m_RenderSemaphores[i] != null_handle)
+        { vkDestroySemaphore(m_DeviceMgr.GetDevice(), m_RenderSemaphores[i], nullptr); }
+    }
+    m_RenderSemaphores.clear();
+
+    for(size_t i=0; i<m_FrameBuffer.size(); ++i)
     {
         if(auto device = m_DeviceMgr.GetDevice())
         {
@@ -556,6 +769,7 @@ void App::TermVulkan()
             m_FrameBuffer[i] = null_handle;
         }
     }
+    m_FrameBuffer.clear();
 
     if (m_RenderPass != null_handle)
     {
@@ -565,6 +779,7 @@ void App::TermVulkan()
 
     m_DepthBuffer.Term(&m_DeviceMgr);
     m_SwapChain  .Term(&m_DeviceMgr);
+    m_GpuProfiler.Term(&m_DeviceMgr);
     m_CommandList.Term(&m_DeviceMgr);
 
     m_DeviceMgr.Term();
@@ -577,8 +792,27 @@ void App::MainLoop()
 {
     MSG msg = { 0 };
 
+    // 描画スレッドモードではメッセージスレッドはイベントの転送だけを行う.
+    if ( m_IsRenderThreadMode )
+    {
+        StartRenderThread();
+
+        while( GetMessage( &msg, nullptr, 0, 0 ) > 0 )
+        {
+            auto ret = TranslateAccelerator( m_hWnd, m_hAccel, &msg );
+            if ( 0 == ret )
+            {
+                TranslateMessage( &msg );
+                DispatchMessage ( &msg );
+            }
+        }
+
+        StopRenderThread();
+        return;
+    }
+
     FrameEventArgs args;
-    auto frameCount = 0;
+    uint32_t frameCount = 0;
 
     while( WM_QUIT != msg.message )
     {
@@ -594,97 +828,451 @@ void App::MainLoop()
         }
         else
         {
-            double uptimeSec;
-            double absTimeSec;
-            double elapsedTimeSec;
-            m_StepTimer.GetValues( uptimeSec, absTimeSec, elapsedTimeSec );
+            // 見えていない間はメッセージが届くか次の確認時刻になるまで眠る.
+            if ( StandBy() )
+            { continue; }
 
-            auto interval = float( uptimeSec - m_LastUpdateSec );
-            if ( interval > 0.5 )
+            // 入力の取得時刻まで待機. 待機中に届いたメッセージは先に処理してから再度待つ.
+            if ( !m_FramePacer.Wait() )
+            { continue; }
+
+            m_FramePacer.BeginFrame();
+
+            // 待機明けに溜まっている入力を取り込んでからフレームを開始する.
+            while( PeekMessage( &msg, nullptr, 0, 0, PM_REMOVE ) )
             {
-                m_FramePerSec   = frameCount / interval;
-                m_LastUpdateSec = uptimeSec;
-                frameCount      = 0;
+                if ( 0 == TranslateAccelerator( m_hWnd, m_hAccel, &msg ) )
+                {
+                    TranslateMessage( &msg );
+                    DispatchMessage ( &msg );
+                }
+
+                if ( WM_QUIT == msg.message )
+                { break; }
             }
 
-            args.UpTimeSec   = uptimeSec;
-            args.FramePerSec = 1.0f / static_cast<float>(elapsedTimeSec);
-            args.ElapsedSec  = elapsedTimeSec;
-            args.IsStopDraw  = m_IsStopDraw;
+            if ( WM_QUIT == msg.message )
+            { break; }
 
-            OnFrameMove( args );
+            UpdateFrame( args, frameCount );
+        }
+    }
+}
 
-            if ( !IsStopDraw() )
-            {
-                OnFrameRender( args );
-                m_FrameCount++;
-            }
+//-------------------------------------------------------------------------------------------------
+//      フレームを更新して描画します.
+//-------------------------------------------------------------------------------------------------
+void App::UpdateFrame( FrameEventArgs& args, uint32_t& frameCount )
+{
+    double uptimeSec;
+    double absTimeSec;
+    double elapsedTimeSec;
+    m_StepTimer.GetValues( uptimeSec, absTimeSec, elapsedTimeSec );
 
-            frameCount++;
+    auto interval = float( uptimeSec - m_LastUpdateSec );
+    if ( interval > 0.5 )
+    {
+        m_FramePerSec   = frameCount / interval;
+        m_LastUpdateSec = uptimeSec;
+        frameCount      = 0;
+    }
+
+    args.UpTimeSec   = uptimeSec;
+    args.FramePerSec = 1.0f / static_cast<float>(elapsedTimeSec);
+    args.ElapsedSec  = elapsedTimeSec;
+    args.IsStopDraw  = m_IsStopDraw;
+
+    OnFrameMove( args );
+
+    // 固定ステップ更新. シミュレーションの負荷をフレームレートから切り離す.
+    args.Alpha          = 1.0f;
+    args.FixedStepCount = 0;
+    if ( m_FixedUpdateRate > 0.0 )
+    {
+        auto stepSec = 1.0 / m_FixedUpdateRate;
+        m_FixedAccumulatorSec += elapsedTimeSec;
+
+        while( m_FixedAccumulatorSec >= stepSec && args.FixedStepCount < m_MaxFixedStepCount )
+        {
+            m_FixedArgs.StepSec = stepSec;
+
+            OnFixedUpdate( m_FixedArgs );
+
+            m_FixedArgs.SimTimeSec += stepSec;
+            m_FixedArgs.StepIndex++;
+            m_FixedAccumulatorSec  -= stepSec;
+            args.FixedStepCount++;
+        }
+
+        // 追いつけない分は切り捨て，重いフレームの後に更新が連鎖して重くなるのを防ぐ.
+        if ( m_FixedAccumulatorSec >= stepSec )
+        { m_FixedAccumulatorSec = fmod( m_FixedAccumulatorSec, stepSec ); }
+
+        args.Alpha = static_cast<float>( m_FixedAccumulatorSec / stepSec );
+    }
+
+    if ( !IsStopDraw() )
+    {
+        if ( BeginFrame() )
+        {
+            OnFrameRender( args );
+            EndFrame();
         }
+        m_FrameCount++;
     }
+
+    m_FramePacer.EndFrame();
+
+    // GPU時間は読み戻し済みの最新フレームの値なので，同時処理フレーム数だけ遅れる.
+    m_FrameTimes.Record( elapsedTimeSec * 1000.0, m_GpuProfiler.GetFrameGpuMs() );
+
+    frameCount++;
 }
 
 //-------------------------------------------------------------------------------------------------
-//      アプリケーションを実行します.
+//      描画スレッドを開始します.
 //-------------------------------------------------------------------------------------------------
-void App::Run()
+void App::StartRenderThread()
 {
-    if ( InitApp() )
-    { MainLoop(); }
+    if ( m_RenderThread.joinable() )
+    { return; }
 
-    TermApp();
+    // スタンバイ中の描画スレッドはメッセージを受け取れないので，イベントで起こす.
+    m_hStandByEvent = CreateEventW( nullptr, FALSE, FALSE, nullptr );
+    if ( m_hStandByEvent == nullptr )
+    { ELOG( "Error : CreateEventW() Failed." ); }
+
+    // スレッド生成前に切り替えておき，以降のイベントを必ずキューに積ませる.
+    m_IsQuitRequested       = false;
+    m_IsRenderThreadRunning = true;
+
+    m_RenderThread = std::thread( &App::RenderThreadMain, this );
 }
 
 //-------------------------------------------------------------------------------------------------
-//      キー処理.
+//      描画スレッドを停止します.
 //-------------------------------------------------------------------------------------------------
-void App::DoKeyEvent( const KeyEventArgs& args )
-{ OnKey( args ); }
+void App::StopRenderThread()
+{
+    if ( !m_RenderThread.joinable() )
+    { return; }
+
+    RequestStopRenderThread();
+    m_RenderThread.join();
+
+    m_IsRenderThreadRunning = false;
+
+    if ( m_hStandByEvent != nullptr )
+    {
+        CloseHandle( m_hStandByEvent );
+        m_hStandByEvent = nullptr;
+    }
+
+    // 取り出されずに残ったイベントをこのスレッドで処理する(ドロップのファイル名を解放するため).
+    Event event;
+    while( m_EventQueue.Pop( &event ) )
+    { DispatchEvent( event ); }
+}
 
 //-------------------------------------------------------------------------------------------------
-//      リサイズ処理.
+//      描画スレッドに停止を要求します.
 //-------------------------------------------------------------------------------------------------
-void App::DoResizeEvent( const ResizeEventArgs& args )
+void App::RequestStopRenderThread()
 {
-    // パラメータ設定.
-    m_Width       = args.Width;
-    m_Height      = args.Height;
-    m_AspectRatio = args.AspectRatio;
+    m_IsQuitRequested = true;
+    WakeStandBy();
+}
 
-    m_Viewport.width  = static_cast<float>(m_Width);
-    m_Viewport.height = static_cast<float>(m_Height);
+//-------------------------------------------------------------------------------------------------
+//      描画スレッドのメイン処理です.
+//-------------------------------------------------------------------------------------------------
+void App::RenderThreadMain()
+{
+    FrameEventArgs args;
+    uint32_t frameCount = 0;
 
-    m_Scissor.extent.width  = m_Width;
-    m_Scissor.extent.height = m_Height;
+    while( !m_IsQuitRequested )
+    {
+        // 見えていない間はイベントが届くか次の確認時刻になるまで眠る.
+        if ( StandBy() )
+        {
+            Event event;
+            while( m_EventQueue.Pop( &event ) )
+            { DispatchEvent( event ); }
+            continue;
+        }
+
+        // このスレッドはウィンドウを持たないので，待機がメッセージで中断されることはない.
+        if ( !m_FramePacer.Wait() )
+        { continue; }
+
+        m_FramePacer.BeginFrame();
+
+        // 待機中に溜まった入力とリサイズをまとめて処理してからフレームを開始する.
+        Event event;
+        while( m_EventQueue.Pop( &event ) )
+        { DispatchEvent( event ); }
+
+        UpdateFrame( args, frameCount );
+    }
+}
 
-    for(auto i=0u; i<ChainCount; ++i)
+//-------------------------------------------------------------------------------------------------
+//      イベントを送信します.
+//-------------------------------------------------------------------------------------------------
+void App::PostEvent( const Event& event )
+{
+    if ( !m_IsRenderThreadRunning )
     {
-        vkDestroyFramebuffer(m_DeviceMgr.GetDevice(), m_FrameBuffer[i], nullptr);
-        m_FrameBuffer[i] = null_handle;
+        DispatchEvent( event );
+        return;
     }
-    m_DepthBuffer.Term(&m_DeviceMgr);
-    m_SwapChain  .Term(&m_DeviceMgr);
 
-    auto cmdBuffer = m_CommandList.GetCommandBuffer(m_CommandList.GetBufferIndex());
+    // 入力を捨てると押下と解放の対応が崩れるので，空きができるまで待つ.
+    while( !m_EventQueue.Push( event ) )
+    { std::this_thread::yield(); }
 
-    // スワップチェインを再生成.
+    WakeStandBy();
+}
+
+//-------------------------------------------------------------------------------------------------
+//      イベントを処理します.
+//-------------------------------------------------------------------------------------------------
+void App::DispatchEvent( const Event& event )
+{
+    switch( event.Type )
     {
-        SwapChainDesc desc;
-        desc.Width       = m_Width;
-        desc.Height      = m_Height;
-        desc.Format      = m_SwapChainFormat;
-        desc.ColorSpace  = VK_COLORSPACE_SRGB_NONLINEAR_KHR;
-        desc.BufferCount = ChainCount;
-        desc.hInstance   = m_hInst;
-        desc.hWnd        = m_hWnd;
+    case EventType_Key:
+        { DoKeyEvent( event.Key ); }
+        break;
+
+    case EventType_Mouse:
+        { DoMouseEvent( event.Mouse ); }
+        break;
 
-        if (!m_SwapChain.Init(&m_DeviceMgr, cmdBuffer, &desc))
-        { ELOG( "Error : SwapChain::Init() Falied." ); }
+    case EventType_Resize:
+        { DoResizeEvent( event.Resize ); }
+        break;
+
+    case EventType_Drop:
+        {
+            DoDropEvent( event.Drop );
+
+            // ファイル名リストの所有権はイベントが持っている.
+            auto files = event.Drop.Files;
+            for( uint32_t i=0; i<event.Drop.FileCount; ++i )
+            { SafeDeleteArray( files[i] ); }
+            SafeDeleteArray( files );
+        }
+        break;
     }
+}
 
-    // 深度バッファの生成.
+//-------------------------------------------------------------------------------------------------
+//      スタンバイ状態を更新し，必要なら待機します.
+//-------------------------------------------------------------------------------------------------
+bool App::StandBy()
+{
+    // 最小化中や別の仮想デスクトップにある間は描画しても見えない.
+    BOOL isCloaked = FALSE;
+    if ( FAILED( DwmGetWindowAttribute( m_hWnd, DWMWA_CLOAKED, &isCloaked, sizeof(isCloaked) ) ) )
+    { isCloaked = FALSE; }
+
+    auto isHidden   = IsIconic( m_hWnd ) || !IsWindowVisible( m_hWnd ) || isCloaked;
+    auto isThrottle = m_IsSurfaceSuspended || ( m_IsThrottleInactive && GetForegroundWindow() != m_hWnd );
+
+    m_IsStandByMode = isHidden || isThrottle;
+    if ( !m_IsStandByMode )
+    { return false; }
+
+    auto tickSec = ( m_StandByTickRate > 0.0 ) ? 1.0 / m_StandByTickRate : 0.1;
+    auto now     = m_StepTimer.GetAbsoluteSec();
+
+    // 見えてはいる場合は低頻度でフレームを進める. スワップチェインの再生成もここで再試行される.
+    if ( !isHidden && now >= m_NextTickSec )
+    {
+        m_NextTickSec = now + tickSec;
+        return false;
+    }
+
+    auto waitSec = isHidden ? tickSec : m_NextTickSec - now;
+    auto waitMs  = static_cast<DWORD>( waitSec * 1000.0 ) + 1;
+
+    if ( m_IsRenderThreadRunning )
+    {
+        if ( m_hStandByEvent != nullptr )
+        { WaitForSingleObject( m_hStandByEvent, waitMs ); }
+        else
+        { Sleep( waitMs ); }
+    }
+    else
+    { MsgWaitForMultipleObjects( 0, nullptr, FALSE, waitMs, QS_ALLINPUT ); }
+
+    // 休止していた時間を次のフレームの経過時間に含めない.
+    if ( isHidden )
+    { m_StepTimer.GetElapsedSec(); }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      スタンバイ中の描画スレッドを起こします.
+//-------------------------------------------------------------------------------------------------
+void App::WakeStandBy()
+{
+    // スタンバイに入る直前の通知も取りこぼさないよう，状態に関わらず通知する(自動リセット).
+    if ( m_hStandByEvent != nullptr )
+    { SetEvent( m_hStandByEvent ); }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      フレームの描画を開始します.
+//-------------------------------------------------------------------------------------------------
+bool App::BeginFrame()
+{
+    // 溜まったリサイズ要求と表示側からの再生成要求は，フレームの頭で1回だけ処理する.
+    if (m_IsResizeRequested || m_SwapChain.IsOutOfDate())
+    {
+        if (!m_IsResizeRequested)
+        {
+            m_ResizeArgs.Width       = m_Width;
+            m_ResizeArgs.Height      = m_Height;
+            m_ResizeArgs.AspectRatio = m_AspectRatio;
+        }
+
+        m_IsResizeRequested = true;
+        if (!ResizeSwapChain())
+        {
+            // サーフェイスの大きさが 0 の間は作り直せないので，表示されるまで更新を間引く.
+            m_IsSurfaceSuspended = true;
+            return false;
+        }
+
+        m_IsSurfaceSuspended = false;
+    }
+
+    // 再利用するフレームのフェンスだけを待機して記録を開始.
+    if (!m_CommandList.Reset())
+    { return false; }
+
+    // 前フレームのサブミット統計を保存してリセット.
+    m_DeviceMgr.GetGraphicsQueue()->GetStats(&m_QueueStats);
+    m_DeviceMgr.GetGraphicsQueue()->ResetStats();
+
+    // Reset() で読み戻したパイプライン統計を保存.
+    m_FrameStats.PipelinePassCount = m_GpuProfiler.GetFramePipelineStats(&m_FrameStats.Pipeline);
+
+    // 描画先のイメージを取得.
+    auto index = m_CommandList.GetBufferIndex();
+    if (!m_SwapChain.AcquireNextImage(m_AcquireSemaphores[index], UINT64_MAX))
+    {
+        // 記録を破棄して次のフレームに回す. 古くなっていた場合は次のフレームで再生成される.
+        m_CommandList.Close();
+        return false;
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      フレームの描画を終了します.
+//-------------------------------------------------------------------------------------------------
+void App::EndFrame()
+{
+    auto index = m_CommandList.GetBufferIndex();
+    auto image = m_SwapChain.GetBufferIndex();
+    auto cmd   = m_CommandList.GetCurrentCommandBuffer();
+
+    // コマンドの記録を終了.
+    m_CommandList.Close();
+
+    // イメージ取得を待ってから描画し, 完了をフェンスとセマフォに通知.
+    auto ret = m_DeviceMgr.GetGraphicsQueue()->Submit(
+        cmd,
+        m_AcquireSemaphores[index],
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+        m_RenderSemaphores[image],
+        m_CommandList.GetFence(index));
+    if (!ret)
+    {
+        // 取得したイメージを表示しないと返却されないので, コマンドなしでセマフォだけ受け渡して表示する.
+        SubmitBatch batch;
+        batch.AddWait(m_AcquireSemaphores[index], VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+        batch.AddSignal(m_RenderSemaphores[image]);
+        if (m_DeviceMgr.GetGraphicsQueue()->Submit(&batch) == 0)
+        {
+            // 表示もできない場合は, スワップチェインを作り直してイメージとセマフォを解放する.
+            ELOG( "Error : Queue::Submit() Failed. SwapChain will be recreated." );
+            m_ResizeArgs.Width       = m_Width;
+            m_ResizeArgs.Height      = m_Height;
+            m_ResizeArgs.AspectRatio = m_AspectRatio;
+            m_IsResizeRequested      = true;
+            return;
+        }
+    }
+
+    // 描画完了を待ってから表示.
+    m_SwapChain.Present(m_RenderSemaphores[image]);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      スワップチェインのサイズを変更します.
+//-------------------------------------------------------------------------------------------------
+bool App::ResizeSwapChain()
+{
+    // 実行中のフレームが使用しているリソースを破棄するので完了を待つ.
+    // セマフォを参照する表示要求も残さないようにドライバに渡しておく.
+    m_CommandList.WaitAll(UINT64_MAX);
+    m_DeviceMgr.GetGraphicsQueue()->Flush();
+
+    for(size_t i=0; i<m_FrameBuffer.size(); ++i)
+    {
+        if (m_FrameBuffer[i] != null_handle)
+        { vkDestroyFramebuffer(m_DeviceMgr.GetDevice(), m_FrameBuffer[i], nullptr); }
+        m_FrameBuffer[i] = null_handle;
+    }
+
+    // レイアウト変更コマンドの記録を開始.
+    auto index = m_CommandList.GetBufferIndex();
+    if (!m_CommandList.Reset())
+    { return false; }
+    auto cmdBuffer = m_CommandList.GetCurrentCommandBuffer();
+
+    auto prevWidth  = m_SwapChain.GetDesc().Width;
+    auto prevHeight = m_SwapChain.GetDesc().Height;
+
+    // サーフェイスを再利用してスワップチェインを再生成.
+    if (!m_SwapChain.Resize(cmdBuffer, m_ResizeArgs.Width, m_ResizeArgs.Height))
+    {
+        // 最小化中などは次のフレームで再試行する.
+        m_CommandList.Close();
+        return false;
+    }
+
+    // 表示できずに待機されないまま残ったイメージ取得セマフォがあり得るので, 旧スワップチェインの破棄後に作り直す.
+    if (!CreateSemaphores(&m_AcquireSemaphores, m_InFlightFrameCount))
+    { ELOG( "Error : App::CreateSemaphores() Failed." ); }
+
+    // イメージ数は再生成で変わることがあるので, 描画完了セマフォも合わせて作り直す.
+    if (!CreateSemaphores(&m_RenderSemaphores, m_SwapChain.GetDesc().BufferCount))
+    { ELOG( "Error : App::CreateSemaphores() Failed." ); }
+
+    // サーフェイスの都合で要求と異なるサイズになることがあるので，実際のサイズを採用する.
+    m_Width       = m_SwapChain.GetDesc().Width;
+    m_Height      = m_SwapChain.GetDesc().Height;
+    m_AspectRatio = static_cast<float>(m_Width) / static_cast<float>(m_Height);
+
+    m_Viewport.width  = static_cast<float>(m_Width);
+    m_Viewport.height = static_cast<float>(m_Height);
+
+    m_Scissor.extent.width  = m_Width;
+    m_Scissor.extent.height = m_Height;
+
+    // 深度バッファはサイズが変わった時だけ作り直す.
+    if (m_Width != prevWidth || m_Height != prevHeight || m_DepthBuffer.GetView() == null_handle)
     {
+        m_DepthBuffer.Term(&m_DeviceMgr);
+
         RenderBufferDesc desc;
         desc.Dimension  = VK_IMAGE_TYPE_2D;
         desc.Width      = m_Width;
@@ -715,9 +1303,11 @@ void App::DoResizeEvent( const ResizeEventArgs& args )
         info.height             = m_Height;
         info.layers             = 1;
 
-        for(auto i=0u; i<ChainCount; ++i)
+        // イメージ数はポリシーで決まり，再生成で変わることもある.
+        m_FrameBuffer.resize(m_SwapChain.GetDesc().BufferCount, null_handle);
+        for(size_t i=0; i<m_FrameBuffer.size(); ++i)
         {
-            attachments[0] = m_SwapChain.GetBuffer(i)->View;
+            attachments[0] = m_SwapChain.GetBuffer(uint32_t(i))->View;
             attachments[1] = m_DepthBuffer.GetView();
 
             auto result = vkCreateFramebuffer(m_DeviceMgr.GetDevice(), &info, nullptr, &m_FrameBuffer[i]);
@@ -726,7 +1316,103 @@ void App::DoResizeEvent( const ResizeEventArgs& args )
         }
     }
 
+    // レイアウト変更コマンドを実行.
+    m_CommandList.Close();
+    m_DeviceMgr.GetGraphicsQueue()->Submit(
+        cmdBuffer,
+        null_handle,
+        VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+        null_handle,
+        m_CommandList.GetFence(index));
+
+    m_IsResizeRequested = false;
+
+    ResizeEventArgs args = m_ResizeArgs;
+    args.Width       = m_Width;
+    args.Height      = m_Height;
+    args.AspectRatio = m_AspectRatio;
     OnResize( args );
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      セマフォを作り直します.
+//-------------------------------------------------------------------------------------------------
+bool App::CreateSemaphores(std::vector<VkSemaphore>* pSemaphores, uint32_t count)
+{
+    if (pSemaphores == nullptr)
+    {
+        ELOG( "Error : Invalid Argument." );
+        return false;
+    }
+
+    for(size_t i=0; i<pSemaphores->size(); ++i)
+    {
+        if ((*pSemaphores)[i] != null_handle)
+        { vkDestroySemaphore(m_DeviceMgr.GetDevice(), (*pSemaphores)[i], nullptr); }
+    }
+    pSemaphores->clear();
+    pSemaphores->resize(count, null_handle);
+
+    VkSemaphoreCreateInfo info = {};
+    info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    info.pNext = nullptr;
+    info.flags = 0;
+
+    for(auto i=0u; i<count; ++i)
+    {
+        auto result = vkCreateSemaphore(m_DeviceMgr.GetDevice(), &info, nullptr, &(*pSemaphores)[i]);
+        if ( result != VK_SUCCESS )
+        {
+            ELOG( "Error : vkCreateSemaphore() Failed." );
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      アプリケーションを実行します.
+//-------------------------------------------------------------------------------------------------
+void App::Run()
+{
+    if ( InitApp() )
+    { MainLoop(); }
+
+    TermApp();
+}
+
+//-------------------------------------------------------------------------------------------------
+//      キー処理.
+//-------------------------------------------------------------------------------------------------
+void App::DoKeyEvent( const KeyEventArgs& args )
+{ OnKey( args ); }
+
+//-------------------------------------------------------------------------------------------------
+//      リサイズ処理.
+//-------------------------------------------------------------------------------------------------
+void App::DoResizeEvent( const ResizeEventArgs& args )
+{
+    // Vulkan 初期化前ならパラメータだけ設定する.
+    if (m_DeviceMgr.GetDevice() == null_handle)
+    {
+        m_Width       = args.Width;
+        m_Height      = args.Height;
+        m_AspectRatio = args.AspectRatio;
+
+        m_Viewport.width  = static_cast<float>(m_Width);
+        m_Viewport.height = static_cast<float>(m_Height);
+
+        m_Scissor.extent.width  = m_Width;
+        m_Scissor.extent.height = m_Height;
+        return;
+    }
+
+    // ドラッグ中などで連続して届くので，最後のサイズだけを覚えておき次のフレームでまとめて再生成する.
+    m_ResizeArgs        = args;
+    m_IsResizeRequested = true;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -755,13 +1441,14 @@ LRESULT CALLBACK App::MsgProc( HWND hWnd, UINT msg, WPARAM wp, LPARAM lp )
         uint32_t mask = ( 1 << 29 );
         auto isAltDown = ( ( lp & mask ) != 0 );
 
-        KeyEventArgs args;
-        args.KeyCode   = uint32_t( wp );
-        args.IsAltDown = isAltDown;
-        args.IsKeyDown = isKeyDown;
+        Event event;
+        event.Type          = EventType_Key;
+        event.Key.KeyCode   = uint32_t( wp );
+        event.Key.IsAltDown = isAltDown;
+        event.Key.IsKeyDown = isKeyDown;
 
         for( auto app : g_AppList )
-        { app->DoKeyEvent( args ); }
+        { app->PostEvent( event ); }
     }
 
     const UINT OLD_WM_MOUSEWHEEL = 0x020A;
@@ -803,17 +1490,18 @@ LRESULT CALLBACK App::MsgProc( HWND hWnd, UINT msg, WPARAM wp, LPARAM lp )
         auto isDownX1 = ( ( state & MK_XBUTTON1 ) != 0 );
         auto isDownX2 = ( ( state & MK_XBUTTON2 ) != 0 );
 
-        MouseEventArgs args;
-        args.CursorX      = x;
-        args.CursorY      = y;
-        args.IsLeftDown   = isDownL;
-        args.IsMiddleDown = isDownM;
-        args.IsRightDown  = isDownR;
-        args.IsSide1Down  = isDownX1;
-        args.IsSide2Down  = isDownX2;
+        Event event;
+        event.Type               = EventType_Mouse;
+        event.Mouse.CursorX      = x;
+        event.Mouse.CursorY      = y;
+        event.Mouse.IsLeftDown   = isDownL;
+        event.Mouse.IsMiddleDown = isDownM;
+        event.Mouse.IsRightDown  = isDownR;
+        event.Mouse.IsSide1Down  = isDownX1;
+        event.Mouse.IsSide2Down  = isDownX2;
 
         for( auto app : g_AppList )
-        { app->DoMouseEvent( args ); }
+        { app->PostEvent( event ); }
     }
 
     switch( msg )
@@ -830,8 +1518,33 @@ LRESULT CALLBACK App::MsgProc( HWND hWnd, UINT msg, WPARAM wp, LPARAM lp )
         }
         break;
 
+    case WM_ACTIVATE:
+        {
+            // フォーカスが戻ったら間引きを解除するため描画スレッドを起こす.
+            for( auto app : g_AppList )
+            { app->WakeStandBy(); }
+        }
+        break;
+
+    case WM_CLOSE:
+        {
+            // 描画スレッドが記録・イメージ取得・表示の途中でサーフェイスを失わないよう,
+            // ウィンドウを破棄する前に終了を待つ. 描画スレッドはウィンドウにメッセージを送らないので待機してもデッドロックしない.
+            for( auto app : g_AppList )
+            { app->StopRenderThread(); }
+
+            DestroyWindow( hWnd );
+        }
+        return 0;
+
     case WM_DESTROY:
-        { PostQuitMessage( 0 ); }
+        {
+            // WM_CLOSE を経由せずに破棄された場合に備えて，ここでも停止を要求する.
+            for( auto app : g_AppList )
+            { app->RequestStopRenderThread(); }
+
+            PostQuitMessage( 0 );
+        }
         break;
 
     case WM_SIZE:
@@ -839,13 +1552,14 @@ LRESULT CALLBACK App::MsgProc( HWND hWnd, UINT msg, WPARAM wp, LPARAM lp )
             auto w = static_cast<uint32_t>( LOWORD( lp ) );
             auto h = static_cast<uint32_t>( HIWORD( lp ) );
 
-            ResizeEventArgs args;
-            args.Width  = asvk::Max( w, uint32_t( 1 ) );
-            args.Height = asvk::Max( h, uint32_t( 1 ) );
-            args.AspectRatio = float( args.Width ) / float( args.Height );
+            Event event;
+            event.Type          = EventType_Resize;
+            event.Resize.Width  = asvk::Max( w, uint32_t( 1 ) );
+            event.Resize.Height = asvk::Max( h, uint32_t( 1 ) );
+            event.Resize.AspectRatio = float( event.Resize.Width ) / float( event.Resize.Height );
 
             for( auto app : g_AppList )
-            { app->DoResizeEvent( args ); }
+            { app->PostEvent( event ); }
         }
         break;
 
@@ -855,23 +1569,23 @@ LRESULT CALLBACK App::MsgProc( HWND hWnd, UINT msg, WPARAM wp, LPARAM lp )
             if (fileCount <= 0)
             { break; }
 
-            DropEventArgs args;
-            args.Files = new wchar_t* [fileCount];
-            args.FileCount = fileCount;
-            for( uint32_t i=0; i<fileCount; ++i )
+            // 描画スレッドで処理される場合もあるので，ファイル名リストはアプリごとに確保して渡す.
+            for ( auto app : g_AppList )
             {
-                wchar_t* file = new wchar_t [ MAX_PATH ];
-                DragQueryFileW( (HDROP)wp, i, file, MAX_PATH );
-                args.Files[i] = file;
+                Event event;
+                event.Type           = EventType_Drop;
+                event.Drop.Files     = new wchar_t* [fileCount];
+                event.Drop.FileCount = fileCount;
+                for( uint32_t i=0; i<fileCount; ++i )
+                {
+                    wchar_t* file = new wchar_t [ MAX_PATH ];
+                    DragQueryFileW( (HDROP)wp, i, file, MAX_PATH );
+                    event.Drop.Files[i] = file;
+                }
+
+                app->PostEvent( event );
             }
 
-            for ( auto app : g_AppList )
-            { app->DoDropEvent( args ); }
-
-            for( uint32_t i=0; i<fileCount; ++i )
-            { SafeDeleteArray( args.Files[i] ); }
-            SafeDeleteArray( args.Files );
-
             DragFinish( (HDROP)wp );
         }
         break;
@@ -910,6 +1624,12 @@ void App::OnFrameMove( const FrameEventArgs& )
 void App::OnFrameRender( const FrameEventArgs& )
 { /* DO_NOTHING */ }
 
+//-------------------------------------------------------------------------------------------------
+//      固定ステップ更新時の処理です.
+//-------------------------------------------------------------------------------------------------
+void App::OnFixedUpdate( const FixedUpdateEventArgs& )
+{ /* DO_NOTHING */ }
+
 //-------------------------------------------------------------------------------------------------
 //      リサイズ時の処理
 //-------------------------------------------------------------------------------------------------
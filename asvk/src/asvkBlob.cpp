@@ -141,6 +141,29 @@ private:
     Blob& operator = (const Blob&) = delete;    // アクセス禁止.
 };
 
+//-------------------------------------------------------------------------------------------------
+//      バイト長オブジェクトを生成します.
+//-------------------------------------------------------------------------------------------------
+bool CreateBlob(size_t size, IBlob** ppOut)
+{
+    // 引数チェック.
+    if (ppOut == nullptr)
+    {
+        ELOG( "Error : Invalid Argument." );
+        return false;
+    }
+
+    auto blob = Blob::Create(size);
+    if (blob == nullptr)
+    {
+        ELOG( "Error : Blob::Create() Failed. size = %lu", size );
+        return false;
+    }
+
+    *ppOut = blob;
+    return true;
+}
+
 //-------------------------------------------------------------------------------------------------
 //      ファイルから読み込みします.
 //-------------------------------------------------------------------------------------------------
@@ -9,6 +9,36 @@
 //-------------------------------------------------------------------------------------------------
 #include <asvkCommandList.h>
 #include <asvkLogger.h>
+#include <cstring>
+#include <chrono>
+
+
+namespace /* anonymous */ {
+
+//-------------------------------------------------------------------------------------------------
+//      経過時間をミリ秒で取得します.
+//-------------------------------------------------------------------------------------------------
+inline double ElapsedMs
+(
+    const std::chrono::high_resolution_clock::time_point& begin,
+    const std::chrono::high_resolution_clock::time_point& end
+)
+{ return std::chrono::duration<double, std::milli>(end - begin).count(); }
+
+//-------------------------------------------------------------------------------------------------
+//      キュータイプに対応するキューを取得します.
+//-------------------------------------------------------------------------------------------------
+asvk::Queue* GetQueue(asvk::DeviceMgr* pDeviceMgr, asvk::QueueType queueType)
+{
+    if (queueType == asvk::QueueType_Graphics)
+    { return pDeviceMgr->GetGraphicsQueue(); }
+    else if (queueType == asvk::QueueType_Compute)
+    { return pDeviceMgr->GetComputeQueue(); }
+
+    return pDeviceMgr->GetTransferQueue();
+}
+
+} // namespace /* anonymous */
 
 
 namespace asvk {
@@ -21,8 +51,10 @@ namespace asvk {
 //      コンストラクタです.
 //-------------------------------------------------------------------------------------------------
 CommandList::CommandList()
-: m_CommandPool(null_handle)
+: m_Device     (null_handle)
+, m_CommandPool(null_handle)
 , m_BufferIndex(0)
+, m_pProfiler  (nullptr)
 { /* DO_NOTHING */ }
 
 //-------------------------------------------------------------------------------------------------
@@ -56,8 +88,10 @@ bool CommandList::Init
         info.pNext = nullptr;
         if (queueType == QueueType_Graphics)
         { info.queueFamilyIndex = pDeviceMgr->GetGraphicsQueue()->GetFamilyIndex(); }
-        else
+        else if (queueType == QueueType_Compute)
         { info.queueFamilyIndex = pDeviceMgr->GetComputeQueue()->GetFamilyIndex(); }
+        else
+        { info.queueFamilyIndex = pDeviceMgr->GetTransferQueue()->GetFamilyIndex(); }
         info.flags = createFlags;
 
         auto result = vkCreateCommandPool(pDeviceMgr->GetDevice(), &info, nullptr, &m_CommandPool);
@@ -87,6 +121,26 @@ bool CommandList::Init
         }
     }
 
+    // フェンスの生成.
+    {
+        VkFenceCreateInfo info = {};
+        info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        info.pNext = nullptr;
+        info.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+
+        m_Fences.resize(count);
+        for(auto i=0u; i<count; ++i)
+        {
+            auto result = vkCreateFence(pDeviceMgr->GetDevice(), &info, nullptr, &m_Fences[i]);
+            if ( result != VK_SUCCESS )
+            {
+                ELOG( "Error : vkCreateFence() Failed." );
+                return false;
+            }
+        }
+    }
+
+    m_Device      = pDeviceMgr->GetDevice();
     m_BufferIndex = 0;
 
     return true;
@@ -109,9 +163,18 @@ void CommandList::Term(DeviceMgr* pDeviceMgr)
     if (m_CommandPool != null_handle)
     { vkDestroyCommandPool(pDeviceMgr->GetDevice(), m_CommandPool, nullptr); }
 
+    for(size_t i=0; i<m_Fences.size(); ++i)
+    {
+        if (m_Fences[i] != null_handle)
+        { vkDestroyFence(pDeviceMgr->GetDevice(), m_Fences[i], nullptr); }
+    }
+
+    m_Device      = null_handle;
     m_CommandPool = null_handle;
     m_BufferIndex = 0;
+    m_pProfiler   = nullptr;
     m_CommandBuffers.clear();
+    m_Fences.clear();
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -119,6 +182,14 @@ void CommandList::Term(DeviceMgr* pDeviceMgr)
 //-------------------------------------------------------------------------------------------------
 bool CommandList::Reset()
 {
+    // 前回このバッファをサブミットしたフレームの完了だけを待つ.
+    auto result = vkWaitForFences(m_Device, 1, &m_Fences[m_BufferIndex], VK_TRUE, UINT64_MAX);
+    if ( result != VK_SUCCESS )
+    {
+        ELOG( "Error : vkWaitForFences() Failed." );
+        return false;
+    }
+
     VkCommandBufferInheritanceInfo inheritanceInfo = {};
     inheritanceInfo.sType                = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
     inheritanceInfo.pNext                = nullptr;
@@ -135,13 +206,17 @@ bool CommandList::Reset()
     beginInfo.flags            = 0;
     beginInfo.pInheritanceInfo = &inheritanceInfo;
 
-    auto result = vkBeginCommandBuffer(m_CommandBuffers[m_BufferIndex], &beginInfo);
+    result = vkBeginCommandBuffer(m_CommandBuffers[m_BufferIndex], &beginInfo);
     if ( result != VK_SUCCESS )
     {
         ELOG( "Error : vkBeginCommandBuffer() Failed." );
         return false;
     }
 
+    // フェンス待機済みなので, このバッファで前回計測した結果を読み戻せる.
+    if (m_pProfiler != nullptr)
+    { m_pProfiler->BeginFrame(m_CommandBuffers[m_BufferIndex], m_BufferIndex); }
+
     return true;
 }
 
@@ -187,4 +262,996 @@ VkCommandBuffer CommandList::GetCurrentCommandBuffer() const
 uint32_t CommandList::GetBufferIndex() const
 { return m_BufferIndex; }
 
+//-------------------------------------------------------------------------------------------------
+//      コマンドバッファの数を取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t CommandList::GetBufferCount() const
+{ return static_cast<uint32_t>(m_CommandBuffers.size()); }
+
+//-------------------------------------------------------------------------------------------------
+//      コマンドバッファに対応するフェンスを取得します.
+//-------------------------------------------------------------------------------------------------
+VkFence CommandList::GetFence(uint32_t index) const
+{ return m_Fences[index]; }
+
+//-------------------------------------------------------------------------------------------------
+//      全てのコマンドバッファの実行完了を待機します.
+//-------------------------------------------------------------------------------------------------
+void CommandList::WaitAll(uint64_t timeout)
+{
+    if (m_Device == null_handle || m_Fences.empty())
+    { return; }
+
+    auto result = vkWaitForFences(
+        m_Device,
+        static_cast<uint32_t>(m_Fences.size()),
+        m_Fences.data(),
+        VK_TRUE,
+        timeout);
+    if (result == VK_TIMEOUT)
+    { ILOG( "Info : vkWaitForFences() Timeout. time out nanoseconds = %ld", timeout ); }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      GPUプロファイラを設定します.
+//-------------------------------------------------------------------------------------------------
+void CommandList::SetProfiler(GpuProfiler* pProfiler)
+{ m_pProfiler = pProfiler; }
+
+//-------------------------------------------------------------------------------------------------
+//      GPUプロファイラを取得します.
+//-------------------------------------------------------------------------------------------------
+GpuProfiler* CommandList::GetProfiler() const
+{ return m_pProfiler; }
+
+//-------------------------------------------------------------------------------------------------
+//      区間の計測を開始します.
+//-------------------------------------------------------------------------------------------------
+void CommandList::BeginRegion(const char* name, bool pipelineStats)
+{
+    if (m_pProfiler == nullptr)
+    { return; }
+
+    m_pProfiler->BeginRegion(m_CommandBuffers[m_BufferIndex], name, pipelineStats);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      区間の計測を終了します.
+//-------------------------------------------------------------------------------------------------
+void CommandList::EndRegion()
+{
+    if (m_pProfiler == nullptr)
+    { return; }
+
+    m_pProfiler->EndRegion(m_CommandBuffers[m_BufferIndex]);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// ParallelCommandList class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+ParallelCommandList::ParallelCommandList()
+: m_Device      (null_handle)
+, m_ThreadCount (0)
+, m_FrameCount  (0)
+, m_FrameIndex  (0)
+, m_Generation  (0)
+, m_PendingCount(0)
+, m_IsExit      (false)
+, m_IsFailed    (false)
+, m_pFunc       (nullptr)
+{ memset(&m_Inheritance, 0, sizeof(m_Inheritance)); }
+
+//-------------------------------------------------------------------------------------------------
+//      デストラクタです.
+//-------------------------------------------------------------------------------------------------
+ParallelCommandList::~ParallelCommandList()
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      初期化処理を行います.
+//-------------------------------------------------------------------------------------------------
+bool ParallelCommandList::Init
+(
+    DeviceMgr*  pDeviceMgr,
+    QueueType   queueType,
+    uint32_t    threadCount,
+    uint32_t    frameCount
+)
+{
+    if (pDeviceMgr == nullptr || frameCount == 0)
+    {
+        ELOG( "Error : Invalid Argument." );
+        return false;
+    }
+
+    if (threadCount == 0)
+    {
+        threadCount = std::thread::hardware_concurrency();
+        if (threadCount == 0)
+        { threadCount = 1; }
+    }
+
+    m_Device      = pDeviceMgr->GetDevice();
+    m_ThreadCount = threadCount;
+    m_FrameCount  = frameCount;
+    m_FrameIndex  = 0;
+
+    // スレッドごと・フレームごとにコマンドプールを生成.
+    // コマンドプールは外部同期が必要なため, 1つのプールを複数スレッドで共有しない.
+    {
+        VkCommandPoolCreateInfo info = {};
+        info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        info.pNext = nullptr;
+        if (queueType == QueueType_Graphics)
+        { info.queueFamilyIndex = pDeviceMgr->GetGraphicsQueue()->GetFamilyIndex(); }
+        else if (queueType == QueueType_Compute)
+        { info.queueFamilyIndex = pDeviceMgr->GetComputeQueue()->GetFamilyIndex(); }
+        else
+        { info.queueFamilyIndex = pDeviceMgr->GetTransferQueue()->GetFamilyIndex(); }
+        info.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+        m_Contexts.resize(threadCount * frameCount);
+        for(size_t i=0; i<m_Contexts.size(); ++i)
+        {
+            m_Contexts[i].CommandPool = null_handle;
+            m_Contexts[i].UsedCount   = 0;
+        }
+
+        for(size_t i=0; i<m_Contexts.size(); ++i)
+        {
+            auto result = vkCreateCommandPool(m_Device, &info, nullptr, &m_Contexts[i].CommandPool);
+            if ( result != VK_SUCCESS )
+            {
+                ELOG( "Error : vkCreateCommandPool() Failed." );
+                return false;
+            }
+        }
+    }
+
+    m_Secondaries.resize(threadCount, null_handle);
+
+    // ワーカースレッドを起動. スレッド番号 0 は呼び出し元スレッドが担当する.
+    m_Generation   = 0;
+    m_PendingCount = 0;
+    m_IsExit       = false;
+    m_IsFailed     = false;
+
+    m_Workers.reserve(threadCount - 1);
+    for(auto i=1u; i<threadCount; ++i)
+    { m_Workers.emplace_back(&ParallelCommandList::WorkerMain, this, i); }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      終了処理を行います.
+//-------------------------------------------------------------------------------------------------
+void ParallelCommandList::Term(DeviceMgr* pDeviceMgr)
+{
+    // ワーカースレッドを終了.
+    {
+        std::lock_guard<std::mutex> locker(m_Mutex);
+        m_IsExit = true;
+    }
+    m_StartCond.notify_all();
+
+    for(size_t i=0; i<m_Workers.size(); ++i)
+    {
+        if (m_Workers[i].joinable())
+        { m_Workers[i].join(); }
+    }
+    m_Workers.clear();
+
+    for(size_t i=0; i<m_Contexts.size(); ++i)
+    {
+        auto& context = m_Contexts[i];
+        if (context.CommandPool == null_handle)
+        { continue; }
+
+        if (!context.CommandBuffers.empty())
+        {
+            vkFreeCommandBuffers(
+                pDeviceMgr->GetDevice(),
+                context.CommandPool,
+                static_cast<uint32_t>(context.CommandBuffers.size()),
+                context.CommandBuffers.data());
+        }
+
+        vkDestroyCommandPool(pDeviceMgr->GetDevice(), context.CommandPool, nullptr);
+    }
+
+    m_Device        = null_handle;
+    m_ThreadCount   = 0;
+    m_FrameCount    = 0;
+    m_FrameIndex    = 0;
+    m_pFunc         = nullptr;
+    m_Contexts   .clear();
+    m_Secondaries.clear();
+}
+
+//-------------------------------------------------------------------------------------------------
+//      指定フレームのコマンドプールをリセットします.
+//-------------------------------------------------------------------------------------------------
+bool ParallelCommandList::Reset(uint32_t frameIndex)
+{
+    if (frameIndex >= m_FrameCount)
+    {
+        ELOG( "Error : Invalid Argument." );
+        return false;
+    }
+
+    // コマンドバッファ単位ではなくプール単位でまとめてリセットする.
+    for(auto i=0u; i<m_ThreadCount; ++i)
+    {
+        auto& context = m_Contexts[frameIndex * m_ThreadCount + i];
+
+        auto result = vkResetCommandPool(m_Device, context.CommandPool, 0);
+        if ( result != VK_SUCCESS )
+        {
+            ELOG( "Error : vkResetCommandPool() Failed." );
+            return false;
+        }
+
+        context.UsedCount = 0;
+    }
+
+    m_FrameIndex = frameIndex;
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      セカンダリコマンドバッファを並列に記録し, プライマリコマンドバッファから実行します.
+//-------------------------------------------------------------------------------------------------
+bool ParallelCommandList::Record
+(
+    VkCommandBuffer                 primary,
+    VkRenderPass                    renderPass,
+    uint32_t                        subpass,
+    VkFramebuffer                   frameBuffer,
+    const RecordFunc&               func,
+    VkQueryPipelineStatisticFlags   pipelineStatistics
+)
+{
+    if (primary == null_handle || !func || m_ThreadCount == 0)
+    {
+        ELOG( "Error : Invalid Argument." );
+        return false;
+    }
+
+    m_Inheritance.sType                = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    m_Inheritance.pNext                = nullptr;
+    m_Inheritance.renderPass           = renderPass;
+    m_Inheritance.subpass              = subpass;
+    m_Inheritance.framebuffer          = frameBuffer;
+    m_Inheritance.occlusionQueryEnable = VK_FALSE;
+    m_Inheritance.queryFlags           = 0;
+    m_Inheritance.pipelineStatistics   = pipelineStatistics;
+
+    // ワーカースレッドに記録を要求.
+    {
+        std::lock_guard<std::mutex> locker(m_Mutex);
+        m_pFunc        = &func;
+        m_PendingCount = m_ThreadCount - 1;
+        m_IsFailed     = false;
+        m_Generation++;
+    }
+    m_StartCond.notify_all();
+
+    // 呼び出し元スレッドも記録に参加する.
+    auto succeeded = RecordSecondary(0);
+
+    // 全ワーカーの記録完了を待機.
+    {
+        std::unique_lock<std::mutex> locker(m_Mutex);
+        m_DoneCond.wait(locker, [this]() { return m_PendingCount == 0; });
+        m_pFunc = nullptr;
+
+        if (m_IsFailed)
+        { succeeded = false; }
+    }
+
+    if (!succeeded)
+    {
+        ELOG( "Error : ParallelCommandList::RecordSecondary() Failed." );
+        return false;
+    }
+
+    // スレッド番号順に実行するので, 描画順は記録関数側の分割で決まる.
+    vkCmdExecuteCommands(primary, m_ThreadCount, m_Secondaries.data());
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      記録スレッド数を取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t ParallelCommandList::GetThreadCount() const
+{ return m_ThreadCount; }
+
+//-------------------------------------------------------------------------------------------------
+//      同時に処理するフレーム数を取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t ParallelCommandList::GetFrameCount() const
+{ return m_FrameCount; }
+
+//-------------------------------------------------------------------------------------------------
+//      ワーカースレッドのメイン処理です.
+//-------------------------------------------------------------------------------------------------
+void ParallelCommandList::WorkerMain(uint32_t threadIndex)
+{
+    uint64_t generation = 0;
+
+    for(;;)
+    {
+        {
+            std::unique_lock<std::mutex> locker(m_Mutex);
+            m_StartCond.wait(locker, [&]() { return m_IsExit || m_Generation != generation; });
+
+            if (m_IsExit)
+            { return; }
+
+            generation = m_Generation;
+        }
+
+        auto succeeded = RecordSecondary(threadIndex);
+
+        bool isDone = false;
+        {
+            std::lock_guard<std::mutex> locker(m_Mutex);
+            if (!succeeded)
+            { m_IsFailed = true; }
+
+            m_PendingCount--;
+            isDone = (m_PendingCount == 0);
+        }
+
+        if (isDone)
+        { m_DoneCond.notify_one(); }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      指定スレッドのセカンダリコマンドバッファを記録します.
+//-------------------------------------------------------------------------------------------------
+bool ParallelCommandList::RecordSecondary(uint32_t threadIndex)
+{
+    auto& context = m_Contexts[m_FrameIndex * m_ThreadCount + threadIndex];
+    m_Secondaries[threadIndex] = null_handle;
+
+    // 足りなければ自スレッドのプールから追加で確保する.
+    if (context.UsedCount >= context.CommandBuffers.size())
+    {
+        VkCommandBufferAllocateInfo info = {};
+        info.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        info.pNext              = nullptr;
+        info.commandPool        = context.CommandPool;
+        info.level              = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+        info.commandBufferCount = 1;
+
+        VkCommandBuffer commandBuffer = null_handle;
+        auto result = vkAllocateCommandBuffers(m_Device, &info, &commandBuffer);
+        if ( result != VK_SUCCESS )
+        {
+            ELOG( "Error : vkAllocateCommandBuffers() Failed." );
+            return false;
+        }
+
+        context.CommandBuffers.push_back(commandBuffer);
+    }
+
+    auto commandBuffer = context.CommandBuffers[context.UsedCount];
+    context.UsedCount++;
+
+    VkCommandBufferBeginInfo beginInfo = {};
+    beginInfo.sType            = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.pNext            = nullptr;
+    beginInfo.flags            = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    beginInfo.pInheritanceInfo = &m_Inheritance;
+    if (m_Inheritance.renderPass != null_handle)
+    { beginInfo.flags |= VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT; }
+
+    auto result = vkBeginCommandBuffer(commandBuffer, &beginInfo);
+    if ( result != VK_SUCCESS )
+    {
+        ELOG( "Error : vkBeginCommandBuffer() Failed." );
+        return false;
+    }
+
+    (*m_pFunc)(threadIndex, commandBuffer);
+
+    result = vkEndCommandBuffer(commandBuffer);
+    if ( result != VK_SUCCESS )
+    {
+        ELOG( "Error : vkEndCommandBuffer() Failed." );
+        return false;
+    }
+
+    m_Secondaries[threadIndex] = commandBuffer;
+    return true;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// FrameCommandAllocator class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+FrameCommandAllocator::FrameCommandAllocator()
+: m_Device      (null_handle)
+, m_FrameIndex  (0)
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      デストラクタです.
+//-------------------------------------------------------------------------------------------------
+FrameCommandAllocator::~FrameCommandAllocator()
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      初期化処理を行います.
+//-------------------------------------------------------------------------------------------------
+bool FrameCommandAllocator::Init
+(
+    DeviceMgr*  pDeviceMgr,
+    QueueType   queueType,
+    uint32_t    frameCount
+)
+{
+    if (pDeviceMgr == nullptr || frameCount == 0)
+    {
+        ELOG( "Error : Invalid Argument." );
+        return false;
+    }
+
+    m_Device     = pDeviceMgr->GetDevice();
+    m_FrameIndex = 0;
+
+    m_Frames.resize(frameCount);
+    for(size_t i=0; i<m_Frames.size(); ++i)
+    {
+        m_Frames[i].CommandPool = null_handle;
+        m_Frames[i].UsedCount   = 0;
+        m_Frames[i].Fence       = null_handle;
+    }
+
+    // プール単位でリセットするので, コマンドバッファ単位のリセットフラグは指定しない.
+    VkCommandPoolCreateInfo poolInfo = {};
+    poolInfo.sType              = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.pNext              = nullptr;
+    poolInfo.flags              = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    poolInfo.queueFamilyIndex   = GetQueue(pDeviceMgr, queueType)->GetFamilyIndex();
+
+    VkFenceCreateInfo fenceInfo = {};
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    fenceInfo.pNext = nullptr;
+    fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+
+    for(size_t i=0; i<m_Frames.size(); ++i)
+    {
+        auto result = vkCreateCommandPool(m_Device, &poolInfo, nullptr, &m_Frames[i].CommandPool);
+        if ( result != VK_SUCCESS )
+        {
+            ELOG( "Error : vkCreateCommandPool() Failed." );
+            return false;
+        }
+
+        result = vkCreateFence(m_Device, &fenceInfo, nullptr, &m_Frames[i].Fence);
+        if ( result != VK_SUCCESS )
+        {
+            ELOG( "Error : vkCreateFence() Failed." );
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      終了処理を行います.
+//-------------------------------------------------------------------------------------------------
+void FrameCommandAllocator::Term(DeviceMgr* pDeviceMgr)
+{
+    for(size_t i=0; i<m_Frames.size(); ++i)
+    {
+        auto& frame = m_Frames[i];
+
+        if (frame.CommandPool != null_handle && !frame.CommandBuffers.empty())
+        {
+            vkFreeCommandBuffers(
+                pDeviceMgr->GetDevice(),
+                frame.CommandPool,
+                static_cast<uint32_t>(frame.CommandBuffers.size()),
+                frame.CommandBuffers.data());
+        }
+
+        if (frame.CommandPool != null_handle)
+        { vkDestroyCommandPool(pDeviceMgr->GetDevice(), frame.CommandPool, nullptr); }
+
+        if (frame.Fence != null_handle)
+        { vkDestroyFence(pDeviceMgr->GetDevice(), frame.Fence, nullptr); }
+    }
+
+    m_Device     = null_handle;
+    m_FrameIndex = 0;
+    m_Frames.clear();
+}
+
+//-------------------------------------------------------------------------------------------------
+//      フレームを開始します.
+//-------------------------------------------------------------------------------------------------
+bool FrameCommandAllocator::BeginFrame()
+{
+    auto& frame = m_Frames[m_FrameIndex];
+
+    // 前回このフレームをサブミットした処理の完了を待つ.
+    auto result = vkWaitForFences(m_Device, 1, &frame.Fence, VK_TRUE, UINT64_MAX);
+    if ( result != VK_SUCCESS )
+    {
+        ELOG( "Error : vkWaitForFences() Failed." );
+        return false;
+    }
+
+    // 確保済みのコマンドバッファをまとめて初期状態に戻す.
+    result = vkResetCommandPool(m_Device, frame.CommandPool, 0);
+    if ( result != VK_SUCCESS )
+    {
+        ELOG( "Error : vkResetCommandPool() Failed." );
+        return false;
+    }
+
+    frame.UsedCount = 0;
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      フレームを終了します.
+//-------------------------------------------------------------------------------------------------
+void FrameCommandAllocator::EndFrame()
+{ m_FrameIndex = (m_FrameIndex + 1) % static_cast<uint32_t>(m_Frames.size()); }
+
+//-------------------------------------------------------------------------------------------------
+//      記録を開始したプライマリコマンドバッファを取得します.
+//-------------------------------------------------------------------------------------------------
+VkCommandBuffer FrameCommandAllocator::Allocate()
+{
+    auto& frame = m_Frames[m_FrameIndex];
+
+    // 足りない分だけ確保し, 以降のフレームでは使い回す.
+    if (frame.UsedCount >= frame.CommandBuffers.size())
+    {
+        VkCommandBufferAllocateInfo info = {};
+        info.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        info.pNext              = nullptr;
+        info.commandPool        = frame.CommandPool;
+        info.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        info.commandBufferCount = 1;
+
+        VkCommandBuffer commandBuffer = null_handle;
+        auto result = vkAllocateCommandBuffers(m_Device, &info, &commandBuffer);
+        if ( result != VK_SUCCESS )
+        {
+            ELOG( "Error : vkAllocateCommandBuffers() Failed." );
+            return null_handle;
+        }
+
+        frame.CommandBuffers.push_back(commandBuffer);
+    }
+
+    auto commandBuffer = frame.CommandBuffers[frame.UsedCount];
+
+    VkCommandBufferBeginInfo beginInfo = {};
+    beginInfo.sType            = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.pNext            = nullptr;
+    beginInfo.flags            = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    beginInfo.pInheritanceInfo = nullptr;
+
+    auto result = vkBeginCommandBuffer(commandBuffer, &beginInfo);
+    if ( result != VK_SUCCESS )
+    {
+        ELOG( "Error : vkBeginCommandBuffer() Failed." );
+        return null_handle;
+    }
+
+    frame.UsedCount++;
+    return commandBuffer;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      現在のフレームのフェンスを取得します.
+//-------------------------------------------------------------------------------------------------
+VkFence FrameCommandAllocator::GetFence() const
+{ return m_Frames[m_FrameIndex].Fence; }
+
+//-------------------------------------------------------------------------------------------------
+//      現在のフレーム番号を取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t FrameCommandAllocator::GetFrameIndex() const
+{ return m_FrameIndex; }
+
+//-------------------------------------------------------------------------------------------------
+//      同時に処理するフレーム数を取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t FrameCommandAllocator::GetFrameCount() const
+{ return static_cast<uint32_t>(m_Frames.size()); }
+
+//-------------------------------------------------------------------------------------------------
+//      現在のフレームで割り当てたコマンドバッファ数を取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t FrameCommandAllocator::GetAllocatedCount() const
+{ return m_Frames[m_FrameIndex].UsedCount; }
+
+//-------------------------------------------------------------------------------------------------
+//      全てのフレームの実行完了を待機します.
+//-------------------------------------------------------------------------------------------------
+void FrameCommandAllocator::WaitAll(uint64_t timeout)
+{
+    if (m_Device == null_handle || m_Frames.empty())
+    { return; }
+
+    for(size_t i=0; i<m_Frames.size(); ++i)
+    {
+        auto result = vkWaitForFences(m_Device, 1, &m_Frames[i].Fence, VK_TRUE, timeout);
+        if (result == VK_TIMEOUT)
+        { ILOG( "Info : vkWaitForFences() Timeout. time out nanoseconds = %ld", timeout ); }
+    }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// StaticCommandList class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+StaticCommandList::StaticCommandList()
+: m_Device      (null_handle)
+, m_pQueue      (nullptr)
+, m_CommandPool (null_handle)
+, m_RecordCount (0)
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      デストラクタです.
+//-------------------------------------------------------------------------------------------------
+StaticCommandList::~StaticCommandList()
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      初期化処理を行います.
+//-------------------------------------------------------------------------------------------------
+bool StaticCommandList::Init
+(
+    DeviceMgr*  pDeviceMgr,
+    QueueType   queueType,
+    uint32_t    count
+)
+{
+    if (pDeviceMgr == nullptr || count == 0)
+    {
+        ELOG( "Error : Invalid Argument." );
+        return false;
+    }
+
+    m_Device      = pDeviceMgr->GetDevice();
+    m_pQueue      = GetQueue(pDeviceMgr, queueType);
+    m_RecordCount = 0;
+
+    // 再記録はバッファ単位で行うのでリセットフラグを指定する.
+    {
+        VkCommandPoolCreateInfo info = {};
+        info.sType              = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        info.pNext              = nullptr;
+        info.flags              = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+        info.queueFamilyIndex   = m_pQueue->GetFamilyIndex();
+
+        auto result = vkCreateCommandPool(m_Device, &info, nullptr, &m_CommandPool);
+        if ( result != VK_SUCCESS )
+        {
+            ELOG( "Error : vkCreateCommandPool() Failed." );
+            return false;
+        }
+    }
+
+    // セカンダリコマンドバッファの生成.
+    {
+        std::vector<VkCommandBuffer> buffers(count);
+
+        VkCommandBufferAllocateInfo info = {};
+        info.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        info.pNext              = nullptr;
+        info.commandPool        = m_CommandPool;
+        info.level              = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+        info.commandBufferCount = count;
+
+        auto result = vkAllocateCommandBuffers(m_Device, &info, buffers.data());
+        if ( result != VK_SUCCESS )
+        {
+            ELOG( "Error : vkAllocateCommandBuffers() Failed." );
+            return false;
+        }
+
+        m_Entries.resize(count);
+        for(auto i=0u; i<count; ++i)
+        {
+            m_Entries[i].CommandBuffer  = buffers[i];
+            m_Entries[i].RenderPass     = null_handle;
+            m_Entries[i].Subpass        = 0;
+            m_Entries[i].FrameBuffer    = null_handle;
+            m_Entries[i].StateKey       = 0;
+            m_Entries[i].PipelineStatistics = 0;
+            m_Entries[i].UseTicket      = 0;
+            m_Entries[i].IsValid        = false;
+        }
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      終了処理を行います.
+//-------------------------------------------------------------------------------------------------
+void StaticCommandList::Term(DeviceMgr* pDeviceMgr)
+{
+    if (m_CommandPool != null_handle)
+    {
+        for(size_t i=0; i<m_Entries.size(); ++i)
+        { vkFreeCommandBuffers(pDeviceMgr->GetDevice(), m_CommandPool, 1, &m_Entries[i].CommandBuffer); }
+
+        vkDestroyCommandPool(pDeviceMgr->GetDevice(), m_CommandPool, nullptr);
+    }
+
+    m_Device      = null_handle;
+    m_pQueue      = nullptr;
+    m_CommandPool = null_handle;
+    m_RecordCount = 0;
+    m_Entries.clear();
+}
+
+//-------------------------------------------------------------------------------------------------
+//      記録済みのコマンドを全て無効にします.
+//-------------------------------------------------------------------------------------------------
+void StaticCommandList::Invalidate()
+{
+    for(size_t i=0; i<m_Entries.size(); ++i)
+    { m_Entries[i].IsValid = false; }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      記録済みのセカンダリコマンドバッファをプライマリコマンドバッファから実行します.
+//-------------------------------------------------------------------------------------------------
+bool StaticCommandList::Execute
+(
+    VkCommandBuffer                 primary,
+    uint32_t                        index,
+    VkRenderPass                    renderPass,
+    uint32_t                        subpass,
+    VkFramebuffer                   frameBuffer,
+    uint64_t                        stateKey,
+    const RecordFunc&               func,
+    VkQueryPipelineStatisticFlags   pipelineStatistics
+)
+{
+    if (primary == null_handle || index >= m_Entries.size() || !func)
+    {
+        ELOG( "Error : Invalid Argument." );
+        return false;
+    }
+
+    auto& entry = m_Entries[index];
+
+    auto isDirty = !entry.IsValid
+                || entry.RenderPass  != renderPass
+                || entry.Subpass     != subpass
+                || entry.FrameBuffer != frameBuffer
+                || entry.StateKey    != stateKey
+                || entry.PipelineStatistics != pipelineStatistics;
+
+    if (isDirty)
+    {
+        // 前回このバッファを参照したサブミットが完了するまでは書き換えられない.
+        // どのチケットで実行されたかは分からないので, それ以降のサブミット済みチケットを全て待つ.
+        auto submitted = m_pQueue->GetSubmittedTicket();
+        if (entry.UseTicket != 0 && entry.UseTicket <= submitted)
+        { m_pQueue->WaitFor(submitted); }
+
+        VkCommandBufferInheritanceInfo inheritanceInfo = {};
+        inheritanceInfo.sType                = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+        inheritanceInfo.pNext                = nullptr;
+        inheritanceInfo.renderPass           = renderPass;
+        inheritanceInfo.subpass              = subpass;
+        inheritanceInfo.framebuffer          = frameBuffer;
+        inheritanceInfo.occlusionQueryEnable = VK_FALSE;
+        inheritanceInfo.queryFlags           = 0;
+        inheritanceInfo.pipelineStatistics   = pipelineStatistics;
+
+        // 同じバッファが複数の実行中フレームから参照されうるので同時使用を許可する.
+        VkCommandBufferBeginInfo beginInfo = {};
+        beginInfo.sType            = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.pNext            = nullptr;
+        beginInfo.flags            = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT
+                                   | VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
+        beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+        auto result = vkBeginCommandBuffer(entry.CommandBuffer, &beginInfo);
+        if ( result != VK_SUCCESS )
+        {
+            ELOG( "Error : vkBeginCommandBuffer() Failed." );
+            entry.IsValid = false;
+            return false;
+        }
+
+        func(index, entry.CommandBuffer);
+
+        result = vkEndCommandBuffer(entry.CommandBuffer);
+        if ( result != VK_SUCCESS )
+        {
+            ELOG( "Error : vkEndCommandBuffer() Failed." );
+            entry.IsValid = false;
+            return false;
+        }
+
+        entry.RenderPass  = renderPass;
+        entry.Subpass     = subpass;
+        entry.FrameBuffer = frameBuffer;
+        entry.StateKey    = stateKey;
+        entry.PipelineStatistics = pipelineStatistics;
+        entry.IsValid     = true;
+        m_RecordCount++;
+    }
+
+    vkCmdExecuteCommands(primary, 1, &entry.CommandBuffer);
+
+    // プライマリが実行されうる最小のチケットを覚えておく.
+    entry.UseTicket = m_pQueue->GetSubmittedTicket() + 1;
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      バッファ数を取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t StaticCommandList::GetCount() const
+{ return static_cast<uint32_t>(m_Entries.size()); }
+
+//-------------------------------------------------------------------------------------------------
+//      記録した回数を取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t StaticCommandList::GetRecordCount() const
+{ return m_RecordCount; }
+
+
+//-------------------------------------------------------------------------------------------------
+//      コマンドバッファごとのリセットとコマンドプールのリセットを比較するベンチマークを実行します.
+//-------------------------------------------------------------------------------------------------
+bool RunCommandBenchmark
+(
+    DeviceMgr*              pDeviceMgr,
+    uint32_t                bufferCount,
+    uint32_t                frameCount,
+    CommandBenchmarkResult* pResult
+)
+{
+    if (pDeviceMgr == nullptr || bufferCount == 0 || frameCount == 0 || pResult == nullptr)
+    {
+        ELOG( "Error : Invalid Argument." );
+        return false;
+    }
+
+    auto pQueue = pDeviceMgr->GetGraphicsQueue();
+
+    // 0 : コマンドバッファごとのリセット (CommandList と同じ方式).
+    {
+        CommandList list;
+        if (!list.Init(
+            pDeviceMgr,
+            QueueType_Graphics,
+            VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+            VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+            bufferCount))
+        {
+            ELOG( "Error : CommandList::Init() Failed." );
+            list.Term(pDeviceMgr);
+            return false;
+        }
+
+        VkCommandBufferBeginInfo beginInfo = {};
+        beginInfo.sType            = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.pNext            = nullptr;
+        beginInfo.flags            = 0;
+        beginInfo.pInheritanceInfo = nullptr;
+
+        std::vector<VkCommandBuffer> buffers(bufferCount);
+        for(auto i=0u; i<bufferCount; ++i)
+        { buffers[i] = list.GetCommandBuffer(i); }
+
+        auto totalMs = 0.0;
+        for(auto frame=0u; frame<frameCount; ++frame)
+        {
+            auto begin = std::chrono::high_resolution_clock::now();
+            for(auto i=0u; i<bufferCount; ++i)
+            {
+                vkBeginCommandBuffer(buffers[i], &beginInfo);
+                vkEndCommandBuffer(buffers[i]);
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            totalMs += ElapsedMs(begin, end);
+
+            auto ticket = pQueue->Execute(bufferCount, buffers.data());
+            if (ticket == 0)
+            {
+                ELOG( "Error : Queue::Execute() Failed." );
+                list.Term(pDeviceMgr);
+                return false;
+            }
+            pQueue->WaitFor(ticket);
+        }
+
+        list.Term(pDeviceMgr);
+        pResult->BufferResetMs = totalMs / frameCount;
+    }
+
+    // 1 : コマンドプールのリセット.
+    {
+        FrameCommandAllocator allocator;
+        if (!allocator.Init(pDeviceMgr, QueueType_Graphics, 1))
+        {
+            ELOG( "Error : FrameCommandAllocator::Init() Failed." );
+            allocator.Term(pDeviceMgr);
+            return false;
+        }
+
+        SubmitBatch batch;
+        auto totalMs = 0.0;
+        for(auto frame=0u; frame<frameCount; ++frame)
+        {
+            batch.Reset();
+
+            auto begin = std::chrono::high_resolution_clock::now();
+            allocator.BeginFrame();
+            for(auto i=0u; i<bufferCount; ++i)
+            {
+                auto cmd = allocator.Allocate();
+                if (cmd == null_handle)
+                {
+                    ELOG( "Error : FrameCommandAllocator::Allocate() Failed." );
+                    allocator.Term(pDeviceMgr);
+                    return false;
+                }
+                vkEndCommandBuffer(cmd);
+                batch.AddCommandBuffer(cmd);
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            totalMs += ElapsedMs(begin, end);
+
+            auto ticket = pQueue->Submit(&batch, allocator.GetFence());
+            if (ticket == 0)
+            {
+                ELOG( "Error : Queue::Submit() Failed." );
+                allocator.Term(pDeviceMgr);
+                return false;
+            }
+            pQueue->WaitFor(ticket);
+            allocator.EndFrame();
+        }
+
+        allocator.WaitAll(UINT64_MAX);
+        allocator.Term(pDeviceMgr);
+        pResult->PoolResetMs = totalMs / frameCount;
+    }
+
+    ILOG( "Info : Command Benchmark (%u buffers/frame, %u frames)", bufferCount, frameCount );
+    ILOG( "    BufferReset : %.4f ms/frame", pResult->BufferResetMs );
+    ILOG( "    PoolReset   : %.4f ms/frame", pResult->PoolResetMs );
+
+    return true;
+}
+
 } // namespace asvk
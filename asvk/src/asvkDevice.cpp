@@ -10,8 +10,11 @@
 #include <asvkTypedef.h>
 #include <asvkDevice.h>
 #include <asvkLogger.h>
-#include <array>
+#include <vector>
 #include <cassert>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
 
 
 namespace /* anonymous */ {
@@ -30,7 +33,41 @@ void* VKAPI_CALL Alloc
 {
     ASVK_UNUSED(pUserData);
     ASVK_UNUSED(scope);
+#if defined(_WIN32)
     return _aligned_malloc(size, alignment);
+#else
+    if (alignment < sizeof(size_t) * 2)
+    { alignment = sizeof(size_t) * 2; }
+
+    void* pBase = nullptr;
+    if (posix_memalign(&pBase, alignment, size + alignment) != 0)
+    { return nullptr; }
+
+    // 先頭に確保サイズ, 返却ポインタの直前に先頭までのオフセットを格納しておく.
+    static_cast<size_t*>(pBase)[0] = size;
+
+    auto pResult = static_cast<uint8_t*>(pBase) + alignment;
+    reinterpret_cast<size_t*>(pResult)[-1] = alignment;
+    return pResult;
+#endif
+}
+
+//-------------------------------------------------------------------------------------------------
+//      メモリ解放処理.
+//-------------------------------------------------------------------------------------------------
+VKAPI_ATTR
+void VKAPI_CALL Free(void* pUserData, void* pMemory)
+{
+    ASVK_UNUSED(pUserData);
+#if defined(_WIN32)
+    _aligned_free( pMemory );
+#else
+    if (pMemory == nullptr)
+    { return; }
+
+    auto offset = reinterpret_cast<size_t*>(pMemory)[-1];
+    free( static_cast<uint8_t*>(pMemory) - offset );
+#endif
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -48,17 +85,30 @@ void* VKAPI_CALL Realloc
 {
     ASVK_UNUSED(pUserData);
     ASVK_UNUSED(scope);
+#if defined(_WIN32)
     return _aligned_realloc(pOriginal, size, alignment);
-}
+#else
+    if (pOriginal == nullptr)
+    { return Alloc(pUserData, size, alignment, scope); }
 
-//-------------------------------------------------------------------------------------------------
-//      メモリ解放処理.
-//-------------------------------------------------------------------------------------------------
-VKAPI_ATTR
-void VKAPI_CALL Free(void* pUserData, void* pMemory)
-{
-    ASVK_UNUSED(pUserData);
-    _aligned_free( pMemory );
+    if (size == 0)
+    {
+        Free(pUserData, pOriginal);
+        return nullptr;
+    }
+
+    auto offset  = reinterpret_cast<size_t*>(pOriginal)[-1];
+    auto pHeader = reinterpret_cast<size_t*>(static_cast<uint8_t*>(pOriginal) - offset);
+    auto oldSize = pHeader[0];
+
+    auto pResult = Alloc(pUserData, size, alignment, scope);
+    if (pResult == nullptr)
+    { return nullptr; }
+
+    memcpy(pResult, pOriginal, (oldSize < size) ? oldSize : size);
+    Free(pUserData, pOriginal);
+    return pResult;
+#endif
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -106,6 +156,272 @@ VkBool32 VKAPI_CALL DebugReport
     return false;
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// QueueLocation structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct QueueLocation
+{
+    uint32_t    FamilyIndex;    //!< ファミリーインデックスです.
+    uint32_t    QueueIndex;     //!< ファミリー内のキューインデックスです.
+};
+
+//-------------------------------------------------------------------------------------------------
+//      キューの配置を決定します.
+//-------------------------------------------------------------------------------------------------
+bool FindQueueLocation
+(
+    const std::vector<VkQueueFamilyProperties>& props,
+    QueueLocation*                              pGraphics,
+    QueueLocation*                              pCompute,
+    QueueLocation*                              pTransfer
+)
+{
+    const uint32_t kInvalid = UINT32_MAX;
+
+    uint32_t graphicsFamily = kInvalid;
+    uint32_t computeFamily  = kInvalid;
+    uint32_t transferFamily = kInvalid;
+
+    for(auto i=0u; i<props.size(); ++i)
+    {
+        if (props[i].queueCount == 0)
+        { continue; }
+
+        auto flags = props[i].queueFlags;
+
+        // グラフィックスはコンピュートも可能なファミリーを優先.
+        if (flags & VK_QUEUE_GRAPHICS_BIT)
+        {
+            if (graphicsFamily == kInvalid
+            || ((flags & VK_QUEUE_COMPUTE_BIT) && !(props[graphicsFamily].queueFlags & VK_QUEUE_COMPUTE_BIT)))
+            { graphicsFamily = i; }
+        }
+        // グラフィックス非対応のコンピュートファミリーは非同期コンピュート用.
+        else if (flags & VK_QUEUE_COMPUTE_BIT)
+        {
+            if (computeFamily == kInvalid)
+            { computeFamily = i; }
+        }
+        // 転送専用ファミリーはDMAエンジン.
+        else if (flags & VK_QUEUE_TRANSFER_BIT)
+        {
+            if (transferFamily == kInvalid)
+            { transferFamily = i; }
+        }
+    }
+
+    if (graphicsFamily == kInvalid)
+    { return false; }
+
+    pGraphics->FamilyIndex = graphicsFamily;
+    pGraphics->QueueIndex  = 0;
+
+    // ファミリーごとの使用済みキュー数.
+    std::vector<uint32_t> used;
+    used.resize(props.size(), 0);
+    used[graphicsFamily] = 1;
+
+    // 空いているキューがあれば割り当て, 無ければ既存のキューを共有する.
+    auto assign = [&](uint32_t family, const QueueLocation& fallback, QueueLocation* pResult)
+    {
+        if (family != kInvalid && used[family] < props[family].queueCount)
+        {
+            pResult->FamilyIndex = family;
+            pResult->QueueIndex  = used[family]++;
+        }
+        else
+        { *pResult = fallback; }
+    };
+
+    // コンピュート : 専用ファミリー -> グラフィックスファミリーの別キュー -> グラフィックスキューを共有.
+    if (computeFamily != kInvalid)
+    { assign(computeFamily, *pGraphics, pCompute); }
+    else if (props[graphicsFamily].queueFlags & VK_QUEUE_COMPUTE_BIT)
+    { assign(graphicsFamily, *pGraphics, pCompute); }
+    else
+    { *pCompute = *pGraphics; }
+
+    // 転送 : 専用ファミリー -> コンピュートファミリーの別キュー -> グラフィックスファミリーの別キュー -> 共有.
+    // グラフィックス・コンピュート対応のファミリーは暗黙的に転送をサポートする.
+    if (transferFamily != kInvalid)
+    { assign(transferFamily, *pGraphics, pTransfer); }
+    else if (computeFamily != kInvalid && used[computeFamily] < props[computeFamily].queueCount)
+    { assign(computeFamily, *pCompute, pTransfer); }
+    else
+    { assign(graphicsFamily, *pGraphics, pTransfer); }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      デバイス拡張機能がサポートされているかどうかチェックします.
+//-------------------------------------------------------------------------------------------------
+bool IsSupportDeviceExtension(VkPhysicalDevice gpu, const char* name)
+{
+    uint32_t count = 0;
+    auto result = vkEnumerateDeviceExtensionProperties(gpu, nullptr, &count, nullptr);
+    if ( result != VK_SUCCESS || count == 0 )
+    { return false; }
+
+    std::vector<VkExtensionProperties> props;
+    props.resize(count);
+    result = vkEnumerateDeviceExtensionProperties(gpu, nullptr, &count, props.data());
+    if ( result != VK_SUCCESS )
+    { return false; }
+
+    for(auto i=0u; i<count; ++i)
+    {
+        if (strcmp(props[i].extensionName, name) == 0)
+        { return true; }
+    }
+
+    return false;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      インスタンス拡張機能をサポートしているかどうかチェックします.
+//-------------------------------------------------------------------------------------------------
+bool IsSupportInstanceExtension(const char* name)
+{
+    uint32_t count = 0;
+    auto result = vkEnumerateInstanceExtensionProperties(nullptr, &count, nullptr);
+    if ( result != VK_SUCCESS || count == 0 )
+    { return false; }
+
+    std::vector<VkExtensionProperties> props;
+    props.resize(count);
+    result = vkEnumerateInstanceExtensionProperties(nullptr, &count, props.data());
+    if ( result != VK_SUCCESS )
+    { return false; }
+
+    for(auto i=0u; i<count; ++i)
+    {
+        if (strcmp(props[i].extensionName, name) == 0)
+        { return true; }
+    }
+
+    return false;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      物理デバイスを評価します.
+//-------------------------------------------------------------------------------------------------
+int32_t ScorePhysicalDevice(const asvk::PhysicalDevice& device, bool headless, bool allowTimeline)
+{
+    uint32_t propCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(device.Gpu, &propCount, nullptr);
+
+    std::vector<VkQueueFamilyProperties> props;
+    props.resize(propCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(device.Gpu, &propCount, props.data());
+
+    // 必須条件 : グラフィックスキューとスワップチェイン.
+    QueueLocation graphics;
+    QueueLocation compute;
+    QueueLocation transfer;
+    if (!FindQueueLocation(props, &graphics, &compute, &transfer))
+    { return -1; }
+
+    if (!headless && !IsSupportDeviceExtension(device.Gpu, VK_KHR_SWAPCHAIN_EXTENSION_NAME))
+    { return -1; }
+
+    // ノートPCでは内蔵GPUが先に列挙されることが多いので, デバイスタイプを最も重視する.
+    int32_t score = 0;
+    switch(device.Props.deviceType)
+    {
+    case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:      score += 1000; break;
+    case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU:    score += 500;  break;
+    case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:       score += 200;  break;
+    case VK_PHYSICAL_DEVICE_TYPE_CPU:               score += 100;  break;
+    default:                                        break;
+    }
+
+    // デバイスローカルメモリは 256MiB ごとに加点する(デバイスタイプの差を覆さないよう上限を設ける).
+    auto heapScore = static_cast<int32_t>(device.LocalHeapSize / (256ull * 1024 * 1024));
+    score += (heapScore < 256) ? heapScore : 256;
+
+    // 任意の機能.
+    VkPhysicalDeviceFeatures features;
+    vkGetPhysicalDeviceFeatures(device.Gpu, &features);
+    if (features.pipelineStatisticsQuery)
+    { score += 10; }
+
+#if ASVK_IS_TIMELINE_SEMAPHORE
+    if (allowTimeline && IsSupportDeviceExtension(device.Gpu, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME))
+    { score += 20; }
+#endif
+
+    // 非同期コンピュートと転送専用のキューがあれば加点.
+    auto isSame = [](const QueueLocation& a, const QueueLocation& b)
+    { return a.FamilyIndex == b.FamilyIndex && a.QueueIndex == b.QueueIndex; };
+
+    if (compute.FamilyIndex != graphics.FamilyIndex)
+    { score += 30; }
+    else if (!isSame(compute, graphics))
+    { score += 10; }
+
+    if (transfer.FamilyIndex != graphics.FamilyIndex && transfer.FamilyIndex != compute.FamilyIndex)
+    { score += 20; }
+    else if (!isSame(transfer, graphics) && !isSame(transfer, compute))
+    { score += 5; }
+
+    return score;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      環境変数で指定された物理デバイスを検索します.
+//-------------------------------------------------------------------------------------------------
+int32_t FindPhysicalDeviceOverride(const std::vector<asvk::PhysicalDevice>& devices)
+{
+    char value[256] = {};
+#if defined(_WIN32)
+    size_t length = 0;
+    if (getenv_s(&length, value, sizeof(value), "ASVK_PHYSICAL_DEVICE") != 0 || length <= 1)
+    { return -1; }
+#else
+    auto env = getenv("ASVK_PHYSICAL_DEVICE");
+    if (env == nullptr || env[0] == '\0')
+    { return -1; }
+    strncpy(value, env, sizeof(value) - 1);
+#endif
+
+    // 数字のみなら列挙順の番号として扱う.
+    auto isNumber = true;
+    for(auto p = value; *p != '\0'; ++p)
+    { isNumber &= (isdigit(static_cast<unsigned char>(*p)) != 0); }
+
+    if (isNumber)
+    {
+        auto index = atoi(value);
+        if (index < 0 || index >= static_cast<int32_t>(devices.size()))
+        {
+            ELOGA( "Error : ASVK_PHYSICAL_DEVICE = %s is out of range.", value );
+            return -1;
+        }
+
+        return index;
+    }
+
+    // それ以外はデバイス名の一部として大文字小文字を区別せずに検索する.
+    for(size_t i=0; i<devices.size(); ++i)
+    {
+        const char* name = devices[i].Props.deviceName;
+        for(auto p = name; *p != '\0'; ++p)
+        {
+            auto j = 0u;
+            while(value[j] != '\0' && p[j] != '\0'
+               && tolower(static_cast<unsigned char>(p[j])) == tolower(static_cast<unsigned char>(value[j])))
+            { ++j; }
+
+            if (value[j] == '\0')
+            { return static_cast<int32_t>(i); }
+        }
+    }
+
+    ELOGA( "Error : ASVK_PHYSICAL_DEVICE = %s is not found.", value );
+    return -1;
+}
+
 //-------------------------------------------------------------------------------------------------
 //      インスタンスプロシージャアドレスを取得します.
 //-------------------------------------------------------------------------------------------------
@@ -135,8 +451,17 @@ namespace asvk {
 DeviceMgr::DeviceMgr()
 : m_Instance        ( null_handle )
 , m_Device          ( null_handle )
+, m_SelectedIndex   ( 0 )
 , m_GraphicsQueue   ()
 , m_ComputeQueue    ()
+, m_TransferQueue   ()
+, m_pComputeQueue   ( &m_ComputeQueue )
+, m_pTransferQueue  ( &m_TransferQueue )
+, m_MemoryAllocator ()
+, m_IsHeadless      ( false )
+, m_IsTimelineSemaphore ( false )
+, m_IsPipelineStatistics( false )
+, m_IsInheritedQueries  ( false )
 #if ASVK_IS_DEBUG
 , m_DebugReporter               ( null_handle )
 , m_CreateDebugReportCallback   ( nullptr )
@@ -154,21 +479,31 @@ DeviceMgr::~DeviceMgr()
 //-------------------------------------------------------------------------------------------------
 //      初期化処理を行います.
 //-------------------------------------------------------------------------------------------------
-bool DeviceMgr::Init()
+bool DeviceMgr::Init(const DeviceMgrDesc& desc)
 {
+    m_IsHeadless = desc.Headless;
+
+    // ヘッドレスモードではサーフェイス関連の拡張機能を有効化しない.
+    std::vector<const char*> layerExtensions;
+    if (!m_IsHeadless)
+    {
+        layerExtensions.push_back(VK_KHR_SURFACE_EXTENSION_NAME);
+    #if defined(VK_USE_PLATFORM_WIN32_KHR)
+        layerExtensions.push_back(VK_KHR_WIN32_SURFACE_EXTENSION_NAME);
+    #endif
+    }
+
+    // VK_KHR_timeline_semaphore は Vulkan 1.0 のインスタンスでは VK_KHR_get_physical_device_properties2 を必要とする.
+    auto isProperties2 = IsSupportInstanceExtension(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
+    if (isProperties2)
+    { layerExtensions.push_back(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME); }
+
     #if ASVK_IS_DEBUG
-        std::array<const char*, 3> layerExtensions;
-        layerExtensions[0] = VK_KHR_SURFACE_EXTENSION_NAME;
-        layerExtensions[1] = VK_KHR_WIN32_SURFACE_EXTENSION_NAME;
-        layerExtensions[2] = VK_EXT_DEBUG_REPORT_EXTENSION_NAME;
+        layerExtensions.push_back(VK_EXT_DEBUG_REPORT_EXTENSION_NAME);
 
         const char* layer[]     = { "VK_LAYER_LUNARG_standard_validation" };
         uint32_t    layerCount  = 1;
     #else
-        std::array<const char*, 2> layerExtensions;
-        layerExtensions[0] = VK_KHR_SURFACE_EXTENSION_NAME;
-        layerExtensions[1] = VK_KHR_WIN32_SURFACE_EXTENSION_NAME;
-
         const char* layer[]     = { nullptr };
         uint32_t    layerCount  = 0;
     #endif
@@ -192,7 +527,7 @@ bool DeviceMgr::Init()
         instanceInfo.enabledLayerCount          = layerCount;
         instanceInfo.ppEnabledLayerNames        = layer;
         instanceInfo.enabledExtensionCount      = static_cast<uint32_t>(layerExtensions.size());
-        instanceInfo.ppEnabledExtensionNames    = layerExtensions.data();
+        instanceInfo.ppEnabledExtensionNames    = (layerExtensions.empty()) ? nullptr : layerExtensions.data();
 
         m_Allocator.pfnAllocation         = Alloc;
         m_Allocator.pfnFree               = Free;
@@ -262,14 +597,64 @@ bool DeviceMgr::Init()
         m_PhysicalDevice.resize(count);
         for(auto i=0u; i<count; ++i)
         {
-            m_PhysicalDevice[i].Gpu = gpus[i];
-            vkGetPhysicalDeviceMemoryProperties(gpus[i], &m_PhysicalDevice[i].MemoryProps);
+            auto& device = m_PhysicalDevice[i];
+            device.Gpu = gpus[i];
+            vkGetPhysicalDeviceMemoryProperties(gpus[i], &device.MemoryProps);
+            vkGetPhysicalDeviceProperties(gpus[i], &device.Props);
+
+            device.LocalHeapSize = 0;
+            for(auto j=0u; j<device.MemoryProps.memoryHeapCount; ++j)
+            {
+                auto& heap = device.MemoryProps.memoryHeaps[j];
+                if ((heap.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) && heap.size > device.LocalHeapSize)
+                { device.LocalHeapSize = heap.size; }
+            }
+
+            device.Score = ScorePhysicalDevice(device, m_IsHeadless, isProperties2);
+
+            ILOGA( "Info : PhysicalDevice[%u] %s (type = %d, local heap = %llu MiB, score = %d)",
+                i,
+                device.Props.deviceName,
+                device.Props.deviceType,
+                static_cast<unsigned long long>(device.LocalHeapSize / (1024 * 1024)),
+                device.Score );
         }
 
         gpus.clear();
     }
 
-    auto gpu = m_PhysicalDevice[0].Gpu;
+    // 物理デバイスの選択. 環境変数の指定を優先し, 無ければ評価値が最大のものを使う.
+    {
+        auto index = FindPhysicalDeviceOverride(m_PhysicalDevice);
+        if (index >= 0 && m_PhysicalDevice[index].Score < 0)
+        {
+            ELOGA( "Error : PhysicalDevice[%d] does not support required features.", index );
+            index = -1;
+        }
+
+        if (index < 0)
+        {
+            for(size_t i=0; i<m_PhysicalDevice.size(); ++i)
+            {
+                if (m_PhysicalDevice[i].Score < 0)
+                { continue; }
+
+                if (index < 0 || m_PhysicalDevice[i].Score > m_PhysicalDevice[index].Score)
+                { index = static_cast<int32_t>(i); }
+            }
+        }
+
+        if (index < 0)
+        {
+            ELOG( "Error : Suitable PhysicalDevice Not Found." );
+            return false;
+        }
+
+        m_SelectedIndex = static_cast<uint32_t>(index);
+        ILOGA( "Info : Selected PhysicalDevice[%u] %s", m_SelectedIndex, m_PhysicalDevice[m_SelectedIndex].Props.deviceName );
+    }
+
+    auto gpu = m_PhysicalDevice[m_SelectedIndex].Gpu;
 
     // デバイスとキューの生成.
     {
@@ -280,46 +665,100 @@ bool DeviceMgr::Init()
         props.resize(propCount);
         vkGetPhysicalDeviceQueueFamilyProperties(gpu, &propCount, props.data());
 
-        uint32_t familyIndex = 0;
+        QueueLocation graphics;
+        QueueLocation compute;
+        QueueLocation transfer;
+        if (!FindQueueLocation(props, &graphics, &compute, &transfer))
+        {
+            ELOG( "Error : Graphics Queue Not Found." );
+            return false;
+        }
+
+        // ファミリーごとに必要なキュー数を集計.
+        std::vector<uint32_t> queueCounts;
+        queueCounts.resize(propCount, 0);
+
+        const QueueLocation* locations[] = { &graphics, &compute, &transfer };
+        for(auto i=0; i<3; ++i)
+        {
+            auto& count = queueCounts[locations[i]->FamilyIndex];
+            if (count < locations[i]->QueueIndex + 1)
+            { count = locations[i]->QueueIndex + 1; }
+        }
+
+        uint32_t maxQueueCount = 0;
+        for(auto i=0u; i<propCount; ++i)
+        {
+            if (maxQueueCount < queueCounts[i])
+            { maxQueueCount = queueCounts[i]; }
+        }
 
         std::vector<float> priorities;
-        auto offset = 0;
+        priorities.resize(maxQueueCount, 1.0f);
 
+        std::vector<VkDeviceQueueCreateInfo> queueInfos;
         for(auto i=0u; i<propCount; ++i)
         {
-            for(auto j=0u; j<props[i].queueCount; ++j)
-            { priorities.push_back( 0.0f ); }
+            if (queueCounts[i] == 0)
+            { continue; }
+
+            VkDeviceQueueCreateInfo queueInfo = {};
+            queueInfo.sType              = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+            queueInfo.pNext              = nullptr;
+            queueInfo.flags              = 0;
+            queueInfo.queueCount         = queueCounts[i];
+            queueInfo.queueFamilyIndex   = i;
+            queueInfo.pQueuePriorities   = priorities.data();
+
+            queueInfos.push_back(queueInfo);
+        }
 
-            offset += props[i].queueCount;
+        // ヘッドレスモードではスワップチェインを使用しない.
+        std::vector<const char*> deviceExtensions;
+        if (!m_IsHeadless)
+        { deviceExtensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME); }
 
-            if ((props[i].queueFlags & VK_QUEUE_GRAPHICS_BIT)
-             && (props[i].queueFlags & VK_QUEUE_COMPUTE_BIT))
-            { 
-                familyIndex = i;
-            }
+        // タイムラインセマフォが使用可能なら有効化する.
+        m_IsTimelineSemaphore = false;
+    #if ASVK_IS_TIMELINE_SEMAPHORE
+        VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timelineFeatures = {};
+        timelineFeatures.sType              = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR;
+        timelineFeatures.pNext              = nullptr;
+        timelineFeatures.timelineSemaphore  = VK_TRUE;
+
+        if (isProperties2 && IsSupportDeviceExtension(gpu, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME))
+        {
+            deviceExtensions.push_back(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+            m_IsTimelineSemaphore = true;
         }
+    #endif
+
+        // パイプライン統計クエリが使用可能なら有効化する.
+        VkPhysicalDeviceFeatures supportFeatures;
+        vkGetPhysicalDeviceFeatures(gpu, &supportFeatures);
 
-        VkDeviceQueueCreateInfo queueInfo = {};
-        queueInfo.sType              = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-        queueInfo.pNext              = nullptr;
-        queueInfo.flags              = 0;
-        queueInfo.queueCount         = props[familyIndex].queueCount;
-        queueInfo.queueFamilyIndex   = familyIndex;
-        queueInfo.pQueuePriorities   = priorities.data();
+        VkPhysicalDeviceFeatures enabledFeatures = {};
+        enabledFeatures.pipelineStatisticsQuery = supportFeatures.pipelineStatisticsQuery;
+        m_IsPipelineStatistics = (supportFeatures.pipelineStatisticsQuery == VK_TRUE);
 
-        const char* deviceExtensions[]   = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
-        uint32_t    deviceExtensionCount = 1;
+        // クエリの計測区間内でセカンダリコマンドバッファを実行できるようにする.
+        enabledFeatures.inheritedQueries = supportFeatures.inheritedQueries;
+        m_IsInheritedQueries = (supportFeatures.inheritedQueries == VK_TRUE);
 
         VkDeviceCreateInfo deviceInfo = {};
         deviceInfo.sType                    = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
         deviceInfo.pNext                    = nullptr;
-        deviceInfo.queueCreateInfoCount     = 1;
-        deviceInfo.pQueueCreateInfos        = &queueInfo;
+    #if ASVK_IS_TIMELINE_SEMAPHORE
+        if (m_IsTimelineSemaphore)
+        { deviceInfo.pNext = &timelineFeatures; }
+    #endif
+        deviceInfo.queueCreateInfoCount     = static_cast<uint32_t>(queueInfos.size());
+        deviceInfo.pQueueCreateInfos        = queueInfos.data();
         deviceInfo.enabledLayerCount        = layerCount;
         deviceInfo.ppEnabledLayerNames      = layer;
-        deviceInfo.enabledExtensionCount    = deviceExtensionCount;
-        deviceInfo.ppEnabledExtensionNames  = deviceExtensions;
-        deviceInfo.pEnabledFeatures         = nullptr;
+        deviceInfo.enabledExtensionCount    = static_cast<uint32_t>(deviceExtensions.size());
+        deviceInfo.ppEnabledExtensionNames  = (deviceExtensions.empty()) ? nullptr : deviceExtensions.data();
+        deviceInfo.pEnabledFeatures         = &enabledFeatures;
 
         auto result = vkCreateDevice(gpu, &deviceInfo, nullptr, &m_Device);
         if ( result != VK_SUCCESS )
@@ -328,12 +767,57 @@ bool DeviceMgr::Init()
             return false;
         }
 
-        m_GraphicsQueue.Init(m_Device, familyIndex, 0, QueueType_Graphics);
-        m_ComputeQueue .Init(m_Device, familyIndex, 1, QueueType_Compute);
+        if (!m_GraphicsQueue.Init(m_Device, graphics.FamilyIndex, graphics.QueueIndex, QueueType_Graphics, m_IsTimelineSemaphore))
+        {
+            ELOG( "Error : Queue::Init() Failed." );
+            return false;
+        }
+
+        // VkQueue は外部同期が必要なので, 同じ VkQueue を指すキューは1つのインスタンスにまとめる.
+        auto isSame = [](const QueueLocation& a, const QueueLocation& b)
+        { return a.FamilyIndex == b.FamilyIndex && a.QueueIndex == b.QueueIndex; };
+
+        m_pComputeQueue  = &m_ComputeQueue;
+        m_pTransferQueue = &m_TransferQueue;
+
+        if (isSame(compute, graphics))
+        { m_pComputeQueue = &m_GraphicsQueue; }
+        else if (!m_ComputeQueue.Init(m_Device, compute.FamilyIndex, compute.QueueIndex, QueueType_Compute, m_IsTimelineSemaphore))
+        {
+            ELOG( "Error : Queue::Init() Failed." );
+            return false;
+        }
+
+        if (isSame(transfer, graphics))
+        { m_pTransferQueue = &m_GraphicsQueue; }
+        else if (isSame(transfer, compute))
+        { m_pTransferQueue = m_pComputeQueue; }
+        else if (!m_TransferQueue.Init(m_Device, transfer.FamilyIndex, transfer.QueueIndex, QueueType_Transfer, m_IsTimelineSemaphore))
+        {
+            ELOG( "Error : Queue::Init() Failed." );
+            return false;
+        }
+
+        ILOG( "Info : Graphics Queue (family = %u, index = %u)", graphics.FamilyIndex, graphics.QueueIndex );
+        ILOG( "Info : Compute  Queue (family = %u, index = %u)", compute .FamilyIndex, compute .QueueIndex );
+        ILOG( "Info : Transfer Queue (family = %u, index = %u)", transfer.FamilyIndex, transfer.QueueIndex );
+        ILOG( "Info : Timeline Semaphore = %s", (m_IsTimelineSemaphore) ? "enabled" : "disabled" );
+        ILOG( "Info : Pipeline Statistics = %s", (m_IsPipelineStatistics) ? "enabled" : "disabled" );
+        ILOG( "Info : Inherited Queries = %s", (m_IsInheritedQueries) ? "enabled" : "disabled" );
 
         props.clear();
     }
 
+    // デバイスメモリアロケータの初期化.
+    {
+        MemoryAllocatorDesc desc;
+        if (!m_MemoryAllocator.Init(m_Device, gpu, desc))
+        {
+            ELOG( "Error : MemoryAllocator::Init() Failed." );
+            return false;
+        }
+    }
+
     return true;
 }
 
@@ -344,6 +828,12 @@ void DeviceMgr::Term()
 {
     m_GraphicsQueue.Term(m_Device);
     m_ComputeQueue .Term(m_Device);
+    m_TransferQueue.Term(m_Device);
+
+    m_pComputeQueue  = &m_ComputeQueue;
+    m_pTransferQueue = &m_TransferQueue;
+
+    m_MemoryAllocator.Term();
 
     if (m_Device != null_handle)
     { vkDestroyDevice(m_Device, nullptr); }
@@ -363,9 +853,14 @@ void DeviceMgr::Term()
     { vkDestroyInstance(m_Instance, &m_Allocator); }
 
     m_PhysicalDevice.clear();
-
-    m_Device   = null_handle;
-    m_Instance = null_handle;
+    m_SelectedIndex = 0;
+
+    m_Device     = null_handle;
+    m_Instance   = null_handle;
+    m_IsHeadless          = false;
+    m_IsTimelineSemaphore  = false;
+    m_IsPipelineStatistics = false;
+    m_IsInheritedQueries   = false;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -386,6 +881,12 @@ VkDevice DeviceMgr::GetDevice() const
 const std::vector<PhysicalDevice>& DeviceMgr::GetPhysicalDevice() const
 { return m_PhysicalDevice; }
 
+//-------------------------------------------------------------------------------------------------
+//      選択した物理デバイスを取得します.
+//-------------------------------------------------------------------------------------------------
+const PhysicalDevice& DeviceMgr::GetSelectedPhysicalDevice() const
+{ return m_PhysicalDevice[m_SelectedIndex]; }
+
 //-------------------------------------------------------------------------------------------------
 //      グラフィックスキューを取得します.
 //-------------------------------------------------------------------------------------------------
@@ -396,7 +897,43 @@ Queue* DeviceMgr::GetGraphicsQueue()
 //      コンピュートキューを取得します.
 //-------------------------------------------------------------------------------------------------
 Queue* DeviceMgr::GetComputeQueue()
-{ return &m_ComputeQueue; }
+{ return m_pComputeQueue; }
+
+//-------------------------------------------------------------------------------------------------
+//      転送キューを取得します.
+//-------------------------------------------------------------------------------------------------
+Queue* DeviceMgr::GetTransferQueue()
+{ return m_pTransferQueue; }
+
+//-------------------------------------------------------------------------------------------------
+//      メモリアロケータを取得します.
+//-------------------------------------------------------------------------------------------------
+MemoryAllocator* DeviceMgr::GetMemoryAllocator()
+{ return &m_MemoryAllocator; }
+
+//-------------------------------------------------------------------------------------------------
+//      ヘッドレスモードかどうかチェックします.
+//-------------------------------------------------------------------------------------------------
+bool DeviceMgr::IsHeadless() const
+{ return m_IsHeadless; }
+
+//-------------------------------------------------------------------------------------------------
+//      タイムラインセマフォが有効かどうかチェックします.
+//-------------------------------------------------------------------------------------------------
+bool DeviceMgr::IsTimelineSemaphore() const
+{ return m_IsTimelineSemaphore; }
+
+//-------------------------------------------------------------------------------------------------
+//      パイプライン統計クエリが有効かどうかチェックします.
+//-------------------------------------------------------------------------------------------------
+bool DeviceMgr::IsPipelineStatistics() const
+{ return m_IsPipelineStatistics; }
+
+//-------------------------------------------------------------------------------------------------
+//      クエリの継承が有効かどうかチェックします.
+//-------------------------------------------------------------------------------------------------
+bool DeviceMgr::IsInheritedQueries() const
+{ return m_IsInheritedQueries; }
 
 
 } // namespace asvk
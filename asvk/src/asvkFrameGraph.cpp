@@ -0,0 +1,956 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asvkFrameGraph.cpp
+// Desc : Frame Graph Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asvkFrameGraph.h>
+#include <asvkLogger.h>
+#include <algorithm>
+#include <cstring>
+
+
+namespace /* anonymous */ {
+
+//-------------------------------------------------------------------------------------------------
+//      使用用途に対応するイメージの使用用途フラグを取得します.
+//-------------------------------------------------------------------------------------------------
+VkImageUsageFlags ToImageUsage(asvk::ResourceUsage usage)
+{
+    switch(usage)
+    {
+    case asvk::ResourceUsage_ColorAttachment:
+        return VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+
+    case asvk::ResourceUsage_DepthStencilAttachment:
+    case asvk::ResourceUsage_DepthStencilRead:
+        return VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+
+    case asvk::ResourceUsage_ShaderRead:
+    case asvk::ResourceUsage_ComputeRead:
+        return VK_IMAGE_USAGE_SAMPLED_BIT;
+
+    case asvk::ResourceUsage_ComputeWrite:
+        return VK_IMAGE_USAGE_STORAGE_BIT;
+
+    case asvk::ResourceUsage_TransferSrc:
+        return VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+
+    case asvk::ResourceUsage_TransferDst:
+        return VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+
+    default:
+        break;
+    }
+
+    return 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      フォーマットに対応するイメージアスペクトを取得します.
+//-------------------------------------------------------------------------------------------------
+VkImageAspectFlags ToAspect(VkFormat format)
+{
+    switch(format)
+    {
+    case VK_FORMAT_D16_UNORM:
+    case VK_FORMAT_X8_D24_UNORM_PACK32:
+    case VK_FORMAT_D32_SFLOAT:
+        return VK_IMAGE_ASPECT_DEPTH_BIT;
+
+    case VK_FORMAT_S8_UINT:
+        return VK_IMAGE_ASPECT_STENCIL_BIT;
+
+    case VK_FORMAT_D16_UNORM_S8_UINT:
+    case VK_FORMAT_D24_UNORM_S8_UINT:
+    case VK_FORMAT_D32_SFLOAT_S8_UINT:
+        return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+
+    default:
+        break;
+    }
+
+    return VK_IMAGE_ASPECT_COLOR_BIT;
+}
+
+} // namespace /* anonymous */
+
+
+namespace asvk {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// FrameGraph class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+FrameGraph::FrameGraph()
+: m_pAllocator      (nullptr)
+, m_Device          (null_handle)
+, m_pGraphicsQueue  (nullptr)
+, m_pComputeQueue   (nullptr)
+, m_AsyncTicket     (0)
+, m_AsyncWaitStage  (0)
+, m_IsCompiled      (false)
+{ memset(&m_Stats, 0, sizeof(m_Stats)); }
+
+//-------------------------------------------------------------------------------------------------
+//      デストラクタです.
+//-------------------------------------------------------------------------------------------------
+FrameGraph::~FrameGraph()
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      初期化処理です.
+//-------------------------------------------------------------------------------------------------
+bool FrameGraph::Init(DeviceMgr* pDeviceMgr, uint32_t frameCount)
+{
+    if (pDeviceMgr == nullptr || frameCount == 0)
+    {
+        ELOG( "Error : Invalid Argument." );
+        return false;
+    }
+
+    m_pAllocator     = pDeviceMgr->GetMemoryAllocator();
+    m_Device         = pDeviceMgr->GetDevice();
+    m_pGraphicsQueue = pDeviceMgr->GetGraphicsQueue();
+    m_pComputeQueue  = nullptr;
+
+    // グラフィックスと同じキューを共有している場合は並列に実行できないため無効にする.
+    auto pComputeQueue = pDeviceMgr->GetComputeQueue();
+    if (pComputeQueue != m_pGraphicsQueue)
+    {
+        if (!m_ComputeCommands.Init(pDeviceMgr, QueueType_Compute, frameCount))
+        {
+            ELOG( "Error : FrameCommandAllocator::Init() Failed." );
+            return false;
+        }
+
+        m_pComputeQueue = pComputeQueue;
+    }
+
+    memset(&m_Stats, 0, sizeof(m_Stats));
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      終了処理です.
+//-------------------------------------------------------------------------------------------------
+void FrameGraph::Term(DeviceMgr* pDeviceMgr)
+{
+    if (pDeviceMgr == nullptr)
+    { return; }
+
+    if (m_pComputeQueue != nullptr)
+    {
+        m_ComputeCommands.WaitAll(UINT64_MAX);
+        m_ComputeCommands.Term(pDeviceMgr);
+    }
+
+    DestroyResources();
+    Reset();
+
+    m_Tracker.Reset();
+
+    m_pAllocator     = nullptr;
+    m_Device         = null_handle;
+    m_pGraphicsQueue = nullptr;
+    m_pComputeQueue  = nullptr;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      宣言したパスとテクスチャを破棄します.
+//-------------------------------------------------------------------------------------------------
+void FrameGraph::Reset()
+{
+    m_Passes  .clear();
+    m_Textures.clear();
+
+    m_AsyncWaitStage = 0;
+    m_IsCompiled     = false;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      一時テクスチャを宣言します.
+//-------------------------------------------------------------------------------------------------
+uint32_t FrameGraph::CreateTexture(const char* name, const FrameGraphTextureDesc& desc)
+{
+    Texture texture = {};
+    texture.Name        = (name != nullptr) ? name : "";
+    texture.Desc        = desc;
+    texture.Usage       = 0;
+    texture.IsImported  = false;
+    texture.IsOutput    = false;
+    texture.IsAsync     = false;
+    texture.Image       = null_handle;
+    texture.View        = null_handle;
+    texture.FinalUsage  = ResourceUsage_Undefined;
+    texture.FirstPass   = InvalidIndex;
+    texture.LastPass    = InvalidIndex;
+    texture.Block       = InvalidIndex;
+
+    texture.Range.aspectMask     = ToAspect(desc.Format);
+    texture.Range.baseMipLevel   = 0;
+    texture.Range.levelCount     = 1;
+    texture.Range.baseArrayLayer = 0;
+    texture.Range.layerCount     = 1;
+
+    m_Textures.push_back(texture);
+    m_IsCompiled = false;
+
+    return uint32_t(m_Textures.size() - 1);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      外部で生成したイメージをインポートします.
+//-------------------------------------------------------------------------------------------------
+uint32_t FrameGraph::ImportTexture
+(
+    const char*                     name,
+    VkImage                         image,
+    VkImageView                     view,
+    const VkImageSubresourceRange&  range,
+    const ResourceState&            state,
+    ResourceUsage                   finalUsage
+)
+{
+    Texture texture = {};
+    texture.Name            = (name != nullptr) ? name : "";
+    texture.Usage           = 0;
+    texture.IsImported      = true;
+    texture.IsOutput        = true;
+    texture.IsAsync         = false;
+    texture.Image           = image;
+    texture.View            = view;
+    texture.Range           = range;
+    texture.InitialState    = state;
+    texture.FinalUsage      = finalUsage;
+    texture.FirstPass       = InvalidIndex;
+    texture.LastPass        = InvalidIndex;
+    texture.Block           = InvalidIndex;
+
+    m_Textures.push_back(texture);
+    m_IsCompiled = false;
+
+    return uint32_t(m_Textures.size() - 1);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      パスを追加します.
+//-------------------------------------------------------------------------------------------------
+uint32_t FrameGraph::AddPass(const char* name, QueueType queueType, ExecuteFunc func)
+{
+    Pass pass;
+    pass.Name           = (name != nullptr) ? name : "";
+    pass.Type           = queueType;
+    pass.Func           = func;
+    pass.HasSideEffect  = false;
+    pass.IsCulled       = false;
+    pass.IsAsync        = false;
+
+    m_Passes.push_back(pass);
+    m_IsCompiled = false;
+
+    return uint32_t(m_Passes.size() - 1);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      パスがテクスチャを読み取ることを宣言します.
+//-------------------------------------------------------------------------------------------------
+void FrameGraph::Read(uint32_t pass, uint32_t texture, ResourceUsage usage)
+{
+    if (pass >= m_Passes.size() || texture >= m_Textures.size())
+    {
+        ELOG( "Error : Invalid Argument." );
+        return;
+    }
+
+    Access access;
+    access.Texture  = texture;
+    access.Usage    = usage;
+    access.IsWrite  = false;
+
+    m_Passes[pass].Accesses.push_back(access);
+    m_IsCompiled = false;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      パスがテクスチャに書き込むことを宣言します.
+//-------------------------------------------------------------------------------------------------
+void FrameGraph::Write(uint32_t pass, uint32_t texture, ResourceUsage usage)
+{
+    if (pass >= m_Passes.size() || texture >= m_Textures.size())
+    {
+        ELOG( "Error : Invalid Argument." );
+        return;
+    }
+
+    Access access;
+    access.Texture  = texture;
+    access.Usage    = usage;
+    access.IsWrite  = true;
+
+    m_Passes[pass].Accesses.push_back(access);
+    m_IsCompiled = false;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      パスに副作用があることを設定します.
+//-------------------------------------------------------------------------------------------------
+void FrameGraph::SetSideEffect(uint32_t pass)
+{
+    if (pass >= m_Passes.size())
+    {
+        ELOG( "Error : Invalid Argument." );
+        return;
+    }
+
+    m_Passes[pass].HasSideEffect = true;
+    m_IsCompiled = false;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      テクスチャをグラフの出力に設定します.
+//-------------------------------------------------------------------------------------------------
+void FrameGraph::MarkOutput(uint32_t texture)
+{
+    if (texture >= m_Textures.size())
+    {
+        ELOG( "Error : Invalid Argument." );
+        return;
+    }
+
+    m_Textures[texture].IsOutput = true;
+    m_IsCompiled = false;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      グラフをコンパイルします.
+//-------------------------------------------------------------------------------------------------
+bool FrameGraph::Compile(DeviceMgr* pDeviceMgr)
+{
+    if (pDeviceMgr == nullptr || m_pAllocator == nullptr)
+    {
+        ELOG( "Error : Invalid Argument." );
+        return false;
+    }
+
+    m_IsCompiled = false;
+
+    CullPasses();
+    ScheduleAsync();
+
+    // 生き残ったパスから寿命と使用用途を求める.
+    for(auto& texture : m_Textures)
+    {
+        texture.Usage     = texture.Desc.Usage;
+        texture.IsAsync   = false;
+        texture.FirstPass = InvalidIndex;
+        texture.LastPass  = InvalidIndex;
+    }
+
+    uint32_t culledCount = 0;
+    uint32_t asyncCount  = 0;
+    for(size_t i=0; i<m_Passes.size(); ++i)
+    {
+        const auto& pass = m_Passes[i];
+        if (pass.IsCulled)
+        {
+            culledCount++;
+            continue;
+        }
+
+        if (pass.IsAsync)
+        { asyncCount++; }
+
+        for(const auto& access : pass.Accesses)
+        {
+            auto& texture = m_Textures[access.Texture];
+            texture.Usage |= ToImageUsage(access.Usage);
+
+            if (texture.FirstPass == InvalidIndex)
+            { texture.FirstPass = uint32_t(i); }
+            texture.LastPass = uint32_t(i);
+
+            if (pass.IsAsync)
+            { texture.IsAsync = true; }
+        }
+    }
+
+    // 非同期コンピュートの結果を参照するグラフィックス側のステージで待機する.
+    m_AsyncWaitStage = 0;
+    for(const auto& pass : m_Passes)
+    {
+        if (pass.IsCulled || pass.IsAsync)
+        { continue; }
+
+        for(const auto& access : pass.Accesses)
+        {
+            if (m_Textures[access.Texture].IsAsync)
+            { m_AsyncWaitStage |= GetResourceState(access.Usage).Stage; }
+        }
+    }
+    if (asyncCount > 0 && m_AsyncWaitStage == 0)
+    { m_AsyncWaitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT; }
+
+    // 物理リソースの構成を比較して, 変わった場合のみ作り直す.
+    std::vector<uint64_t> signature;
+    signature.reserve(m_Textures.size() * 4);
+    for(const auto& texture : m_Textures)
+    {
+        if (texture.IsImported)
+        {
+            signature.push_back(UINT64_MAX);
+            continue;
+        }
+
+        signature.push_back((uint64_t(texture.Desc.Width) << 32) | texture.Desc.Height);
+        signature.push_back((uint64_t(texture.Desc.Format) << 32) | texture.Desc.Samples);
+        signature.push_back((uint64_t(texture.Usage) << 1) | (texture.IsAsync ? 1 : 0));
+        signature.push_back((uint64_t(texture.FirstPass) << 32) | texture.LastPass);
+    }
+
+    if (signature != m_Signature)
+    {
+        // 前のフレームが使用中の可能性があるため完了を待ってから破棄する.
+        // vkDeviceWaitIdle() は全キューの外部同期が必要でサブミットスレッドと競合するため, チケットで待つ.
+        if (!m_Signature.empty())
+        {
+            m_pGraphicsQueue->WaitFor(m_pGraphicsQueue->GetSubmittedTicket());
+            if (m_pComputeQueue != nullptr)
+            { m_pComputeQueue->WaitFor(m_pComputeQueue->GetSubmittedTicket()); }
+        }
+
+        if (!CreateResources())
+        {
+            ELOG( "Error : FrameGraph::CreateResources() Failed." );
+            DestroyResources();
+            return false;
+        }
+
+        m_Signature = signature;
+        m_Stats.RebuildCount++;
+    }
+    else
+    {
+        for(size_t i=0; i<m_Textures.size(); ++i)
+        {
+            if (m_Textures[i].IsImported)
+            { continue; }
+
+            m_Textures[i].Image = m_Images[i];
+            m_Textures[i].View  = m_Views [i];
+        }
+
+        for(size_t i=0; i<m_Blocks.size(); ++i)
+        {
+            for(auto index : m_Blocks[i].Textures)
+            { m_Textures[index].Block = uint32_t(i); }
+        }
+    }
+
+    m_Stats.PassCount       = uint32_t(m_Passes.size());
+    m_Stats.CulledPassCount = culledCount;
+    m_Stats.AsyncPassCount  = asyncCount;
+
+    m_IsCompiled = true;
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      グラフを実行します.
+//-------------------------------------------------------------------------------------------------
+bool FrameGraph::Execute(VkCommandBuffer commandBuffer)
+{
+    if (commandBuffer == null_handle)
+    {
+        ELOG( "Error : Invalid Argument." );
+        return false;
+    }
+
+    if (!m_IsCompiled)
+    {
+        ELOG( "Error : FrameGraph is not compiled." );
+        return false;
+    }
+
+    m_Tracker.Reset();
+    m_AsyncTicket = 0;
+
+    for(const auto& texture : m_Textures)
+    {
+        if (texture.IsImported)
+        { m_Tracker.SetImageState(texture.Image, texture.InitialState); }
+    }
+
+    // 先行するグラフィックスのパスに依存しないコンピュートパスを先にサブミットする.
+    if (m_Stats.AsyncPassCount > 0)
+    {
+        if (!m_ComputeCommands.BeginFrame())
+        {
+            ELOG( "Error : FrameCommandAllocator::BeginFrame() Failed." );
+            return false;
+        }
+
+        auto computeBuffer = m_ComputeCommands.Allocate();
+        if (computeBuffer == null_handle)
+        {
+            ELOG( "Error : FrameCommandAllocator::Allocate() Failed." );
+            return false;
+        }
+
+        for(size_t i=0; i<m_Passes.size(); ++i)
+        {
+            if (!m_Passes[i].IsCulled && m_Passes[i].IsAsync)
+            { RecordPass(uint32_t(i), computeBuffer); }
+        }
+
+        auto result = vkEndCommandBuffer(computeBuffer);
+        if (result != VK_SUCCESS)
+        {
+            ELOG( "Error : vkEndCommandBuffer() Failed." );
+            return false;
+        }
+
+        // 前のフレームのグラフィックス側が非同期テクスチャを使い終わるまで待たせる.
+        m_ComputeBatch.Reset();
+        m_ComputeBatch.AddWaitQueue(
+            m_pGraphicsQueue,
+            m_pGraphicsQueue->GetSubmittedTicket(),
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+        m_ComputeBatch.AddCommandBuffer(computeBuffer);
+
+        auto ticket = m_pComputeQueue->Submit(&m_ComputeBatch, m_ComputeCommands.GetFence());
+
+        m_ComputeCommands.EndFrame();
+
+        if (ticket == 0)
+        {
+            ELOG( "Error : Queue::Submit() Failed." );
+            return false;
+        }
+
+        // グラフィックス側の待機は呼び出し側のサブミットに AddAsyncWait() で追加させる.
+        m_AsyncTicket = ticket;
+    }
+
+    for(size_t i=0; i<m_Passes.size(); ++i)
+    {
+        if (!m_Passes[i].IsCulled && !m_Passes[i].IsAsync)
+        { RecordPass(uint32_t(i), commandBuffer); }
+    }
+
+    // インポートしたテクスチャを指定の使用用途に戻す.
+    for(const auto& texture : m_Textures)
+    {
+        if (texture.IsImported)
+        { m_Tracker.TransitionImage(texture.Image, texture.Range, texture.FinalUsage); }
+    }
+    m_Tracker.Flush(commandBuffer);
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      非同期コンピュートの完了待ちをバッチに追加します.
+//-------------------------------------------------------------------------------------------------
+void FrameGraph::AddAsyncWait(SubmitBatch* pBatch) const
+{
+    if (pBatch == nullptr || m_pComputeQueue == nullptr || m_AsyncTicket == 0)
+    { return; }
+
+    pBatch->AddWaitQueue(m_pComputeQueue, m_AsyncTicket, m_AsyncWaitStage);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      テクスチャのイメージを取得します.
+//-------------------------------------------------------------------------------------------------
+VkImage FrameGraph::GetImage(uint32_t texture) const
+{
+    if (texture >= m_Textures.size())
+    { return null_handle; }
+
+    return m_Textures[texture].Image;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      テクスチャのイメージビューを取得します.
+//-------------------------------------------------------------------------------------------------
+VkImageView FrameGraph::GetView(uint32_t texture) const
+{
+    if (texture >= m_Textures.size())
+    { return null_handle; }
+
+    return m_Textures[texture].View;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      テクスチャのサブリソース範囲を取得します.
+//-------------------------------------------------------------------------------------------------
+VkImageSubresourceRange FrameGraph::GetRange(uint32_t texture) const
+{
+    if (texture >= m_Textures.size())
+    {
+        VkImageSubresourceRange range = {};
+        return range;
+    }
+
+    return m_Textures[texture].Range;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      パスがカリングされたかどうかチェックします.
+//-------------------------------------------------------------------------------------------------
+bool FrameGraph::IsCulled(uint32_t pass) const
+{
+    if (pass >= m_Passes.size())
+    { return true; }
+
+    return m_Passes[pass].IsCulled;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      統計情報を取得します.
+//-------------------------------------------------------------------------------------------------
+const FrameGraphStats& FrameGraph::GetStats() const
+{ return m_Stats; }
+
+//-------------------------------------------------------------------------------------------------
+//      カリングを行います.
+//-------------------------------------------------------------------------------------------------
+void FrameGraph::CullPasses()
+{
+    // 出力から逆順にたどり, 必要なテクスチャに書き込むパスだけを残す.
+    std::vector<bool> needed(m_Textures.size(), false);
+    for(size_t i=0; i<m_Textures.size(); ++i)
+    { needed[i] = m_Textures[i].IsOutput; }
+
+    for(size_t i=m_Passes.size(); i>0; --i)
+    {
+        auto& pass = m_Passes[i - 1];
+
+        auto isLive = pass.HasSideEffect;
+        for(const auto& access : pass.Accesses)
+        {
+            if (access.IsWrite && needed[access.Texture])
+            { isLive = true; }
+        }
+
+        pass.IsCulled = !isLive;
+        if (!isLive)
+        { continue; }
+
+        for(const auto& access : pass.Accesses)
+        {
+            if (!access.IsWrite)
+            { needed[access.Texture] = true; }
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      非同期コンピュートで実行するパスを選択します.
+//-------------------------------------------------------------------------------------------------
+void FrameGraph::ScheduleAsync()
+{
+    for(auto& pass : m_Passes)
+    { pass.IsAsync = false; }
+
+    if (m_pComputeQueue == nullptr)
+    { return; }
+
+    // 非同期パスはグラフィックスのパスより先にサブミットされるため,
+    // 先行するグラフィックスのパスが触れたテクスチャを参照するパスは対象外にする.
+    std::vector<bool> touched(m_Textures.size(), false);
+    for(auto& pass : m_Passes)
+    {
+        if (pass.IsCulled)
+        { continue; }
+
+        if (pass.Type == QueueType_Compute)
+        {
+            auto isIndependent = true;
+            for(const auto& access : pass.Accesses)
+            {
+                // インポートしたテクスチャはキューファミリーの所有権が分からないため対象外.
+                if (touched[access.Texture] || m_Textures[access.Texture].IsImported)
+                { isIndependent = false; }
+            }
+
+            pass.IsAsync = isIndependent;
+            if (isIndependent)
+            { continue; }
+        }
+
+        for(const auto& access : pass.Accesses)
+        { touched[access.Texture] = true; }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      物理リソースを生成します.
+//-------------------------------------------------------------------------------------------------
+bool FrameGraph::CreateResources()
+{
+    DestroyResources();
+
+    m_Images.resize(m_Textures.size(), null_handle);
+    m_Views .resize(m_Textures.size(), null_handle);
+
+    uint32_t families[2] = {
+        m_pGraphicsQueue->GetFamilyIndex(),
+        (m_pComputeQueue != nullptr) ? m_pComputeQueue->GetFamilyIndex() : m_pGraphicsQueue->GetFamilyIndex()
+    };
+    auto isConcurrent = (families[0] != families[1]);
+
+    std::vector<VkMemoryRequirements> requirements(m_Textures.size());
+    std::vector<uint32_t>             order;
+
+    for(size_t i=0; i<m_Textures.size(); ++i)
+    {
+        auto& texture = m_Textures[i];
+        texture.Block = InvalidIndex;
+
+        // カリングで使われなくなったテクスチャは生成しない.
+        if (texture.IsImported || texture.FirstPass == InvalidIndex)
+        { continue; }
+
+        VkImageCreateInfo info = {};
+        info.sType                  = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        info.pNext                  = nullptr;
+        info.flags                  = 0;
+        info.imageType              = VK_IMAGE_TYPE_2D;
+        info.format                 = texture.Desc.Format;
+        info.extent                 = { texture.Desc.Width, texture.Desc.Height, 1 };
+        info.mipLevels              = 1;
+        info.arrayLayers            = 1;
+        info.samples                = texture.Desc.Samples;
+        info.tiling                 = VK_IMAGE_TILING_OPTIMAL;
+        info.usage                  = texture.Usage;
+        info.sharingMode            = VK_SHARING_MODE_EXCLUSIVE;
+        info.queueFamilyIndexCount  = 0;
+        info.pQueueFamilyIndices    = nullptr;
+        info.initialLayout          = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        // 非同期コンピュートとグラフィックスで共有する場合は所有権の移動を不要にする.
+        if (texture.IsAsync && isConcurrent)
+        {
+            info.sharingMode            = VK_SHARING_MODE_CONCURRENT;
+            info.queueFamilyIndexCount  = 2;
+            info.pQueueFamilyIndices    = families;
+        }
+
+        auto result = vkCreateImage(m_Device, &info, nullptr, &m_Images[i]);
+        if (result != VK_SUCCESS)
+        {
+            ELOG( "Error : vkCreateImage() Failed. name = %s", texture.Name.c_str() );
+            return false;
+        }
+
+        vkGetImageMemoryRequirements(m_Device, m_Images[i], &requirements[i]);
+        order.push_back(uint32_t(i));
+    }
+
+    // 大きい順に, 寿命が重ならないテクスチャと同じメモリブロックに詰める.
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t lhs, uint32_t rhs)
+    { return requirements[lhs].size > requirements[rhs].size; });
+
+    VkDeviceSize requiredBytes = 0;
+    for(auto index : order)
+    {
+        auto& texture = m_Textures[index];
+        const auto& req = requirements[index];
+        requiredBytes += req.size;
+
+        auto block = InvalidIndex;
+
+        // 非同期テクスチャはキューをまたいで寿命を比較できないためエイリアスしない.
+        if (!texture.IsAsync)
+        {
+            for(size_t i=0; i<m_Blocks.size() && block == InvalidIndex; ++i)
+            {
+                const auto& candidate = m_Blocks[i];
+                if ((candidate.Requirements.memoryTypeBits & req.memoryTypeBits) == 0)
+                { continue; }
+
+                auto isOverlap = false;
+                for(auto other : candidate.Textures)
+                {
+                    const auto& occupant = m_Textures[other];
+                    if (occupant.IsAsync
+                    || !(occupant.LastPass < texture.FirstPass || texture.LastPass < occupant.FirstPass))
+                    {
+                        isOverlap = true;
+                        break;
+                    }
+                }
+
+                if (!isOverlap)
+                { block = uint32_t(i); }
+            }
+        }
+
+        if (block == InvalidIndex)
+        {
+            MemoryBlock newBlock;
+            newBlock.Requirements = req;
+            m_Blocks.push_back(newBlock);
+            block = uint32_t(m_Blocks.size() - 1);
+        }
+        else
+        {
+            auto& target = m_Blocks[block].Requirements;
+            target.size            = std::max(target.size, req.size);
+            target.alignment       = std::max(target.alignment, req.alignment);
+            target.memoryTypeBits &= req.memoryTypeBits;
+        }
+
+        m_Blocks[block].Textures.push_back(index);
+        texture.Block = block;
+    }
+
+    VkDeviceSize allocatedBytes = 0;
+    for(auto& block : m_Blocks)
+    {
+        if (!m_pAllocator->Allocate(block.Requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, false, &block.Memory))
+        {
+            ELOG( "Error : MemoryAllocator::Allocate() Failed." );
+            return false;
+        }
+        allocatedBytes += block.Requirements.size;
+
+        // 同じメモリブロックのテクスチャは同じ領域にバインドする.
+        for(auto index : block.Textures)
+        {
+            auto result = vkBindImageMemory(m_Device, m_Images[index], block.Memory.Memory, block.Memory.Offset);
+            if (result != VK_SUCCESS)
+            {
+                ELOG( "Error : vkBindImageMemory() Failed. name = %s", m_Textures[index].Name.c_str() );
+                return false;
+            }
+        }
+    }
+
+    for(auto index : order)
+    {
+        auto& texture = m_Textures[index];
+
+        VkImageViewCreateInfo viewInfo = {};
+        viewInfo.sType            = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.pNext            = nullptr;
+        viewInfo.flags            = 0;
+        viewInfo.image            = m_Images[index];
+        viewInfo.viewType         = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format           = texture.Desc.Format;
+        viewInfo.components.r     = VK_COMPONENT_SWIZZLE_R;
+        viewInfo.components.g     = VK_COMPONENT_SWIZZLE_G;
+        viewInfo.components.b     = VK_COMPONENT_SWIZZLE_B;
+        viewInfo.components.a     = VK_COMPONENT_SWIZZLE_A;
+        viewInfo.subresourceRange = texture.Range;
+
+        auto result = vkCreateImageView(m_Device, &viewInfo, nullptr, &m_Views[index]);
+        if (result != VK_SUCCESS)
+        {
+            ELOG( "Error : vkCreateImageView() Failed. name = %s", texture.Name.c_str() );
+            return false;
+        }
+
+        texture.Image = m_Images[index];
+        texture.View  = m_Views [index];
+    }
+
+    m_Stats.TextureCount     = uint32_t(order.size());
+    m_Stats.MemoryBlockCount = uint32_t(m_Blocks.size());
+    m_Stats.RequiredBytes    = requiredBytes;
+    m_Stats.AllocatedBytes   = allocatedBytes;
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      物理リソースを破棄します.
+//-------------------------------------------------------------------------------------------------
+void FrameGraph::DestroyResources()
+{
+    if (m_Device != null_handle)
+    {
+        for(auto& view : m_Views)
+        {
+            if (view != null_handle)
+            { vkDestroyImageView(m_Device, view, nullptr); }
+        }
+
+        for(auto& image : m_Images)
+        {
+            if (image != null_handle)
+            { vkDestroyImage(m_Device, image, nullptr); }
+        }
+    }
+
+    if (m_pAllocator != nullptr)
+    {
+        for(auto& block : m_Blocks)
+        {
+            if (block.Memory.Memory != null_handle)
+            { m_pAllocator->Free(&block.Memory); }
+        }
+    }
+
+    m_Views .clear();
+    m_Images.clear();
+    m_Blocks.clear();
+    m_Signature.clear();
+}
+
+//-------------------------------------------------------------------------------------------------
+//      パスを記録します.
+//-------------------------------------------------------------------------------------------------
+void FrameGraph::RecordPass(uint32_t index, VkCommandBuffer commandBuffer)
+{
+    const auto& pass = m_Passes[index];
+
+    // 最初に使用する時は内容を破棄し, 同じメモリを直前に使っていたテクスチャの完了を待つ.
+    for(const auto& access : pass.Accesses)
+    {
+        const auto& texture = m_Textures[access.Texture];
+        if (texture.IsImported || texture.FirstPass != index)
+        { continue; }
+
+        if (texture.IsAsync)
+        {
+            // キューをまたぐ同期はセマフォで行うため, 実行ステージの依存は不要.
+            m_Tracker.SetImageState(texture.Image, ResourceState());
+        }
+        else
+        {
+            const auto& last = m_Blocks[texture.Block].LastState;
+            m_Tracker.SetImageState(texture.Image, ResourceState(VK_IMAGE_LAYOUT_UNDEFINED, last.Access, last.Stage));
+        }
+    }
+
+    for(const auto& access : pass.Accesses)
+    {
+        const auto& texture = m_Textures[access.Texture];
+        m_Tracker.TransitionImage(texture.Image, texture.Range, access.Usage);
+    }
+    m_Tracker.Flush(commandBuffer);
+
+    if (pass.Func)
+    { pass.Func(commandBuffer, *this); }
+
+    // メモリブロックの次の利用者のために最終ステートを記録.
+    for(const auto& access : pass.Accesses)
+    {
+        const auto& texture = m_Textures[access.Texture];
+        if (texture.IsImported || texture.IsAsync || texture.LastPass != index)
+        { continue; }
+
+        m_Tracker.GetImageState(texture.Image, &m_Blocks[texture.Block].LastState);
+    }
+}
+
+} // namespace asvk
@@ -0,0 +1,268 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asvkFramePacer.cpp
+// Desc : Frame Pacer Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asvkFramePacer.h>
+#include <asvkLogger.h>
+#include <cstring>
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION   0x00000002
+#endif
+
+
+namespace asvk {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// FramePacer class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+const double FramePacer::MinSpinSec      = 0.00025;
+const double FramePacer::MaxSpinSec      = 0.004;
+const double FramePacer::SafetyMarginSec = 0.0005;
+const double FramePacer::SmoothFactor    = 0.1;
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+FramePacer::FramePacer()
+: m_Timer           ()
+, m_hTimer          (nullptr)
+, m_TargetSec       (0.0)
+, m_DeadlineSec     (0.0)
+, m_FrameBeginSec   (0.0)
+, m_PredictedSec    (0.0)
+, m_SpinSec         (0.002)
+, m_SleepSec        (0.0)
+, m_SpinWaitSec     (0.0)
+, m_SumErrorSec     (0.0)
+, m_SumSleepSec     (0.0)
+, m_SumSpinSec      (0.0)
+{ memset(&m_Stats, 0, sizeof(m_Stats)); }
+
+//-------------------------------------------------------------------------------------------------
+//      デストラクタです.
+//-------------------------------------------------------------------------------------------------
+FramePacer::~FramePacer()
+{ Term(); }
+
+//-------------------------------------------------------------------------------------------------
+//      初期化処理を行います.
+//-------------------------------------------------------------------------------------------------
+bool FramePacer::Init(double targetFrameRate)
+{
+    if (targetFrameRate < 0.0)
+    {
+        ELOG( "Error : Invalid Argument." );
+        return false;
+    }
+
+    // 高精度タイマーが使えない環境では通常の待機可能タイマーで代用する(寝過ごしはスピンで吸収).
+    m_hTimer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+    if (m_hTimer == nullptr)
+    { m_hTimer = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS); }
+
+    if (m_hTimer == nullptr)
+    {
+        ELOG( "Error : CreateWaitableTimerExW() Failed." );
+        return false;
+    }
+
+    SetTargetFrameRate(targetFrameRate);
+    ResetStats();
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      終了処理を行います.
+//-------------------------------------------------------------------------------------------------
+void FramePacer::Term()
+{
+    if (m_hTimer != nullptr)
+    {
+        CloseHandle(m_hTimer);
+        m_hTimer = nullptr;
+    }
+
+    m_TargetSec   = 0.0;
+    m_DeadlineSec = 0.0;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      目標フレームレートを設定します.
+//-------------------------------------------------------------------------------------------------
+void FramePacer::SetTargetFrameRate(double targetFrameRate)
+{
+    m_TargetSec    = (targetFrameRate > 0.0) ? 1.0 / targetFrameRate : 0.0;
+    m_DeadlineSec  = m_Timer.GetAbsoluteSec() + m_TargetSec;
+    m_PredictedSec = 0.0;
+
+    m_Stats.TargetMs = m_TargetSec * 1000.0;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      目標フレーム時間を取得します.
+//-------------------------------------------------------------------------------------------------
+double FramePacer::GetTargetFrameSec() const
+{ return m_TargetSec; }
+
+//-------------------------------------------------------------------------------------------------
+//      次のフレームの入力取得時刻まで待機します.
+//-------------------------------------------------------------------------------------------------
+bool FramePacer::Wait()
+{
+    if (m_TargetSec <= 0.0)
+    { return true; }
+
+    // 入力をできるだけ遅く取得するため，表示の目標時刻から予測処理時間を逆算して起床する.
+    auto wakeSec = m_DeadlineSec - m_PredictedSec - SafetyMarginSec;
+    auto now     = m_Timer.GetAbsoluteSec();
+    auto remain  = wakeSec - now;
+
+    // スリープの精度が足りない最後の区間だけをスピンで待つ.
+    if (remain > m_SpinSec)
+    {
+        auto request = remain - m_SpinSec;
+        auto isDone  = SleepFor(request);
+        auto end     = m_Timer.GetAbsoluteSec();
+
+        m_SleepSec += end - now;
+
+        if (!isDone)
+        { return false; }
+
+        // 寝過ごした分だけスピン時間を延ばし，余裕があれば少しずつ縮める.
+        auto target = (end - now - request) + MinSpinSec;
+        if (target > m_SpinSec)
+        { m_SpinSec = target; }
+        else
+        { m_SpinSec += (target - m_SpinSec) * SmoothFactor; }
+
+        if (m_SpinSec < MinSpinSec) { m_SpinSec = MinSpinSec; }
+        if (m_SpinSec > MaxSpinSec) { m_SpinSec = MaxSpinSec; }
+
+        now = end;
+    }
+
+    auto spinBegin = now;
+    while(now < wakeSec)
+    {
+        YieldProcessor();
+        now = m_Timer.GetAbsoluteSec();
+    }
+    m_SpinWaitSec += now - spinBegin;
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      フレームの開始を通知します.
+//-------------------------------------------------------------------------------------------------
+void FramePacer::BeginFrame()
+{ m_FrameBeginSec = m_Timer.GetAbsoluteSec(); }
+
+//-------------------------------------------------------------------------------------------------
+//      フレームの終了を通知します.
+//-------------------------------------------------------------------------------------------------
+void FramePacer::EndFrame()
+{
+    auto now  = m_Timer.GetAbsoluteSec();
+    auto work = now - m_FrameBeginSec;
+
+    // 処理時間の予測. 間に合わないと遅延が1フレーム増えるので，増加には即座に追従する.
+    if (work > m_PredictedSec)
+    { m_PredictedSec = work; }
+    else
+    { m_PredictedSec += (work - m_PredictedSec) * SmoothFactor; }
+
+    if (m_TargetSec > 0.0 && m_PredictedSec > m_TargetSec)
+    { m_PredictedSec = m_TargetSec; }
+
+    m_Stats.FrameCount++;
+    m_SumSleepSec += m_SleepSec;
+    m_SumSpinSec  += m_SpinWaitSec;
+    m_SleepSec     = 0.0;
+    m_SpinWaitSec  = 0.0;
+
+    if (m_TargetSec > 0.0)
+    {
+        auto error    = now - m_DeadlineSec;
+        auto absError = (error < 0.0) ? -error : error;
+
+        if (error > 0.0)
+        { m_Stats.MissedCount++; }
+
+        m_SumErrorSec += absError;
+        if (absError * 1000.0 > m_Stats.MaxErrorMs)
+        { m_Stats.MaxErrorMs = absError * 1000.0; }
+
+        // 1フレーム以上遅れた場合は追いつこうとせずに基準を取り直す.
+        m_DeadlineSec += m_TargetSec;
+        if (now > m_DeadlineSec)
+        { m_DeadlineSec = now + m_TargetSec; }
+    }
+
+    auto invCount = 1000.0 / m_Stats.FrameCount;
+    m_Stats.AvgErrorMs      = m_SumErrorSec * invCount;
+    m_Stats.AvgSleepMs      = m_SumSleepSec * invCount;
+    m_Stats.AvgSpinMs       = m_SumSpinSec  * invCount;
+    m_Stats.PredictedWorkMs = m_PredictedSec * 1000.0;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      統計情報を取得します.
+//-------------------------------------------------------------------------------------------------
+const FramePacerStats& FramePacer::GetStats() const
+{ return m_Stats; }
+
+//-------------------------------------------------------------------------------------------------
+//      統計情報をリセットします.
+//-------------------------------------------------------------------------------------------------
+void FramePacer::ResetStats()
+{
+    memset(&m_Stats, 0, sizeof(m_Stats));
+    m_Stats.TargetMs        = m_TargetSec * 1000.0;
+    m_Stats.PredictedWorkMs = m_PredictedSec * 1000.0;
+
+    m_SumErrorSec = 0.0;
+    m_SumSleepSec = 0.0;
+    m_SumSpinSec  = 0.0;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      スリープします.
+//-------------------------------------------------------------------------------------------------
+bool FramePacer::SleepFor(double sec)
+{
+    if (m_hTimer == nullptr)
+    {
+        ::Sleep(static_cast<DWORD>(sec * 1000.0));
+        return true;
+    }
+
+    // 100ナノ秒単位の相対時間(負値)で指定する.
+    LARGE_INTEGER dueTime;
+    dueTime.QuadPart = -static_cast<LONGLONG>(sec * 10000000.0);
+    if (!SetWaitableTimer(m_hTimer, &dueTime, 0, nullptr, nullptr, FALSE))
+    {
+        ::Sleep(static_cast<DWORD>(sec * 1000.0));
+        return true;
+    }
+
+    // 入力メッセージが届いたら起床して，すぐに処理できるようにする.
+    auto ret = MsgWaitForMultipleObjects(1, &m_hTimer, FALSE, INFINITE, QS_ALLINPUT);
+    if (ret == WAIT_OBJECT_0 + 1)
+    {
+        CancelWaitableTimer(m_hTimer);
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace asvk
@@ -0,0 +1,278 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asvkFrameTimeRecorder.cpp
+// Desc : Frame Time Recorder Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asvkFrameTimeRecorder.h>
+#include <asvkLogger.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+
+namespace asvk {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// FrameTimeRecorder class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+const double FrameTimeRecorder::HitchRatio   = 2.0;
+const double FrameTimeRecorder::SmoothFactor = 0.05;
+const double FrameTimeRecorder::MinBucketMs  = 0.5;
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+FrameTimeRecorder::FrameTimeRecorder()
+: m_WriteIndex  (0)
+, m_HitchCount  (0)
+, m_AvgCpuMs    (0.0)
+{
+    for(auto i=0u; i<Capacity; ++i)
+    { m_Samples[i].store(0, std::memory_order_relaxed); }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      デストラクタです.
+//-------------------------------------------------------------------------------------------------
+FrameTimeRecorder::~FrameTimeRecorder()
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      フレーム時間を記録します.
+//-------------------------------------------------------------------------------------------------
+void FrameTimeRecorder::Record(double cpuMs, double gpuMs)
+{
+    auto index = m_WriteIndex.load(std::memory_order_relaxed);
+
+    // 平均から大きく外れたフレームをヒッチとして数える. 平均が安定するまでは判定しない.
+    if (index >= 8 && cpuMs > m_AvgCpuMs * HitchRatio)
+    { m_HitchCount.fetch_add(1, std::memory_order_relaxed); }
+
+    if (index == 0)
+    { m_AvgCpuMs = cpuMs; }
+    else
+    { m_AvgCpuMs += (cpuMs - m_AvgCpuMs) * SmoothFactor; }
+
+    // CPU時間とGPU時間を1つの64bit値にまとめ，読み手が片方だけ新しい値を見ることがないようにする.
+    auto cpu = static_cast<float>(cpuMs);
+    auto gpu = static_cast<float>((gpuMs >= 0.0) ? gpuMs : -1.0);
+
+    uint32_t cpuBits;
+    uint32_t gpuBits;
+    memcpy(&cpuBits, &cpu, sizeof(cpuBits));
+    memcpy(&gpuBits, &gpu, sizeof(gpuBits));
+
+    auto packed = (uint64_t(gpuBits) << 32) | uint64_t(cpuBits);
+    m_Samples[index & (Capacity - 1)].store(packed, std::memory_order_relaxed);
+
+    // サンプルの書き込みを読み手から見えるようにしてから番号を進める.
+    m_WriteIndex.store(index + 1, std::memory_order_release);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      記録を破棄します.
+//-------------------------------------------------------------------------------------------------
+void FrameTimeRecorder::Reset()
+{
+    m_WriteIndex.store(0, std::memory_order_release);
+    m_HitchCount.store(0, std::memory_order_relaxed);
+    m_AvgCpuMs = 0.0;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      直近のフレームを集計します.
+//-------------------------------------------------------------------------------------------------
+bool FrameTimeRecorder::GetStats(FrameTimeStats* pStats) const
+{
+    if (pStats == nullptr)
+    { return false; }
+
+    memset(pStats, 0, sizeof(FrameTimeStats));
+
+    std::vector<float> cpuMs;
+    std::vector<float> gpuMs;
+    pStats->FrameCount = Snapshot(cpuMs, gpuMs);
+    pStats->HitchCount = m_HitchCount.load(std::memory_order_relaxed);
+
+    if (cpuMs.empty())
+    { return false; }
+
+    Summarize(cpuMs, &pStats->Cpu);
+    Summarize(gpuMs, &pStats->Gpu);
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      集計結果と直近のフレーム時間をCSVファイルに保存します.
+//-------------------------------------------------------------------------------------------------
+bool FrameTimeRecorder::SaveCsv(const wchar_t* filename) const
+{
+    if (filename == nullptr)
+    {
+        ELOG( "Error : Invalid Argument." );
+        return false;
+    }
+
+    FrameTimeStats stats;
+    if (!GetStats(&stats))
+    {
+        ELOG( "Error : FrameTimeRecorder::GetStats() Failed." );
+        return false;
+    }
+
+    FILE* pFile = nullptr;
+    auto err = _wfopen_s( &pFile, filename, L"w" );
+    if ( err != 0 )
+    {
+        ELOG( "Error : File Open Failed." );
+        return false;
+    }
+
+    // 1つの表で扱えるように section,key,cpu_ms,gpu_ms の4列に揃える.
+    fprintf(pFile, "section,key,cpu_ms,gpu_ms\n");
+    fprintf(pFile, "summary,samples,%u,%u\n", stats.Cpu.SampleCount, stats.Gpu.SampleCount);
+    fprintf(pFile, "summary,avg,%.4f,%.4f\n", stats.Cpu.AvgMs, stats.Gpu.AvgMs);
+    fprintf(pFile, "summary,p50,%.4f,%.4f\n", stats.Cpu.P50Ms, stats.Gpu.P50Ms);
+    fprintf(pFile, "summary,p95,%.4f,%.4f\n", stats.Cpu.P95Ms, stats.Gpu.P95Ms);
+    fprintf(pFile, "summary,p99,%.4f,%.4f\n", stats.Cpu.P99Ms, stats.Gpu.P99Ms);
+    fprintf(pFile, "summary,max,%.4f,%.4f\n", stats.Cpu.MaxMs, stats.Gpu.MaxMs);
+    fprintf(pFile, "summary,frames,%llu,\n", static_cast<unsigned long long>(stats.FrameCount));
+    fprintf(pFile, "summary,hitches,%llu,\n", static_cast<unsigned long long>(stats.HitchCount));
+
+    for(auto i=0u; i<FrameTimeBucketCount; ++i)
+    {
+        auto upper = GetBucketUpperMs(i);
+        if (upper < 0.0)
+        { fprintf(pFile, "histogram,inf,%u,%u\n", stats.Cpu.Histogram[i], stats.Gpu.Histogram[i]); }
+        else
+        { fprintf(pFile, "histogram,%.3f,%u,%u\n", upper, stats.Cpu.Histogram[i], stats.Gpu.Histogram[i]); }
+    }
+
+    // 直近のフレーム時間. GPU時間を計測できなかったフレームは空欄にする.
+    auto end   = m_WriteIndex.load(std::memory_order_acquire);
+    auto count = std::min<uint64_t>(end, Capacity);
+    for(auto i=end - count; i<end; ++i)
+    {
+        auto packed  = m_Samples[i & (Capacity - 1)].load(std::memory_order_relaxed);
+        auto cpuBits = static_cast<uint32_t>(packed);
+        auto gpuBits = static_cast<uint32_t>(packed >> 32);
+
+        float cpu;
+        float gpu;
+        memcpy(&cpu, &cpuBits, sizeof(cpu));
+        memcpy(&gpu, &gpuBits, sizeof(gpu));
+
+        if (gpu >= 0.0f)
+        { fprintf(pFile, "frame,%llu,%.4f,%.4f\n", static_cast<unsigned long long>(i), cpu, gpu); }
+        else
+        { fprintf(pFile, "frame,%llu,%.4f,\n", static_cast<unsigned long long>(i), cpu); }
+    }
+
+    fclose(pFile);
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ヒストグラムのビンの上限を取得します.
+//-------------------------------------------------------------------------------------------------
+double FrameTimeRecorder::GetBucketUpperMs(uint32_t index)
+{
+    if (index + 1 >= FrameTimeBucketCount)
+    { return -1.0; }
+
+    // 半オクターブ刻み(0.5, 0.71, 1.0, 1.41, ... ミリ秒).
+    return MinBucketMs * pow(2.0, index * 0.5);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      直近のサンプルを取得します.
+//-------------------------------------------------------------------------------------------------
+uint64_t FrameTimeRecorder::Snapshot(std::vector<float>& cpuMs, std::vector<float>& gpuMs) const
+{
+    auto end   = m_WriteIndex.load(std::memory_order_acquire);
+    auto count = static_cast<uint32_t>(std::min<uint64_t>(end, Capacity));
+
+    cpuMs.clear();
+    gpuMs.clear();
+    cpuMs.reserve(count);
+    gpuMs.reserve(count);
+
+    // 読んでいる間に古いサンプルが上書きされることはあるが，各サンプルは常に対になっている.
+    for(auto i=end - count; i<end; ++i)
+    {
+        auto packed  = m_Samples[i & (Capacity - 1)].load(std::memory_order_relaxed);
+        auto cpuBits = static_cast<uint32_t>(packed);
+        auto gpuBits = static_cast<uint32_t>(packed >> 32);
+
+        float cpu;
+        float gpu;
+        memcpy(&cpu, &cpuBits, sizeof(cpu));
+        memcpy(&gpu, &gpuBits, sizeof(gpu));
+
+        cpuMs.push_back(cpu);
+        if (gpu >= 0.0f)
+        { gpuMs.push_back(gpu); }
+    }
+
+    return end;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      サンプルを集計します.
+//-------------------------------------------------------------------------------------------------
+void FrameTimeRecorder::Summarize(std::vector<float>& samples, FrameTimeSummary* pSummary)
+{
+    memset(pSummary, 0, sizeof(FrameTimeSummary));
+    if (samples.empty())
+    { return; }
+
+    std::sort(samples.begin(), samples.end());
+
+    auto count = static_cast<uint32_t>(samples.size());
+
+    // 最近傍順位法でパーセンタイルを求める.
+    auto percentile = [&](double p)
+    {
+        auto rank = static_cast<uint32_t>(ceil(p * count));
+        if (rank < 1)     { rank = 1; }
+        if (rank > count) { rank = count; }
+        return static_cast<double>(samples[rank - 1]);
+    };
+
+    double sum = 0.0;
+    for(auto ms : samples)
+    {
+        sum += ms;
+        pSummary->Histogram[GetBucketIndex(ms)]++;
+    }
+
+    pSummary->SampleCount = count;
+    pSummary->AvgMs       = sum / count;
+    pSummary->P50Ms       = percentile(0.50);
+    pSummary->P95Ms       = percentile(0.95);
+    pSummary->P99Ms       = percentile(0.99);
+    pSummary->MaxMs       = samples.back();
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ビン番号を取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t FrameTimeRecorder::GetBucketIndex(double ms)
+{
+    if (ms < MinBucketMs)
+    { return 0; }
+
+    auto index = 1 + static_cast<uint32_t>(floor(2.0 * log2(ms / MinBucketMs)));
+    if (index >= FrameTimeBucketCount)
+    { index = FrameTimeBucketCount - 1; }
+
+    return index;
+}
+
+} // namespace asvk
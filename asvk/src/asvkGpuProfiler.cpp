@@ -0,0 +1,603 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asvkGpuProfiler.cpp
+// Desc : GPU Profiler Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asvkGpuProfiler.h>
+#include <asvkLogger.h>
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
+
+
+namespace asvk {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// GpuProfiler class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+GpuProfiler::GpuProfiler()
+: m_Device          (null_handle)
+, m_QueryPool       (null_handle)
+, m_StatsPool       (null_handle)
+, m_StatsFlags      (0)
+, m_StatsValueCount (0)
+, m_MaxStatsCount   (0)
+, m_IsStatsActive   (false)
+, m_FrameStatsCount (0)
+, m_FrameGpuMs      (-1.0)
+, m_TimestampPeriod (0.0)
+, m_TimestampMask   (0)
+, m_MaxQueryCount   (0)
+, m_FrameIndex      (0)
+{ memset(&m_FrameStats, 0, sizeof(m_FrameStats)); }
+
+//-------------------------------------------------------------------------------------------------
+//      デストラクタです.
+//-------------------------------------------------------------------------------------------------
+GpuProfiler::~GpuProfiler()
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      初期化処理です.
+//-------------------------------------------------------------------------------------------------
+bool GpuProfiler::Init
+(
+    DeviceMgr*  pDeviceMgr,
+    QueueType   queueType,
+    uint32_t    frameCount,
+    uint32_t    maxRegionCount,
+    uint32_t    maxStatsCount
+)
+{
+    if (pDeviceMgr == nullptr || frameCount == 0 || maxRegionCount == 0)
+    {
+        ELOG( "Error : Invalid Argument." );
+        return false;
+    }
+
+    auto device = pDeviceMgr->GetDevice();
+    auto gpu    = pDeviceMgr->GetSelectedPhysicalDevice().Gpu;
+
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(gpu, &props);
+
+    uint32_t familyIndex = 0;
+    if (queueType == QueueType_Graphics)
+    { familyIndex = pDeviceMgr->GetGraphicsQueue()->GetFamilyIndex(); }
+    else if (queueType == QueueType_Compute)
+    { familyIndex = pDeviceMgr->GetComputeQueue()->GetFamilyIndex(); }
+    else
+    { familyIndex = pDeviceMgr->GetTransferQueue()->GetFamilyIndex(); }
+
+    uint32_t familyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(gpu, &familyCount, nullptr);
+
+    std::vector<VkQueueFamilyProperties> families(familyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(gpu, &familyCount, families.data());
+
+    uint32_t validBits = 0;
+    if (familyIndex < familyCount)
+    { validBits = families[familyIndex].timestampValidBits; }
+
+    m_Frames.resize(frameCount);
+    for(auto& frame : m_Frames)
+    {
+        frame.Queries.reserve(maxRegionCount);
+        frame.QueryCount = 0;
+        frame.StatsRegions.reserve(maxStatsCount);
+    }
+
+    // 対応していない場合は区間の記録を無視して動作させる.
+    if (validBits == 0 || props.limits.timestampPeriod <= 0.0f)
+    { ILOG( "Info : Timestamp query is not supported. GPU profiling is disabled." ); }
+    else
+    {
+        m_TimestampPeriod = props.limits.timestampPeriod;
+        m_TimestampMask   = (validBits >= 64) ? UINT64_MAX : ((uint64_t(1) << validBits) - 1);
+        m_MaxQueryCount   = maxRegionCount * 2;
+
+        VkQueryPoolCreateInfo info = {};
+        info.sType              = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        info.pNext              = nullptr;
+        info.flags              = 0;
+        info.queryType          = VK_QUERY_TYPE_TIMESTAMP;
+        info.queryCount         = m_MaxQueryCount * frameCount;
+        info.pipelineStatistics = 0;
+
+        auto result = vkCreateQueryPool(device, &info, nullptr, &m_QueryPool);
+        if (result != VK_SUCCESS)
+        {
+            ELOG( "Error : vkCreateQueryPool() Failed." );
+            return false;
+        }
+
+        m_Results.resize(m_MaxQueryCount);
+    }
+
+    // パイプライン統計はグラフィックス・コンピュートのキューでのみ使用できる.
+    m_StatsFlags = 0;
+    if (queueType == QueueType_Graphics)
+    {
+        m_StatsFlags = VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT
+                     | VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT
+                     | VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT
+                     | VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT
+                     | VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT
+                     | VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT
+                     | VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT;
+        m_StatsValueCount = 7;
+    }
+    else if (queueType == QueueType_Compute)
+    {
+        m_StatsFlags      = VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT;
+        m_StatsValueCount = 1;
+    }
+
+    if (maxStatsCount > 0 && m_StatsFlags != 0)
+    {
+        if (!pDeviceMgr->IsPipelineStatistics())
+        { ILOG( "Info : Pipeline statistics query is not supported." ); }
+        else
+        {
+            m_MaxStatsCount = maxStatsCount;
+
+            VkQueryPoolCreateInfo info = {};
+            info.sType              = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+            info.pNext              = nullptr;
+            info.flags              = 0;
+            info.queryType          = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+            info.queryCount         = m_MaxStatsCount * frameCount;
+            info.pipelineStatistics = m_StatsFlags;
+
+            auto result = vkCreateQueryPool(device, &info, nullptr, &m_StatsPool);
+            if (result != VK_SUCCESS)
+            {
+                ELOG( "Error : vkCreateQueryPool() Failed." );
+                return false;
+            }
+
+            m_Results.resize(std::max(m_MaxQueryCount, m_MaxStatsCount * m_StatsValueCount));
+        }
+    }
+
+    m_Device     = device;
+    m_FrameIndex = 0;
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      終了処理です.
+//-------------------------------------------------------------------------------------------------
+void GpuProfiler::Term(DeviceMgr* pDeviceMgr)
+{
+    if (pDeviceMgr == nullptr)
+    { return; }
+
+    if (m_QueryPool != null_handle)
+    {
+        vkDestroyQueryPool(pDeviceMgr->GetDevice(), m_QueryPool, nullptr);
+        m_QueryPool = null_handle;
+    }
+
+    if (m_StatsPool != null_handle)
+    {
+        vkDestroyQueryPool(pDeviceMgr->GetDevice(), m_StatsPool, nullptr);
+        m_StatsPool = null_handle;
+    }
+
+    m_Frames   .clear();
+    m_Regions  .clear();
+    m_RegionMap.clear();
+    m_Stack    .clear();
+    m_Results  .clear();
+
+    m_Device          = null_handle;
+    m_TimestampPeriod = 0.0;
+    m_TimestampMask   = 0;
+    m_MaxQueryCount   = 0;
+    m_StatsFlags      = 0;
+    m_StatsValueCount = 0;
+    m_MaxStatsCount   = 0;
+    m_IsStatsActive   = false;
+    m_FrameStatsCount = 0;
+    m_FrameGpuMs      = -1.0;
+    m_FrameIndex      = 0;
+    memset(&m_FrameStats, 0, sizeof(m_FrameStats));
+}
+
+//-------------------------------------------------------------------------------------------------
+//      フレームの計測を開始します.
+//-------------------------------------------------------------------------------------------------
+void GpuProfiler::BeginFrame(VkCommandBuffer commandBuffer, uint32_t frameIndex)
+{
+    if (m_Frames.empty())
+    { return; }
+
+    m_FrameIndex = frameIndex % static_cast<uint32_t>(m_Frames.size());
+
+    auto& frame = m_Frames[m_FrameIndex];
+
+    m_FrameGpuMs = -1.0;
+
+    // 数フレーム前の結果なので待機せずに読み戻せる.
+    if (m_QueryPool != null_handle)
+    {
+        auto firstQuery = m_FrameIndex * m_MaxQueryCount;
+        Resolve(frame, firstQuery);
+        vkCmdResetQueryPool(commandBuffer, m_QueryPool, firstQuery, m_MaxQueryCount);
+    }
+
+    if (m_StatsPool != null_handle)
+    {
+        auto firstQuery = m_FrameIndex * m_MaxStatsCount;
+        ResolveStats(frame, firstQuery);
+        vkCmdResetQueryPool(commandBuffer, m_StatsPool, firstQuery, m_MaxStatsCount);
+    }
+
+    frame.Queries.clear();
+    frame.QueryCount = 0;
+    frame.StatsRegions.clear();
+    m_Stack.clear();
+    m_IsStatsActive = false;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      区間の計測を開始します.
+//-------------------------------------------------------------------------------------------------
+void GpuProfiler::BeginRegion(VkCommandBuffer commandBuffer, const char* name, bool pipelineStats)
+{
+    if (m_Frames.empty() || name == nullptr)
+    { return; }
+
+    auto& frame = m_Frames[m_FrameIndex];
+
+    // クエリが足りない場合も EndRegion() と対応が取れるように無効な番号を積んでおく.
+    Scope scope;
+    scope.Query = UINT32_MAX;
+    scope.Stats = UINT32_MAX;
+
+    if (m_QueryPool != null_handle && frame.QueryCount + 2 <= m_MaxQueryCount)
+    {
+        Query query;
+        query.Region = FindOrAddRegion(name);
+        query.Begin  = frame.QueryCount;
+        query.End    = frame.QueryCount + 1;
+        frame.QueryCount += 2;
+
+        scope.Query = static_cast<uint32_t>(frame.Queries.size());
+        frame.Queries.push_back(query);
+
+        vkCmdWriteTimestamp(
+            commandBuffer,
+            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+            m_QueryPool,
+            m_FrameIndex * m_MaxQueryCount + query.Begin);
+    }
+
+    if (pipelineStats
+     && m_StatsPool != null_handle
+     && !m_IsStatsActive
+     && frame.StatsRegions.size() < m_MaxStatsCount)
+    {
+        scope.Stats = static_cast<uint32_t>(frame.StatsRegions.size());
+        frame.StatsRegions.push_back(FindOrAddRegion(name));
+        m_IsStatsActive = true;
+
+        vkCmdBeginQuery(commandBuffer, m_StatsPool, m_FrameIndex * m_MaxStatsCount + scope.Stats, 0);
+    }
+
+    m_Stack.push_back(scope);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      区間の計測を終了します.
+//-------------------------------------------------------------------------------------------------
+void GpuProfiler::EndRegion(VkCommandBuffer commandBuffer)
+{
+    if (m_Stack.empty())
+    { return; }
+
+    auto scope = m_Stack.back();
+    m_Stack.pop_back();
+
+    if (scope.Stats != UINT32_MAX)
+    {
+        vkCmdEndQuery(commandBuffer, m_StatsPool, m_FrameIndex * m_MaxStatsCount + scope.Stats);
+        m_IsStatsActive = false;
+    }
+
+    if (scope.Query != UINT32_MAX)
+    {
+        const auto& query = m_Frames[m_FrameIndex].Queries[scope.Query];
+
+        vkCmdWriteTimestamp(
+            commandBuffer,
+            VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+            m_QueryPool,
+            m_FrameIndex * m_MaxQueryCount + query.End);
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      タイムスタンプによる計測が可能かどうかチェックします.
+//-------------------------------------------------------------------------------------------------
+bool GpuProfiler::IsSupported() const
+{ return m_QueryPool != null_handle; }
+
+//-------------------------------------------------------------------------------------------------
+//      パイプライン統計の収集が可能かどうかチェックします.
+//-------------------------------------------------------------------------------------------------
+bool GpuProfiler::IsPipelineStatsSupported() const
+{ return m_StatsPool != null_handle; }
+
+//-------------------------------------------------------------------------------------------------
+//      収集するパイプライン統計のフラグを取得します.
+//-------------------------------------------------------------------------------------------------
+VkQueryPipelineStatisticFlags GpuProfiler::GetPipelineStatisticFlags() const
+{ return (m_StatsPool != null_handle) ? m_StatsFlags : 0; }
+
+//-------------------------------------------------------------------------------------------------
+//      計測済みの区間数を取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t GpuProfiler::GetRegionCount() const
+{ return static_cast<uint32_t>(m_Regions.size()); }
+
+//-------------------------------------------------------------------------------------------------
+//      区間の統計情報を取得します.
+//-------------------------------------------------------------------------------------------------
+bool GpuProfiler::GetRegionStats(uint32_t index, GpuRegionStats* pStats) const
+{
+    if (index >= m_Regions.size() || pStats == nullptr)
+    { return false; }
+
+    const auto& region = m_Regions[index];
+
+    pStats->Name        = region.Name.c_str();
+    pStats->Depth       = region.Depth;
+    pStats->SampleCount = region.SampleCount;
+    pStats->LastMs      = 0.0;
+    pStats->MinMs       = 0.0;
+    pStats->AvgMs       = 0.0;
+    pStats->MaxMs       = 0.0;
+
+    if (region.SampleCount == 0)
+    { return true; }
+
+    auto minMs = DBL_MAX;
+    auto maxMs = 0.0;
+    auto sumMs = 0.0;
+    for(auto i=0u; i<region.SampleCount; ++i)
+    {
+        auto ms = region.History[i];
+        minMs  = std::min(minMs, ms);
+        maxMs  = std::max(maxMs, ms);
+        sumMs += ms;
+    }
+
+    auto last = (region.HistoryIndex + HistoryCount - 1) % HistoryCount;
+
+    pStats->LastMs = region.History[last];
+    pStats->MinMs  = minMs;
+    pStats->AvgMs  = sumMs / region.SampleCount;
+    pStats->MaxMs  = maxMs;
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      区間名を指定して統計情報を取得します.
+//-------------------------------------------------------------------------------------------------
+bool GpuProfiler::FindRegionStats(const char* name, GpuRegionStats* pStats) const
+{
+    if (name == nullptr)
+    { return false; }
+
+    auto itr = m_RegionMap.find(name);
+    if (itr == m_RegionMap.end())
+    { return false; }
+
+    return GetRegionStats(itr->second, pStats);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      区間名を指定して最新のパイプライン統計を取得します.
+//-------------------------------------------------------------------------------------------------
+bool GpuProfiler::FindPipelineStats(const char* name, PipelineStats* pStats) const
+{
+    if (name == nullptr || pStats == nullptr)
+    { return false; }
+
+    auto itr = m_RegionMap.find(name);
+    if (itr == m_RegionMap.end())
+    { return false; }
+
+    const auto& region = m_Regions[itr->second];
+    if (!region.HasStats)
+    { return false; }
+
+    *pStats = region.Stats;
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      最後に読み戻したフレームのパイプライン統計の合計を取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t GpuProfiler::GetFramePipelineStats(PipelineStats* pStats) const
+{
+    if (pStats != nullptr)
+    { *pStats = m_FrameStats; }
+
+    return m_FrameStatsCount;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      最後に読み戻したフレームのGPU時間を取得します.
+//-------------------------------------------------------------------------------------------------
+double GpuProfiler::GetFrameGpuMs() const
+{ return m_FrameGpuMs; }
+
+//-------------------------------------------------------------------------------------------------
+//      集計済みのサンプルを破棄します.
+//-------------------------------------------------------------------------------------------------
+void GpuProfiler::ResetStats()
+{
+    for(auto& region : m_Regions)
+    {
+        region.HistoryIndex = 0;
+        region.SampleCount  = 0;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      区間名に対応する区間番号を取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t GpuProfiler::FindOrAddRegion(const char* name)
+{
+    auto itr = m_RegionMap.find(name);
+    if (itr != m_RegionMap.end())
+    { return itr->second; }
+
+    Region region;
+    region.Name         = name;
+    region.Depth        = static_cast<uint32_t>(m_Stack.size());
+    region.HistoryIndex = 0;
+    region.SampleCount  = 0;
+    region.FrameMs      = 0.0;
+    region.IsHit        = false;
+    region.HasStats     = false;
+    region.History.resize(HistoryCount, 0.0);
+    memset(&region.Stats, 0, sizeof(region.Stats));
+
+    auto index = static_cast<uint32_t>(m_Regions.size());
+    m_Regions.push_back(region);
+    m_RegionMap[region.Name] = index;
+
+    return index;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      前回記録したタイムスタンプを読み戻して集計します.
+//-------------------------------------------------------------------------------------------------
+void GpuProfiler::Resolve(Frame& frame, uint32_t firstQuery)
+{
+    if (frame.QueryCount == 0)
+    { return; }
+
+    // 待機フラグは付けない. サブミットされなかったフレームは VK_NOT_READY となり破棄される.
+    auto result = vkGetQueryPoolResults(
+        m_Device,
+        m_QueryPool,
+        firstQuery,
+        frame.QueryCount,
+        sizeof(uint64_t) * frame.QueryCount,
+        m_Results.data(),
+        sizeof(uint64_t),
+        VK_QUERY_RESULT_64_BIT);
+    if (result != VK_SUCCESS)
+    { return; }
+
+    m_FrameGpuMs = 0.0;
+
+    // 同じ区間名を1フレームに複数回計測した場合は合計する.
+    for(const auto& query : frame.Queries)
+    {
+        auto ticks = (m_Results[query.End] - m_Results[query.Begin]) & m_TimestampMask;
+        auto ms    = double(ticks) * m_TimestampPeriod / 1000000.0;
+
+        auto& region = m_Regions[query.Region];
+        region.FrameMs += ms;
+        region.IsHit    = true;
+
+        // 入れ子の区間は親に含まれるので, 最上位の区間だけをフレームのGPU時間に加える.
+        if (region.Depth == 0)
+        { m_FrameGpuMs += ms; }
+    }
+
+    for(auto& region : m_Regions)
+    {
+        if (!region.IsHit)
+        { continue; }
+
+        region.History[region.HistoryIndex] = region.FrameMs;
+        region.HistoryIndex = (region.HistoryIndex + 1) % HistoryCount;
+        region.FrameMs      = 0.0;
+        region.IsHit        = false;
+
+        if (region.SampleCount < HistoryCount)
+        { region.SampleCount++; }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      前回記録したパイプライン統計を読み戻します.
+//-------------------------------------------------------------------------------------------------
+void GpuProfiler::ResolveStats(Frame& frame, uint32_t firstQuery)
+{
+    if (frame.StatsRegions.empty())
+    {
+        memset(&m_FrameStats, 0, sizeof(m_FrameStats));
+        m_FrameStatsCount = 0;
+        return;
+    }
+
+    auto count  = static_cast<uint32_t>(frame.StatsRegions.size());
+    auto stride = sizeof(uint64_t) * m_StatsValueCount;
+
+    auto result = vkGetQueryPoolResults(
+        m_Device,
+        m_StatsPool,
+        firstQuery,
+        count,
+        stride * count,
+        m_Results.data(),
+        stride,
+        VK_QUERY_RESULT_64_BIT);
+    if (result != VK_SUCCESS)
+    { return; }
+
+    memset(&m_FrameStats, 0, sizeof(m_FrameStats));
+    m_FrameStatsCount = count;
+
+    for(auto i=0u; i<count; ++i)
+    {
+        // 結果は有効にしたビットの昇順に並ぶ.
+        const auto* values = &m_Results[i * m_StatsValueCount];
+
+        PipelineStats stats = {};
+        if (m_StatsValueCount == 1)
+        { stats.ComputeShaderInvocations = values[0]; }
+        else
+        {
+            stats.InputVertices             = values[0];
+            stats.InputPrimitives           = values[1];
+            stats.VertexShaderInvocations   = values[2];
+            stats.ClippingInvocations       = values[3];
+            stats.ClippingPrimitives        = values[4];
+            stats.FragmentShaderInvocations = values[5];
+            stats.ComputeShaderInvocations  = values[6];
+        }
+
+        auto& region = m_Regions[frame.StatsRegions[i]];
+        region.Stats    = stats;
+        region.HasStats = true;
+
+        m_FrameStats.InputVertices             += stats.InputVertices;
+        m_FrameStats.InputPrimitives           += stats.InputPrimitives;
+        m_FrameStats.VertexShaderInvocations   += stats.VertexShaderInvocations;
+        m_FrameStats.ClippingInvocations       += stats.ClippingInvocations;
+        m_FrameStats.ClippingPrimitives        += stats.ClippingPrimitives;
+        m_FrameStats.FragmentShaderInvocations += stats.FragmentShaderInvocations;
+        m_FrameStats.ComputeShaderInvocations  += stats.ComputeShaderInvocations;
+    }
+}
+
+} // namespace asvk
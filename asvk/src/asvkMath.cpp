@@ -0,0 +1,408 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asvkMath.cpp
+// Desc : Math Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asvkMath.h>
+#include <algorithm>
+
+
+namespace /* anonymous */ {
+
+//-------------------------------------------------------------------------------------------------
+// Constant Values.
+//-------------------------------------------------------------------------------------------------
+static const size_t SoABlockSize = 16;      // AoS から SoA に並べ替えて処理する要素数 (4の倍数).
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// SoABlock structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct SoABlock
+{
+    float   X[SoABlockSize];    //!< X成分です.
+    float   Y[SoABlockSize];    //!< Y成分です.
+    float   Z[SoABlockSize];    //!< Z成分です.
+};
+
+//-------------------------------------------------------------------------------------------------
+// Type Definitions.
+//-------------------------------------------------------------------------------------------------
+typedef void (*SoAKernel)( const SoABlock& input, const asvk::Matrix& matrix, SoABlock& output );
+
+
+//-------------------------------------------------------------------------------------------------
+//      インターリーブされた3成分ベクトルを SoA に並べ替えます.
+//-------------------------------------------------------------------------------------------------
+inline void LoadSoA( const uint8_t* pInput, size_t stride, size_t count, SoABlock& block )
+{
+    for( size_t i=0; i<count; ++i )
+    {
+        auto p = reinterpret_cast<const float*>( pInput + i * stride );
+        block.X[i] = p[0];
+        block.Y[i] = p[1];
+        block.Z[i] = p[2];
+    }
+
+    // 端数は未使用レーンを 0 で埋める.
+    for( size_t i=count; i<SoABlockSize; ++i )
+    {
+        block.X[i] = 0.0f;
+        block.Y[i] = 0.0f;
+        block.Z[i] = 0.0f;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      SoA をインターリーブされた3成分ベクトルに書き戻します.
+//-------------------------------------------------------------------------------------------------
+inline void StoreSoA( const SoABlock& block, size_t count, uint8_t* pOutput, size_t stride )
+{
+    for( size_t i=0; i<count; ++i )
+    {
+        auto p = reinterpret_cast<float*>( pOutput + i * stride );
+        p[0] = block.X[i];
+        p[1] = block.Y[i];
+        p[2] = block.Z[i];
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      SoA ブロックの位置座標を変換します.
+//-------------------------------------------------------------------------------------------------
+void TransformSoA( const SoABlock& input, const asvk::Matrix& m, SoABlock& output )
+{
+#if ASVK_IS_SIMD && ASVK_IS_SSE2
+    auto m11 = _mm_set1_ps( m._11 ); auto m12 = _mm_set1_ps( m._12 ); auto m13 = _mm_set1_ps( m._13 );
+    auto m21 = _mm_set1_ps( m._21 ); auto m22 = _mm_set1_ps( m._22 ); auto m23 = _mm_set1_ps( m._23 );
+    auto m31 = _mm_set1_ps( m._31 ); auto m32 = _mm_set1_ps( m._32 ); auto m33 = _mm_set1_ps( m._33 );
+    auto m41 = _mm_set1_ps( m._41 ); auto m42 = _mm_set1_ps( m._42 ); auto m43 = _mm_set1_ps( m._43 );
+
+    for( size_t i=0; i<SoABlockSize; i+=4 )
+    {
+        auto x = _mm_loadu_ps( input.X + i );
+        auto y = _mm_loadu_ps( input.Y + i );
+        auto z = _mm_loadu_ps( input.Z + i );
+
+        _mm_storeu_ps( output.X + i, _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, m11 ), _mm_mul_ps( y, m21 ) ), _mm_mul_ps( z, m31 ) ), m41 ) );
+        _mm_storeu_ps( output.Y + i, _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, m12 ), _mm_mul_ps( y, m22 ) ), _mm_mul_ps( z, m32 ) ), m42 ) );
+        _mm_storeu_ps( output.Z + i, _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, m13 ), _mm_mul_ps( y, m23 ) ), _mm_mul_ps( z, m33 ) ), m43 ) );
+    }
+#else
+    for( size_t i=0; i<SoABlockSize; ++i )
+    {
+        auto x = input.X[i];
+        auto y = input.Y[i];
+        auto z = input.Z[i];
+        output.X[i] = ( ((x * m._11) + (y * m._21)) + (z * m._31)) + m._41;
+        output.Y[i] = ( ((x * m._12) + (y * m._22)) + (z * m._32)) + m._42;
+        output.Z[i] = ( ((x * m._13) + (y * m._23)) + (z * m._33)) + m._43;
+    }
+#endif
+}
+
+//-------------------------------------------------------------------------------------------------
+//      SoA ブロックの法線ベクトルを変換します.
+//-------------------------------------------------------------------------------------------------
+void TransformNormalSoA( const SoABlock& input, const asvk::Matrix& m, SoABlock& output )
+{
+#if ASVK_IS_SIMD && ASVK_IS_SSE2
+    auto m11 = _mm_set1_ps( m._11 ); auto m12 = _mm_set1_ps( m._12 ); auto m13 = _mm_set1_ps( m._13 );
+    auto m21 = _mm_set1_ps( m._21 ); auto m22 = _mm_set1_ps( m._22 ); auto m23 = _mm_set1_ps( m._23 );
+    auto m31 = _mm_set1_ps( m._31 ); auto m32 = _mm_set1_ps( m._32 ); auto m33 = _mm_set1_ps( m._33 );
+
+    for( size_t i=0; i<SoABlockSize; i+=4 )
+    {
+        auto x = _mm_loadu_ps( input.X + i );
+        auto y = _mm_loadu_ps( input.Y + i );
+        auto z = _mm_loadu_ps( input.Z + i );
+
+        _mm_storeu_ps( output.X + i, _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, m11 ), _mm_mul_ps( y, m21 ) ), _mm_mul_ps( z, m31 ) ) );
+        _mm_storeu_ps( output.Y + i, _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, m12 ), _mm_mul_ps( y, m22 ) ), _mm_mul_ps( z, m32 ) ) );
+        _mm_storeu_ps( output.Z + i, _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, m13 ), _mm_mul_ps( y, m23 ) ), _mm_mul_ps( z, m33 ) ) );
+    }
+#else
+    for( size_t i=0; i<SoABlockSize; ++i )
+    {
+        auto x = input.X[i];
+        auto y = input.Y[i];
+        auto z = input.Z[i];
+        output.X[i] = ((x * m._11) + (y * m._21)) + (z * m._31);
+        output.Y[i] = ((x * m._12) + (y * m._22)) + (z * m._32);
+        output.Z[i] = ((x * m._13) + (y * m._23)) + (z * m._33);
+    }
+#endif
+}
+
+//-------------------------------------------------------------------------------------------------
+//      SoA ブロックの位置座標を変換し, w=1 に射影します.
+//-------------------------------------------------------------------------------------------------
+void TransformCoordSoA( const SoABlock& input, const asvk::Matrix& m, SoABlock& output )
+{
+#if ASVK_IS_SIMD && ASVK_IS_SSE2
+    auto m11 = _mm_set1_ps( m._11 ); auto m12 = _mm_set1_ps( m._12 ); auto m13 = _mm_set1_ps( m._13 ); auto m14 = _mm_set1_ps( m._14 );
+    auto m21 = _mm_set1_ps( m._21 ); auto m22 = _mm_set1_ps( m._22 ); auto m23 = _mm_set1_ps( m._23 ); auto m24 = _mm_set1_ps( m._24 );
+    auto m31 = _mm_set1_ps( m._31 ); auto m32 = _mm_set1_ps( m._32 ); auto m33 = _mm_set1_ps( m._33 ); auto m34 = _mm_set1_ps( m._34 );
+    auto m41 = _mm_set1_ps( m._41 ); auto m42 = _mm_set1_ps( m._42 ); auto m43 = _mm_set1_ps( m._43 ); auto m44 = _mm_set1_ps( m._44 );
+
+    for( size_t i=0; i<SoABlockSize; i+=4 )
+    {
+        auto x = _mm_loadu_ps( input.X + i );
+        auto y = _mm_loadu_ps( input.Y + i );
+        auto z = _mm_loadu_ps( input.Z + i );
+
+        auto X = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, m11 ), _mm_mul_ps( y, m21 ) ), _mm_mul_ps( z, m31 ) ), m41 );
+        auto Y = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, m12 ), _mm_mul_ps( y, m22 ) ), _mm_mul_ps( z, m32 ) ), m42 );
+        auto Z = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, m13 ), _mm_mul_ps( y, m23 ) ), _mm_mul_ps( z, m33 ) ), m43 );
+        auto W = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, m14 ), _mm_mul_ps( y, m24 ) ), _mm_mul_ps( z, m34 ) ), m44 );
+
+        _mm_storeu_ps( output.X + i, _mm_div_ps( X, W ) );
+        _mm_storeu_ps( output.Y + i, _mm_div_ps( Y, W ) );
+        _mm_storeu_ps( output.Z + i, _mm_div_ps( Z, W ) );
+    }
+#else
+    for( size_t i=0; i<SoABlockSize; ++i )
+    {
+        auto x = input.X[i];
+        auto y = input.Y[i];
+        auto z = input.Z[i];
+        auto X = ( ( ((x * m._11) + (y * m._21)) + (z * m._31) ) + m._41);
+        auto Y = ( ( ((x * m._12) + (y * m._22)) + (z * m._32) ) + m._42);
+        auto Z = ( ( ((x * m._13) + (y * m._23)) + (z * m._33) ) + m._43);
+        auto W = ( ( ((x * m._14) + (y * m._24)) + (z * m._34) ) + m._44);
+        output.X[i] = X / W;
+        output.Y[i] = Y / W;
+        output.Z[i] = Z / W;
+    }
+#endif
+}
+
+//-------------------------------------------------------------------------------------------------
+//      3成分ベクトル配列をブロック単位で変換します.
+//-------------------------------------------------------------------------------------------------
+void TransformVector3Array
+(
+    SoAKernel           kernel,
+    const void*         pInput,
+    size_t              inputStride,
+    size_t              count,
+    const asvk::Matrix& matrix,
+    void*               pOutput,
+    size_t              outputStride
+)
+{
+    if ( pInput == nullptr || pOutput == nullptr || count == 0 )
+    { return; }
+
+    auto pSrc = static_cast<const uint8_t*>( pInput );
+    auto pDst = static_cast<uint8_t*>( pOutput );
+
+    SoABlock input;
+    SoABlock output;
+
+    // ブロック全体を読み込んでから書き戻すため, 入出力が同じ配列でも正しく動作する.
+    for( size_t offset=0; offset<count; offset+=SoABlockSize )
+    {
+        auto n = std::min( SoABlockSize, count - offset );
+        LoadSoA( pSrc + offset * inputStride, inputStride, n, input );
+        kernel( input, matrix, output );
+        StoreSoA( output, n, pDst + offset * outputStride, outputStride );
+    }
+}
+
+} // namespace /* anonymous */
+
+
+namespace asvk {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Vector3 structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      指定された行列を用いて，ベクトル配列を一括変換します.
+//-------------------------------------------------------------------------------------------------
+void Vector3::TransformArray( const Vector3* pInput, size_t count, const Matrix& matrix, Vector3* pOutput )
+{ TransformVector3Array( TransformSoA, pInput, sizeof(Vector3), count, matrix, pOutput, sizeof(Vector3) ); }
+
+//-------------------------------------------------------------------------------------------------
+//      指定された行列を用いて，ベクトル配列を一括変換します.
+//-------------------------------------------------------------------------------------------------
+void Vector3::TransformArray
+(
+    const void*     pInput,
+    size_t          inputStride,
+    size_t          count,
+    const Matrix&   matrix,
+    void*           pOutput,
+    size_t          outputStride
+)
+{ TransformVector3Array( TransformSoA, pInput, inputStride, count, matrix, pOutput, outputStride ); }
+
+//-------------------------------------------------------------------------------------------------
+//      指定された行列を用いて，法線ベクトル配列を一括変換します.
+//-------------------------------------------------------------------------------------------------
+void Vector3::TransformNormalArray( const Vector3* pInput, size_t count, const Matrix& matrix, Vector3* pOutput )
+{ TransformVector3Array( TransformNormalSoA, pInput, sizeof(Vector3), count, matrix, pOutput, sizeof(Vector3) ); }
+
+//-------------------------------------------------------------------------------------------------
+//      指定された行列を用いて，法線ベクトル配列を一括変換します.
+//-------------------------------------------------------------------------------------------------
+void Vector3::TransformNormalArray
+(
+    const void*     pInput,
+    size_t          inputStride,
+    size_t          count,
+    const Matrix&   matrix,
+    void*           pOutput,
+    size_t          outputStride
+)
+{ TransformVector3Array( TransformNormalSoA, pInput, inputStride, count, matrix, pOutput, outputStride ); }
+
+//-------------------------------------------------------------------------------------------------
+//      指定された行列を用いてベクトル配列を一括変換し，変換結果をw=1に射影します.
+//-------------------------------------------------------------------------------------------------
+void Vector3::TransformCoordArray( const Vector3* pInput, size_t count, const Matrix& matrix, Vector3* pOutput )
+{ TransformVector3Array( TransformCoordSoA, pInput, sizeof(Vector3), count, matrix, pOutput, sizeof(Vector3) ); }
+
+//-------------------------------------------------------------------------------------------------
+//      指定された行列を用いてベクトル配列を一括変換し，変換結果をw=1に射影します.
+//-------------------------------------------------------------------------------------------------
+void Vector3::TransformCoordArray
+(
+    const void*     pInput,
+    size_t          inputStride,
+    size_t          count,
+    const Matrix&   matrix,
+    void*           pOutput,
+    size_t          outputStride
+)
+{ TransformVector3Array( TransformCoordSoA, pInput, inputStride, count, matrix, pOutput, outputStride ); }
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Vector4 structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      指定された行列を用いて，ベクトル配列を一括変換します.
+//-------------------------------------------------------------------------------------------------
+void Vector4::TransformArray( const Vector4* pInput, size_t count, const Matrix& matrix, Vector4* pOutput )
+{ TransformArray( pInput, sizeof(Vector4), count, matrix, pOutput, sizeof(Vector4) ); }
+
+//-------------------------------------------------------------------------------------------------
+//      指定された行列を用いて，ベクトル配列を一括変換します.
+//-------------------------------------------------------------------------------------------------
+void Vector4::TransformArray
+(
+    const void*     pInput,
+    size_t          inputStride,
+    size_t          count,
+    const Matrix&   matrix,
+    void*           pOutput,
+    size_t          outputStride
+)
+{
+    if ( pInput == nullptr || pOutput == nullptr || count == 0 )
+    { return; }
+
+    auto pSrc = static_cast<const uint8_t*>( pInput );
+    auto pDst = static_cast<uint8_t*>( pOutput );
+
+#if ASVK_IS_SIMD && ASVK_IS_SSE2
+    auto r0 = _mm_loadu_ps( &matrix._11 );
+    auto r1 = _mm_loadu_ps( &matrix._21 );
+    auto r2 = _mm_loadu_ps( &matrix._31 );
+    auto r3 = _mm_loadu_ps( &matrix._41 );
+
+    for( size_t i=0; i<count; ++i )
+    {
+        auto v = _mm_loadu_ps( reinterpret_cast<const float*>( pSrc + i * inputStride ) );
+        _mm_storeu_ps( reinterpret_cast<float*>( pDst + i * outputStride ), detail::TransformRow( v, r0, r1, r2, r3 ) );
+    }
+#else
+    for( size_t i=0; i<count; ++i )
+    {
+        auto& input  = *reinterpret_cast<const Vector4*>( pSrc + i * inputStride );
+        auto& output = *reinterpret_cast<Vector4*>( pDst + i * outputStride );
+        output = Vector4::Transform( input, matrix );
+    }
+#endif
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Matrix structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      行列配列の各要素に行列を乗算します.
+//-------------------------------------------------------------------------------------------------
+void Matrix::MultiplyArray( const Matrix* pInput, size_t count, const Matrix& matrix, Matrix* pOutput )
+{
+    if ( pInput == nullptr || pOutput == nullptr || count == 0 )
+    { return; }
+
+#if ASVK_IS_SIMD && ASVK_IS_SSE2
+    // 右辺の行列は全要素で共通のため一度だけ読み込む.
+    auto b0 = _mm_loadu_ps( &matrix._11 );
+    auto b1 = _mm_loadu_ps( &matrix._21 );
+    auto b2 = _mm_loadu_ps( &matrix._31 );
+    auto b3 = _mm_loadu_ps( &matrix._41 );
+
+    for( size_t i=0; i<count; ++i )
+    {
+        auto a0 = _mm_loadu_ps( &pInput[i]._11 );
+        auto a1 = _mm_loadu_ps( &pInput[i]._21 );
+        auto a2 = _mm_loadu_ps( &pInput[i]._31 );
+        auto a3 = _mm_loadu_ps( &pInput[i]._41 );
+
+        _mm_storeu_ps( &pOutput[i]._11, detail::TransformRow( a0, b0, b1, b2, b3 ) );
+        _mm_storeu_ps( &pOutput[i]._21, detail::TransformRow( a1, b0, b1, b2, b3 ) );
+        _mm_storeu_ps( &pOutput[i]._31, detail::TransformRow( a2, b0, b1, b2, b3 ) );
+        _mm_storeu_ps( &pOutput[i]._41, detail::TransformRow( a3, b0, b1, b2, b3 ) );
+    }
+#else
+    for( size_t i=0; i<count; ++i )
+    { pOutput[i] = Matrix::Multiply( pInput[i], matrix ); }
+#endif
+}
+
+//-------------------------------------------------------------------------------------------------
+//      行列配列の各要素に行列を乗算します.
+//-------------------------------------------------------------------------------------------------
+void Matrix::MultiplyArray( const Matrix& matrix, const Matrix* pInput, size_t count, Matrix* pOutput )
+{
+    if ( pInput == nullptr || pOutput == nullptr || count == 0 )
+    { return; }
+
+#if ASVK_IS_SIMD && ASVK_IS_SSE2
+    // 左辺の行列は全要素で共通のため一度だけ読み込む.
+    auto a0 = _mm_loadu_ps( &matrix._11 );
+    auto a1 = _mm_loadu_ps( &matrix._21 );
+    auto a2 = _mm_loadu_ps( &matrix._31 );
+    auto a3 = _mm_loadu_ps( &matrix._41 );
+
+    for( size_t i=0; i<count; ++i )
+    {
+        auto b0 = _mm_loadu_ps( &pInput[i]._11 );
+        auto b1 = _mm_loadu_ps( &pInput[i]._21 );
+        auto b2 = _mm_loadu_ps( &pInput[i]._31 );
+        auto b3 = _mm_loadu_ps( &pInput[i]._41 );
+
+        _mm_storeu_ps( &pOutput[i]._11, detail::TransformRow( a0, b0, b1, b2, b3 ) );
+        _mm_storeu_ps( &pOutput[i]._21, detail::TransformRow( a1, b0, b1, b2, b3 ) );
+        _mm_storeu_ps( &pOutput[i]._31, detail::TransformRow( a2, b0, b1, b2, b3 ) );
+        _mm_storeu_ps( &pOutput[i]._41, detail::TransformRow( a3, b0, b1, b2, b3 ) );
+    }
+#else
+    for( size_t i=0; i<count; ++i )
+    { pOutput[i] = Matrix::Multiply( matrix, pInput[i] ); }
+#endif
+}
+
+} // namespace asvk
@@ -0,0 +1,257 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asvkPipelineCache.cpp
+// Desc : Pipeline Cache Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asvkPipelineCache.h>
+#include <asvkLogger.h>
+#include <asvkBlob.h>
+#include <asvkMisc.h>
+#include <chrono>
+#include <cstring>
+
+
+namespace /* anonymous */ {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// PipelineCacheHeader structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct PipelineCacheHeader
+{
+    uint32_t    HeaderSize;                 //!< ヘッダーサイズです.
+    uint32_t    HeaderVersion;              //!< ヘッダーバージョンです.
+    uint32_t    VendorId;                   //!< ベンダーIDです.
+    uint32_t    DeviceId;                   //!< デバイスIDです.
+    uint8_t     CacheUUID[VK_UUID_SIZE];    //!< パイプラインキャッシュのUUIDです.
+};
+
+//-------------------------------------------------------------------------------------------------
+//      経過時間をミリ秒で取得します.
+//-------------------------------------------------------------------------------------------------
+inline double ElapsedMs
+(
+    const std::chrono::high_resolution_clock::time_point& begin,
+    const std::chrono::high_resolution_clock::time_point& end
+)
+{ return std::chrono::duration<double, std::milli>(end - begin).count(); }
+
+//-------------------------------------------------------------------------------------------------
+//      キャッシュデータが現在の物理デバイスで使用できるかチェックします.
+//-------------------------------------------------------------------------------------------------
+bool IsValidCacheData
+(
+    const void*                         pData,
+    size_t                              size,
+    const VkPhysicalDeviceProperties&   props
+)
+{
+    if (pData == nullptr || size < sizeof(PipelineCacheHeader))
+    { return false; }
+
+    // ファイルから読み込んだデータはアライメントが保証されないためコピーして参照する.
+    PipelineCacheHeader header;
+    memcpy(&header, pData, sizeof(header));
+
+    if (header.HeaderSize < sizeof(PipelineCacheHeader) || header.HeaderSize > size)
+    { return false; }
+
+    if (header.HeaderVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE)
+    { return false; }
+
+    if (header.VendorId != props.vendorID || header.DeviceId != props.deviceID)
+    { return false; }
+
+    return memcmp(header.CacheUUID, props.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
+} // namespace /* anonymous */
+
+
+namespace asvk {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// PipelineCache class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+PipelineCache::PipelineCache()
+: m_FilePath    ()
+, m_Cache       (null_handle)
+{ memset(&m_Stats, 0, sizeof(m_Stats)); }
+
+//-------------------------------------------------------------------------------------------------
+//      デストラクタです.
+//-------------------------------------------------------------------------------------------------
+PipelineCache::~PipelineCache()
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      初期化処理を行います.
+//-------------------------------------------------------------------------------------------------
+bool PipelineCache::Init(DeviceMgr* pDeviceMgr, const wchar_t* filePath)
+{
+    if (pDeviceMgr == nullptr || filePath == nullptr)
+    {
+        ELOG( "Error : Invalid Argument." );
+        return false;
+    }
+
+    auto begin = std::chrono::high_resolution_clock::now();
+
+    memset(&m_Stats, 0, sizeof(m_Stats));
+    m_FilePath = filePath;
+
+    auto device = pDeviceMgr->GetDevice();
+
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(pDeviceMgr->GetSelectedPhysicalDevice().Gpu, &props);
+
+    // 前回保存したキャッシュデータを読み込み.
+    RefPtr<IBlob> blob;
+    if (IsExistFilePath(filePath))
+    {
+        if (!ReadFileToBlob(filePath, blob.GetAddress()))
+        { ELOG( "Error : ReadFileToBlob() Failed. filename = %lS", filePath ); }
+    }
+
+    const void* pInitialData    = nullptr;
+    size_t      initialDataSize = 0;
+
+    if (blob.GetPtr() != nullptr)
+    {
+        // ドライバやGPUが変わった古いデータは渡さずに破棄する.
+        if (IsValidCacheData(blob->GetBufferPointer(), blob->GetBufferSize(), props))
+        {
+            pInitialData    = blob->GetBufferPointer();
+            initialDataSize = blob->GetBufferSize();
+        }
+        else
+        {
+            ILOG( "Info : Pipeline cache header mismatch, discarded. filename = %lS", filePath );
+            m_Stats.IsDiscarded = true;
+        }
+    }
+
+    VkPipelineCacheCreateInfo info = {};
+    info.sType              = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    info.pNext              = nullptr;
+    info.flags              = 0;
+    info.initialDataSize    = initialDataSize;
+    info.pInitialData       = pInitialData;
+
+    auto result = vkCreatePipelineCache(device, &info, nullptr, &m_Cache);
+    if (result != VK_SUCCESS && pInitialData != nullptr)
+    {
+        // ヘッダーが一致してもデータ本体を受け付けない場合があるため空で作り直す.
+        m_Stats.IsDiscarded = true;
+        pInitialData    = nullptr;
+        initialDataSize = 0;
+
+        info.initialDataSize = 0;
+        info.pInitialData    = nullptr;
+        result = vkCreatePipelineCache(device, &info, nullptr, &m_Cache);
+    }
+
+    if (result != VK_SUCCESS)
+    {
+        ELOG( "Error : vkCreatePipelineCache() Failed." );
+        return false;
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+
+    m_Stats.IsWarm      = (pInitialData != nullptr);
+    m_Stats.LoadedSize  = initialDataSize;
+    m_Stats.LoadMs      = ElapsedMs(begin, end);
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      終了処理を行います.
+//-------------------------------------------------------------------------------------------------
+void PipelineCache::Term(DeviceMgr* pDeviceMgr)
+{
+    if (pDeviceMgr == nullptr)
+    { return; }
+
+    if (m_Cache != null_handle)
+    {
+        Save(pDeviceMgr);
+
+        vkDestroyPipelineCache(pDeviceMgr->GetDevice(), m_Cache, nullptr);
+        m_Cache = null_handle;
+    }
+
+    m_FilePath.clear();
+}
+
+//-------------------------------------------------------------------------------------------------
+//      キャッシュデータをファイルに保存します.
+//-------------------------------------------------------------------------------------------------
+bool PipelineCache::Save(DeviceMgr* pDeviceMgr)
+{
+    if (pDeviceMgr == nullptr || m_Cache == null_handle || m_FilePath.empty())
+    {
+        ELOG( "Error : Invalid Argument." );
+        return false;
+    }
+
+    auto begin  = std::chrono::high_resolution_clock::now();
+    auto device = pDeviceMgr->GetDevice();
+
+    size_t size = 0;
+    auto result = vkGetPipelineCacheData(device, m_Cache, &size, nullptr);
+    if (result != VK_SUCCESS)
+    {
+        ELOG( "Error : vkGetPipelineCacheData() Failed." );
+        return false;
+    }
+
+    RefPtr<IBlob> blob;
+    if (!CreateBlob(size, blob.GetAddress()))
+    {
+        ELOG( "Error : CreateBlob() Failed." );
+        return false;
+    }
+
+    result = vkGetPipelineCacheData(device, m_Cache, &size, blob->GetBufferPointer());
+    if (result != VK_SUCCESS)
+    {
+        ELOG( "Error : vkGetPipelineCacheData() Failed." );
+        return false;
+    }
+
+    if (!WriteBlobToFile(m_FilePath.c_str(), blob.GetPtr()))
+    {
+        ELOG( "Error : WriteBlobToFile() Failed. filename = %lS", m_FilePath.c_str() );
+        return false;
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+
+    m_Stats.SavedSize = size;
+    m_Stats.SaveMs    = ElapsedMs(begin, end);
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      パイプラインキャッシュを取得します.
+//-------------------------------------------------------------------------------------------------
+VkPipelineCache PipelineCache::GetHandle() const
+{ return m_Cache; }
+
+//-------------------------------------------------------------------------------------------------
+//      統計情報を取得します.
+//-------------------------------------------------------------------------------------------------
+const PipelineCacheStats& PipelineCache::GetStats() const
+{ return m_Stats; }
+
+} // namespace asvk
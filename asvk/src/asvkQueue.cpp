@@ -9,10 +9,158 @@
 //-------------------------------------------------------------------------------------------------
 #include <asvkQueue.h>
 #include <asvkLogger.h>
+#include <cstdlib>
 
 
 namespace asvk {
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// SubmitBatch class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+SubmitBatch::SubmitBatch()
+: m_IsOpen(false)
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      デストラクタです.
+//-------------------------------------------------------------------------------------------------
+SubmitBatch::~SubmitBatch()
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      登録内容を全て破棄します.
+//-------------------------------------------------------------------------------------------------
+void SubmitBatch::Reset()
+{
+    // 容量は残しておき, フレームごとの再確保を避ける.
+    m_Entries         .clear();
+    m_WaitSemaphores  .clear();
+    m_WaitStages      .clear();
+    m_WaitValues      .clear();
+    m_CommandBuffers  .clear();
+    m_SignalSemaphores.clear();
+    m_IsOpen = false;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      待機するセマフォを追加します.
+//-------------------------------------------------------------------------------------------------
+void SubmitBatch::AddWait(VkSemaphore semaphore, VkPipelineStageFlags waitStageMask)
+{
+    auto& entry = GetCurrent();
+
+    // 待機はコマンドより前に行われるため, コマンド追加後ならバッチを分ける.
+    if (entry.CommandBufferCount > 0 || entry.SignalCount > 0)
+    {
+        NextBatch();
+        AddWait(semaphore, waitStageMask);
+        return;
+    }
+
+    m_WaitSemaphores.push_back(semaphore);
+    m_WaitStages    .push_back(waitStageMask);
+    m_WaitValues    .push_back(0);
+    entry.WaitCount++;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      他のキューのチケット完了を待機させます.
+//-------------------------------------------------------------------------------------------------
+void SubmitBatch::AddWaitQueue(Queue* pQueue, uint64_t ticket, VkPipelineStageFlags waitStageMask)
+{
+    if (pQueue == nullptr || ticket == 0)
+    { return; }
+
+    // 既に完了していれば待つ必要はない.
+    if (pQueue->IsComplete(ticket))
+    { return; }
+
+    // タイムラインセマフォがあればGPU上で待機する.
+    if (pQueue->IsTimeline())
+    {
+        AddWait(pQueue->GetTimelineSemaphore(), waitStageMask);
+        m_WaitValues.back() = ticket;
+        return;
+    }
+
+    // フェンスでは他のキューのサブミットを待機できないため, CPU側で完了を待つ.
+    pQueue->WaitFor(ticket);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      コマンドバッファを追加します.
+//-------------------------------------------------------------------------------------------------
+void SubmitBatch::AddCommandBuffer(VkCommandBuffer commandBuffer)
+{
+    auto& entry = GetCurrent();
+
+    // シグナルはコマンドより後に行われるため, シグナル追加後ならバッチを分ける.
+    if (entry.SignalCount > 0)
+    {
+        NextBatch();
+        AddCommandBuffer(commandBuffer);
+        return;
+    }
+
+    m_CommandBuffers.push_back(commandBuffer);
+    entry.CommandBufferCount++;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      シグナルするセマフォを追加します.
+//-------------------------------------------------------------------------------------------------
+void SubmitBatch::AddSignal(VkSemaphore semaphore)
+{
+    auto& entry = GetCurrent();
+    m_SignalSemaphores.push_back(semaphore);
+    entry.SignalCount++;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      次のバッチを開始します.
+//-------------------------------------------------------------------------------------------------
+void SubmitBatch::NextBatch()
+{ m_IsOpen = false; }
+
+//-------------------------------------------------------------------------------------------------
+//      バッチ数を取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t SubmitBatch::GetBatchCount() const
+{ return static_cast<uint32_t>(m_Entries.size()); }
+
+//-------------------------------------------------------------------------------------------------
+//      空かどうかチェックします.
+//-------------------------------------------------------------------------------------------------
+bool SubmitBatch::IsEmpty() const
+{ return m_Entries.empty(); }
+
+//-------------------------------------------------------------------------------------------------
+//      追加先のバッチを取得します.
+//-------------------------------------------------------------------------------------------------
+SubmitBatch::Entry& SubmitBatch::GetCurrent()
+{
+    if (!m_IsOpen || m_Entries.empty())
+    {
+        Entry entry;
+        entry.WaitOffset            = static_cast<uint32_t>(m_WaitSemaphores.size());
+        entry.WaitCount             = 0;
+        entry.CommandBufferOffset   = static_cast<uint32_t>(m_CommandBuffers.size());
+        entry.CommandBufferCount    = 0;
+        entry.SignalOffset          = static_cast<uint32_t>(m_SignalSemaphores.size());
+        entry.SignalCount           = 0;
+
+        m_Entries.push_back(entry);
+        m_IsOpen = true;
+    }
+
+    return m_Entries.back();
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // Queue class
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -21,44 +169,106 @@ namespace asvk {
 //      コンストラクタです.
 //-------------------------------------------------------------------------------------------------
 Queue::Queue()
-: m_Device      (null_handle)
-, m_Queue       (null_handle)
-, m_Fence       (null_handle)
-, m_FamiliyIndex(0)
+: m_Device          (null_handle)
+, m_Queue           (null_handle)
+, m_FamiliyIndex    (0)
+, m_Type            (QueueType_Graphics)
+, m_NextTicket      (1)
+, m_SubmittedTicket (0)
+, m_CompletedTicket (0)
+, m_Timeline        (null_handle)
+, m_FenceWaiterCount(0)
+, m_SubmitCallCount (0)
+, m_SubmitInfoCount (0)
+, m_CommandBufferCount  (0)
+, m_IssuedTicket    (0)
+, m_RequestHead     (0)
+, m_RequestTail     (0)
+, m_TicketBase      (1)
+, m_SubmitThread    ()
+, m_IsSubmitThreadRunning   (false)
+, m_IsSubmitQuitRequested   (false)
+, m_IsSubmitThreadSleeping  (false)
+, m_DrainWaiterCount        (0)
+#if ASVK_IS_TIMELINE_SEMAPHORE
+, m_GetSemaphoreCounterValue(nullptr)
+, m_WaitSemaphoresFunc      (nullptr)
+, m_SignalSemaphoreFunc     (nullptr)
+#endif
 { /* DO_NOTHING */ }
 
 //-------------------------------------------------------------------------------------------------
 //      デストラクタです.
 //-------------------------------------------------------------------------------------------------
 Queue::~Queue()
-{ /* DO_NOTHING */ }
+{ StopSubmitThread(); }
 
 //-------------------------------------------------------------------------------------------------
 //      初期化処理を行います.
 //-------------------------------------------------------------------------------------------------
-bool Queue::Init(VkDevice device, uint32_t familyIndex, uint32_t queueIndex, QueueType type)
+bool Queue::Init
+(
+    VkDevice    device,
+    uint32_t    familyIndex,
+    uint32_t    queueIndex,
+    QueueType   type,
+    bool        useTimeline
+)
 {
     if (device == nullptr)
     { return false; }
 
     vkGetDeviceQueue(device, familyIndex, queueIndex, &m_Queue);
 
+#if ASVK_IS_TIMELINE_SEMAPHORE
+    if (useTimeline)
     {
-        VkFenceCreateInfo info = {};
-        info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-        info.pNext = nullptr;
-        info.flags = 0;
-        auto result = vkCreateFence(device, &info, nullptr, &m_Fence);
-        if ( result != VK_SUCCESS )
+        m_GetSemaphoreCounterValue = reinterpret_cast<PFN_vkGetSemaphoreCounterValueKHR>(
+            vkGetDeviceProcAddr(device, "vkGetSemaphoreCounterValueKHR"));
+        m_WaitSemaphoresFunc       = reinterpret_cast<PFN_vkWaitSemaphoresKHR>(
+            vkGetDeviceProcAddr(device, "vkWaitSemaphoresKHR"));
+        m_SignalSemaphoreFunc      = reinterpret_cast<PFN_vkSignalSemaphoreKHR>(
+            vkGetDeviceProcAddr(device, "vkSignalSemaphoreKHR"));
+
+        if (m_GetSemaphoreCounterValue != nullptr && m_WaitSemaphoresFunc != nullptr && m_SignalSemaphoreFunc != nullptr)
         {
-            ELOG( "Error : vkCreateFence() Failed." );
-            return false;
+            VkSemaphoreTypeCreateInfoKHR typeInfo = {};
+            typeInfo.sType          = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR;
+            typeInfo.pNext          = nullptr;
+            typeInfo.semaphoreType  = VK_SEMAPHORE_TYPE_TIMELINE_KHR;
+            typeInfo.initialValue   = 0;
+
+            VkSemaphoreCreateInfo info = {};
+            info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+            info.pNext = &typeInfo;
+            info.flags = 0;
+
+            auto result = vkCreateSemaphore(device, &info, nullptr, &m_Timeline);
+            if ( result != VK_SUCCESS )
+            {
+                ELOG( "Error : vkCreateSemaphore() Failed." );
+                return false;
+            }
+        }
+        else
+        {
+            ILOG( "Info : Timeline Semaphore Functions Not Found. Fence pool is used." );
+            m_GetSemaphoreCounterValue = nullptr;
+            m_WaitSemaphoresFunc       = nullptr;
+            m_SignalSemaphoreFunc      = nullptr;
         }
     }
+#else
+    ASVK_UNUSED(useTimeline);
+#endif
 
-    m_Device       = device;
-    m_FamiliyIndex = familyIndex;
-    m_Type         = type;
+    m_Device          = device;
+    m_FamiliyIndex    = familyIndex;
+    m_Type            = type;
+    m_NextTicket      = 1;
+    m_SubmittedTicket = 0;
+    m_CompletedTicket = 0;
+    m_IssuedTicket    = 0;
 
     return true;
 }
@@ -68,70 +278,495 @@ bool Queue::Init(VkDevice device, uint32_t familyIndex, uint32_t queueIndex, Que
 //-------------------------------------------------------------------------------------------------
 void Queue::Term(VkDevice device)
 {
-    if (m_Fence != null_handle && device != null_handle)
-    { vkDestroyFence(device, m_Fence, nullptr); }
+    // 積まれている要求をドライバに渡し切ってから破棄する.
+    StopSubmitThread();
+
+    // 実行中のコマンドが参照するフェンスやセマフォを破棄するので完了を待つ.
+    if (m_Queue != null_handle)
+    { vkQueueWaitIdle(m_Queue); }
 
-    m_Device    = null_handle;
-    m_Fence     = null_handle;
-    m_Queue     = null_handle;
+    if (device != null_handle)
+    {
+        // 呼び出し側のフェンスは呼び出し側が破棄する.
+        for(size_t i=0; i<m_InFlightFences.size(); ++i)
+        {
+            if (m_InFlightFences[i].IsOwned)
+            { vkDestroyFence(device, m_InFlightFences[i].Fence, nullptr); }
+        }
+
+        for(size_t i=0; i<m_FreeFences.size(); ++i)
+        { vkDestroyFence(device, m_FreeFences[i], nullptr); }
+
+        for(size_t i=0; i<m_RetiredFences.size(); ++i)
+        { vkDestroyFence(device, m_RetiredFences[i], nullptr); }
+
+        if (m_Timeline != null_handle)
+        { vkDestroySemaphore(device, m_Timeline, nullptr); }
+    }
+
+    m_InFlightFences.clear();
+    m_FreeFences    .clear();
+    m_RetiredFences .clear();
+
+    m_Device       = null_handle;
+    m_Queue        = null_handle;
+    m_Timeline     = null_handle;
     m_FamiliyIndex = 0;
+
+#if ASVK_IS_TIMELINE_SEMAPHORE
+    m_GetSemaphoreCounterValue = nullptr;
+    m_WaitSemaphoresFunc       = nullptr;
+    m_SignalSemaphoreFunc      = nullptr;
+#endif
 }
 
 //-------------------------------------------------------------------------------------------------
 //      コマンドを実行します.
 //-------------------------------------------------------------------------------------------------
-void Queue::Execute(uint32_t count, VkCommandBuffer* pBuffers)
+uint64_t Queue::Execute(uint32_t count, VkCommandBuffer* pBuffers)
 {
-    VkPipelineStageFlags waitDstStageMask = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
-    VkSubmitInfo info = {};
-    info.sType                  = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    info.pNext                  = nullptr;
-    info.waitSemaphoreCount     = 0;
-    info.pWaitSemaphores        = nullptr;
-    info.pWaitDstStageMask      = &waitDstStageMask;
-    info.commandBufferCount     = count;
-    info.pCommandBuffers        = pBuffers;
-    info.signalSemaphoreCount   = 0;
-    info.pSignalSemaphores      = nullptr;
+    if (m_IsSubmitThreadRunning)
+    {
+        uint64_t position;
+        auto pRequest = BeginRequest(&position);
+
+        pRequest->Type  = RequestType_Submit;
+        pRequest->Fence = null_handle;
+        pRequest->Batch.Reset();
+        for(auto i=0u; i<count; ++i)
+        { pRequest->Batch.AddCommandBuffer(pBuffers[i]); }
+
+        EndRequest(pRequest, position);
+        return m_TicketBase + position;
+    }
 
-    vkQueueSubmit(m_Queue, 1, &info, m_Fence);
+    std::lock_guard<std::mutex> locker(m_Mutex);
+
+    m_SingleBatch.Reset();
+    for(auto i=0u; i<count; ++i)
+    { m_SingleBatch.AddCommandBuffer(pBuffers[i]); }
+
+    return SubmitWithTicket(m_SingleBatch, null_handle);
 }
 
 //-------------------------------------------------------------------------------------------------
-//      コマンドの完了を待機します.
+//      セマフォとフェンスを指定してコマンドを実行します.
 //-------------------------------------------------------------------------------------------------
-void Queue::Wait(uint64_t timeout)
+uint64_t Queue::Submit
+(
+    VkCommandBuffer         commandBuffer,
+    VkSemaphore             waitSemaphore,
+    VkPipelineStageFlags    waitStageMask,
+    VkSemaphore             signalSemaphore,
+    VkFence                 fence
+)
 {
-    auto result = vkWaitForFences(m_Device, 1, &m_Fence, VK_TRUE, timeout);
+    if (fence != null_handle)
+    {
+        // 以前のチケットの追跡に使っていれば対応を外してからリセットする.
+        std::lock_guard<std::mutex> locker(m_Mutex);
+        ReleaseFence(fence);
+        vkResetFences(m_Device, 1, &fence);
+    }
+
+    if (m_IsSubmitThreadRunning)
+    {
+        uint64_t position;
+        auto pRequest = BeginRequest(&position);
+
+        pRequest->Type  = RequestType_Submit;
+        pRequest->Fence = fence;
+        pRequest->Batch.Reset();
+        if (waitSemaphore != null_handle)
+        { pRequest->Batch.AddWait(waitSemaphore, waitStageMask); }
+        pRequest->Batch.AddCommandBuffer(commandBuffer);
+        if (signalSemaphore != null_handle)
+        { pRequest->Batch.AddSignal(signalSemaphore); }
+
+        EndRequest(pRequest, position);
+        return m_TicketBase + position;
+    }
+
+    std::lock_guard<std::mutex> locker(m_Mutex);
+
+    m_SingleBatch.Reset();
+    if (waitSemaphore != null_handle)
+    { m_SingleBatch.AddWait(waitSemaphore, waitStageMask); }
+    m_SingleBatch.AddCommandBuffer(commandBuffer);
+    if (signalSemaphore != null_handle)
+    { m_SingleBatch.AddSignal(signalSemaphore); }
+
+    auto ticket = SubmitWithTicket(m_SingleBatch, fence);
+    if (ticket == 0)
+    { SignalFence(fence); }
+
+    return ticket;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      バッチをまとめて実行します.
+//-------------------------------------------------------------------------------------------------
+uint64_t Queue::Submit(const SubmitBatch* pBatch, VkFence fence)
+{
+    if (pBatch == nullptr)
+    {
+        ELOG( "Error : Invalid Argument." );
+        return 0;
+    }
+
+    if (fence != null_handle)
+    {
+        // 以前のチケットの追跡に使っていれば対応を外してからリセットする.
+        std::lock_guard<std::mutex> locker(m_Mutex);
+        ReleaseFence(fence);
+        vkResetFences(m_Device, 1, &fence);
+    }
+
+    if (m_IsSubmitThreadRunning)
+    {
+        uint64_t position;
+        auto pRequest = BeginRequest(&position);
+
+        // 呼び出し側はすぐにバッチを再利用するのでコピーする(要求側の容量は使い回される).
+        pRequest->Type  = RequestType_Submit;
+        pRequest->Fence = fence;
+        pRequest->Batch = *pBatch;
+
+        EndRequest(pRequest, position);
+        return m_TicketBase + position;
+    }
+
+    std::lock_guard<std::mutex> locker(m_Mutex);
+
+    auto ticket = SubmitWithTicket(*pBatch, fence);
+    if (ticket == 0)
+    { SignalFence(fence); }
+
+    return ticket;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      スワップチェインのイメージを表示します.
+//-------------------------------------------------------------------------------------------------
+void Queue::Present
+(
+    VkSwapchainKHR          swapChain,
+    uint32_t                imageIndex,
+    VkSemaphore             waitSemaphore,
+    std::atomic<int32_t>*   pResult
+)
+{
+    if (m_IsSubmitThreadRunning)
+    {
+        uint64_t position;
+        auto pRequest = BeginRequest(&position);
+
+        pRequest->Type          = RequestType_Present;
+        pRequest->Fence         = null_handle;
+        pRequest->SwapChain     = swapChain;
+        pRequest->ImageIndex    = imageIndex;
+        pRequest->WaitSemaphore = waitSemaphore;
+        pRequest->pResult       = pResult;
+
+        EndRequest(pRequest, position);
+        return;
+    }
+
+    // VkQueue は外部同期が必要なので, サブミットと同じロックで保護する.
+    std::lock_guard<std::mutex> locker(m_Mutex);
+
+    auto result = PresentCore(swapChain, imageIndex, waitSemaphore);
+    if (pResult != nullptr)
+    { pResult->store(result); }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      サブミットスレッドを開始します.
+//-------------------------------------------------------------------------------------------------
+bool Queue::StartSubmitThread()
+{
+    if (m_IsSubmitThreadRunning)
+    { return true; }
+
+    if (m_Queue == null_handle)
+    {
+        ELOG( "Error : Queue is not initialized." );
+        return false;
+    }
+
+    // 位置 p の要求はチケット m_TicketBase + p に対応させ, 処理順とチケットの順序を一致させる.
+    {
+        std::lock_guard<std::mutex> locker(m_Mutex);
+        m_TicketBase = m_NextTicket;
+    }
+
+    for(auto i=0u; i<RequestQueueSize; ++i)
+    { m_Requests[i].Sequence.store(i, std::memory_order_relaxed); }
+
+    m_RequestHead.store(0, std::memory_order_relaxed);
+    m_RequestTail.store(0, std::memory_order_relaxed);
+
+    m_IsSubmitQuitRequested  = false;
+    m_IsSubmitThreadSleeping = false;
+    m_IsSubmitThreadRunning  = true;
+
+    m_SubmitThread = std::thread(&Queue::SubmitThreadMain, this);
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      サブミットスレッドを停止します.
+//-------------------------------------------------------------------------------------------------
+void Queue::StopSubmitThread()
+{
+    if (!m_SubmitThread.joinable())
+    { return; }
+
+    {
+        std::lock_guard<std::mutex> locker(m_SleepMutex);
+        m_IsSubmitQuitRequested = true;
+        m_SleepCondition.notify_one();
+    }
+
+    m_SubmitThread.join();
+    m_IsSubmitThreadRunning = false;
+
+    // 表示要求の位置はチケットとして使われないので, 次のチケットは位置の続きから発行する.
+    std::lock_guard<std::mutex> locker(m_Mutex);
+    m_NextTicket = m_TicketBase + m_RequestTail.load();
+}
+
+//-------------------------------------------------------------------------------------------------
+//      サブミットスレッドが動作中かどうかチェックします.
+//-------------------------------------------------------------------------------------------------
+bool Queue::IsSubmitThreadRunning() const
+{ return m_IsSubmitThreadRunning; }
+
+//-------------------------------------------------------------------------------------------------
+//      積まれている要求が全てドライバに渡るまで待機します.
+//-------------------------------------------------------------------------------------------------
+void Queue::Flush()
+{
+    if (!m_IsSubmitThreadRunning)
+    { return; }
+
+    auto tail = m_RequestTail.load(std::memory_order_acquire);
+    if (tail > 0)
+    { WaitRequest(tail - 1); }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      統計情報を取得します.
+//-------------------------------------------------------------------------------------------------
+void Queue::GetStats(QueueStats* pStats) const
+{
+    if (pStats == nullptr)
+    { return; }
+
+    pStats->SubmitCallCount    = m_SubmitCallCount.load();
+    pStats->SubmitInfoCount    = m_SubmitInfoCount.load();
+    pStats->CommandBufferCount = m_CommandBufferCount.load();
+}
+
+//-------------------------------------------------------------------------------------------------
+//      統計情報をリセットします.
+//-------------------------------------------------------------------------------------------------
+void Queue::ResetStats()
+{
+    m_SubmitCallCount    = 0;
+    m_SubmitInfoCount    = 0;
+    m_CommandBufferCount = 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      チケットが完了したかどうかチェックします.
+//-------------------------------------------------------------------------------------------------
+bool Queue::IsComplete(uint64_t ticket)
+{
+    if (ticket <= m_CompletedTicket.load())
+    { return true; }
+
+    return ticket <= GetCompletedTicket();
+}
+
+//-------------------------------------------------------------------------------------------------
+//      チケットの完了を待機します.
+//-------------------------------------------------------------------------------------------------
+bool Queue::WaitFor(uint64_t ticket, uint64_t timeout)
+{
+    if (ticket <= m_CompletedTicket.load())
+    { return true; }
+
+    if (ticket > m_IssuedTicket.load())
+    {
+        ELOG( "Error : Invalid Ticket. ticket = %llu", ticket );
+        return false;
+    }
+
+    // サブミットスレッドがまだドライバに渡していなければ, 渡し終わるまで待つ.
+    if (ticket > m_SubmittedTicket.load() && m_IsSubmitThreadRunning)
+    { WaitRequest(ticket - m_TicketBase); }
+
+    VkResult result = VK_SUCCESS;
+
+#if ASVK_IS_TIMELINE_SEMAPHORE
+    if (m_Timeline != null_handle)
+    {
+        VkSemaphoreWaitInfoKHR info = {};
+        info.sType          = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR;
+        info.pNext          = nullptr;
+        info.flags          = 0;
+        info.semaphoreCount = 1;
+        info.pSemaphores    = &m_Timeline;
+        info.pValues        = &ticket;
+
+        result = m_WaitSemaphoresFunc(m_Device, &info, timeout);
+        if (result == VK_SUCCESS)
+        { UpdateCompletedTicket(ticket); }
+    }
+    else
+#endif
+    {
+        // 待機中もサブミットできるよう, フェンスだけを取り出してロックの外で待つ.
+        // 取り出したフェンスは待機が終わるまでフェンスプールで再利用されない.
+        VkFence  waitFence  = null_handle;
+        uint64_t waitTicket = 0;
+
+        // 同じキューのフェンスは順にシグナルされるので, 後続のチケットのフェンスでも完了を確認できる.
+        auto findFence = [&]()
+        {
+            std::lock_guard<std::mutex> locker(m_Mutex);
+            RetireFences();
+
+            if (ticket <= m_CompletedTicket.load())
+            { return true; }
+
+            for(size_t i=0; i<m_InFlightFences.size(); ++i)
+            {
+                if (m_InFlightFences[i].Ticket < ticket)
+                { continue; }
+
+                waitFence  = m_InFlightFences[i].Fence;
+                waitTicket = m_InFlightFences[i].Ticket;
+                m_FenceWaiterCount++;
+                break;
+            }
+
+            return false;
+        };
+
+        if (findFence())
+        { return true; }
+
+        if (waitFence == null_handle)
+        {
+            // 追跡していたフェンスが呼び出し側で再利用されたか, サブミットに失敗したチケットなので,
+            // 空のサブミットで新しいチケットを発行し, そのフェンスで完了を確認する.
+            auto flushTicket = Execute(0, nullptr);
+            if (flushTicket == 0)
+            {
+                ELOG( "Error : Queue::Execute() Failed." );
+                return false;
+            }
+
+            if (m_IsSubmitThreadRunning)
+            { WaitRequest(flushTicket - m_TicketBase); }
+
+            if (findFence())
+            { return true; }
+
+            if (waitFence == null_handle)
+            {
+                ELOG( "Error : Queue::WaitFor() Failed. ticket = %llu", ticket );
+                return false;
+            }
+        }
+
+        result = vkWaitForFences(m_Device, 1, &waitFence, VK_TRUE, timeout);
+        m_FenceWaiterCount--;
+
+        if (result == VK_SUCCESS)
+        { UpdateCompletedTicket(waitTicket); }
+
+        std::lock_guard<std::mutex> locker(m_Mutex);
+        RetireFences();
+    }
+
     if (result == VK_TIMEOUT)
-    { ILOG( "Info : vkWaitForFences() Timeout. time out nanoseconds = %ld", timeout ); }
-    else if (result == VK_ERROR_OUT_OF_HOST_MEMORY)
-    { ELOG( "Error : vkWaitForFences() Failed. ErrorCode = VK_ERROR_OUT_OF_HOST_MEMORY" ); }
-    else if (result == VK_ERROR_OUT_OF_DEVICE_MEMORY)
-    { ELOG( "Error : vkWaitForFences() Failed. ErrorCode = VK_ERROR_OUT_OF_DEVICE_MEMORY" ); }
+    {
+        ILOG( "Info : Queue::WaitFor() Timeout. time out nanoseconds = %llu", timeout );
+        return false;
+    }
     else if (result == VK_ERROR_DEVICE_LOST)
     {
         // エラーログ表示.
-        ELOG( "Fatal Error : vkWaitForFences() Failed. ErrorCode = VK_ERROR_DEVICE_LOST " );
+        ELOG( "Fatal Error : Queue::WaitFor() Failed. ErrorCode = VK_ERROR_DEVICE_LOST " );
 
         // 続行不能なので殺す.
         abort();
     }
+    else if (result != VK_SUCCESS)
+    {
+        ELOG( "Error : Queue::WaitFor() Failed. ErrorCode = %d", result );
+        return false;
+    }
 
-    // フェンスをリセット.
-    vkResetFences(m_Device, 1, &m_Fence);
+    // 完了が確認できたチケットまでしか成功を返さない.
+    return ticket <= m_CompletedTicket.load();
 }
+
 //-------------------------------------------------------------------------------------------------
-//      キューを取得します.
+//      最後にサブミットしたコマンドの完了を待機します.
 //-------------------------------------------------------------------------------------------------
-VkQueue Queue::GetQueue() const
-{ return m_Queue; }
+void Queue::Wait(uint64_t timeout)
+{ WaitFor(m_IssuedTicket.load(), timeout); }
 
 //-------------------------------------------------------------------------------------------------
-//      フェンスを取得します.
+//      最後にサブミットしたチケットを取得します.
 //-------------------------------------------------------------------------------------------------
-VkFence Queue::GetFence() const
-{ return m_Fence; }
+uint64_t Queue::GetSubmittedTicket() const
+{ return m_IssuedTicket.load(); }
+
+//-------------------------------------------------------------------------------------------------
+//      完了済みのチケットを取得します.
+//-------------------------------------------------------------------------------------------------
+uint64_t Queue::GetCompletedTicket()
+{
+#if ASVK_IS_TIMELINE_SEMAPHORE
+    if (m_Timeline != null_handle)
+    {
+        uint64_t value = 0;
+        auto result = m_GetSemaphoreCounterValue(m_Device, m_Timeline, &value);
+        if (result == VK_SUCCESS)
+        { UpdateCompletedTicket(value); }
+
+        return m_CompletedTicket.load();
+    }
+#endif
+
+    std::lock_guard<std::mutex> locker(m_Mutex);
+    RetireFences();
+    return m_CompletedTicket.load();
+}
+
+//-------------------------------------------------------------------------------------------------
+//      タイムラインセマフォを使用しているかどうかチェックします.
+//-------------------------------------------------------------------------------------------------
+bool Queue::IsTimeline() const
+{ return m_Timeline != null_handle; }
+
+//-------------------------------------------------------------------------------------------------
+//      タイムラインセマフォを取得します.
+//-------------------------------------------------------------------------------------------------
+VkSemaphore Queue::GetTimelineSemaphore() const
+{ return m_Timeline; }
+
+//-------------------------------------------------------------------------------------------------
+//      キューを取得します.
+//-------------------------------------------------------------------------------------------------
+VkQueue Queue::GetQueue() const
+{ return m_Queue; }
 
 //-------------------------------------------------------------------------------------------------
 //      ファミリーインデックスを取得します.
@@ -145,4 +780,459 @@ uint32_t Queue::GetFamilyIndex() const
 QueueType Queue::GetType() const
 { return m_Type; }
 
+//-------------------------------------------------------------------------------------------------
+//      チケットを付与してサブミットします.
+//-------------------------------------------------------------------------------------------------
+uint64_t Queue::SubmitWithTicket(const SubmitBatch& batch, VkFence fence)
+{
+    auto ticket     = m_NextTicket;
+    auto entryCount = static_cast<uint32_t>(batch.m_Entries.size());
+
+    // 空のバッチでもチケットを発行できるよう, 最低1つの VkSubmitInfo を用意する.
+    auto infoCount = (entryCount > 0) ? entryCount : 1;
+    m_SubmitInfos.resize(infoCount);
+
+    uint32_t commandBufferCount = 0;
+    for(auto i=0u; i<infoCount; ++i)
+    {
+        auto& info = m_SubmitInfos[i];
+        info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        info.pNext = nullptr;
+
+        if (i < entryCount)
+        {
+            auto& entry = batch.m_Entries[i];
+            info.waitSemaphoreCount     = entry.WaitCount;
+            info.pWaitSemaphores        = batch.m_WaitSemaphores.data() + entry.WaitOffset;
+            info.pWaitDstStageMask      = batch.m_WaitStages.data() + entry.WaitOffset;
+            info.commandBufferCount     = entry.CommandBufferCount;
+            info.pCommandBuffers        = batch.m_CommandBuffers.data() + entry.CommandBufferOffset;
+            info.signalSemaphoreCount   = entry.SignalCount;
+            info.pSignalSemaphores      = batch.m_SignalSemaphores.data() + entry.SignalOffset;
+
+            commandBufferCount += entry.CommandBufferCount;
+        }
+        else
+        {
+            info.waitSemaphoreCount     = 0;
+            info.pWaitSemaphores        = nullptr;
+            info.pWaitDstStageMask      = nullptr;
+            info.commandBufferCount     = 0;
+            info.pCommandBuffers        = nullptr;
+            info.signalSemaphoreCount   = 0;
+            info.pSignalSemaphores      = nullptr;
+        }
+    }
+
+#if ASVK_IS_TIMELINE_SEMAPHORE
+    m_TimelineInfos.resize(infoCount);
+    for(auto i=0u; i<infoCount; ++i)
+    {
+        auto& timelineInfo = m_TimelineInfos[i];
+        timelineInfo.sType                      = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR;
+        timelineInfo.pNext                      = nullptr;
+        timelineInfo.waitSemaphoreValueCount    = 0;
+        timelineInfo.pWaitSemaphoreValues       = nullptr;
+        timelineInfo.signalSemaphoreValueCount  = 0;
+        timelineInfo.pSignalSemaphoreValues     = nullptr;
+
+        if (i >= entryCount)
+        { continue; }
+
+        // 他のキューのチケット待機を含むバッチにだけ待機する値を設定する(バイナリセマフォの値は無視される).
+        auto& entry = batch.m_Entries[i];
+        auto isTimelineWait = false;
+        for(auto j=0u; j<entry.WaitCount; ++j)
+        { isTimelineWait |= (batch.m_WaitValues[entry.WaitOffset + j] != 0); }
+
+        if (isTimelineWait)
+        {
+            timelineInfo.waitSemaphoreValueCount = entry.WaitCount;
+            timelineInfo.pWaitSemaphoreValues    = batch.m_WaitValues.data() + entry.WaitOffset;
+            m_SubmitInfos[i].pNext = &timelineInfo;
+        }
+    }
+
+    // チケットのシグナルは末尾のバッチに追加する.
+    if (m_Timeline != null_handle)
+    {
+        auto& lastInfo = m_SubmitInfos.back();
+
+        m_SignalSemaphores.assign(lastInfo.pSignalSemaphores, lastInfo.pSignalSemaphores + lastInfo.signalSemaphoreCount);
+        m_SignalValues    .assign(lastInfo.signalSemaphoreCount, 0);
+
+        m_SignalSemaphores.push_back(m_Timeline);
+        m_SignalValues    .push_back(ticket);
+
+        lastInfo.signalSemaphoreCount = static_cast<uint32_t>(m_SignalSemaphores.size());
+        lastInfo.pSignalSemaphores    = m_SignalSemaphores.data();
+
+        auto& timelineInfo = m_TimelineInfos.back();
+        timelineInfo.signalSemaphoreValueCount  = lastInfo.signalSemaphoreCount;
+        timelineInfo.pSignalSemaphoreValues     = m_SignalValues.data();
+        lastInfo.pNext = &timelineInfo;
+    }
+#endif
+
+    // タイムラインセマフォが無い場合はフェンスでチケットの完了を追跡する.
+    // 呼び出し側のフェンスがあればそれをチケット用に兼用し, サブミットを増やさない.
+    VkFence ticketFence = null_handle;
+    auto    isOwned     = false;
+    if (m_Timeline == null_handle && fence != null_handle)
+    { ticketFence = fence; }
+    else if (m_Timeline == null_handle)
+    {
+        isOwned = true;
+
+        if (!m_FreeFences.empty())
+        {
+            ticketFence = m_FreeFences.back();
+            m_FreeFences.pop_back();
+            vkResetFences(m_Device, 1, &ticketFence);
+        }
+        else
+        {
+            VkFenceCreateInfo fenceInfo = {};
+            fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+            fenceInfo.pNext = nullptr;
+            fenceInfo.flags = 0;
+
+            auto result = vkCreateFence(m_Device, &fenceInfo, nullptr, &ticketFence);
+            if ( result != VK_SUCCESS )
+            {
+                ELOG( "Error : vkCreateFence() Failed." );
+                return 0;
+            }
+        }
+    }
+
+    // 呼び出し側のフェンスが無ければチケット用フェンスを直接渡す.
+    auto submitFence = (fence != null_handle) ? fence : ticketFence;
+
+    auto result = vkQueueSubmit(m_Queue, infoCount, m_SubmitInfos.data(), submitFence);
+    if ( result != VK_SUCCESS )
+    {
+        ELOG( "Error : vkQueueSubmit() Failed." );
+        if (isOwned)
+        { m_FreeFences.push_back(ticketFence); }
+        return 0;
+    }
+
+    m_SubmitCallCount++;
+    m_SubmitInfoCount    += infoCount;
+    m_CommandBufferCount += commandBufferCount;
+
+    if (ticketFence != null_handle)
+    {
+        FenceEntry entry;
+        entry.Ticket  = ticket;
+        entry.Fence   = ticketFence;
+        entry.IsOwned = isOwned;
+        m_InFlightFences.push_back(entry);
+    }
+
+    m_NextTicket++;
+    UpdateIssuedTicket(ticket);
+    m_SubmittedTicket.store(ticket);
+
+    return ticket;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      サブミットに失敗したフェンスをシグナルさせます.
+//-------------------------------------------------------------------------------------------------
+void Queue::SignalFence(VkFence fence)
+{
+    if (fence == null_handle)
+    { return; }
+
+    // フェンスはリセット済みなので, 空のサブミットでシグナルさせて待機側が止まらないようにする.
+    auto result = vkQueueSubmit(m_Queue, 0, nullptr, fence);
+    if ( result != VK_SUCCESS )
+    { ELOG( "Error : vkQueueSubmit() Failed." ); }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      サブミットできなかったチケットを完了扱いにして進めます.
+//-------------------------------------------------------------------------------------------------
+void Queue::SkipTicket(uint64_t ticket)
+{
+#if ASVK_IS_TIMELINE_SEMAPHORE
+    if (m_Timeline != null_handle)
+    {
+        // ホストからのシグナルは実行待ちのシグナルより小さい値でなければならないので,
+        // 先行するチケットの完了を待ってからタイムラインを進める.
+        auto prevTicket = m_SubmittedTicket.load();
+        if (prevTicket > 0)
+        {
+            VkSemaphoreWaitInfoKHR waitInfo = {};
+            waitInfo.sType          = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR;
+            waitInfo.pNext          = nullptr;
+            waitInfo.flags          = 0;
+            waitInfo.semaphoreCount = 1;
+            waitInfo.pSemaphores    = &m_Timeline;
+            waitInfo.pValues        = &prevTicket;
+
+            auto result = m_WaitSemaphoresFunc(m_Device, &waitInfo, UINT64_MAX);
+            if ( result != VK_SUCCESS )
+            { ELOG( "Error : vkWaitSemaphoresKHR() Failed. ErrorCode = %d", result ); }
+        }
+
+        VkSemaphoreSignalInfoKHR signalInfo = {};
+        signalInfo.sType        = VK_STRUCTURE_TYPE_SEMAPHORE_SIGNAL_INFO_KHR;
+        signalInfo.pNext        = nullptr;
+        signalInfo.semaphore    = m_Timeline;
+        signalInfo.value        = ticket;
+
+        auto result = m_SignalSemaphoreFunc(m_Device, &signalInfo);
+        if ( result != VK_SUCCESS )
+        { ELOG( "Error : vkSignalSemaphoreKHR() Failed. ErrorCode = %d", result ); }
+        else
+        { UpdateCompletedTicket(ticket); }
+    }
+#endif
+
+    m_NextTicket = ticket + 1;
+    m_SubmittedTicket.store(ticket);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      完了したフェンスを回収します.
+//-------------------------------------------------------------------------------------------------
+void Queue::RetireFences()
+{
+    // ロックの外で待機しているスレッドがいなくなれば, 保留していたフェンスを再利用可能にする.
+    auto isWaiting = (m_FenceWaiterCount.load() > 0);
+    if (!isWaiting && !m_RetiredFences.empty())
+    {
+        m_FreeFences.insert(m_FreeFences.end(), m_RetiredFences.begin(), m_RetiredFences.end());
+        m_RetiredFences.clear();
+    }
+
+    while(!m_InFlightFences.empty())
+    {
+        auto& entry = m_InFlightFences.front();
+        if (vkGetFenceStatus(m_Device, entry.Fence) != VK_SUCCESS)
+        { break; }
+
+        UpdateCompletedTicket(entry.Ticket);
+        if (entry.IsOwned)
+        {
+            if (isWaiting)
+            { m_RetiredFences.push_back(entry.Fence); }
+            else
+            { m_FreeFences.push_back(entry.Fence); }
+        }
+        m_InFlightFences.pop_front();
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      呼び出し側のフェンスとチケットの対応を外します.
+//-------------------------------------------------------------------------------------------------
+void Queue::ReleaseFence(VkFence fence)
+{
+    if (m_Timeline != null_handle)
+    { return; }
+
+    // シグナル済みなら完了したチケットとして回収する. 残っていればリセット後は追跡できないので外す.
+    RetireFences();
+
+    for(auto itr = m_InFlightFences.begin(); itr != m_InFlightFences.end();)
+    {
+        if (!itr->IsOwned && itr->Fence == fence)
+        { itr = m_InFlightFences.erase(itr); }
+        else
+        { ++itr; }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      完了済みチケットを更新します.
+//-------------------------------------------------------------------------------------------------
+void Queue::UpdateCompletedTicket(uint64_t ticket)
+{
+    auto completed = m_CompletedTicket.load();
+    while(completed < ticket && !m_CompletedTicket.compare_exchange_weak(completed, ticket))
+    { /* DO_NOTHING */ }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      発行済みチケットを更新します.
+//-------------------------------------------------------------------------------------------------
+void Queue::UpdateIssuedTicket(uint64_t ticket)
+{
+    auto issued = m_IssuedTicket.load();
+    while(issued < ticket && !m_IssuedTicket.compare_exchange_weak(issued, ticket))
+    { /* DO_NOTHING */ }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      表示します.
+//-------------------------------------------------------------------------------------------------
+VkResult Queue::PresentCore(VkSwapchainKHR swapChain, uint32_t imageIndex, VkSemaphore waitSemaphore)
+{
+    VkPresentInfoKHR present = {};
+    present.sType               = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+    present.pNext               = nullptr;
+    present.swapchainCount      = 1;
+    present.waitSemaphoreCount  = (waitSemaphore != null_handle) ? 1 : 0;
+    present.pWaitSemaphores     = &waitSemaphore;
+    present.pSwapchains         = &swapChain;
+    present.pImageIndices       = &imageIndex;
+
+    return vkQueuePresentKHR(m_Queue, &present);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      要求キューの空きを確保します.
+//-------------------------------------------------------------------------------------------------
+Queue::Request* Queue::BeginRequest(uint64_t* pPosition)
+{
+    auto position = m_RequestTail.load(std::memory_order_relaxed);
+    for(;;)
+    {
+        auto& request  = m_Requests[position & (RequestQueueSize - 1)];
+        auto sequence  = request.Sequence.load(std::memory_order_acquire);
+        auto diff      = static_cast<int64_t>(sequence - position);
+
+        if (diff == 0)
+        {
+            // 空いていれば位置を確保する. 他の要求側に先を越されたら取り直す.
+            if (m_RequestTail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                *pPosition = position;
+                return &request;
+            }
+        }
+        else if (diff < 0)
+        {
+            // 一杯なのでサブミットスレッドが1周前の要求を処理して空けるのを待つ.
+            WaitRequest(position - RequestQueueSize);
+            position = m_RequestTail.load(std::memory_order_relaxed);
+        }
+        else
+        { position = m_RequestTail.load(std::memory_order_relaxed); }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      書き込んだ要求をサブミットスレッドに渡します.
+//-------------------------------------------------------------------------------------------------
+void Queue::EndRequest(Request* pRequest, uint64_t position)
+{
+    if (pRequest->Type == RequestType_Submit)
+    { UpdateIssuedTicket(m_TicketBase + position); }
+
+    pRequest->Sequence.store(position + 1, std::memory_order_release);
+
+    // サブミットスレッドの眠る直前の確認と順序付けして, 起こし忘れを防ぐ.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_IsSubmitThreadSleeping.load(std::memory_order_relaxed))
+    {
+        std::lock_guard<std::mutex> locker(m_SleepMutex);
+        m_SleepCondition.notify_one();
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      サブミットスレッドのメイン処理です.
+//-------------------------------------------------------------------------------------------------
+void Queue::SubmitThreadMain()
+{
+    for(;;)
+    {
+        auto  position = m_RequestHead.load(std::memory_order_relaxed);
+        auto& request  = m_Requests[position & (RequestQueueSize - 1)];
+
+        auto isReady = [&]()
+        { return request.Sequence.load(std::memory_order_acquire) == position + 1; };
+
+        if (!isReady())
+        {
+            // 終了要求は積まれた要求を処理し切ってから受け付ける.
+            if (m_IsSubmitQuitRequested)
+            { break; }
+
+            m_IsSubmitThreadSleeping.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            {
+                std::unique_lock<std::mutex> locker(m_SleepMutex);
+                m_SleepCondition.wait(locker, [&]()
+                { return isReady() || m_IsSubmitQuitRequested.load(); });
+            }
+
+            m_IsSubmitThreadSleeping.store(false, std::memory_order_relaxed);
+            continue;
+        }
+
+        ProcessRequest(request, m_TicketBase + position);
+
+        // スロットを次の周回の位置として要求側に返す.
+        request.Sequence.store(position + RequestQueueSize, std::memory_order_release);
+        m_RequestHead.store(position + 1, std::memory_order_release);
+
+        // 処理待ちのスレッドの眠る直前の確認と順序付けして, 起こし忘れを防ぐ.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_DrainWaiterCount.load(std::memory_order_relaxed) > 0)
+        {
+            std::lock_guard<std::mutex> locker(m_DrainMutex);
+            m_DrainCondition.notify_all();
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      サブミットスレッドが要求を処理し終えるまで待機します.
+//-------------------------------------------------------------------------------------------------
+void Queue::WaitRequest(uint64_t position)
+{
+    auto isProcessed = [&]()
+    { return m_RequestHead.load(std::memory_order_acquire) > position; };
+
+    if (isProcessed())
+    { return; }
+
+    m_DrainWaiterCount.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    {
+        std::unique_lock<std::mutex> locker(m_DrainMutex);
+        m_DrainCondition.wait(locker, isProcessed);
+    }
+
+    m_DrainWaiterCount.fetch_sub(1);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      要求を処理します.
+//-------------------------------------------------------------------------------------------------
+void Queue::ProcessRequest(Request& request, uint64_t ticket)
+{
+    if (request.Type == RequestType_Present)
+    {
+        auto result = PresentCore(request.SwapChain, request.ImageIndex, request.WaitSemaphore);
+        if (request.pResult != nullptr)
+        { request.pResult->store(result); }
+        return;
+    }
+
+    std::lock_guard<std::mutex> locker(m_Mutex);
+
+    // 表示要求の位置は飛ばすので, チケットは増加のみで連続するとは限らない.
+    m_NextTicket = ticket;
+    if (SubmitWithTicket(request.Batch, request.Fence) != 0)
+    { return; }
+
+    // 待機している側が止まらないよう, コマンドは破棄してチケットとフェンスだけを進める.
+    m_SingleBatch.Reset();
+    if (SubmitWithTicket(m_SingleBatch, request.Fence) == 0)
+    {
+        ELOG( "Error : Queue::SubmitWithTicket() Failed. ticket = %llu", ticket );
+        SignalFence(request.Fence);
+        SkipTicket(ticket);
+    }
+}
+
 } // namespace asvk
@@ -9,64 +9,9 @@
 //-------------------------------------------------------------------------------------------------
 #include <asvkRenderBuffer.h>
 #include <asvkLogger.h>
-#include <cassert>
+#include <asvkResourceState.h>
 
 
-namespace /* anonymous */ {
-
-//-------------------------------------------------------------------------------------------------
-//      イメージレイアウトを設定します.
-//-------------------------------------------------------------------------------------------------
-void SetImageLayout
-(
-    VkDevice                device,
-    VkCommandBuffer         commandBuffer,
-    VkImage                 image,
-    VkImageLayout           oldLayout,
-    VkImageLayout           newLayout,
-    VkImageSubresourceRange range
-)
-{
-    assert(device        != null_handle);
-    assert(commandBuffer != null_handle);
-
-    VkImageMemoryBarrier barrier = {};
-    barrier.sType            = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    barrier.pNext            = nullptr;
-    barrier.srcAccessMask    = 0;
-    barrier.dstAccessMask    = 0;
-    barrier.oldLayout        = oldLayout;
-    barrier.newLayout        = newLayout;
-    barrier.image            = image;
-    barrier.subresourceRange = range;
-
-    if (newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
-    { barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT; }
-
-    if (newLayout == VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL)
-    { barrier.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT; }
-
-    if (newLayout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL)
-    { barrier.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT; }
-
-    if (newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
-    { barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_INPUT_ATTACHMENT_READ_BIT; }
-
-    vkCmdPipelineBarrier(
-        commandBuffer,
-        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-        0,
-        0,
-        nullptr,
-        0,
-        nullptr,
-        1,
-        &barrier);
-}
-
-} // namespace /* anonymous */
-
 namespace asvk {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -104,10 +49,9 @@ bool RenderBuffer::Init
     }
 
     auto device     = pDeviceMgr->GetDevice();
-    auto gpu        = pDeviceMgr->GetPhysicalDevice()[0].Gpu;
-    auto memoryProp = pDeviceMgr->GetPhysicalDevice()[0].MemoryProps;
+    auto gpu        = pDeviceMgr->GetSelectedPhysicalDevice().Gpu;
 
-    VkImageLayout       imageLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    ResourceUsage       usage       = ResourceUsage_Undefined;
     VkImageAspectFlags  aspect      = VK_IMAGE_ASPECT_COLOR_BIT;
     VkImageTiling       tiling      = VK_IMAGE_TILING_OPTIMAL;
     VkFormatProperties  props;
@@ -116,7 +60,7 @@ bool RenderBuffer::Init
     if(pDesc->Usage & VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT)
     {
         aspect      = VK_IMAGE_ASPECT_COLOR_BIT;
-        imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        usage       = ResourceUsage_ColorAttachment;
 
         if(props.linearTilingFeatures & VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT)
         { tiling = VK_IMAGE_TILING_LINEAR; }
@@ -125,8 +69,14 @@ bool RenderBuffer::Init
     }
     else if (pDesc->Usage & VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT)
     {
-        aspect      = VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
-        imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+        aspect      = VK_IMAGE_ASPECT_DEPTH_BIT;
+        usage       = ResourceUsage_DepthStencilAttachment;
+
+        // ステンシルを持つフォーマットのみステンシルアスペクトを含める.
+        if (pDesc->Format == VK_FORMAT_D16_UNORM_S8_UINT
+         || pDesc->Format == VK_FORMAT_D24_UNORM_S8_UINT
+         || pDesc->Format == VK_FORMAT_D32_SFLOAT_S8_UINT)
+        { aspect |= VK_IMAGE_ASPECT_STENCIL_BIT; }
 
         if (props.linearTilingFeatures & VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT)
         { tiling = VK_IMAGE_TILING_LINEAR; }
@@ -151,7 +101,7 @@ bool RenderBuffer::Init
     info.sharingMode            = VK_SHARING_MODE_EXCLUSIVE;
     info.initialLayout          = VK_IMAGE_LAYOUT_UNDEFINED;
 
-    if (!m_Resource.Init(device, memoryProp, &info))
+    if (!m_Resource.Init(pDeviceMgr->GetMemoryAllocator(), &info))
     {
         ELOG( "Error : Resource::Init() Failed." );
         return false;
@@ -201,13 +151,10 @@ bool RenderBuffer::Init
         return false;
     }
 
-    SetImageLayout(
-        device,
-        commandBuffer,
-        m_Resource.GetImage(),
-        VK_IMAGE_LAYOUT_UNDEFINED,
-        imageLayout,
-        m_Range);
+    // 用途に合わせたアクセスフラグ・ステージで初期レイアウトに遷移.
+    ResourceStateTracker tracker;
+    tracker.TransitionImage(m_Resource, m_Range, usage);
+    tracker.Flush(commandBuffer);
 
     memcpy(&m_Desc, pDesc, sizeof(m_Desc));
 
@@ -229,7 +176,7 @@ void RenderBuffer::Term(DeviceMgr* pDeviceMgr)
     if (m_View != null_handle)
     { vkDestroyImageView(device, m_View, nullptr); }
 
-    m_Resource.Term(device);
+    m_Resource.Term();
 
     memset(&m_Desc,  0, sizeof(m_Desc));
     memset(&m_Range, 0, sizeof(m_Range));
@@ -21,8 +21,9 @@ namespace asvk {
 //      コンストラクタです.
 //-------------------------------------------------------------------------------------------------
 ImageResource::ImageResource()
-: m_Resource(null_handle)
-, m_Memory  (null_handle)
+: m_Resource  (null_handle)
+, m_pAllocator(nullptr)
+, m_Allocation()
 { /* DO_NOTHING */ }
 
 //-------------------------------------------------------------------------------------------------
@@ -36,17 +37,19 @@ ImageResource::~ImageResource()
 //-------------------------------------------------------------------------------------------------
 bool ImageResource::Init
 (
-    VkDevice                         device,
-    VkPhysicalDeviceMemoryProperties props,
-    const VkImageCreateInfo*         pInfo 
+    MemoryAllocator*            pAllocator,
+    const VkImageCreateInfo*    pInfo,
+    VkMemoryPropertyFlags       propFlags
 )
 {
-    if (device == null_handle || pInfo == nullptr)
+    if (pAllocator == nullptr || pInfo == nullptr)
     {
         ELOG( "Error : Invalid Argument." );
         return false;
     }
 
+    auto device = pAllocator->GetDevice();
+
     auto result = vkCreateImage(device, pInfo, nullptr, &m_Resource);
     if ( result != VK_SUCCESS )
     {
@@ -57,40 +60,21 @@ bool ImageResource::Init
     VkMemoryRequirements requirements;
     vkGetImageMemoryRequirements(device, m_Resource, &requirements);
 
-    VkFlags requirementsMask = 0;
-    auto typeBits  = requirements.memoryTypeBits;
-    auto typeIndex = 0u;
-    for (auto i=0u; i<32; ++i)
-    {
-        auto& propFlags = props.memoryTypes[i].propertyFlags;
-        if ((typeBits & 0x1) == 0x1)
-        {
-            if ((propFlags & requirementsMask) == requirementsMask)
-            {
-                typeIndex = i;
-                break;
-            }
-        }
-        typeBits >>= 1;
-    }
-
-    VkMemoryAllocateInfo allocInfo = {};
-    allocInfo.sType             = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.pNext             = nullptr;
-    allocInfo.memoryTypeIndex   = typeIndex;
-    allocInfo.allocationSize    = requirements.size;
-
-    result = vkAllocateMemory(device, &allocInfo, nullptr, &m_Memory);
-    if ( result != VK_SUCCESS )
+    if (!pAllocator->Allocate(requirements, propFlags, pInfo->tiling == VK_IMAGE_TILING_LINEAR, &m_Allocation))
     {
-        ELOG( "Error : vkAllocateMemory() Failed." );
+        ELOG( "Error : MemoryAllocator::Allocate() Failed." );
+        vkDestroyImage(device, m_Resource, nullptr);
+        m_Resource = null_handle;
         return false;
     }
 
-    result = vkBindImageMemory(device, m_Resource, m_Memory, 0);
+    m_pAllocator = pAllocator;
+
+    result = vkBindImageMemory(device, m_Resource, m_Allocation.Memory, m_Allocation.Offset);
     if ( result != VK_SUCCESS )
     {
-        ELOG( "Error : vkBindBufferMemory() Failed." );
+        ELOG( "Error : vkBindImageMemory() Failed." );
+        Term();
         return false;
     }
 
@@ -100,51 +84,62 @@ bool ImageResource::Init
 //-------------------------------------------------------------------------------------------------
 //      終了処理です.
 //-------------------------------------------------------------------------------------------------
-void ImageResource::Term(VkDevice device)
+void ImageResource::Term()
 {
-    if (m_Memory != null_handle)
-    { vkFreeMemory(device, m_Memory, nullptr); }
+    if (m_pAllocator == nullptr)
+    { return; }
 
     if (m_Resource != null_handle)
-    { vkDestroyImage(device, m_Resource, nullptr); }
+    { vkDestroyImage(m_pAllocator->GetDevice(), m_Resource, nullptr); }
 
-    m_Memory    = null_handle;
-    m_Resource  = null_handle;
+    m_pAllocator->Free(&m_Allocation);
+
+    m_Resource   = null_handle;
+    m_pAllocator = nullptr;
 }
 
 //-------------------------------------------------------------------------------------------------
 //      マップします.
 //-------------------------------------------------------------------------------------------------
-bool ImageResource::Map
-(
-    VkDevice            device,
-    VkDeviceSize        offset,
-    VkDeviceSize        size,
-    VkMemoryMapFlags    flags,
-    void**              ppData
-) const
+bool ImageResource::Map(VkDeviceSize offset, void** ppData) const
 {
-    auto result = vkMapMemory(device, m_Memory, offset, size, flags, ppData);
-    if (result != VK_SUCCESS)
+    if (m_pAllocator == nullptr || ppData == nullptr)
     {
-        ELOG( "Error : vkMapMemory() Failed." );
+        ELOG( "Error : Invalid Argument." );
+        return false;
+    }
+
+    void* pData = nullptr;
+    if (!m_pAllocator->Map(m_Allocation, &pData))
+    {
+        ELOG( "Error : MemoryAllocator::Map() Failed." );
         return false;
     }
 
+    *ppData = static_cast<uint8_t*>(pData) + offset;
     return true;
 }
 
 //-------------------------------------------------------------------------------------------------
 //      アンマップします.
 //-------------------------------------------------------------------------------------------------
-void ImageResource::Unmap(VkDevice device) const
-{ vkUnmapMemory(device, m_Memory); }
+void ImageResource::Unmap() const
+{
+    if (m_pAllocator != nullptr)
+    { m_pAllocator->Unmap(m_Allocation); }
+}
 
 //-------------------------------------------------------------------------------------------------
 //      デバイスメモリを取得します.
 //-------------------------------------------------------------------------------------------------
 VkDeviceMemory ImageResource::GetMemory() const
-{ return m_Memory; }
+{ return m_Allocation.Memory; }
+
+//-------------------------------------------------------------------------------------------------
+//      デバイスメモリ先頭からのオフセットを取得します.
+//-------------------------------------------------------------------------------------------------
+VkDeviceSize ImageResource::GetOffset() const
+{ return m_Allocation.Offset; }
 
 //-------------------------------------------------------------------------------------------------
 //      イメージを取得します.
@@ -161,8 +156,9 @@ VkImage ImageResource::GetImage() const
 //      コンストラクタです.
 //-------------------------------------------------------------------------------------------------
 BufferResource::BufferResource()
-: m_Resource(null_handle)
-, m_Memory  (null_handle)
+: m_Resource  (null_handle)
+, m_pAllocator(nullptr)
+, m_Allocation()
 { /* DO_NOTHING */ }
 
 //-------------------------------------------------------------------------------------------------
@@ -174,14 +170,21 @@ BufferResource::~BufferResource()
 //-------------------------------------------------------------------------------------------------
 //      初期化処理を行います.
 //-------------------------------------------------------------------------------------------------
-bool BufferResource::Init(VkDevice device, const VkBufferCreateInfo* pInfo)
+bool BufferResource::Init
+(
+    MemoryAllocator*            pAllocator,
+    const VkBufferCreateInfo*   pInfo,
+    VkMemoryPropertyFlags       propFlags
+)
 {
-    if (device == null_handle || pInfo == nullptr)
+    if (pAllocator == nullptr || pInfo == nullptr)
     {
         ELOG( "Error : Invalid Argument." );
         return false;
     }
 
+    auto device = pAllocator->GetDevice();
+
     auto result = vkCreateBuffer(device, pInfo, nullptr, &m_Resource);
     if ( result != VK_SUCCESS )
     {
@@ -192,23 +195,21 @@ bool BufferResource::Init(VkDevice device, const VkBufferCreateInfo* pInfo)
     VkMemoryRequirements requirements;
     vkGetBufferMemoryRequirements(device, m_Resource, &requirements);
 
-    VkMemoryAllocateInfo allocInfo = {};
-    allocInfo.sType             = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.pNext             = nullptr;
-    allocInfo.memoryTypeIndex   = 0;
-    allocInfo.allocationSize    = requirements.size;
-
-    result = vkAllocateMemory(device, &allocInfo, nullptr, &m_Memory);
-    if ( result != VK_SUCCESS )
+    if (!pAllocator->Allocate(requirements, propFlags, true, &m_Allocation))
     {
-        ELOG( "Error : vkAllocateMemory() Failed." );
+        ELOG( "Error : MemoryAllocator::Allocate() Failed." );
+        vkDestroyBuffer(device, m_Resource, nullptr);
+        m_Resource = null_handle;
         return false;
     }
 
-    result = vkBindBufferMemory(device, m_Resource, m_Memory, 0);
+    m_pAllocator = pAllocator;
+
+    result = vkBindBufferMemory(device, m_Resource, m_Allocation.Memory, m_Allocation.Offset);
     if ( result != VK_SUCCESS )
     {
         ELOG( "Error : vkBindBufferMemory() Failed." );
+        Term();
         return false;
     }
 
@@ -218,51 +219,62 @@ bool BufferResource::Init(VkDevice device, const VkBufferCreateInfo* pInfo)
 //-------------------------------------------------------------------------------------------------
 //      終了処理を行います.
 //-------------------------------------------------------------------------------------------------
-void BufferResource::Term(VkDevice device)
+void BufferResource::Term()
 {
-    if (m_Memory != null_handle)
-    { vkFreeMemory(device, m_Memory, nullptr); }
+    if (m_pAllocator == nullptr)
+    { return; }
 
     if (m_Resource != null_handle)
-    { vkDestroyBuffer(device, m_Resource, nullptr); }
+    { vkDestroyBuffer(m_pAllocator->GetDevice(), m_Resource, nullptr); }
+
+    m_pAllocator->Free(&m_Allocation);
 
-    m_Memory   = null_handle;
-    m_Resource = null_handle;
+    m_Resource   = null_handle;
+    m_pAllocator = nullptr;
 }
 
 //-------------------------------------------------------------------------------------------------
 //      マップします.
 //-------------------------------------------------------------------------------------------------
-bool BufferResource::Map
-(
-    VkDevice            device,
-    VkDeviceSize        offset,
-    VkDeviceSize        size,
-    VkMemoryMapFlags    flags,
-    void**              ppData
-) const
+bool BufferResource::Map(VkDeviceSize offset, void** ppData) const
 {
-    auto result = vkMapMemory(device, m_Memory, offset, size, flags, ppData);
-    if ( result != VK_SUCCESS )
+    if (m_pAllocator == nullptr || ppData == nullptr)
     {
-        ELOG( "Error : vkMapMemory() Failed." );
+        ELOG( "Error : Invalid Argument." );
         return false;
     }
 
+    void* pData = nullptr;
+    if (!m_pAllocator->Map(m_Allocation, &pData))
+    {
+        ELOG( "Error : MemoryAllocator::Map() Failed." );
+        return false;
+    }
+
+    *ppData = static_cast<uint8_t*>(pData) + offset;
     return true;
 }
 
 //-------------------------------------------------------------------------------------------------
 //      アンマップします.
 //-------------------------------------------------------------------------------------------------
-void BufferResource::Unmap(VkDevice device) const
-{ vkUnmapMemory(device, m_Memory); }
+void BufferResource::Unmap() const
+{
+    if (m_pAllocator != nullptr)
+    { m_pAllocator->Unmap(m_Allocation); }
+}
 
 //-------------------------------------------------------------------------------------------------
 //      デバイスメモリを取得します.
 //-------------------------------------------------------------------------------------------------
 VkDeviceMemory BufferResource::GetMemory() const
-{ return m_Memory; }
+{ return m_Allocation.Memory; }
+
+//-------------------------------------------------------------------------------------------------
+//      デバイスメモリ先頭からのオフセットを取得します.
+//-------------------------------------------------------------------------------------------------
+VkDeviceSize BufferResource::GetOffset() const
+{ return m_Allocation.Offset; }
 
 //-------------------------------------------------------------------------------------------------
 //      バッファを取得します.
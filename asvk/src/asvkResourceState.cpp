@@ -0,0 +1,400 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asvkResourceState.cpp
+// Desc : Resource State Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asvkResourceState.h>
+#include <asvkLogger.h>
+
+
+namespace /* anonymous */ {
+
+//-------------------------------------------------------------------------------------------------
+// Constant Values
+//-------------------------------------------------------------------------------------------------
+const VkAccessFlags WriteAccessMask =
+      VK_ACCESS_SHADER_WRITE_BIT
+    | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT
+    | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT
+    | VK_ACCESS_TRANSFER_WRITE_BIT
+    | VK_ACCESS_HOST_WRITE_BIT
+    | VK_ACCESS_MEMORY_WRITE_BIT;
+
+} // namespace /* anonymous */
+
+
+namespace asvk {
+
+//-------------------------------------------------------------------------------------------------
+//      使用用途に対応するリソースステートを取得します.
+//-------------------------------------------------------------------------------------------------
+ResourceState GetResourceState(ResourceUsage usage)
+{
+    switch(usage)
+    {
+    case ResourceUsage_ColorAttachment:
+        return ResourceState(
+            VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+            VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+
+    case ResourceUsage_DepthStencilAttachment:
+        return ResourceState(
+            VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+            VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+            VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT);
+
+    case ResourceUsage_DepthStencilRead:
+        return ResourceState(
+            VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
+            VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_SHADER_READ_BIT,
+            VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+
+    case ResourceUsage_ShaderRead:
+        return ResourceState(
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            VK_ACCESS_SHADER_READ_BIT,
+            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+
+    case ResourceUsage_ComputeRead:
+        return ResourceState(
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            VK_ACCESS_SHADER_READ_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+
+    case ResourceUsage_ComputeWrite:
+        return ResourceState(
+            VK_IMAGE_LAYOUT_GENERAL,
+            VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+
+    case ResourceUsage_TransferSrc:
+        return ResourceState(
+            VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            VK_ACCESS_TRANSFER_READ_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+    case ResourceUsage_TransferDst:
+        return ResourceState(
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            VK_ACCESS_TRANSFER_WRITE_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+    case ResourceUsage_Present:
+        // 表示エンジンとの同期はセマフォで行うので, アクセスフラグは不要.
+        return ResourceState(
+            VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+            0,
+            VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+
+    case ResourceUsage_VertexBuffer:
+        return ResourceState(
+            VK_IMAGE_LAYOUT_UNDEFINED,
+            VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT,
+            VK_PIPELINE_STAGE_VERTEX_INPUT_BIT);
+
+    case ResourceUsage_IndexBuffer:
+        return ResourceState(
+            VK_IMAGE_LAYOUT_UNDEFINED,
+            VK_ACCESS_INDEX_READ_BIT,
+            VK_PIPELINE_STAGE_VERTEX_INPUT_BIT);
+
+    case ResourceUsage_UniformBuffer:
+        return ResourceState(
+            VK_IMAGE_LAYOUT_UNDEFINED,
+            VK_ACCESS_UNIFORM_READ_BIT,
+            VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+
+    case ResourceUsage_IndirectBuffer:
+        return ResourceState(
+            VK_IMAGE_LAYOUT_UNDEFINED,
+            VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
+            VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT);
+
+    case ResourceUsage_HostRead:
+        return ResourceState(
+            VK_IMAGE_LAYOUT_UNDEFINED,
+            VK_ACCESS_HOST_READ_BIT,
+            VK_PIPELINE_STAGE_HOST_BIT);
+
+    default:
+        break;
+    }
+
+    return ResourceState();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// ResourceStateTracker class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+ResourceStateTracker::ResourceStateTracker()
+: m_SrcStageMask(0)
+, m_DstStageMask(0)
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      デストラクタです.
+//-------------------------------------------------------------------------------------------------
+ResourceStateTracker::~ResourceStateTracker()
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      追跡中のステートと未発行のバリアを全て破棄します.
+//-------------------------------------------------------------------------------------------------
+void ResourceStateTracker::Reset()
+{
+    m_Images        .clear();
+    m_Buffers       .clear();
+    m_ImageBarriers .clear();
+    m_BufferBarriers.clear();
+    m_SrcStageMask = 0;
+    m_DstStageMask = 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      イメージの現在のステートを設定します.
+//-------------------------------------------------------------------------------------------------
+void ResourceStateTracker::SetImageState(VkImage image, const ResourceState& state)
+{
+    auto& entry = m_Images[image];
+    entry.State        = state;
+    entry.PendingIndex = -1;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      バッファの現在のステートを設定します.
+//-------------------------------------------------------------------------------------------------
+void ResourceStateTracker::SetBufferState(VkBuffer buffer, const ResourceState& state)
+{
+    auto& entry = m_Buffers[buffer];
+    entry.State        = state;
+    entry.PendingIndex = -1;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      イメージの現在のステートを取得します.
+//-------------------------------------------------------------------------------------------------
+bool ResourceStateTracker::GetImageState(VkImage image, ResourceState* pState) const
+{
+    auto itr = m_Images.find(image);
+    if (itr == m_Images.end())
+    { return false; }
+
+    if (pState != nullptr)
+    { *pState = itr->second.State; }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      イメージの遷移を要求します.
+//-------------------------------------------------------------------------------------------------
+void ResourceStateTracker::TransitionImage
+(
+    VkImage                         image,
+    const VkImageSubresourceRange&  range,
+    ResourceUsage                   usage
+)
+{ TransitionImage(image, range, GetResourceState(usage)); }
+
+//-------------------------------------------------------------------------------------------------
+//      イメージリソースの遷移を要求します.
+//-------------------------------------------------------------------------------------------------
+void ResourceStateTracker::TransitionImage
+(
+    const ImageResource&            resource,
+    const VkImageSubresourceRange&  range,
+    ResourceUsage                   usage
+)
+{ TransitionImage(resource.GetImage(), range, GetResourceState(usage)); }
+
+//-------------------------------------------------------------------------------------------------
+//      イメージの遷移を要求します.
+//-------------------------------------------------------------------------------------------------
+void ResourceStateTracker::TransitionImage
+(
+    VkImage                         image,
+    const VkImageSubresourceRange&  range,
+    const ResourceState&            state
+)
+{
+    auto itr = m_Images.find(image);
+    if (itr == m_Images.end())
+    {
+        Entry entry;
+        entry.PendingIndex = -1;
+        itr = m_Images.insert(std::make_pair(image, entry)).first;
+    }
+
+    auto& entry = itr->second;
+
+    // 未定義レイアウトへの遷移は内容の破棄なのでバリアは不要.
+    if (state.Layout == VK_IMAGE_LAYOUT_UNDEFINED)
+    {
+        entry.State = state;
+        return;
+    }
+
+    // 同じフラッシュ内で再遷移する場合は, 中間のステートを飛ばして1つのバリアにまとめる.
+    if (entry.PendingIndex >= 0)
+    {
+        auto& barrier = m_ImageBarriers[entry.PendingIndex];
+        barrier.newLayout        = state.Layout;
+        barrier.dstAccessMask    = state.Access;
+        barrier.subresourceRange = range;
+        m_DstStageMask |= state.Stage;
+        entry.State = state;
+        return;
+    }
+
+    auto& current = entry.State;
+    auto isLayoutChanged = (current.Layout != state.Layout);
+    auto isCurrentWrite  = (current.Access & WriteAccessMask) != 0;
+    auto isNextWrite     = (state  .Access & WriteAccessMask) != 0;
+
+    // 読み取り同士ならバリアは不要. 次の書き込みが全ての読み取りを待てるようにステートを合成する.
+    if (!isLayoutChanged && !isCurrentWrite && !isNextWrite)
+    {
+        current.Access |= state.Access;
+        current.Stage  |= state.Stage;
+        return;
+    }
+
+    VkImageMemoryBarrier barrier = {};
+    barrier.sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.pNext               = nullptr;
+    barrier.srcAccessMask       = current.Access & WriteAccessMask;    // 可視化が必要なのは書き込みのみ.
+    barrier.dstAccessMask       = state.Access;
+    barrier.oldLayout           = current.Layout;
+    barrier.newLayout           = state.Layout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image               = image;
+    barrier.subresourceRange    = range;
+
+    m_SrcStageMask |= current.Stage;
+    m_DstStageMask |= state.Stage;
+
+    entry.PendingIndex = static_cast<int>(m_ImageBarriers.size());
+    entry.State        = state;
+    m_ImageBarriers.push_back(barrier);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      バッファの遷移を要求します.
+//-------------------------------------------------------------------------------------------------
+void ResourceStateTracker::TransitionBuffer(VkBuffer buffer, ResourceUsage usage)
+{ TransitionBuffer(buffer, GetResourceState(usage)); }
+
+//-------------------------------------------------------------------------------------------------
+//      バッファリソースの遷移を要求します.
+//-------------------------------------------------------------------------------------------------
+void ResourceStateTracker::TransitionBuffer(const BufferResource& resource, ResourceUsage usage)
+{ TransitionBuffer(resource.GetBuffer(), GetResourceState(usage)); }
+
+//-------------------------------------------------------------------------------------------------
+//      バッファの遷移を要求します.
+//-------------------------------------------------------------------------------------------------
+void ResourceStateTracker::TransitionBuffer(VkBuffer buffer, const ResourceState& state)
+{
+    auto itr = m_Buffers.find(buffer);
+    if (itr == m_Buffers.end())
+    {
+        Entry entry;
+        entry.PendingIndex = -1;
+        itr = m_Buffers.insert(std::make_pair(buffer, entry)).first;
+    }
+
+    auto& entry = itr->second;
+
+    if (entry.PendingIndex >= 0)
+    {
+        auto& barrier = m_BufferBarriers[entry.PendingIndex];
+        barrier.dstAccessMask = state.Access;
+        m_DstStageMask |= state.Stage;
+        entry.State = state;
+        return;
+    }
+
+    auto& current = entry.State;
+    auto isCurrentWrite = (current.Access & WriteAccessMask) != 0;
+    auto isNextWrite    = (state  .Access & WriteAccessMask) != 0;
+
+    // バッファはレイアウトを持たないので, 書き込みが絡む場合のみバリアが必要.
+    if (!isCurrentWrite && !isNextWrite)
+    {
+        current.Access |= state.Access;
+        current.Stage  |= state.Stage;
+        return;
+    }
+
+    VkBufferMemoryBarrier barrier = {};
+    barrier.sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier.pNext               = nullptr;
+    barrier.srcAccessMask       = current.Access & WriteAccessMask;
+    barrier.dstAccessMask       = state.Access;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer              = buffer;
+    barrier.offset              = 0;
+    barrier.size                = VK_WHOLE_SIZE;
+
+    m_SrcStageMask |= current.Stage;
+    m_DstStageMask |= state.Stage;
+
+    entry.PendingIndex = static_cast<int>(m_BufferBarriers.size());
+    entry.State        = state;
+    m_BufferBarriers.push_back(barrier);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      未発行のバリアをまとめて発行します.
+//-------------------------------------------------------------------------------------------------
+void ResourceStateTracker::Flush(VkCommandBuffer commandBuffer)
+{
+    if (!HasPending())
+    { return; }
+
+    VkPipelineStageFlags srcStageMask = (m_SrcStageMask != 0) ? m_SrcStageMask : VkPipelineStageFlags(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+    VkPipelineStageFlags dstStageMask = (m_DstStageMask != 0) ? m_DstStageMask : VkPipelineStageFlags(VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+
+    vkCmdPipelineBarrier(
+        commandBuffer,
+        srcStageMask,
+        dstStageMask,
+        0,
+        0,
+        nullptr,
+        static_cast<uint32_t>(m_BufferBarriers.size()),
+        m_BufferBarriers.data(),
+        static_cast<uint32_t>(m_ImageBarriers.size()),
+        m_ImageBarriers.data());
+
+    for(size_t i=0; i<m_ImageBarriers.size(); ++i)
+    { m_Images[m_ImageBarriers[i].image].PendingIndex = -1; }
+
+    for(size_t i=0; i<m_BufferBarriers.size(); ++i)
+    { m_Buffers[m_BufferBarriers[i].buffer].PendingIndex = -1; }
+
+    m_ImageBarriers .clear();
+    m_BufferBarriers.clear();
+    m_SrcStageMask = 0;
+    m_DstStageMask = 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      未発行のバリアがあるかどうかチェックします.
+//-------------------------------------------------------------------------------------------------
+bool ResourceStateTracker::HasPending() const
+{ return !m_ImageBarriers.empty() || !m_BufferBarriers.empty(); }
+
+} // namespace asvk
@@ -25,8 +25,13 @@ SwapChain::SwapChain()
 , m_Surface     (null_handle)
 , m_SwapChain   (null_handle)
 , m_Device      (null_handle)
-, m_Semaphore   (null_handle)
 , m_pQueue      (null_handle)
+, m_Gpu         (null_handle)
+, m_PreTransform(VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR)
+, m_PresentMode (VK_PRESENT_MODE_FIFO_KHR)
+, m_IsOutOfDate (false)
+, m_PresentResult(VK_SUCCESS)
+, m_FrameLatency(1)
 { /* DO_NOTHING */ }
 
 //-------------------------------------------------------------------------------------------------
@@ -47,23 +52,8 @@ bool SwapChain::Init(DeviceMgr* pDeviceMgr, VkCommandBuffer commandBuffer,const
         return false;
     }
 
-    // セマフォの生成.
-    {
-        VkSemaphoreCreateInfo info = {};
-        info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
-        info.pNext = nullptr;
-        info.flags = 0;
-
-        auto result = vkCreateSemaphore(pDeviceMgr->GetDevice(), &info, nullptr, &m_Semaphore);
-        if (result != VK_SUCCESS)
-        {
-            ELOG("Error : vkCreatSemaphore() Failed.");
-            return false;
-        }
-    }
-
     // 物理デバイス取得.
-    auto gpu = pDeviceMgr->GetPhysicalDevice()[0].Gpu;
+    auto gpu = pDeviceMgr->GetSelectedPhysicalDevice().Gpu;
 
     // サーフェイス生成情報を設定する.
     VkWin32SurfaceCreateInfoKHR surfaceInfo = {};
@@ -106,18 +96,13 @@ bool SwapChain::Init(DeviceMgr* pDeviceMgr, VkCommandBuffer commandBuffer,const
         return false;
     }
 
-    auto imageFormat     = VK_FORMAT_UNDEFINED;
-    auto imageColorSpace = VK_COLORSPACE_SRGB_NONLINEAR_KHR;
-
     bool isFind = false;
     for(size_t i=0; i<formats.size(); ++i)
     {
         if (pDesc->Format     == formats[i].format &&
             pDesc->ColorSpace == formats[i].colorSpace)
         { 
-            imageFormat     = pDesc->Format;
-            imageColorSpace = pDesc->ColorSpace;
-            isFind          = true;
+            isFind = true;
             break;
         }
     }
@@ -147,8 +132,8 @@ bool SwapChain::Init(DeviceMgr* pDeviceMgr, VkCommandBuffer commandBuffer,const
         else
         { preTransform = capabilities.currentTransform; }
 
-        // 最大スワップチェイン数をチェック.
-        if (capabilities.maxImageCount < pDesc->BufferCount)
+        // 最大スワップチェイン数をチェック(0 は上限なし).
+        if (capabilities.maxImageCount != 0 && capabilities.maxImageCount < pDesc->BufferCount)
         {
             ELOG( "Error : Invalid Buffer Count. Specified Buffer Count is %u, Maximum Buffer Count is %u.", 
                  pDesc->BufferCount,
@@ -184,154 +169,96 @@ bool SwapChain::Init(DeviceMgr* pDeviceMgr, VkCommandBuffer commandBuffer,const
             return false;
         }
 
-        for(size_t i=0; i<presentModes.size(); ++i)
+        // ポリシーごとの優先順. FIFO は必ずサポートされているので最後の候補とする.
+        VkPresentModeKHR candidates[3] = {
+            VK_PRESENT_MODE_FIFO_KHR,
+            VK_PRESENT_MODE_FIFO_KHR,
+            VK_PRESENT_MODE_FIFO_KHR
+        };
+        switch(pDesc->Policy)
         {
-            // 垂直同期OFFを優先.
-            if (presentModes[i] == VK_PRESENT_MODE_IMMEDIATE_KHR)
+        case PresentPolicy_LowLatency:
             {
-                presentMode = VK_PRESENT_MODE_IMMEDIATE_KHR;
-                break;
+                // ティアリングさせずに最新のフレームを表示する.
+                candidates[0] = VK_PRESENT_MODE_MAILBOX_KHR;
             }
+            break;
 
-            // 垂直同期ON
-            if (presentModes[i] == VK_PRESENT_MODE_MAILBOX_KHR)
-            { presentMode = VK_PRESENT_MODE_MAILBOX_KHR; }
-        }
-
-        presentModes.clear();
-    }
-
-    // スワップチェインを生成.
-    {
-        VkSwapchainCreateInfoKHR createInfo = {};
-        createInfo.sType                    = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
-        createInfo.pNext                    = nullptr;
-        createInfo.flags                    = 0;
-        createInfo.surface                  = m_Surface;
-        createInfo.minImageCount            = pDesc->BufferCount;
-        createInfo.imageFormat              = imageFormat;
-        createInfo.imageColorSpace          = imageColorSpace;
-        createInfo.imageExtent              = { pDesc->Width, pDesc->Height };
-        createInfo.imageArrayLayers         = 1;
-        createInfo.imageUsage               = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
-        createInfo.imageSharingMode         = VK_SHARING_MODE_EXCLUSIVE;
-        createInfo.queueFamilyIndexCount    = 0;
-        createInfo.pQueueFamilyIndices      = nullptr;
-        createInfo.preTransform             = preTransform;
-        createInfo.compositeAlpha           = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
-        createInfo.presentMode              = presentMode;
-        createInfo.clipped                  = VK_TRUE;
-        createInfo.oldSwapchain             = null_handle;
-
-        result = vkCreateSwapchainKHR(pDeviceMgr->GetDevice(), &createInfo, nullptr, &m_SwapChain);
-        if ( result != VK_SUCCESS )
-        {
-            ELOG( "Error : vkCreateSwapChainKHR() Failed." );
-            return false;
-        }
-    }
-
-    // イメージを取得.
-    {
-        uint32_t chainCount;
-        result = vkGetSwapchainImagesKHR(pDeviceMgr->GetDevice(), m_SwapChain, &chainCount, nullptr);
-        if ( result != VK_SUCCESS )
-        {
-            ELOG( "Error : vkGetSwapChainImagesKHR() Failed." );
-            return false;
-        }
+        case PresentPolicy_Throughput:
+            {
+                // 垂直同期OFFを優先.
+                candidates[0] = VK_PRESENT_MODE_IMMEDIATE_KHR;
+                candidates[1] = VK_PRESENT_MODE_MAILBOX_KHR;
+            }
+            break;
 
-        if ( chainCount != pDesc->BufferCount )
-        {
-            ELOG( "Error : SwapChain Count is Invalid." );
-            return false;
+        default:
+            break;
         }
 
-        std::vector<VkImage> images;
-        images.resize(chainCount);
-        result = vkGetSwapchainImagesKHR(pDeviceMgr->GetDevice(), m_SwapChain, &chainCount, images.data());
-        if ( result != VK_SUCCESS )
+        bool isFindMode = false;
+        for(size_t i=0; i<3 && !isFindMode; ++i)
         {
-            ELOG( "Error : vkGetSwapCHainImagesKHR() Failed." );
-            return false;
+            for(size_t j=0; j<presentModes.size(); ++j)
+            {
+                if (presentModes[j] == candidates[i])
+                {
+                    presentMode = candidates[i];
+                    isFindMode  = true;
+                    break;
+                }
+            }
         }
 
-        m_Buffers.resize(chainCount);
-        for(size_t i=0; i<m_Buffers.size(); ++i)
-        { m_Buffers[i].Image = images[i]; }
-
-        images.clear();
+        presentModes.clear();
     }
 
-    // イメージビューを生成.
+    // イメージ数を決定する.
+    auto bufferCount = pDesc->BufferCount;
+    if (bufferCount == 0)
     {
-        m_Range.aspectMask      = VK_IMAGE_ASPECT_COLOR_BIT;
-        m_Range.baseMipLevel    = 0;
-        m_Range.levelCount      = 1;
-        m_Range.baseArrayLayer  = 0;
-        m_Range.layerCount      = 1;
+        // MAILBOX と IMMEDIATE はGPUが表示待ちで止まらないように1枚余分に確保する.
+        bufferCount = capabilities.minImageCount;
+        if (presentMode != VK_PRESENT_MODE_FIFO_KHR)
+        { bufferCount++; }
+        if (pDesc->Policy == PresentPolicy_Throughput && presentMode == VK_PRESENT_MODE_FIFO_KHR)
+        { bufferCount++; }
+    }
 
-        for(size_t i=0; i<m_Buffers.size(); ++i)
-        {
-            VkImageViewCreateInfo viewInfo = {};
-            viewInfo.sType            = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-            viewInfo.pNext            = nullptr;
-            viewInfo.flags            = 0;
-            viewInfo.image            = m_Buffers[i].Image;
-            viewInfo.viewType         = VK_IMAGE_VIEW_TYPE_2D;
-            viewInfo.format           = imageFormat;
-            viewInfo.components.r     = VK_COMPONENT_SWIZZLE_R;
-            viewInfo.components.g     = VK_COMPONENT_SWIZZLE_G;
-            viewInfo.components.b     = VK_COMPONENT_SWIZZLE_B;
-            viewInfo.components.a     = VK_COMPONENT_SWIZZLE_A;
-            viewInfo.subresourceRange = m_Range;
+    if (bufferCount < 2)
+    { bufferCount = 2; }
+    if (bufferCount < capabilities.minImageCount)
+    { bufferCount = capabilities.minImageCount; }
+    if (capabilities.maxImageCount != 0 && bufferCount > capabilities.maxImageCount)
+    { bufferCount = capabilities.maxImageCount; }
 
-            result = vkCreateImageView(pDeviceMgr->GetDevice(), &viewInfo, nullptr, &m_Buffers[i].View);
-            if ( result != VK_SUCCESS )
-            {
-                ELOG( "Error : vkCreateImageView() Failed." );
-                return false;
-            }
+    // 同時処理フレーム数を決定する. 遅延重視のポリシーではCPUを1フレーム以上先行させない.
+    auto frameLatency = 1u;
+    if (pDesc->Policy == PresentPolicy_Throughput)
+    { frameLatency = bufferCount - 1; }
 
-            VkImageMemoryBarrier barrier = {};
-            barrier.sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-            barrier.pNext               = nullptr;
-            barrier.srcAccessMask       = 0;
-            barrier.dstAccessMask       = 0;
-            barrier.oldLayout           = VK_IMAGE_LAYOUT_UNDEFINED;
-            barrier.newLayout           = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-            barrier.srcQueueFamilyIndex = 0;
-            barrier.dstQueueFamilyIndex = 0;
-            barrier.image               = m_Buffers[i].Image;
-            barrier.subresourceRange    = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+    memcpy(&m_Desc, pDesc, sizeof(m_Desc));
+    m_Desc.BufferCount = bufferCount;
 
-            vkCmdPipelineBarrier(
-                commandBuffer,
-                VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
-                VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-                0, 0, nullptr, 0, nullptr, 1, &barrier );
-        }
-    }
+    m_Gpu           = gpu;
+    m_Device        = pDeviceMgr->GetDevice();
+    m_pQueue        = pDeviceMgr->GetGraphicsQueue();
+    m_PreTransform  = preTransform;
+    m_PresentMode   = presentMode;
+    m_BufferIndex   = 0;
+    m_IsOutOfDate   = false;
+    m_FrameLatency  = frameLatency;
 
-    // イメージを取得.
-    result = vkAcquireNextImageKHR(
-        pDeviceMgr->GetDevice(),
-        m_SwapChain,
-        UINT64_MAX,
-        m_Semaphore,
-        null_handle,
-        &m_BufferIndex);
-    if ( result != VK_SUCCESS )
-    { 
-        ELOG( "Error : vkAcquireNextImageKHR() Failed." );
+    // スワップチェインを生成.
+    if (!CreateSwapChain(commandBuffer))
+    {
+        ELOG( "Error : SwapChain::CreateSwapChain() Failed." );
         return false;
     }
 
-    memcpy(&m_Desc, pDesc, sizeof(m_Desc));
-
-    m_Device      = pDeviceMgr->GetDevice();
-    m_pQueue      = pDeviceMgr->GetGraphicsQueue();
-    m_BufferIndex = 0;
+    // 実際に確保されたイメージ数を超えて先行しないようにする.
+    if (m_FrameLatency >= m_Desc.BufferCount)
+    { m_FrameLatency = m_Desc.BufferCount - 1; }
 
     // 正常終了.
     return true;
@@ -345,6 +272,10 @@ void SwapChain::Term(DeviceMgr* pDeviceMgr)
     if (pDeviceMgr == nullptr)
     { return; }
 
+    // 積まれている表示要求が破棄するスワップチェインを参照しないようにする.
+    if (m_pQueue != nullptr)
+    { m_pQueue->Flush(); }
+
     for(size_t i=0; i<m_Buffers.size(); ++i)
     {
         if (m_Buffers[i].View != null_handle)
@@ -357,9 +288,6 @@ void SwapChain::Term(DeviceMgr* pDeviceMgr)
     if (m_Surface != null_handle)
     { vkDestroySurfaceKHR(pDeviceMgr->GetInstance(), m_Surface, nullptr); }
 
-    if (m_Semaphore != null_handle)
-    { vkDestroySemaphore(pDeviceMgr->GetDevice(), m_Semaphore, nullptr); }
-
     memset(&m_Desc,  0, sizeof(m_Desc));
     memset(&m_Range, 0, sizeof(m_Range));
 
@@ -367,32 +295,110 @@ void SwapChain::Term(DeviceMgr* pDeviceMgr)
     m_Surface   = null_handle;
     m_pQueue    = null_handle;
     m_Device    = null_handle;
-    m_Semaphore = null_handle;
+    m_Gpu       = null_handle;
     m_Buffers.clear();
+
+    m_IsOutOfDate   = false;
+    m_PresentResult = VK_SUCCESS;
+    m_FrameLatency  = 1;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      サイズを変更します.
+//-------------------------------------------------------------------------------------------------
+bool SwapChain::Resize(VkCommandBuffer commandBuffer, uint32_t width, uint32_t height)
+{
+    if (m_SwapChain == null_handle || commandBuffer == null_handle)
+    {
+        ELOG( "Error : Invalid State." );
+        return false;
+    }
+
+    // 最小化中はサーフェイスのサイズがゼロになるので，復帰するまで再生成を見送る.
+    VkSurfaceCapabilitiesKHR capabilities;
+    auto result = vkGetPhysicalDeviceSurfaceCapabilitiesKHR(m_Gpu, m_Surface, &capabilities);
+    if ( result != VK_SUCCESS )
+    {
+        ELOG( "Error : vkGetPhysicalDeviceSurfaceCapabilitiesKHR() Failed." );
+        return false;
+    }
+
+    if (capabilities.currentExtent.width == 0 || capabilities.currentExtent.height == 0)
+    { return false; }
+
+    // 旧イメージビューを破棄.
+    for(size_t i=0; i<m_Buffers.size(); ++i)
+    {
+        if (m_Buffers[i].View != null_handle)
+        { vkDestroyImageView(m_Device, m_Buffers[i].View, nullptr); }
+    }
+    m_Buffers.clear();
+
+    m_Desc.Width  = width;
+    m_Desc.Height = height;
+
+    // サーフェイスはそのままに，旧スワップチェインを引き継いで再生成する.
+    if (!CreateSwapChain(commandBuffer))
+    {
+        ELOG( "Error : SwapChain::CreateSwapChain() Failed." );
+        return false;
+    }
+
+    m_BufferIndex   = 0;
+    m_IsOutOfDate   = false;
+    m_PresentResult = VK_SUCCESS;
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      次に描画するイメージを取得します.
+//-------------------------------------------------------------------------------------------------
+bool SwapChain::AcquireNextImage(VkSemaphore semaphore, uint64_t timeout)
+{
+    auto result = vkAcquireNextImageKHR(
+        m_Device,
+        m_SwapChain,
+        timeout,
+        semaphore,
+        null_handle,
+        &m_BufferIndex);
+    if ( result == VK_ERROR_OUT_OF_DATE_KHR )
+    {
+        // 呼び出し側で再生成してもらう.
+        m_IsOutOfDate = true;
+        return false;
+    }
+
+    if ( result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR )
+    {
+        ELOG( "Error : vkAcquireNextImageKHR() Failed." );
+        return false;
+    }
+
+    // SUBOPTIMALでも表示は可能なので，このフレームは描画して次のフレームで再生成する.
+    if ( result == VK_SUBOPTIMAL_KHR )
+    { m_IsOutOfDate = true; }
+
+    return true;
 }
 
 //-------------------------------------------------------------------------------------------------
 //      表示します.
 //-------------------------------------------------------------------------------------------------
-void SwapChain::Present(uint64_t timeout)
+void SwapChain::Present(VkSemaphore waitSemaphore)
 {
-    VkPresentInfoKHR present = {};
-    present.sType               = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
-    present.pNext               = nullptr;
-    present.swapchainCount      = 1;
-    present.waitSemaphoreCount  = 1;
-    present.pWaitSemaphores     = &m_Semaphore;
-    present.pSwapchains         = &m_SwapChain;
-    present.pImageIndices       = &m_BufferIndex;
-
-    // 表示.
-    auto result = vkQueuePresentKHR(m_pQueue->GetQueue(), &present);
+    // 表示. キューのサブミットスレッドが動作中なら要求を積むだけで戻る.
+    m_pQueue->Present(m_SwapChain, m_BufferIndex, waitSemaphore, &m_PresentResult);
+
+    // サブミットスレッド使用時は前回までの表示結果になるが, 再生成が1フレーム遅れるだけで済む.
+    auto result = static_cast<VkResult>(m_PresentResult.exchange(VK_SUCCESS));
     if (result == VK_ERROR_OUT_OF_HOST_MEMORY )
     { ELOG( "Error : vkQueuePresentKHR() Failed. ErrorCode = VK_ERROR_OUT_OF_HOST_MEMORY" ); }
     else if (result == VK_ERROR_OUT_OF_DEVICE_MEMORY )
     { ELOG( "Error : vkQueuePresentKHR() Failed. ErrorCode = VK_ERROR_OUT_OF_DEVICE_MEMORY" ); }
-    else if (result == VK_ERROR_OUT_OF_DATE_KHR)
-    { ELOG( "Error : vkQueuePresentKHR() Failed. ErrorCode = VK_EROR_OUT_OF_DATE_KHR" ); }
+    else if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR)
+    { m_IsOutOfDate = true; }
     else if (result == VK_ERROR_SURFACE_LOST_KHR )
     { ELOG( "Error : vkQueuePresentKHR() Failed. ErrorCode = VK_ERROR_SURFACE_LOST_KHR" ); }
     else if (result == VK_ERROR_DEVICE_LOST)
@@ -410,17 +416,6 @@ void SwapChain::Present(uint64_t timeout)
         // 殺す.
         abort();
     }
-
-    // イメージを取得.
-    result = vkAcquireNextImageKHR(
-        m_Device,
-        m_SwapChain,
-        timeout,
-        m_Semaphore,
-        null_handle,
-        &m_BufferIndex);
-    if ( result != VK_SUCCESS )
-    { ELOG( "Error : vkAcquireNextImageKHR() Failed." ); }
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -441,12 +436,6 @@ VkSwapchainKHR SwapChain::GetSwapChain() const
 VkSurfaceKHR SwapChain::GetSurface() const
 { return m_Surface; }
 
-//-------------------------------------------------------------------------------------------------
-//      セマフォを取得します.
-//-------------------------------------------------------------------------------------------------
-VkSemaphore SwapChain::GetSemaphore() const
-{ return m_Semaphore; }
-
 //-------------------------------------------------------------------------------------------------
 //      バッファを取得します.
 //-------------------------------------------------------------------------------------------------
@@ -476,4 +465,180 @@ VkImageSubresourceRange SwapChain::GetRange() const
 const SwapChainDesc& SwapChain::GetDesc() const
 { return m_Desc; }
 
+//-------------------------------------------------------------------------------------------------
+//      再生成が必要かどうかチェックします.
+//-------------------------------------------------------------------------------------------------
+bool SwapChain::IsOutOfDate() const
+{ return m_IsOutOfDate; }
+
+//-------------------------------------------------------------------------------------------------
+//      選択された表示モードを取得します.
+//-------------------------------------------------------------------------------------------------
+VkPresentModeKHR SwapChain::GetPresentMode() const
+{ return m_PresentMode; }
+
+//-------------------------------------------------------------------------------------------------
+//      ポリシーに見合った同時処理フレーム数を取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t SwapChain::GetFrameLatency() const
+{ return m_FrameLatency; }
+
+//-------------------------------------------------------------------------------------------------
+//      スワップチェインを生成します.
+//-------------------------------------------------------------------------------------------------
+bool SwapChain::CreateSwapChain(VkCommandBuffer commandBuffer)
+{
+    VkSurfaceCapabilitiesKHR capabilities;
+    auto result = vkGetPhysicalDeviceSurfaceCapabilitiesKHR(m_Gpu, m_Surface, &capabilities);
+    if ( result != VK_SUCCESS )
+    {
+        ELOG( "Error : vkGetPhysicalDeviceSurfaceCapabilitiesKHR() Failed." );
+        return false;
+    }
+
+    // サーフェイスがサイズを決めている場合はそれに合わせる.
+    VkExtent2D extent = { m_Desc.Width, m_Desc.Height };
+    if (capabilities.currentExtent.width != UINT32_MAX)
+    { extent = capabilities.currentExtent; }
+    else
+    {
+        if (extent.width  < capabilities.minImageExtent.width)  { extent.width  = capabilities.minImageExtent.width; }
+        if (extent.width  > capabilities.maxImageExtent.width)  { extent.width  = capabilities.maxImageExtent.width; }
+        if (extent.height < capabilities.minImageExtent.height) { extent.height = capabilities.minImageExtent.height; }
+        if (extent.height > capabilities.maxImageExtent.height) { extent.height = capabilities.maxImageExtent.height; }
+    }
+
+    m_Desc.Width  = extent.width;
+    m_Desc.Height = extent.height;
+
+    auto oldSwapChain = m_SwapChain;
+
+    // スワップチェインを生成.
+    {
+        VkSwapchainCreateInfoKHR createInfo = {};
+        createInfo.sType                    = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
+        createInfo.pNext                    = nullptr;
+        createInfo.flags                    = 0;
+        createInfo.surface                  = m_Surface;
+        createInfo.minImageCount            = m_Desc.BufferCount;
+        createInfo.imageFormat              = m_Desc.Format;
+        createInfo.imageColorSpace          = m_Desc.ColorSpace;
+        createInfo.imageExtent              = extent;
+        createInfo.imageArrayLayers         = 1;
+        createInfo.imageUsage               = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+        createInfo.imageSharingMode         = VK_SHARING_MODE_EXCLUSIVE;
+        createInfo.queueFamilyIndexCount    = 0;
+        createInfo.pQueueFamilyIndices      = nullptr;
+        createInfo.preTransform             = m_PreTransform;
+        createInfo.compositeAlpha           = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+        createInfo.presentMode              = m_PresentMode;
+        createInfo.clipped                  = VK_TRUE;
+        createInfo.oldSwapchain             = oldSwapChain;
+
+        // 旧スワップチェインへの表示要求を全てドライバに渡してから引き継ぐ.
+        m_pQueue->Flush();
+
+        VkSwapchainKHR swapChain = null_handle;
+        result = vkCreateSwapchainKHR(m_Device, &createInfo, nullptr, &swapChain);
+        if ( result != VK_SUCCESS )
+        {
+            ELOG( "Error : vkCreateSwapChainKHR() Failed." );
+            return false;
+        }
+
+        // 旧スワップチェインは引き継ぎ後に破棄する.
+        if (oldSwapChain != null_handle)
+        { vkDestroySwapchainKHR(m_Device, oldSwapChain, nullptr); }
+
+        m_SwapChain = swapChain;
+    }
+
+    // イメージを取得.
+    {
+        uint32_t chainCount;
+        result = vkGetSwapchainImagesKHR(m_Device, m_SwapChain, &chainCount, nullptr);
+        if ( result != VK_SUCCESS )
+        {
+            ELOG( "Error : vkGetSwapChainImagesKHR() Failed." );
+            return false;
+        }
+
+        // ドライバが要求より多く確保する場合があるので，実際の数を採用する.
+        if ( chainCount < m_Desc.BufferCount )
+        {
+            ELOG( "Error : SwapChain Count is Invalid." );
+            return false;
+        }
+        m_Desc.BufferCount = chainCount;
+
+        std::vector<VkImage> images;
+        images.resize(chainCount);
+        result = vkGetSwapchainImagesKHR(m_Device, m_SwapChain, &chainCount, images.data());
+        if ( result != VK_SUCCESS )
+        {
+            ELOG( "Error : vkGetSwapCHainImagesKHR() Failed." );
+            return false;
+        }
+
+        m_Buffers.resize(chainCount);
+        for(size_t i=0; i<m_Buffers.size(); ++i)
+        { m_Buffers[i].Image = images[i]; }
+
+        images.clear();
+    }
+
+    // イメージビューを生成.
+    {
+        m_Range.aspectMask      = VK_IMAGE_ASPECT_COLOR_BIT;
+        m_Range.baseMipLevel    = 0;
+        m_Range.levelCount      = 1;
+        m_Range.baseArrayLayer  = 0;
+        m_Range.layerCount      = 1;
+
+        for(size_t i=0; i<m_Buffers.size(); ++i)
+        {
+            VkImageViewCreateInfo viewInfo = {};
+            viewInfo.sType            = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+            viewInfo.pNext            = nullptr;
+            viewInfo.flags            = 0;
+            viewInfo.image            = m_Buffers[i].Image;
+            viewInfo.viewType         = VK_IMAGE_VIEW_TYPE_2D;
+            viewInfo.format           = m_Desc.Format;
+            viewInfo.components.r     = VK_COMPONENT_SWIZZLE_R;
+            viewInfo.components.g     = VK_COMPONENT_SWIZZLE_G;
+            viewInfo.components.b     = VK_COMPONENT_SWIZZLE_B;
+            viewInfo.components.a     = VK_COMPONENT_SWIZZLE_A;
+            viewInfo.subresourceRange = m_Range;
+
+            result = vkCreateImageView(m_Device, &viewInfo, nullptr, &m_Buffers[i].View);
+            if ( result != VK_SUCCESS )
+            {
+                ELOG( "Error : vkCreateImageView() Failed." );
+                return false;
+            }
+
+            VkImageMemoryBarrier barrier = {};
+            barrier.sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.pNext               = nullptr;
+            barrier.srcAccessMask       = 0;
+            barrier.dstAccessMask       = 0;
+            barrier.oldLayout           = VK_IMAGE_LAYOUT_UNDEFINED;
+            barrier.newLayout           = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+            barrier.srcQueueFamilyIndex = 0;
+            barrier.dstQueueFamilyIndex = 0;
+            barrier.image               = m_Buffers[i].Image;
+            barrier.subresourceRange    = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+
+            vkCmdPipelineBarrier(
+                commandBuffer,
+                VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                0, 0, nullptr, 0, nullptr, 1, &barrier );
+        }
+    }
+
+
+    return true;
+}
+
 } // namespace asvk
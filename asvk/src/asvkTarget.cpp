@@ -8,10 +8,517 @@
 // Includes
 //-------------------------------------------------------------------------------------------------
 #include <asvkTarget.h>
+#include <asvkLogger.h>
+
+
+namespace /* anonymous */ {
+
+//-------------------------------------------------------------------------------------------------
+//      1ピクセルあたりのバイト数を取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t GetPixelSize(VkFormat format)
+{
+    switch(format)
+    {
+    case VK_FORMAT_R8_UNORM:
+        return 1;
+
+    case VK_FORMAT_R8G8B8A8_UNORM:
+    case VK_FORMAT_R8G8B8A8_SRGB:
+    case VK_FORMAT_B8G8R8A8_UNORM:
+    case VK_FORMAT_B8G8R8A8_SRGB:
+    case VK_FORMAT_A2B10G10R10_UNORM_PACK32:
+    case VK_FORMAT_R32_SFLOAT:
+        return 4;
+
+    case VK_FORMAT_R16G16B16A16_SFLOAT:
+        return 8;
+
+    case VK_FORMAT_R32G32B32A32_SFLOAT:
+        return 16;
+
+    default:
+        return 0;
+    }
+}
+
+} // namespace /* anonymous */
 
 
 namespace asvk {
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// OffscreenTarget class
+///////////////////////////////////////////////////////////////////////////////////////////////////
 
-} // namespace asvk
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+OffscreenTarget::OffscreenTarget()
+: m_Desc            ()
+, m_ColorBuffer     ()
+, m_DepthBuffer     ()
+, m_ReadbackBuffer  ()
+, m_RenderPass      (null_handle)
+, m_FrameBuffer     (null_handle)
+, m_RowPitch        (0)
+{
+    memset(&m_Viewport, 0, sizeof(m_Viewport));
+    memset(&m_Scissor,  0, sizeof(m_Scissor));
+}
+
+//-------------------------------------------------------------------------------------------------
+//      デストラクタです.
+//-------------------------------------------------------------------------------------------------
+OffscreenTarget::~OffscreenTarget()
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      初期化処理を行います.
+//-------------------------------------------------------------------------------------------------
+bool OffscreenTarget::Init
+(
+    DeviceMgr*                  pDeviceMgr,
+    VkCommandBuffer             commandBuffer,
+    const OffscreenTargetDesc*  pDesc
+)
+{
+    if (pDeviceMgr == nullptr || commandBuffer == null_handle || pDesc == nullptr
+     || pDesc->Width == 0 || pDesc->Height == 0)
+    {
+        ELOG( "Error : Invalid Argument." );
+        return false;
+    }
+
+    auto device   = pDeviceMgr->GetDevice();
+    auto hasDepth = (pDesc->DepthFormat != VK_FORMAT_UNDEFINED);
+
+    // カラーバッファの生成.
+    {
+        RenderBufferDesc desc;
+        desc.Dimension   = VK_IMAGE_TYPE_2D;
+        desc.Width       = pDesc->Width;
+        desc.Height      = pDesc->Height;
+        desc.Depth       = 1;
+        desc.ArraySize   = 1;
+        desc.Format      = pDesc->ColorFormat;
+        desc.MipLevels   = 1;
+        desc.Samples     = VK_SAMPLE_COUNT_1_BIT;
+        desc.Usage       = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT
+                         | VK_IMAGE_USAGE_TRANSFER_SRC_BIT
+                         | VK_IMAGE_USAGE_SAMPLED_BIT;
+
+        if (!m_ColorBuffer.Init(pDeviceMgr, commandBuffer, &desc))
+        {
+            ELOG( "Error : ColorBuffer::Init() Failed." );
+            return false;
+        }
+    }
+
+    // 深度バッファの生成.
+    if (hasDepth)
+    {
+        RenderBufferDesc desc;
+        desc.Dimension   = VK_IMAGE_TYPE_2D;
+        desc.Width       = pDesc->Width;
+        desc.Height      = pDesc->Height;
+        desc.Depth       = 1;
+        desc.ArraySize   = 1;
+        desc.Format      = pDesc->DepthFormat;
+        desc.MipLevels   = 1;
+        desc.Samples     = VK_SAMPLE_COUNT_1_BIT;
+        desc.Usage       = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+
+        if (!m_DepthBuffer.Init(pDeviceMgr, commandBuffer, &desc))
+        {
+            ELOG( "Error : DepthBuffer::Init() Failed." );
+            return false;
+        }
+    }
+
+    // レンダーパスの生成.
+    {
+        VkAttachmentDescription attachments[2];
+        attachments[0].format           = pDesc->ColorFormat;
+        attachments[0].samples          = VK_SAMPLE_COUNT_1_BIT;
+        attachments[0].loadOp           = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        attachments[0].storeOp          = VK_ATTACHMENT_STORE_OP_STORE;
+        attachments[0].stencilLoadOp    = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        attachments[0].stencilStoreOp   = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        attachments[0].initialLayout    = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        attachments[0].finalLayout      = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        attachments[0].flags            = 0;
+
+        attachments[1].format           = pDesc->DepthFormat;
+        attachments[1].samples          = VK_SAMPLE_COUNT_1_BIT;
+        attachments[1].loadOp           = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        attachments[1].storeOp          = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        attachments[1].stencilLoadOp    = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        attachments[1].stencilStoreOp   = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        attachments[1].initialLayout    = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+        attachments[1].finalLayout      = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+        attachments[1].flags            = 0;
 
+        VkAttachmentReference colorRef = {};
+        colorRef.attachment = 0;
+        colorRef.layout     = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+        VkAttachmentReference depthRef = {};
+        depthRef.attachment = 1;
+        depthRef.layout     = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+        VkSubpassDescription subpass = {};
+        subpass.pipelineBindPoint       = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        subpass.flags                   = 0;
+        subpass.inputAttachmentCount    = 0;
+        subpass.pInputAttachments       = nullptr;
+        subpass.colorAttachmentCount    = 1;
+        subpass.pColorAttachments       = &colorRef;
+        subpass.pResolveAttachments     = nullptr;
+        subpass.pDepthStencilAttachment = (hasDepth) ? &depthRef : nullptr;
+        subpass.preserveAttachmentCount = 0;
+        subpass.pPreserveAttachments    = nullptr;
+
+        // 前回の読み戻し(転送)および描画とパスの書き込みを順序付ける.
+        VkSubpassDependency dependency = {};
+        dependency.srcSubpass       = VK_SUBPASS_EXTERNAL;
+        dependency.dstSubpass       = 0;
+        dependency.srcStageMask     = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT
+                                    | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT
+                                    | VK_PIPELINE_STAGE_TRANSFER_BIT;
+        dependency.dstStageMask     = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT
+                                    | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+        dependency.srcAccessMask    = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT
+                                    | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        dependency.dstAccessMask    = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT
+                                    | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT
+                                    | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        dependency.dependencyFlags  = 0;
+
+        VkRenderPassCreateInfo info = {};
+        info.sType              = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+        info.pNext              = nullptr;
+        info.flags              = 0;
+        info.attachmentCount    = (hasDepth) ? 2 : 1;
+        info.pAttachments       = attachments;
+        info.subpassCount       = 1;
+        info.pSubpasses         = &subpass;
+        info.dependencyCount    = 1;
+        info.pDependencies      = &dependency;
+
+        auto result = vkCreateRenderPass(device, &info, nullptr, &m_RenderPass);
+        if (result != VK_SUCCESS)
+        {
+            ELOG( "Error : vkCreateRenderPass() Failed." );
+            return false;
+        }
+    }
+
+    // フレームバッファの生成.
+    {
+        VkImageView attachments[2];
+        attachments[0] = m_ColorBuffer.GetView();
+        attachments[1] = (hasDepth) ? m_DepthBuffer.GetView() : null_handle;
+
+        VkFramebufferCreateInfo info = {};
+        info.sType              = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+        info.pNext              = nullptr;
+        info.flags              = 0;
+        info.renderPass         = m_RenderPass;
+        info.attachmentCount    = (hasDepth) ? 2 : 1;
+        info.pAttachments       = attachments;
+        info.width              = pDesc->Width;
+        info.height             = pDesc->Height;
+        info.layers             = 1;
+
+        auto result = vkCreateFramebuffer(device, &info, nullptr, &m_FrameBuffer);
+        if ( result != VK_SUCCESS )
+        {
+            ELOG( "Error : vkCreateFramebuffer() Failed." );
+            return false;
+        }
+    }
+
+    // 読み戻し用バッファの生成.
+    if (pDesc->Readback)
+    {
+        auto pixelSize = GetPixelSize(pDesc->ColorFormat);
+        if (pixelSize == 0)
+        {
+            ELOG( "Error : Unsupported Readback Format. format = %d", pDesc->ColorFormat );
+            return false;
+        }
+
+        m_RowPitch = pDesc->Width * pixelSize;
+
+        VkBufferCreateInfo info = {};
+        info.sType                  = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        info.pNext                  = nullptr;
+        info.flags                  = 0;
+        info.size                   = VkDeviceSize(m_RowPitch) * pDesc->Height;
+        info.usage                  = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        info.sharingMode            = VK_SHARING_MODE_EXCLUSIVE;
+        info.queueFamilyIndexCount  = 0;
+        info.pQueueFamilyIndices    = nullptr;
+
+        if (!m_ReadbackBuffer.Init(
+            pDeviceMgr->GetMemoryAllocator(),
+            &info,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT))
+        {
+            ELOG( "Error : BufferResource::Init() Failed." );
+            return false;
+        }
+    }
+
+    // ビューポートとシザー矩形の設定.
+    {
+        m_Viewport.x        = 0.0f;
+        m_Viewport.y        = 0.0f;
+        m_Viewport.width    = static_cast<float>(pDesc->Width);
+        m_Viewport.height   = static_cast<float>(pDesc->Height);
+        m_Viewport.minDepth = 0.0f;
+        m_Viewport.maxDepth = 1.0f;
+
+        m_Scissor.offset.x      = 0;
+        m_Scissor.offset.y      = 0;
+        m_Scissor.extent.width  = pDesc->Width;
+        m_Scissor.extent.height = pDesc->Height;
+    }
+
+    m_Desc = *pDesc;
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      終了処理を行います.
+//-------------------------------------------------------------------------------------------------
+void OffscreenTarget::Term(DeviceMgr* pDeviceMgr)
+{
+    if (pDeviceMgr == nullptr)
+    { return; }
+
+    auto device = pDeviceMgr->GetDevice();
+    if (device == null_handle)
+    { return; }
+
+    if (m_FrameBuffer != null_handle)
+    { vkDestroyFramebuffer(device, m_FrameBuffer, nullptr); }
+
+    if (m_RenderPass != null_handle)
+    { vkDestroyRenderPass(device, m_RenderPass, nullptr); }
+
+    m_ReadbackBuffer.Term();
+    m_DepthBuffer   .Term(pDeviceMgr);
+    m_ColorBuffer   .Term(pDeviceMgr);
+
+    m_FrameBuffer = null_handle;
+    m_RenderPass  = null_handle;
+    m_RowPitch    = 0;
+    m_Desc        = OffscreenTargetDesc();
+}
+
+//-------------------------------------------------------------------------------------------------
+//      レンダーパスを開始します.
+//-------------------------------------------------------------------------------------------------
+void OffscreenTarget::Begin
+(
+    VkCommandBuffer             commandBuffer,
+    const VkClearColorValue&    clearColor,
+    float                       clearDepth,
+    uint32_t                    clearStencil
+)
+{
+    VkClearValue clearValues[2];
+    clearValues[0].color                = clearColor;
+    clearValues[1].depthStencil.depth   = clearDepth;
+    clearValues[1].depthStencil.stencil = clearStencil;
+
+    VkRenderPassBeginInfo info = {};
+    info.sType              = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+    info.pNext              = nullptr;
+    info.renderPass         = m_RenderPass;
+    info.framebuffer        = m_FrameBuffer;
+    info.renderArea         = m_Scissor;
+    info.clearValueCount    = (m_Desc.DepthFormat != VK_FORMAT_UNDEFINED) ? 2 : 1;
+    info.pClearValues       = clearValues;
+
+    vkCmdBeginRenderPass(commandBuffer, &info, VK_SUBPASS_CONTENTS_INLINE);
+    vkCmdSetViewport(commandBuffer, 0, 1, &m_Viewport);
+    vkCmdSetScissor(commandBuffer, 0, 1, &m_Scissor);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      レンダーパスを終了します.
+//-------------------------------------------------------------------------------------------------
+void OffscreenTarget::End(VkCommandBuffer commandBuffer)
+{ vkCmdEndRenderPass(commandBuffer); }
+
+//-------------------------------------------------------------------------------------------------
+//      カラーバッファを読み戻し用バッファにコピーするコマンドを記録します.
+//-------------------------------------------------------------------------------------------------
+void OffscreenTarget::Readback(VkCommandBuffer commandBuffer)
+{
+    if (m_ReadbackBuffer.GetBuffer() == null_handle)
+    { return; }
+
+    auto image = m_ColorBuffer.GetResource()->GetImage();
+    auto range = m_ColorBuffer.GetRange();
+
+    // 描画完了を待ってから転送元レイアウトに変更.
+    {
+        VkImageMemoryBarrier barrier = {};
+        barrier.sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.pNext               = nullptr;
+        barrier.srcAccessMask       = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        barrier.dstAccessMask       = VK_ACCESS_TRANSFER_READ_BIT;
+        barrier.oldLayout           = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        barrier.newLayout           = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image               = image;
+        barrier.subresourceRange    = range;
+
+        vkCmdPipelineBarrier(
+            commandBuffer,
+            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            0,
+            0, nullptr,
+            0, nullptr,
+            1, &barrier);
+    }
+
+    // バッファにコピー.
+    {
+        VkBufferImageCopy region = {};
+        region.bufferOffset                     = 0;
+        region.bufferRowLength                  = 0;
+        region.bufferImageHeight                = 0;
+        region.imageSubresource.aspectMask      = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel        = 0;
+        region.imageSubresource.baseArrayLayer  = 0;
+        region.imageSubresource.layerCount      = 1;
+        region.imageOffset                      = { 0, 0, 0 };
+        region.imageExtent                      = { m_Desc.Width, m_Desc.Height, 1 };
+
+        vkCmdCopyImageToBuffer(
+            commandBuffer,
+            image,
+            VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            m_ReadbackBuffer.GetBuffer(),
+            1,
+            &region);
+    }
+
+    // レイアウトを戻し, ホストからの読み取りを可能にする.
+    {
+        VkImageMemoryBarrier imageBarrier = {};
+        imageBarrier.sType                  = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        imageBarrier.pNext                  = nullptr;
+        imageBarrier.srcAccessMask          = VK_ACCESS_TRANSFER_READ_BIT;
+        imageBarrier.dstAccessMask          = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        imageBarrier.oldLayout              = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        imageBarrier.newLayout              = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        imageBarrier.srcQueueFamilyIndex    = VK_QUEUE_FAMILY_IGNORED;
+        imageBarrier.dstQueueFamilyIndex    = VK_QUEUE_FAMILY_IGNORED;
+        imageBarrier.image                  = image;
+        imageBarrier.subresourceRange       = range;
+
+        VkBufferMemoryBarrier bufferBarrier = {};
+        bufferBarrier.sType                 = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        bufferBarrier.pNext                 = nullptr;
+        bufferBarrier.srcAccessMask         = VK_ACCESS_TRANSFER_WRITE_BIT;
+        bufferBarrier.dstAccessMask         = VK_ACCESS_HOST_READ_BIT;
+        bufferBarrier.srcQueueFamilyIndex   = VK_QUEUE_FAMILY_IGNORED;
+        bufferBarrier.dstQueueFamilyIndex   = VK_QUEUE_FAMILY_IGNORED;
+        bufferBarrier.buffer                = m_ReadbackBuffer.GetBuffer();
+        bufferBarrier.offset                = 0;
+        bufferBarrier.size                  = VK_WHOLE_SIZE;
+
+        vkCmdPipelineBarrier(
+            commandBuffer,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_HOST_BIT,
+            0,
+            0, nullptr,
+            1, &bufferBarrier,
+            1, &imageBarrier);
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      読み戻し用バッファをマップします.
+//-------------------------------------------------------------------------------------------------
+bool OffscreenTarget::MapReadback(void** ppData) const
+{
+    if (m_ReadbackBuffer.GetBuffer() == null_handle)
+    {
+        ELOG( "Error : Readback Buffer is not created." );
+        return false;
+    }
+
+    return m_ReadbackBuffer.Map(0, ppData);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      読み戻し用バッファをアンマップします.
+//-------------------------------------------------------------------------------------------------
+void OffscreenTarget::UnmapReadback() const
+{
+    if (m_ReadbackBuffer.GetBuffer() == null_handle)
+    { return; }
+
+    m_ReadbackBuffer.Unmap();
+}
+
+//-------------------------------------------------------------------------------------------------
+//      読み戻し用バッファの行ピッチを取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t OffscreenTarget::GetReadbackRowPitch() const
+{ return m_RowPitch; }
+
+//-------------------------------------------------------------------------------------------------
+//      構成設定を取得します.
+//-------------------------------------------------------------------------------------------------
+const OffscreenTargetDesc& OffscreenTarget::GetDesc() const
+{ return m_Desc; }
+
+//-------------------------------------------------------------------------------------------------
+//      カラーバッファを取得します.
+//-------------------------------------------------------------------------------------------------
+RenderBuffer* OffscreenTarget::GetColorBuffer()
+{ return &m_ColorBuffer; }
+
+//-------------------------------------------------------------------------------------------------
+//      深度バッファを取得します.
+//-------------------------------------------------------------------------------------------------
+RenderBuffer* OffscreenTarget::GetDepthBuffer()
+{ return (m_Desc.DepthFormat != VK_FORMAT_UNDEFINED) ? &m_DepthBuffer : nullptr; }
+
+//-------------------------------------------------------------------------------------------------
+//      レンダーパスを取得します.
+//-------------------------------------------------------------------------------------------------
+VkRenderPass OffscreenTarget::GetRenderPass() const
+{ return m_RenderPass; }
+
+//-------------------------------------------------------------------------------------------------
+//      フレームバッファを取得します.
+//-------------------------------------------------------------------------------------------------
+VkFramebuffer OffscreenTarget::GetFrameBuffer() const
+{ return m_FrameBuffer; }
+
+//-------------------------------------------------------------------------------------------------
+//      ビューポートを取得します.
+//-------------------------------------------------------------------------------------------------
+const VkViewport& OffscreenTarget::GetViewport() const
+{ return m_Viewport; }
+
+//-------------------------------------------------------------------------------------------------
+//      シザー矩形を取得します.
+//-------------------------------------------------------------------------------------------------
+const VkRect2D& OffscreenTarget::GetScissor() const
+{ return m_Scissor; }
+
+} // namespace asvk